@@ -39,6 +39,12 @@ struct PirData {
     bool motionDetected;
     unsigned long lastDetectionTime;
     unsigned long detectionCount;
+
+    // Field-wise, so padding does not count as a change (Seqlock)
+    bool operator==(const PirData& other) const {
+        return motionDetected == other.motionDetected && lastDetectionTime == other.lastDetectionTime &&
+               detectionCount == other.detectionCount;
+    }
 };
 
 /**
@@ -52,6 +58,14 @@ struct RadarData {
     uint16_t stationaryTargetDistance;
     uint16_t stationaryTargetEnergy;
     unsigned long lastUpdateTime;
+
+    bool operator==(const RadarData& other) const {
+        return movingTargetDetected == other.movingTargetDetected &&
+               stationaryTargetDetected == other.stationaryTargetDetected &&
+               movingTargetDistance == other.movingTargetDistance && movingTargetEnergy == other.movingTargetEnergy &&
+               stationaryTargetDistance == other.stationaryTargetDistance &&
+               stationaryTargetEnergy == other.stationaryTargetEnergy && lastUpdateTime == other.lastUpdateTime;
+    }
 };
 
 /**
@@ -61,8 +75,64 @@ struct PowerData {
     float batteryVoltage;
     uint8_t batteryPercentage;
     bool usbPowerConnected;
+    bool charging;                 // Charger reports charging (external power only)
     bool batteryLow;
     unsigned long lastUpdateTime;
+
+    bool operator==(const PowerData& other) const {
+        return batteryVoltage == other.batteryVoltage && batteryPercentage == other.batteryPercentage &&
+               usbPowerConnected == other.usbPowerConnected && charging == other.charging &&
+               batteryLow == other.batteryLow && lastUpdateTime == other.lastUpdateTime;
+    }
+};
+
+/**
+ * @brief Kind of change reported by a SensorEvent
+ */
+enum class SensorEventType : uint8_t {
+    PIR_MOTION,            // PIR motion started/stopped
+    RADAR_PRESENCE,        // LD2410S presence appeared/cleared
+    POWER_SOURCE,          // External power connected/disconnected
+    PRESENCE,              // Fused presence (PIR + radar) appeared/cleared
+    CHARGING               // Battery charging started/stopped
+};
+
+/**
+ * @brief Sensor state change passed from the sensor task to the network task
+ */
+struct SensorEvent {
+    SensorEventType type;
+    bool active;                   // New state (motion/presence/USB power)
+    uint16_t value;                // Type-specific detail (e.g. radar distance in cm)
+    unsigned long timestamp;       // millis() when the change was observed
+    uint32_t triggerMicros;        // esp_timer time (low 32 bits) of the waking GPIO edge, 0 if polled
+};
+
+/**
+ * @brief Sensor statistics over one rolling window (see SensorAggregator)
+ */
+struct AggregateWindow {
+    static constexpr uint8_t DISTANCE_BINS = 8;
+    static constexpr uint16_t DISTANCE_BIN_CM = 100;   // Last bin is open-ended
+
+    uint16_t minutes;              // Complete minutes covered (less than nominal after boot)
+    uint32_t occupiedSeconds;      // Time fused presence was active
+    uint16_t motionCount;          // PIR motion starts
+    uint16_t presenceCount;        // Fused presence starts
+    uint16_t distanceHistogram[DISTANCE_BINS];  // Radar reports with a target, per distance band
+    uint16_t batteryMinMv;         // 0 if no battery reading in the window
+    uint16_t batteryMeanMv;
+    uint16_t batteryMaxMv;
+};
+
+/**
+ * @brief Rolling 1 min / 15 min / 1 h sensor statistics
+ */
+struct SensorAggregates {
+    static constexpr uint8_t WINDOW_COUNT = 3;
+
+    AggregateWindow windows[WINDOW_COUNT];  // Shortest window first
+    unsigned long timestamp;       // millis() at the end of the newest minute
 };
 
 // ==========================================
@@ -91,6 +161,70 @@ enum class MqttState {
     RECONNECTING           // Attempting to reconnect
 };
 
+// ==========================================
+// Event Bus Messages (utilities/EventBus.h)
+// ==========================================
+
+/**
+ * @brief Fused PIR/radar presence appeared or cleared (sensor task)
+ */
+struct PresenceChanged {
+    static constexpr const char* NAME = "presence";
+    bool present;
+    uint32_t timestamp;            // millis() of the change
+};
+
+/**
+ * @brief External power connected or disconnected (sensor task)
+ */
+struct PowerSourceChanged {
+    static constexpr const char* NAME = "power";
+    bool externalPower;
+    uint8_t batteryPercentage;
+    uint32_t timestamp;            // millis() of the change
+};
+
+/**
+ * @brief WiFi connection state changed (network task)
+ */
+struct WifiStateChanged {
+    static constexpr const char* NAME = "wifi";
+    WifiState state;
+    WifiState previous;
+};
+
+/**
+ * @brief Runtime-adjustable setting identifiers
+ */
+enum class SettingId : uint8_t {
+    LED_BRIGHTNESS,        // 0-255
+    STEALTH_MODE,          // 0/1
+    FUSION_COOLDOWN,       // ms
+    FUSION_RADAR_HOLD,     // ms
+    FUSION_MOVING_ENERGY,  // Minimum, 0-100
+    FUSION_STATIONARY_ENERGY  // Minimum, 0-100
+};
+
+/**
+ * @brief A runtime setting took a new value (task that changed it)
+ */
+struct SettingChanged {
+    static constexpr const char* NAME = "setting";
+    SettingId id;
+    uint32_t value;
+};
+
+/**
+ * @brief A setting change asked for remotely, e.g. from Home Assistant (network task)
+ *
+ * The owner applies it in its own task and confirms with SettingChanged.
+ */
+struct SettingRequested {
+    static constexpr const char* NAME = "request";
+    SettingId id;
+    uint32_t value;
+};
+
 // ==========================================
 // Data Structures
 // ==========================================
@@ -135,4 +269,15 @@ struct SensorData {
         lastLd2410sTrigger = 0;
         dataTimestamp = millis();
     }
+
+    // Field-wise: the constructor leaves the padding unset (Seqlock)
+    bool operator==(const SensorData& other) const {
+        return pirMotionDetected == other.pirMotionDetected &&
+               ld2410sPresenceDetected == other.ld2410sPresenceDetected &&
+               ld2410sMovementDetected == other.ld2410sMovementDetected && isUsbPowered == other.isUsbPowered &&
+               isBatteryCharging == other.isBatteryCharging && isChargeComplete == other.isChargeComplete &&
+               batteryVoltage == other.batteryVoltage && ld2410sDistance == other.ld2410sDistance &&
+               lastPirTrigger == other.lastPirTrigger && lastLd2410sTrigger == other.lastLd2410sTrigger &&
+               dataTimestamp == other.dataTimestamp;
+    }
 };
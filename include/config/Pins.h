@@ -51,6 +51,11 @@
 // Power Good Input - HIGH = External Power, LOW = On Battery
 #define POWER_GOOD_PIN          21
 
+// Battery Sense - Analog input (ADC1) from a divider across the cell
+// Not on the Basic prototype schematic yet; assumes a 1:2 divider
+#define BATTERY_SENSE_PIN       4
+#define BATTERY_DIVIDER_RATIO   2
+
 // ==========================================
 // Audio Feedback Pin
 // ==========================================
@@ -63,7 +68,7 @@
 // ==========================================
 
 // Serial Device Configuration
-#define LD2410S_BAUD_RATE       256000
+#define LD2410S_BAUD_RATE       115200  // LD2410S default (the LD2410/LD2410B use 256000)
 
 // LED Configuration
 #define NUM_LEDS                2
@@ -5,8 +5,9 @@
  * @brief Global configuration settings for HearthGuard: The Scout
  */
 
-// Debug Configuration
-#define DEBUG 1
+// Log Configuration: 0 none, 1 error, 2 warn, 3 info, 4 debug, 5 verbose
+// Levels above LOG_LEVEL are compiled out entirely (see utilities/Logger.h)
+#define LOG_LEVEL 4
 
 // Firmware Information
 #define FIRMWARE_VERSION "0.1.0"
@@ -24,11 +25,84 @@
 #define MQTT_PORT 1883
 #define MQTT_USER "mqtt-user"
 #define MQTT_PASSWORD "##DikTrill45"
+#define MQTT_BASE_TOPIC "hearthguard"  // Topics are <base>/<device id>/<name>
+#define MQTT_PAYLOAD_SIZE 1024  // Reusable payload buffer (bytes)
+#define MQTT_KEEPALIVE 60  // PINGREQ after this long without sending (s)
+#define MQTT_CONNECT_TIMEOUT 5000  // Limit for TCP connect + CONNACK, and for a PINGRESP (ms)
+#define MQTT_RETRY_INTERVAL 15000  // First broker retry (PRD Phase 5)
+#define MQTT_RETRY_MAX 120000  // Retry delay doubles per failure up to this (ms)
+#define MQTT_RETRY_JITTER 20  // Retry delays vary by +/- this percent
+#define MQTT_TX_BUFFER_SIZE 1536  // Queued outgoing packets; fits a full payload plus topic
+#define MQTT_RX_BUFFER_SIZE 256  // Incoming packets; larger ones are skipped
+#define MQTT_INFLIGHT_WINDOW 4  // QoS 1 publishes awaiting PUBACK at once
+#define MQTT_INFLIGHT_PACKET_SIZE 256  // Largest QoS 1 PUBLISH kept for retransmission (bytes)
+
+// Home Assistant Discovery
+#define HA_DISCOVERY_PREFIX "homeassistant"
+#define HA_STATUS_TOPIC HA_DISCOVERY_PREFIX "/status"  // HA announces "online" here after a restart
+#define HA_DISCOVERY_BLOB_SIZE 3072  // All config topics and payloads, built once at boot
+
+// Store-and-Forward (presence/power events queued on LittleFS while MQTT is down)
+#define EVENT_JOURNAL_SEGMENT_COUNT 4  // Ring of journal files
+#define EVENT_JOURNAL_SEGMENT_RECORDS 256  // 16-byte records per file (4 KB, one flash sector)
+#define EVENT_DRAIN_INTERVAL 200  // Minimum time between replayed events after a reconnect (ms)
+#define EVENT_DRAIN_COMMIT 16  // Replay progress is persisted every this many events
 
 // Timing Constants
 #define UPDATE_INTERVAL 100  // Main loop update interval (ms)
 #define STATUS_UPDATE_INTERVAL 30000  // Status updates every 30 seconds
 
+// Scheduler Task Periods (ms)
+#define SENSOR_UPDATE_INTERVAL 250  // Radar polling (PRD Phase 4); PIR is interrupt driven
+#define POWER_UPDATE_INTERVAL 5000  // Power status polling (PRD Phase 4)
+#define DEVICE_UPDATE_INTERVAL 50  // Factory reset button polling
+#define WIFI_UPDATE_INTERVAL 1000  // WiFi connection supervision
+#define MQTT_UPDATE_INTERVAL UPDATE_INTERVAL  // MQTT client servicing
+#define CONSOLE_POLL_INTERVAL 200  // Serial diagnostic commands
+#define PROFILE_PUBLISH_INTERVAL 60000  // Loop profile to MQTT every minute
+#define SYSTEM_PUBLISH_INTERVAL 60000  // CPU temperature and free heap to MQTT (PRD Phase 5)
+
+// FreeRTOS Task Layout
+#define SENSOR_TASK_CORE 1  // Acquisition runs next to the Arduino loop
+#define SENSOR_TASK_PRIORITY 5  // Above loop (1) and network
+#define SENSOR_TASK_STACK_SIZE 4096  // Bytes
+#define NETWORK_TASK_CORE 0  // Alongside the WiFi/LwIP stack
+#define NETWORK_TASK_PRIORITY 2
+#define NETWORK_TASK_STACK_SIZE 8192  // Bytes
+#define SENSOR_EVENT_QUEUE_SIZE 32  // Must be a power of two
+#define LOG_TASK_CORE 0  // Serial output stays off the acquisition core
+#define LOG_TASK_PRIORITY 1  // Lowest application priority
+#define LOG_TASK_STACK_SIZE 3072  // Bytes
+#define LOG_DRAIN_INTERVAL 20  // Ring buffer drain period (ms)
+#define LOG_DRAIN_INTERVAL_BATTERY 1000  // Fewer wake-ups while light sleeping
+
+// Battery Monitoring (continuous ADC bursts)
+#define BATTERY_SAMPLE_RATE 1000  // ADC DMA conversion rate during a burst (Hz)
+#define BATTERY_BURST_SAMPLES 64  // Samples per burst, one burst per power poll
+#define BATTERY_LOW_PERCENT 15  // batteryLow below this charge
+
+// Presence Fusion (PRD Phase 4), tunable at runtime
+#define PRESENCE_COOLDOWN 30000  // PIR off time before presence can clear (ms)
+#define PRESENCE_RADAR_HOLD 0  // Radar dropouts bridged after the cooldown (ms)
+#define PRESENCE_MOVING_ENERGY_MIN 0  // Minimum moving target energy (0-100)
+#define PRESENCE_STATIONARY_ENERGY_MIN 0  // Minimum stationary target energy (0-100)
+// The LD2410S reports no target energy (see Ld2410sSensor), so keep both at 0
+
+// Sensor Aggregation
+#define AGGREGATE_ONLY_ON_BATTERY 1  // On battery, raw PIR/radar events reach MQTT only as rolling aggregates
+
+// Radar Engineering Mode
+#define GATE_ENERGY_LOG_SIZE 128  // Per-gate energy frames kept, power of two (~13 s at 10 Hz)
+#define GATE_STREAM_INTERVAL 20  // Pause between streamed batches (ms)
+#define GATE_STREAM_BATCH 4  // Frames written per batch
+
+// Sensor Trace Recording (LittleFS)
+#define TRACE_SEGMENT_COUNT 4  // Ring of trace files
+#define TRACE_SEGMENT_SIZE 32768  // Bytes per file; flash budget = count x size
+#define TRACE_BUFFER_SIZE 512  // Bytes per RAM buffer (two are used)
+#define TRACE_FLUSH_INTERVAL 10000  // Longest time records wait in RAM (ms)
+#define TRACE_WRITE_INTERVAL 500  // Writer task period (ms)
+
 // LED Configuration
 #define DEFAULT_LED_BRIGHTNESS 100  // 0-255
 #define LED_UPDATE_INTERVAL 50  // LED animation update interval (ms)
@@ -0,0 +1,69 @@
+#pragma once
+
+/**
+ * @file BreathTable.h
+ * @brief Compile-time breathing curve for LED PULSE / BREATHE keyframes
+ *
+ * One breath is 256 gamma-corrected levels indexed by the top byte of a
+ * 16-bit phase. The table is generated by the compiler, so it costs no
+ * flash beyond its 256 bytes and no startup time.
+ */
+
+#include <stdint.h>
+
+namespace BreathTable {
+
+constexpr double PI_VALUE = 3.14159265358979323846;
+constexpr int GAMMA_ROOT_ITERATIONS = 24;
+
+/**
+ * @brief Taylor-series cosine, accurate to well below 1/255 for |x| <= PI
+ */
+constexpr double cosine(double x) {
+    double term = 1.0;
+    double sum = 1.0;
+    for (int n = 1; n < 12; n++) {
+        term *= -x * x / ((2.0 * n - 1.0) * (2.0 * n));
+        sum += term;
+    }
+    return sum;
+}
+
+/**
+ * @brief x^2.2 for x in [0, 1], as x^2 * fifth_root(x) (Newton iteration)
+ */
+constexpr double gamma22(double x) {
+    if (x <= 0.0) {
+        return 0.0;
+    }
+    double root = 1.0;
+    for (int i = 0; i < GAMMA_ROOT_ITERATIONS; i++) {
+        const double root4 = root * root * root * root;
+        root -= (root4 * root - x) / (5.0 * root4);
+    }
+    return x * x * root;
+}
+
+struct Levels {
+    uint8_t values[256];
+};
+
+/**
+ * @brief Raised-cosine breath (0 at phase 0, peak at phase 128), gamma 2.2
+ */
+constexpr Levels makeLevels() {
+    Levels table{};
+    for (int i = 0; i < 256; i++) {
+        const double x = PI_VALUE * (2.0 * i / 256.0 - 1.0);  // -PI..PI
+        const double level = (1.0 + cosine(x)) / 2.0;         // 0 -> 1 -> 0
+        table.values[i] = static_cast<uint8_t>(gamma22(level) * 255.0 + 0.5);
+    }
+    return table;
+}
+
+static constexpr Levels LEVELS = makeLevels();
+
+static_assert(LEVELS.values[0] == 0, "breath must start dark");
+static_assert(LEVELS.values[128] == 255, "breath must peak at half phase");
+
+} // namespace BreathTable
@@ -1,11 +1,64 @@
 #pragma once
 #include <Arduino.h>
+#include <atomic>
+#include <driver/ledc.h>
+#include <esp_timer.h>
+#include <esp_pm.h>
+
+/**
+ * @brief Audible cues available on The Scout
+ *
+ * Each cue maps to a note table in Melodies.h. COUNT must stay last.
+ */
+enum class SoundCue : uint8_t {
+    BOOT,           // Power-on melody
+    SUCCESS,        // Two quick, rising notes
+    FAILURE,        // Single, low, longer note
+    CONFIRM,        // Single, sharp, medium note
+    INTERACTION,    // Very short, high "tick"
+    ALARM,          // Repeating two-tone siren
+    LOW_BATTERY,    // Falling double chirp
+    COUNT
+};
+
+/**
+ * @brief One note of a melody
+ */
+struct MelodyNote {
+    uint16_t frequency;     // Hz, 0 = rest
+    uint16_t duration;      // Tone length in ms
+    uint16_t gap;           // Silence after the tone in ms
+};
+
+/**
+ * @brief A playable sequence of notes with its queue priority
+ */
+struct Melody {
+    const MelodyNote* notes;
+    uint8_t length;
+    uint8_t priority;
+};
 
 /**
  * @brief Medieval-themed audio feedback controller for The Scout
- * 
+ *
  * Manages PWM-based tone generation using ESP32 LEDC peripheral.
  * Provides thematic sound cues with stealth mode capability.
+ *
+ * Tones are generated entirely in hardware on a fixed LEDC timer/channel,
+ * and sequence steps are advanced by a one-shot esp_timer. Once a sound is
+ * started it plays to completion without any help from the main loop.
+ *
+ * Cues are data-driven (see Melodies.h). A cue requested while another is
+ * playing either preempts it (higher priority) or waits in a small
+ * fixed-capacity priority queue.
+ *
+ * LEDC stops while the SoC is in light sleep, so a power-management lock
+ * keeps the chip awake for as long as a melody is playing.
+ *
+ * soundLock only guards the sequencing decision (which note, until when).
+ * The LEDC, esp_timer and PM-lock calls happen afterwards in
+ * syncHardware(), outside the critical section, one caller at a time.
  */
 class BuzzerController {
 public:
@@ -16,7 +69,9 @@ public:
 
     /**
      * @brief Update method for non-blocking sound playback
-     * Must be called in main loop
+     *
+     * Sequences are timer driven, so this is a no-op kept for the
+     * FeedbackManager contract.
      */
     void update();
 
@@ -26,6 +81,13 @@ public:
      */
     void setStealthMode(bool enabled);
 
+    /**
+     * @brief Play a sound cue, preempting or queueing by priority
+     * @param cue Cue to play
+     * @return True if the cue is playing or queued, false if dropped
+     */
+    bool play(SoundCue cue);
+
     /**
      * @brief Play success sound (two quick, rising notes)
      */
@@ -47,45 +109,101 @@ public:
     void playInteraction();
 
 private:
-    // Medieval-themed sound constants (frequencies in Hz)
-    static constexpr uint16_t TONE_BOOT_LOW = 440;      // A4 - Boot sequence start
-    static constexpr uint16_t TONE_BOOT_HIGH = 523;     // C5 - Boot sequence end
-    static constexpr uint16_t TONE_SUCCESS_LOW = 523;   // C5 - Success low note
-    static constexpr uint16_t TONE_SUCCESS_HIGH = 659;  // E5 - Success high note
-    static constexpr uint16_t TONE_FAILURE = 220;       // A3 - Failure (low)
-    static constexpr uint16_t TONE_CONFIRM = 587;       // D5 - Confirmation
-    static constexpr uint16_t TONE_INTERACTION = 880;   // A5 - Quick interaction
-
-    // Timing constants (milliseconds)
-    static constexpr uint16_t DURATION_BOOT = 150;
-    static constexpr uint16_t DURATION_SUCCESS_SHORT = 100;
-    static constexpr uint16_t DURATION_SUCCESS_GAP = 50;
-    static constexpr uint16_t DURATION_FAILURE = 300;
-    static constexpr uint16_t DURATION_CONFIRM = 120;
-    static constexpr uint16_t DURATION_INTERACTION = 50;
-
-    // Sound sequence management
-    enum class SoundState {
-        IDLE,
-        BOOT,
-        SUCCESS_NOTE1,
-        SUCCESS_GAP,
-        SUCCESS_NOTE2,
-        FAILURE,
-        CONFIRM,
-        INTERACTION
-    };
-
-    SoundState currentSound = SoundState::IDLE;
-    unsigned long soundStartTime = 0;
+    // LEDC hardware configuration (fixed channel and timer reserved for the buzzer)
+    static constexpr ledc_mode_t LEDC_MODE = LEDC_LOW_SPEED_MODE;
+    static constexpr ledc_timer_t LEDC_TIMER = LEDC_TIMER_0;
+    static constexpr ledc_channel_t LEDC_CHANNEL = LEDC_CHANNEL_0;
+    static constexpr ledc_timer_bit_t LEDC_RESOLUTION = LEDC_TIMER_10_BIT;
+    static constexpr uint32_t LEDC_DUTY_HALF = 1u << (LEDC_RESOLUTION - 1);  // 50% square wave
+    static constexpr uint32_t LEDC_INITIAL_FREQUENCY = 440;
+
+    // Valid tone range (lower bound keeps the APB-clocked 10-bit divider in range)
+    static constexpr uint16_t MIN_FREQUENCY = 100;
+    static constexpr uint16_t MAX_FREQUENCY = 20000;
+
+    // Pending cue queue, ordered by priority (FIFO within a priority)
+    static constexpr uint8_t QUEUE_CAPACITY = 4;
+
+    SoundCue cueQueue[QUEUE_CAPACITY];
+    uint8_t queueLength = 0;
+
+    // Active melody playback
+    const Melody* currentMelody = nullptr;
+    uint8_t noteIndex = 0;
+    bool inGap = false;
+
     bool stealthMode = false;
     bool buzzerInitialized = false;
 
-    // Software PWM variables
+    // Hardware state the sequencer wants (soundLock held to change)
+    uint16_t targetFrequency = 0;   // 0 = silent
+    int64_t stepDeadline = 0;       // esp_timer time (us) the current step is due, 0 = idle
+    uint32_t stepGeneration = 0;    // Bumped on every decision, tells syncHardware() to catch up
+    portMUX_TYPE soundLock = portMUX_INITIALIZER_UNLOCKED;
+
+    // Hardware state as applied (only touched by the syncHardware() owner)
+    std::atomic<bool> syncBusy{false};
     bool isToneActive = false;
     uint16_t currentFrequency = 0;
-    unsigned long halfPeriod = 0;
-    unsigned long lastToggle = 0;
+    bool sleepLockHeld = false;
+
+    // Sequence timing (step timer runs in the esp_timer task)
+    esp_timer_handle_t stepTimer = nullptr;
+
+    #if CONFIG_PM_ENABLE
+    esp_pm_lock_handle_t sleepLock = nullptr;   // Held while a melody is playing
+    #endif
+
+    /**
+     * @brief Start a melody from its first note (soundLock held)
+     * @param melody Melody to play
+     */
+    void startMelody(const Melody& melody);
+
+    /**
+     * @brief Select the note at noteIndex of the current melody (soundLock held)
+     */
+    void playCurrentNote();
+
+    /**
+     * @brief Insert a cue into the priority queue (soundLock held)
+     * @param cue Cue to queue
+     * @return True if queued, false if the queue had no room for it
+     */
+    bool enqueue(SoundCue cue);
+
+    /**
+     * @brief Advance the active melody to its next step (timer context)
+     */
+    void advanceSequence();
+
+    /**
+     * @brief esp_timer trampoline into advanceSequence()
+     * @param arg BuzzerController instance
+     */
+    static void onStepTimer(void* arg);
+
+    /**
+     * @brief Set the deadline of the current sequence step (soundLock held)
+     * @param duration Step duration in ms
+     */
+    void scheduleStep(uint16_t duration);
+
+    /**
+     * @brief Bring LEDC, the step timer and the sleep lock in line with the
+     *        sequencer state (soundLock not held)
+     *
+     * Single-flight: a caller that finds another sync running returns at
+     * once, and the running one loops until it has applied the newest
+     * stepGeneration.
+     */
+    void syncHardware();
+
+    /**
+     * @brief Block / allow automatic light sleep around melody playback
+     */
+    void keepAwake();
+    void allowSleep();
 
     /**
      * @brief Start playing a tone at specified frequency
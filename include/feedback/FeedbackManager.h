@@ -1,19 +1,30 @@
 #pragma once
 #include <Arduino.h>
 #include <Preferences.h>
+#include <atomic>
 #include "BuzzerController.h"
 #include "LedController.h"
+#include "config/DataTypes.h"
+#include "utilities/Scheduler.h"
 
 /**
  * @brief Comprehensive feedback management system for The Scout
  * 
  * Coordinates LED and buzzer feedback with persistent settings.
  * Provides high-level interface for visual and audio cues.
+ *
+ * WiFi state and fused presence changes arrive on the EventBus from the
+ * network and sensor tasks. The handlers only latch the latest state and
+ * wake the feedback task, which plays the matching cue (PRD Phase 2
+ * feedback table for WiFi, an activity blink for presence). Brightness
+ * and stealth changes are published as SettingChanged; SettingRequested
+ * (e.g. from Home Assistant) is latched the same way and applied by the
+ * feedback task.
  */
 class FeedbackManager {
 public:
     /**
-     * @brief Initialize feedback manager and load settings
+     * @brief Initialize feedback manager, load settings and subscribe to events
      */
     void begin();
 
@@ -22,6 +33,12 @@ public:
      */
     void update();
 
+    /**
+     * @brief Register the feedback task (runs only when an LED deadline is due)
+     * @param scheduler Scheduler to register with
+     */
+    void registerTasks(Scheduler& scheduler);
+
     // LED Control Methods (delegated to LedController)
     /**
      * @brief Set global LED brightness
@@ -38,12 +55,48 @@ public:
      */
     void startAnimation(uint8_t pixelIndex, CRGB color, LedAnimation animation, uint16_t interval);
 
+    /**
+     * @brief Start a finite LED animation (e.g. blink 3 times then stop)
+     * @param pixelIndex PIXEL_SYSTEM or PIXEL_ACTIVITY
+     * @param color CRGB color (FastLED format)
+     * @param animation Animation type
+     * @param interval Animation interval in ms
+     * @param repeatCount Number of cycles to play (0 = forever)
+     * @param endAction What to do after the last cycle
+     */
+    void startAnimation(uint8_t pixelIndex, CRGB color, LedAnimation animation, uint16_t interval,
+                        uint16_t repeatCount, LedEndAction endAction);
+
+    /**
+     * @brief Start a custom LED keyframe timeline
+     * @param pixelIndex PIXEL_SYSTEM or PIXEL_ACTIVITY
+     * @param keyframes Keyframes to play in order
+     * @param count Number of keyframes
+     * @param repeatCount Number of cycles to play (0 = forever)
+     * @param endAction What to do after the last cycle
+     */
+    void startTimeline(uint8_t pixelIndex, const LedKeyframe* keyframes, uint8_t count,
+                       uint16_t repeatCount = 0, LedEndAction endAction = LedEndAction::HOLD);
+
+    /**
+     * @brief Get when the LEDs next need update() to be called
+     * @param deadline Set to the millis() value feedback work is due
+     * @return True if anything is pending, false if feedback is idle
+     */
+    bool getNextDeadline(unsigned long& deadline) const;
+
     /**
      * @brief Turn off all LEDs
      */
     void turnOffLeds();
 
     // Buzzer Control Methods (delegated to BuzzerController)
+    /**
+     * @brief Play any sound cue (preempts or queues by cue priority)
+     * @param cue Cue to play
+     */
+    void playCue(SoundCue cue);
+
     /**
      * @brief Play success sound
      */
@@ -83,6 +136,13 @@ public:
      */
     uint8_t getBrightness() const { return currentBrightness; }
 
+    /**
+     * @brief Publish the current brightness and stealth mode as SettingChanged
+     *
+     * For subscribers that began after the settings were loaded.
+     */
+    void publishSettings();
+
 private:
     // Controller instances
     LedController ledController;
@@ -97,6 +157,57 @@ private:
     // Current settings
     uint8_t currentBrightness = 255;
     bool stealthMode = false;
+
+    // Status cue timing (ms)
+    static constexpr uint16_t PULSE_SLOW_INTERVAL = 3000;
+    static constexpr uint16_t BLINK_FAST_INTERVAL = 200;
+    static constexpr uint16_t BLINK_INTERVAL = 500;
+    static constexpr uint16_t RESULT_BLINK_COUNT = 3;
+
+    // Latest bus events, latched by the publishing task and applied by update()
+    static constexpr uint8_t NO_EVENT = 0xFF;
+    Scheduler* taskScheduler = nullptr;
+    std::atomic<uint8_t> pendingWifiState{NO_EVENT};    // WifiState value
+    std::atomic<uint8_t> pendingPresence{NO_EVENT};     // 0 cleared, 1 present
+    std::atomic<int16_t> pendingBrightness{-1};         // Requested 0-255, -1 if none
+    std::atomic<uint8_t> pendingStealth{NO_EVENT};      // Requested 0 off, 1 on
+
+    /**
+     * @brief Apply the settings and play the cues for bus events received since the last update
+     */
+    void applyPendingEvents();
+
+    /**
+     * @brief Show a WiFi connection state on the system LED
+     * @param state New connection state
+     */
+    void showWifiState(WifiState state);
+
+    /**
+     * @brief EventBus handler: latch the WiFi state and wake the feedback task
+     * @param context FeedbackManager instance
+     * @param event WiFi state change
+     */
+    static void onWifiStateChanged(void* context, const WifiStateChanged& event);
+
+    /**
+     * @brief EventBus handler: latch fused presence and wake the feedback task
+     * @param context FeedbackManager instance
+     * @param event Presence change
+     */
+    static void onPresenceChanged(void* context, const PresenceChanged& event);
+
+    /**
+     * @brief EventBus handler: latch a requested brightness or stealth mode and wake the feedback task
+     * @param context FeedbackManager instance
+     * @param event Requested setting
+     */
+    static void onSettingRequested(void* context, const SettingRequested& event);
+
+    /**
+     * @brief Wake the feedback task (any task)
+     */
+    void wake();
     
     /**
      * @brief Load settings from non-volatile storage
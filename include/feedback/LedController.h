@@ -1,6 +1,7 @@
 #pragma once
 #include <Arduino.h>
 #include <FastLED.h>
+#include "feedback/Ws2812RmtDriver.h"
 
 /**
  * @brief LED animation types for WS2812B control
@@ -11,6 +12,33 @@ enum class LedAnimation {
     PULSE       // Breathing/pulsing effect
 };
 
+/**
+ * @brief How a keyframe moves from the previous color to its own
+ */
+enum class LedEasing : uint8_t {
+    STEP,       // Jump straight to the keyframe color
+    LINEAR,     // Fade from the previous color across the keyframe
+    BREATHE     // One gamma-corrected breath (dark -> color -> dark)
+};
+
+/**
+ * @brief What a finite timeline does once its repeats are used up
+ */
+enum class LedEndAction : uint8_t {
+    HOLD,       // Keep showing the last keyframe's final color
+    REVERT,     // Resume the pattern that was running before
+    OFF         // Turn the pixel off
+};
+
+/**
+ * @brief One step of a pixel timeline
+ */
+struct LedKeyframe {
+    CRGB color;
+    uint16_t duration;      // Keyframe length in ms
+    LedEasing easing;
+};
+
 /**
  * @brief Pixel identifiers for The Scout
  */
@@ -35,8 +63,19 @@ namespace HearthGuardColors {
 /**
  * @brief Advanced LED controller for medieval-themed IoT device
  * 
- * Uses FastLED library with single CRGB array and two addLeds calls
- * as specified in PRD Phase 1 requirements.
+ * Uses a single FastLED CRGB array as specified in PRD Phase 1, with each
+ * data pin driven by its own RMT channel (Ws2812RmtDriver) so frames are
+ * transmitted in the background instead of blocking the main loop.
+ *
+ * Pixel writes only update the frame buffer and mark it dirty; update()
+ * starts at most one frame per frame interval, and only when the bytes
+ * it would send (after global brightness) differ from the last frame
+ * pushed, so steps that quantise to the same output cost no frame.
+ *
+ * Every pixel runs a small keyframe timeline. SOLID, BLINK and PULSE are
+ * built-in timelines, and any of them can repeat a fixed number of times
+ * before holding, reverting or switching off. Each pixel tracks its next
+ * deadline so callers only need to service the LEDs when it is due.
  */
 class LedController {
 public:
@@ -76,6 +115,44 @@ public:
      */
     void startAnimation(uint8_t pixelIndex, CRGB color, LedAnimation animation, uint16_t interval);
 
+    /**
+     * @brief Start a finite animation (e.g. "blink green 3 times then stop")
+     * @param pixelIndex PIXEL_SYSTEM or PIXEL_ACTIVITY
+     * @param color CRGB color
+     * @param animation Animation type
+     * @param interval Animation interval in ms
+     * @param repeatCount Number of cycles to play (0 = forever)
+     * @param endAction What to do after the last cycle
+     */
+    void startAnimation(uint8_t pixelIndex, CRGB color, LedAnimation animation, uint16_t interval,
+                        uint16_t repeatCount, LedEndAction endAction);
+
+    /**
+     * @brief Start a custom keyframe timeline on a pixel
+     * @param pixelIndex PIXEL_SYSTEM or PIXEL_ACTIVITY
+     * @param keyframes Keyframes to play in order (copied)
+     * @param count Number of keyframes (1 to MAX_KEYFRAMES)
+     * @param repeatCount Number of cycles to play (0 = forever)
+     * @param endAction What to do after the last cycle
+     */
+    void startTimeline(uint8_t pixelIndex, const LedKeyframe* keyframes, uint8_t count,
+                       uint16_t repeatCount = 0, LedEndAction endAction = LedEndAction::HOLD);
+
+    /**
+     * @brief Get when a pixel next needs servicing
+     * @param pixelIndex Which pixel to query
+     * @param deadline Set to the millis() value the pixel is due
+     * @return True if the pixel has pending work, false if it is static
+     */
+    bool getPixelDeadline(uint8_t pixelIndex, unsigned long& deadline) const;
+
+    /**
+     * @brief Get when update() next has work to do (animations or a pending frame)
+     * @param deadline Set to the earliest millis() value anything is due
+     * @return True if anything is pending, false if the LEDs are static
+     */
+    bool getNextDeadline(unsigned long& deadline) const;
+
     /**
      * @brief Turn off specified LED (PRD requirement)
      * @param pixelIndex Which pixel to turn off
@@ -87,35 +164,120 @@ public:
      */
     void turnOff();
 
+    /**
+     * @brief Set the minimum time between pushed frames
+     * @param intervalMs Frame interval in ms
+     */
+    void setFrameInterval(uint16_t intervalMs);
+
+    /**
+     * @brief Get number of frames sent to the LEDs
+     * @return Frames handed to the LED output since boot
+     */
+    uint32_t getFramesPushed() const { return framesPushed; }
+
+    /**
+     * @brief Get number of frame slots skipped because nothing changed
+     * @return Frames skipped since boot
+     */
+    uint32_t getFramesSkipped() const { return framesSkipped; }
+
+    /**
+     * @brief Get number of dirty frames dropped because their output bytes matched the last one
+     * @return Frames dropped since boot (also counted in getFramesSkipped())
+     */
+    uint32_t getFramesUnchanged() const { return framesUnchanged; }
+
+    // Maximum keyframes in one pixel timeline
+    static constexpr uint8_t MAX_KEYFRAMES = 4;
+
 private:
-    // Hardware configuration (PRD: single CRGB array, two addLeds calls)
+    // Hardware configuration (PRD: single CRGB array, one output per pin)
     static constexpr uint8_t LED_COUNT = 2;
     static constexpr uint8_t FADE_STEP_MS = 50; // Fixed 50ms fade duration
+    static constexpr uint16_t DEFAULT_FRAME_INTERVAL = 20; // Max 50 frames per second
     
     // FastLED array for both LEDs (PRD requirement)
     CRGB leds[LED_COUNT];
 
-    // Animation state for each pixel
+    // Background WS2812B output (one RMT channel per LED pin)
+    Ws2812RmtDriver rmtDriver;
+
+    // Timeline state for each pixel
     struct PixelState {
-        LedAnimation animation = LedAnimation::SOLID;
-        CRGB baseColor = CRGB::Black;
-        uint16_t interval = 0;
-        unsigned long lastUpdate = 0;
-        bool isOn = false;
-        uint8_t pulsePhase = 0; // For sine wave pulse effect
+        LedKeyframe frames[MAX_KEYFRAMES];
+        uint32_t frameRates[MAX_KEYFRAMES] = {};  // Phase advance per ms in Q8.8 (set once per timeline)
+        uint32_t cycleDuration = 0;               // Sum of keyframe durations in ms
+        uint8_t frameCount = 0;
+        uint8_t frameIndex = 0;
+        uint16_t repeatCount = 0;                 // 0 = forever
+        uint16_t cyclesDone = 0;
+        LedEndAction endAction = LedEndAction::HOLD;
+        unsigned long frameStart = 0;
+        unsigned long nextDeadline = 0;
+        CRGB fromColor = CRGB::Black;             // Color at the start of the current keyframe
+        CRGB outputColor = CRGB::Black;           // Color currently shown (before stealth)
+        bool active = false;                      // False once the timeline holds a static color
     };
     
     // State management
     PixelState pixelStates[LED_COUNT];
+    PixelState previousStates[LED_COUNT];  // Pattern restored by LedEndAction::REVERT
     uint8_t globalBrightness = 255;
     bool stealthMode = false;
     bool ledsInitialized = false;
 
+    // Frame compositor
+    bool frameDirty = false;
+    uint16_t frameInterval = DEFAULT_FRAME_INTERVAL;
+    unsigned long lastFrameTime = 0;
+    uint32_t framesPushed = 0;
+    uint32_t framesSkipped = 0;
+    uint32_t framesUnchanged = 0;
+    CRGB pushed[LED_COUNT];                 // Output bytes of the last frame, brightness applied
+
     /**
      * @brief Update individual pixel animation
      * @param pixelIndex Index of pixel to update
+     * @param currentTime Current millis() value
+     */
+    void updatePixelAnimation(uint8_t pixelIndex, unsigned long currentTime);
+
+    /**
+     * @brief Load keyframes into a pixel and start playing them
+     * @param pixelIndex Which pixel to program
+     * @param keyframes Keyframes to copy
+     * @param count Number of keyframes
+     * @param repeatCount Number of cycles (0 = forever)
+     * @param endAction What to do after the last cycle
+     */
+    void loadTimeline(uint8_t pixelIndex, const LedKeyframe* keyframes, uint8_t count,
+                      uint16_t repeatCount, LedEndAction endAction);
+
+    /**
+     * @brief Apply the end action of a finished timeline
+     * @param pixelIndex Which pixel finished
+     * @param currentTime Current millis() value
+     */
+    void finishTimeline(uint8_t pixelIndex, unsigned long currentTime);
+
+    /**
+     * @brief Color a keyframe leaves behind when it completes
+     * @param frame Keyframe to evaluate
+     * @return Final color of the keyframe
+     */
+    CRGB keyframeEndColor(const LedKeyframe& frame);
+
+    /**
+     * @brief Push the frame buffer if it is dirty and a frame slot is due
+     */
+    void renderFrame();
+
+    /**
+     * @brief Record the bytes the next show() sends
+     * @return true if they differ from the last frame pushed
      */
-    void updatePixelAnimation(uint8_t pixelIndex);
+    bool updatePushedOutput();
 
     /**
      * @brief Apply color to specific pixel with brightness scaling
@@ -125,7 +287,7 @@ private:
     void applyPixelColor(uint8_t pixelIndex, CRGB color);
 
     /**
-     * @brief Scale color by brightness factor
+     * @brief Scale color by brightness factor (fixed-point, no divides)
      * @param color Original CRGB color
      * @param brightness Brightness factor (0-255)
      * @return Scaled CRGB color
@@ -133,9 +295,9 @@ private:
     CRGB scaleColor(CRGB color, uint8_t brightness);
 
     /**
-     * @brief Calculate sine wave value for pulse animation (PRD: smooth breathing)
-     * @param phase Phase value (0-255)
-     * @return Sine wave value (0-255)
+     * @brief Look up the gamma-corrected breathing level (PRD: smooth breathing)
+     * @param phase Phase value (0-65535 = one breath)
+     * @return Brightness level (0-255)
      */
-    uint8_t sineWave(uint8_t phase);
+    uint8_t breathLevel(uint16_t phase);
 };
@@ -0,0 +1,88 @@
+#pragma once
+
+/**
+ * @file Melodies.h
+ * @brief Sound cue tables for the BuzzerController
+ *
+ * Every cue is plain data: a list of notes plus a priority. Adding a new
+ * cue means adding a SoundCue value and a row to CUE_TABLE, no new code.
+ */
+
+#include <Arduino.h>
+#include "feedback/BuzzerController.h"
+
+namespace Melodies {
+
+// Medieval-themed note frequencies (Hz), 0 = rest
+static constexpr uint16_t REST = 0;
+static constexpr uint16_t NOTE_A3 = 220;
+static constexpr uint16_t NOTE_A4 = 440;
+static constexpr uint16_t NOTE_C5 = 523;
+static constexpr uint16_t NOTE_D5 = 587;
+static constexpr uint16_t NOTE_E5 = 659;
+static constexpr uint16_t NOTE_A5 = 880;
+static constexpr uint16_t NOTE_E6 = 1319;
+
+// Cue priorities - a higher priority cue preempts a lower one
+static constexpr uint8_t PRIORITY_TICK = 0;
+static constexpr uint8_t PRIORITY_NORMAL = 1;
+static constexpr uint8_t PRIORITY_WARNING = 2;
+static constexpr uint8_t PRIORITY_ALARM = 3;
+
+// Note sequences: { frequency, duration ms, gap ms }
+static constexpr MelodyNote BOOT[] = {
+    { NOTE_A4, 150, 0 },
+    { NOTE_C5, 150, 0 }
+};
+
+static constexpr MelodyNote SUCCESS[] = {
+    { NOTE_C5, 100, 50 },
+    { NOTE_E5, 100, 0 }
+};
+
+static constexpr MelodyNote FAILURE[] = {
+    { NOTE_A3, 300, 0 }
+};
+
+static constexpr MelodyNote CONFIRM[] = {
+    { NOTE_D5, 120, 0 }
+};
+
+static constexpr MelodyNote INTERACTION[] = {
+    { NOTE_A5, 50, 0 }
+};
+
+static constexpr MelodyNote ALARM[] = {
+    { NOTE_A5, 250, 0 },
+    { NOTE_E6, 250, 0 },
+    { NOTE_A5, 250, 0 },
+    { NOTE_E6, 250, 0 },
+    { NOTE_A5, 250, 0 },
+    { NOTE_E6, 250, 0 }
+};
+
+static constexpr MelodyNote LOW_BATTERY[] = {
+    { NOTE_E5, 60, 80 },
+    { NOTE_A4, 60, 0 }
+};
+
+template <size_t N>
+constexpr Melody melody(const MelodyNote (&notes)[N], uint8_t priority) {
+    return Melody{ notes, static_cast<uint8_t>(N), priority };
+}
+
+// Indexed by SoundCue - keep in the same order as the enum
+static constexpr Melody CUE_TABLE[] = {
+    melody(BOOT, PRIORITY_NORMAL),           // SoundCue::BOOT
+    melody(SUCCESS, PRIORITY_NORMAL),        // SoundCue::SUCCESS
+    melody(FAILURE, PRIORITY_WARNING),       // SoundCue::FAILURE
+    melody(CONFIRM, PRIORITY_NORMAL),        // SoundCue::CONFIRM
+    melody(INTERACTION, PRIORITY_TICK),      // SoundCue::INTERACTION
+    melody(ALARM, PRIORITY_ALARM),           // SoundCue::ALARM
+    melody(LOW_BATTERY, PRIORITY_WARNING)    // SoundCue::LOW_BATTERY
+};
+
+static_assert(sizeof(CUE_TABLE) / sizeof(CUE_TABLE[0]) == static_cast<size_t>(SoundCue::COUNT),
+              "CUE_TABLE must have one entry per SoundCue");
+
+} // namespace Melodies
@@ -0,0 +1,96 @@
+#pragma once
+#include <Arduino.h>
+#include <FastLED.h>
+#include <atomic>
+#include <driver/rmt.h>
+
+/**
+ * @brief Non-blocking WS2812B output on the ESP32 RMT peripheral
+ *
+ * Each strand (data pin) gets its own RMT TX channel. show() encodes the
+ * current pixel colors into RMT items, starts every channel and returns
+ * immediately; the strands transmit in parallel in hardware while the CPU
+ * keeps running. Completion is reported from the RMT TX-end interrupt.
+ *
+ * Strands are registered like FastLED.addLeds(): one shared CRGB array,
+ * with an offset and pixel count per data pin.
+ */
+class Ws2812RmtDriver {
+public:
+    /**
+     * @brief Completion callback, called from interrupt context
+     * @param context User pointer given to setCompletionCallback()
+     */
+    typedef void (*CompletionCallback)(void* context);
+
+    /**
+     * @brief Register a strand on its own RMT channel
+     * @param pin GPIO driving the strand's data line
+     * @param pixels Shared pixel array
+     * @param offset Index of the strand's first pixel in the array
+     * @param count Number of pixels on the strand
+     * @return true if the RMT channel was configured, false otherwise
+     */
+    bool addStrand(uint8_t pin, const CRGB* pixels, uint8_t offset, uint8_t count);
+
+    /**
+     * @brief Start transmitting all strands (non-blocking)
+     * @param brightness Global brightness applied while encoding (0-255)
+     * @return true if a frame was started, false if the previous one is still in flight
+     */
+    bool show(uint8_t brightness);
+
+    /**
+     * @brief Check whether a frame is still being transmitted
+     * @return true while any strand is busy
+     */
+    bool isBusy() const { return busyMask.load(std::memory_order_acquire) != 0; }
+
+    /**
+     * @brief Set a callback fired once every strand of a frame has finished
+     * @param callback Function to call from interrupt context (nullptr to clear)
+     * @param context User pointer passed to the callback
+     */
+    void setCompletionCallback(CompletionCallback callback, void* context);
+
+    // Capacity limits (2 pixels x 24 bits fit in one 48-item RMT memory block)
+    static constexpr uint8_t MAX_STRANDS = 2;
+    static constexpr uint8_t MAX_PIXELS_PER_STRAND = 2;
+
+private:
+    // WS2812B bit timing in RMT ticks (80 MHz APB / 2 = 25 ns per tick)
+    static constexpr uint8_t RMT_CLOCK_DIVIDER = 2;
+    static constexpr uint16_t T0H_TICKS = 16;   // 0.40 us
+    static constexpr uint16_t T0L_TICKS = 34;   // 0.85 us
+    static constexpr uint16_t T1H_TICKS = 32;   // 0.80 us
+    static constexpr uint16_t T1L_TICKS = 18;   // 0.45 us
+    static constexpr uint8_t BITS_PER_PIXEL = 24;
+
+    struct Strand {
+        rmt_channel_t channel;
+        const CRGB* pixels;
+        uint8_t count;
+        rmt_item32_t items[MAX_PIXELS_PER_STRAND * BITS_PER_PIXEL];
+    };
+
+    Strand strands[MAX_STRANDS];
+    uint8_t strandCount = 0;
+    std::atomic<uint8_t> busyMask{0};   // Bit per strand, cleared by the TX-end ISR and on write errors
+
+    CompletionCallback completionCallback = nullptr;
+    void* completionContext = nullptr;
+
+    /**
+     * @brief Encode one strand's pixels (GRB order) into RMT items
+     * @param strand Strand to encode
+     * @param brightness Global brightness to apply
+     */
+    void encodeStrand(Strand& strand, uint8_t brightness);
+
+    /**
+     * @brief RMT TX-end interrupt hook shared by every channel
+     * @param channel Channel that finished
+     * @param arg Ws2812RmtDriver instance
+     */
+    static void IRAM_ATTR onTransmitDone(rmt_channel_t channel, void* arg);
+};
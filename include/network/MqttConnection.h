@@ -0,0 +1,333 @@
+#pragma once
+
+/**
+ * @file MqttConnection.h
+ * @brief Non-blocking MQTT 3.1.1 client connection over a BSD socket
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include "config/Settings.h"
+
+/**
+ * @class MqttConnection
+ * @brief Connects to the broker without ever blocking the caller
+ *
+ * The TCP connect, the CONNECT/CONNACK handshake and all later traffic
+ * are driven by service(), which only issues non-blocking socket calls:
+ * at most one connect or readiness check, one send and one receive per
+ * call. Outgoing packets are queued in a fixed buffer and flushed as the
+ * socket accepts them, so a slow or dead broker costs time-outs, never a
+ * stalled caller.
+ *
+ * QoS 1 publishes are pipelined: up to inflightWindow of them may await
+ * their PUBACK at once, each kept (with its packet ID) in a fixed slot
+ * until acknowledged. The caller never waits for an acknowledgement;
+ * a full window just refuses the publish. Unacknowledged publishes
+ * survive a lost connection and are retransmitted, in order and with the
+ * DUP flag, as soon as the next session is accepted.
+ *
+ * Subscriptions are QoS 0 and, as every session starts clean, must be
+ * made again after each connect. Incoming messages that fit
+ * MQTT_RX_BUFFER_SIZE are handed to the message handler from service().
+ *
+ * Failed attempts are retried with exponential backoff from retryMinMs up
+ * to retryMaxMs, each delay jittered by +/-MQTT_RETRY_JITTER percent so
+ * devices do not reconnect in lockstep after a broker restart.
+ *
+ * The broker is given as a dotted IPv4 address: a DNS lookup would block.
+ * Plain C++ over POSIX/lwIP sockets with no Arduino dependencies, so it
+ * can be exercised against stand-in brokers on the host
+ * (tools/mqtt_connect_check.cpp).
+ */
+class MqttConnection {
+public:
+    /**
+     * @brief Connection phase
+     */
+    enum class Phase : uint8_t {
+        IDLE,               // Stopped
+        WAITING,            // Backing off until the next attempt
+        TCP_CONNECTING,     // Socket connect in progress
+        MQTT_CONNECTING,    // CONNECT queued/sent, waiting for CONNACK
+        CONNECTED
+    };
+
+    /**
+     * @brief Broker and session parameters
+     *
+     * Strings are not copied and must outlive the connection.
+     */
+    struct Config {
+        const char* host;               // Dotted IPv4 address
+        uint16_t port;
+        const char* clientId;
+        const char* username;           // nullptr for none
+        const char* password;           // nullptr for none
+        const char* willTopic;          // nullptr for no last will
+        const char* willMessage;        // Retained last will payload
+        uint16_t keepAliveSeconds;
+        uint32_t connectTimeoutMs;      // TCP connect plus CONNACK
+        uint32_t retryMinMs;            // First retry delay
+        uint32_t retryMaxMs;            // Backoff cap
+        uint32_t seed;                  // Jitter seed, unique per device
+        uint8_t inflightWindow;         // QoS 1 publishes awaiting PUBACK (1 = stop-and-wait)
+    };
+
+    /**
+     * @brief Called when a QoS 1 publish is acknowledged
+     * @param context Context given to setAckHandler()
+     * @param packetId Packet ID of the acknowledged publish
+     */
+    typedef void (*AckHandler)(void* context, uint16_t packetId);
+
+    /**
+     * @brief An incoming PUBLISH, valid for the duration of the handler call
+     */
+    struct Message {
+        const char* topic;              // Not NUL-terminated
+        size_t topicLength;
+        const char* payload;
+        size_t length;
+        bool retained;                  // From the broker's retained store, not sent live
+    };
+
+    /**
+     * @brief Called for each incoming message
+     * @param context Context given to setMessageHandler()
+     * @param message The message
+     */
+    typedef void (*MessageHandler)(void* context, const Message& message);
+
+    MqttConnection() = default;
+    ~MqttConnection();
+
+    MqttConnection(const MqttConnection&) = delete;
+    MqttConnection& operator=(const MqttConnection&) = delete;
+
+    /**
+     * @brief Validate and store the configuration
+     * @param config Broker and session parameters
+     * @return false if the address is not IPv4 or the CONNECT packet does not fit
+     */
+    bool begin(const Config& config);
+
+    /**
+     * @brief Make the first attempt on the next service() call
+     * @param now Current time (ms)
+     */
+    void start(uint32_t now);
+
+    /**
+     * @brief Close the socket and stop retrying (e.g. WiFi went down)
+     */
+    void stop();
+
+    /**
+     * @brief Advance the connection; never blocks
+     * @param now Current time (ms)
+     */
+    void service(uint32_t now);
+
+    /**
+     * @brief Queue a publish
+     *
+     * A QoS 1 publish must fit MQTT_INFLIGHT_PACKET_SIZE; its packet ID is
+     * then available from getLastPacketId().
+     * @param topic Topic name
+     * @param payload Payload bytes
+     * @param length Payload length
+     * @param retain true to have the broker keep the last value
+     * @param qos 0 (fire and forget) or 1 (kept until PUBACK)
+     * @return false if not connected, the window or transmit buffer is full
+     */
+    bool publish(const char* topic, const char* payload, size_t length, bool retain, uint8_t qos = 0);
+
+    /**
+     * @brief Set the callback for PUBACKs
+     * @param handler Called from service(), nullptr for none
+     * @param context Passed to handler
+     */
+    void setAckHandler(AckHandler handler, void* context);
+
+    /**
+     * @brief Subscribe to a topic filter at QoS 0 for this session
+     * @param topic Topic filter
+     * @return false if not connected or the transmit buffer is full
+     */
+    bool subscribe(const char* topic);
+
+    /**
+     * @brief Set the callback for incoming messages
+     * @param handler Called from service(), nullptr for none
+     * @param context Passed to handler
+     */
+    void setMessageHandler(MessageHandler handler, void* context);
+
+    /**
+     * @brief Get the bytes queued but not yet taken by the socket
+     * @return 0 once everything published so far has been sent (or dropped with the session)
+     */
+    size_t getPendingBytes() const { return txLength - txSent; }
+
+    uint16_t getLastPacketId() const { return packetId; }
+    uint8_t getInFlightCount() const { return inFlightCount; }
+    uint32_t getAckedCount() const { return ackedCount; }
+    uint32_t getRetransmitCount() const { return retransmitCount; }
+
+    Phase getPhase() const { return phase; }
+    bool isConnected() const { return phase == Phase::CONNECTED; }
+
+    /**
+     * @brief Check whether the last attempt failed
+     * @return true from a failed attempt until a session is accepted
+     */
+    bool hasFailed() const { return failures > 0; }
+
+    /**
+     * @brief Check whether an established session was lost
+     * @return true from the loss until the next session is accepted
+     */
+    bool wasDropped() const { return dropped; }
+
+    /**
+     * @brief Get why the last attempt or session ended
+     * @return Static description, "" if none
+     */
+    const char* getLastError() const { return lastError; }
+
+    uint32_t getAttemptCount() const { return attempts; }
+    uint32_t getFailureCount() const { return failures; }
+    uint32_t getNextAttempt() const { return nextAttempt; }
+
+private:
+    Config config = {};
+    uint32_t address = 0;               // Network byte order
+    int socketFd = -1;
+    Phase phase = Phase::IDLE;
+
+    uint32_t attempts = 0;              // Since begin()
+    uint32_t failures = 0;              // Consecutive failed attempts
+    bool dropped = false;               // An established session was lost
+    const char* lastError = "";
+    uint32_t nextAttempt = 0;
+    uint32_t attemptStart = 0;
+    uint32_t random = 1;
+
+    uint32_t lastService = 0;           // Time of the last service() call
+    uint32_t lastSent = 0;              // For keep-alive
+    bool pingOutstanding = false;
+    uint32_t pingSentAt = 0;
+
+    uint8_t txBuffer[MQTT_TX_BUFFER_SIZE];
+    size_t txLength = 0;
+    size_t txSent = 0;
+
+    uint8_t rxBuffer[MQTT_RX_BUFFER_SIZE];
+    size_t rxLength = 0;
+    size_t rxDiscard = 0;               // Bytes left of a packet too large to buffer
+
+    // A QoS 1 publish kept for retransmission until its PUBACK
+    struct InFlight {
+        uint16_t packetId;              // 0 if the slot is free
+        uint16_t length;
+        uint32_t order;                 // Publish order, for retransmission
+        uint8_t packet[MQTT_INFLIGHT_PACKET_SIZE];
+    };
+
+    InFlight inFlight[MQTT_INFLIGHT_WINDOW] = {};
+    uint8_t inFlightCount = 0;
+    uint8_t window = MQTT_INFLIGHT_WINDOW;
+    uint16_t packetId = 0;              // Last assigned
+    uint32_t publishOrder = 0;
+    uint32_t ackedCount = 0;
+    uint32_t retransmitCount = 0;
+    AckHandler ackHandler = nullptr;
+    void* ackContext = nullptr;
+    MessageHandler messageHandler = nullptr;
+    void* messageContext = nullptr;
+
+    /**
+     * @brief Open a non-blocking socket and start the TCP connect
+     * @param now Current time (ms)
+     */
+    void openSocket(uint32_t now);
+
+    /**
+     * @brief Check whether the TCP connect finished
+     * @return 1 connected, 0 still in progress, -1 failed
+     */
+    int8_t checkConnected();
+
+    /**
+     * @brief Queue the CONNECT packet
+     * @return false if it did not fit
+     */
+    bool queueConnect();
+
+    /**
+     * @brief Send as much of the transmit buffer as the socket takes
+     * @param now Current time (ms)
+     * @return false if the connection broke
+     */
+    bool flush(uint32_t now);
+
+    /**
+     * @brief Read what is available and handle complete packets
+     * @param now Current time (ms)
+     * @return false if the connection broke or the broker refused the session
+     */
+    bool receive(uint32_t now);
+
+    /**
+     * @brief Handle one complete control packet
+     * @param packet Fixed header onwards
+     * @param length Total packet length
+     * @param now Current time (ms)
+     * @return false if the session must end
+     */
+    bool handlePacket(const uint8_t* packet, size_t length, uint32_t now);
+
+    /**
+     * @brief Acknowledge an incoming PUBLISH and hand it to the message handler
+     * @param packet Complete packet, fixed header included
+     * @param length Packet length
+     */
+    void deliver(const uint8_t* packet, size_t length);
+
+    /**
+     * @brief Queue every unacknowledged publish again, oldest first
+     */
+    void retransmit();
+
+    /**
+     * @brief Pick the next free packet ID
+     * @return Non-zero ID not used by an in-flight publish
+     */
+    uint16_t nextPacketId();
+
+    /**
+     * @brief Reserve space for a packet at the end of the transmit buffer
+     * @param length Total packet length
+     * @return Start of the reserved space, or nullptr if it does not fit
+     */
+    uint8_t* reserve(size_t length);
+
+    /**
+     * @brief End the attempt or session and schedule the next attempt
+     * @param now Current time (ms)
+     * @param reason Static description
+     */
+    void fail(uint32_t now, const char* reason);
+
+    /**
+     * @brief Close the socket and reset the buffers
+     */
+    void closeSocket();
+
+    /**
+     * @brief Backoff delay for the next attempt
+     * @return Delay (ms) including jitter
+     */
+    uint32_t retryDelay();
+};
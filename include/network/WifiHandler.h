@@ -1,10 +1,25 @@
 #pragma once
 
 #include <Arduino.h>
+#include "config/DataTypes.h"
+#include "utilities/Scheduler.h"
 
 class WifiHandler {
 public:
     WifiHandler(); // Constructor
     void begin();
     void update();
+    void registerTasks(Scheduler& scheduler);
+
+    // Battery: maximum modem sleep (keeps the association, wakes per DTIM listen interval)
+    void setPowerSave(bool batterySaving);
+
+    // Last observed connection state; changes are published as WifiStateChanged
+    WifiState getState() const { return currentState; }
+
+private:
+    WifiState currentState = WifiState::DISCONNECTED;
+
+    // Map the Arduino WiFi status onto the connection states
+    static WifiState readState();
 };
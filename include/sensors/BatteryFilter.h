@@ -0,0 +1,73 @@
+#pragma once
+
+/**
+ * @file BatteryFilter.h
+ * @brief Fixed-point median/oversampling/IIR filter for battery ADC samples
+ */
+
+#include <stdint.h>
+
+/**
+ * @class BatteryFilter
+ * @brief Turns bursts of noisy raw ADC samples into a slow, clean reading
+ *
+ * Three stages, all integer:
+ *  1. Sliding median of 5 over each burst removes spikes of up to two
+ *     samples.
+ *  2. The medians of a burst are averaged (oversampling), keeping
+ *     FRACTION_BITS of sub-LSB resolution.
+ *  3. Burst means go through a first-order IIR, y += (x - y) / 2^IIR_SHIFT,
+ *     seeded with the first burst so there is no start-up ramp.
+ *
+ * Plain C++ with no Arduino dependencies so it can be fed synthetic
+ * sample streams on the host.
+ */
+class BatteryFilter {
+public:
+    static constexpr uint8_t FRACTION_BITS = 8;
+    static constexpr uint8_t IIR_SHIFT = 2;         // Weight 1/4 per burst
+    static constexpr uint8_t MEDIAN_WINDOW = 5;
+
+    /**
+     * @brief Start collecting a new burst
+     */
+    void beginBurst();
+
+    /**
+     * @brief Add one raw sample of the current burst
+     * @param raw Raw ADC value
+     */
+    void addSample(uint16_t raw);
+
+    /**
+     * @brief Fold the burst into the filtered value
+     * @return false if the burst had too few samples and was ignored
+     */
+    bool endBurst();
+
+    /**
+     * @brief Get the filtered value
+     * @return Filtered raw ADC value, rounded
+     */
+    uint16_t getValue() const;
+
+    /**
+     * @brief Check whether at least one burst has been folded in
+     * @return true once getValue() is meaningful
+     */
+    bool isValid() const { return valid; }
+
+    /**
+     * @brief Forget all history (e.g. after a step change)
+     */
+    void reset();
+
+private:
+    uint16_t window[MEDIAN_WINDOW] = {};
+    uint8_t windowFill = 0;
+    uint32_t sum = 0;
+    uint16_t count = 0;
+
+    int32_t state = 0;              // Filtered value, FRACTION_BITS fixed point
+    bool valid = false;
+};
@@ -0,0 +1,127 @@
+#pragma once
+
+/**
+ * @file GateEnergyLog.h
+ * @brief Ring buffer of LD2410S standard-output per-gate energies
+ */
+
+#include <Arduino.h>
+#include "config/Settings.h"
+#include "sensors/Ld2410FrameParser.h"
+
+/**
+ * @class GateEnergyLog
+ * @brief Timestamped per-gate energies with rolling min/max/mean per gate
+ *
+ * Stored as a structure of arrays: one timestamp column and one uint32
+ * column per gate, so the statistics for a gate only ever touch that
+ * gate's contiguous words. Statistics cover exactly the frames
+ * currently held and are updated on every record(): the mean from a
+ * running sum, min/max by comparison with the new value. Only when the
+ * evicted value was the gate's current min or max is that gate's column
+ * rescanned.
+ *
+ * Frames are addressed by a sequence number that keeps counting across
+ * wrap-arounds; a sequence is readable while it is within the last
+ * CAPACITY frames. Not thread safe: record and read from the same task.
+ */
+class GateEnergyLog {
+public:
+    static constexpr uint16_t CAPACITY = GATE_ENERGY_LOG_SIZE;
+    static constexpr uint8_t GATE_COUNT = Ld2410Report::MAX_GATES;
+
+    static_assert(CAPACITY >= 2 && (CAPACITY & (CAPACITY - 1)) == 0,
+                  "GATE_ENERGY_LOG_SIZE must be a power of two");
+
+    /**
+     * @brief Rolling statistics for one gate over the held frames
+     */
+    struct GateStats {
+        uint32_t min;
+        uint32_t max;
+        uint32_t mean;              // Rounded to the nearest integer
+    };
+
+    /**
+     * @brief Append one standard-output report
+     * @param report Report with gate energies (standard set)
+     * @param timestamp Reception time (millis)
+     */
+    void record(const Ld2410Report& report, uint32_t timestamp);
+
+    /**
+     * @brief Drop all frames and statistics
+     */
+    void clear();
+
+    /**
+     * @brief Get the number of frames currently held
+     * @return 0 to CAPACITY
+     */
+    uint16_t getCount() const { return count; }
+
+    /**
+     * @brief Get the sequence number the next frame will receive
+     * @return Total frames recorded; keeps counting across clear()
+     */
+    uint32_t getNextSequence() const { return nextSequence; }
+
+    /**
+     * @brief Get the oldest sequence number still held
+     * @return Oldest readable sequence
+     */
+    uint32_t getFirstSequence() const { return nextSequence - count; }
+
+    /**
+     * @brief Get the timestamp of a held frame
+     * @param sequence Sequence number, getFirstSequence() <= sequence < getNextSequence()
+     * @return Reception time (millis)
+     */
+    uint32_t getTimestamp(uint32_t sequence) const { return timestamps[sequence & (CAPACITY - 1)]; }
+
+    /**
+     * @brief Get one gate's energy from a held frame
+     * @param gate Gate index
+     * @param sequence Sequence number of the frame
+     * @return Energy as reported by the radar
+     */
+    uint32_t getEnergy(uint8_t gate, uint32_t sequence) const {
+        return energy[gate][sequence & (CAPACITY - 1)];
+    }
+
+    /**
+     * @brief Get rolling statistics for one gate
+     * @param gate Gate index
+     * @param stats Receives min, max and mean
+     * @return false if the gate does not exist or the log is empty
+     */
+    bool getStats(uint8_t gate, GateStats& stats) const;
+
+private:
+    struct Accumulator {
+        uint64_t sum;
+        uint32_t min;
+        uint32_t max;
+    };
+
+    uint32_t timestamps[CAPACITY];
+    uint32_t energy[GATE_COUNT][CAPACITY];
+    Accumulator accumulators[GATE_COUNT];
+
+    uint16_t count = 0;
+    uint32_t nextSequence = 0;
+
+    /**
+     * @brief Add one gate's new value, evicting the slot's old one if full
+     * @param gate Gate index
+     * @param slot Ring slot being written
+     * @param value New energy
+     */
+    void updateGate(uint8_t gate, uint16_t slot, uint32_t value);
+
+    /**
+     * @brief Recompute min/max of one gate from its column
+     * @param gate Gate index
+     */
+    void rescanGate(uint8_t gate);
+};
@@ -0,0 +1,193 @@
+#pragma once
+
+/**
+ * @file Ld2410FrameParser.h
+ * @brief Incremental parser for LD2410S radar report and ACK frames
+ */
+
+#include <Arduino.h>
+
+/**
+ * @brief Decoded content of one radar report frame
+ */
+struct Ld2410Report {
+    static constexpr uint8_t MAX_GATES = 16;
+    static constexpr uint8_t TARGET_PRESENT = 2;    // States 0-1 = no target, 2-3 = target
+
+    uint8_t targetState;            // 0-3, see TARGET_PRESENT
+    uint16_t distance;              // Target distance in cm
+
+    // Standard output mode only
+    bool standard;
+    uint32_t gateEnergy[MAX_GATES];
+};
+
+/**
+ * @brief Decoded head of one command acknowledgement frame
+ */
+struct Ld2410Ack {
+    static constexpr uint16_t ACK_FLAG = 0x0100;    // Set in the command word of every ACK
+
+    uint16_t command;               // Command word | ACK_FLAG
+    uint16_t status;                // 0 = success
+};
+
+/**
+ * @class Ld2410FrameParser
+ * @brief Resumable byte-level state machine for LD2410S report and ACK frames
+ *
+ * The LD2410S sends one of two report formats (little endian):
+ *
+ *   Minimal output (factory default):
+ *     6E | target state | distance (2) | 62
+ *
+ *   Standard output (per-gate energies, see Ld2410sSensor):
+ *     F4 F3 F2 F1 | length (2) = 70 | 01 | target state | distance (2)
+ *     reserved (2) | 16 x gate energy (4) | F8 F7 F6 F5
+ *
+ * Both decode into the same Ld2410Report; gateEnergy is only valid when
+ * standard is set. The LD2410 / LD2410B layout (02/01 AA ... 55 00) is
+ * not understood and reads as errors.
+ *
+ * Replies to configuration commands arrive on the same stream:
+ *     FD FC FB FA | length (2) | command | 0x0100 (2) | status (2)
+ *     [command specific data] | 04 03 02 01
+ * They are not reports; the last one is kept for getAck().
+ *
+ * Bytes may arrive in chunks of any size, split anywhere. Fields are
+ * decoded as they arrive into a scratch report, so frames are never
+ * reassembled in a buffer; the scratch report only becomes visible once
+ * header, length, type and tail have all validated. On any mismatch the
+ * parser resynchronizes on the next header, re-examining the offending
+ * byte so a frame that starts right after garbage is not lost.
+ */
+class Ld2410FrameParser {
+public:
+    /**
+     * @brief Called for every valid frame, before parse() returns
+     * @param context Listener context
+     * @param report The frame just validated
+     */
+    typedef void (*FrameListener)(void* context, const Ld2410Report& report);
+
+    /**
+     * @brief Consume a chunk of received bytes
+     * @param data Received bytes
+     * @param length Number of bytes
+     * @return Number of complete, valid report frames found in this chunk
+     */
+    uint8_t parse(const uint8_t* data, size_t length);
+
+    /**
+     * @brief Get the most recent command acknowledgement
+     * @return Last ACK (all zero until the first one)
+     */
+    const Ld2410Ack& getAck() const { return ack; }
+
+    /**
+     * @brief Get the most recent valid report
+     * @return Last report (all zero until the first frame)
+     */
+    const Ld2410Report& getReport() const { return report; }
+
+    /**
+     * @brief Receive every valid frame, not just the last one of a chunk
+     * @param listener Callback, or nullptr to remove
+     * @param context Passed to the callback
+     */
+    void setFrameListener(FrameListener listener, void* context);
+
+    /**
+     * @brief Drop any partial frame and wait for the next header
+     */
+    void reset();
+
+    uint32_t getFrameCount() const { return frameCount; }
+    uint32_t getAckCount() const { return ackCount; }
+    uint32_t getErrorCount() const { return errorCount; }
+
+private:
+    static constexpr uint8_t MINIMAL_HEAD = 0x6E;
+    static constexpr uint8_t MINIMAL_TAIL = 0x62;
+    static constexpr uint8_t MINIMAL_LENGTH = 4;    // State, distance, tail
+    static constexpr uint8_t HEADER[4] = { 0xF4, 0xF3, 0xF2, 0xF1 };
+    static constexpr uint8_t TAIL[4] = { 0xF8, 0xF7, 0xF6, 0xF5 };
+    static constexpr uint8_t ACK_HEADER[4] = { 0xFD, 0xFC, 0xFB, 0xFA };
+    static constexpr uint8_t ACK_TAIL[4] = { 0x04, 0x03, 0x02, 0x01 };
+    static constexpr uint16_t ACK_MIN_LENGTH = 4;   // Command word and status
+    static constexpr uint16_t ACK_MAX_LENGTH = 32;
+    static constexpr uint8_t TYPE_STANDARD = 0x01;
+    static constexpr uint16_t STANDARD_LENGTH = 70;
+    static constexpr uint16_t GATES_START = 6;      // Payload offset of gate 0's energy
+    static constexpr uint8_t MAX_TARGET_STATE = 3;
+
+    enum class State : uint8_t {
+        HEADER,
+        MINIMAL,
+        LENGTH,
+        PAYLOAD,
+        TAIL
+    };
+
+    State state = State::HEADER;
+    const uint8_t* header = HEADER; // Header being matched, selects the frame kind
+    uint8_t matchIndex = 0;         // Bytes of header/tail/length matched so far
+    uint16_t payloadLength = 0;
+    uint16_t payloadIndex = 0;
+
+    Ld2410Report scratch = {};      // Frame being decoded
+    Ld2410Report report = {};       // Last validated frame
+    Ld2410Ack scratchAck = {};      // ACK being decoded
+    Ld2410Ack ack = {};             // Last validated ACK
+
+    FrameListener frameListener = nullptr;
+    void* listenerContext = nullptr;
+
+    uint32_t frameCount = 0;
+    uint32_t ackCount = 0;
+    uint32_t errorCount = 0;
+
+    /**
+     * @brief Feed one byte through the state machine
+     * @param byte Received byte
+     * @return true if the byte completed a valid frame
+     */
+    bool consume(uint8_t byte);
+
+    /**
+     * @brief Look for the start of a frame at this byte (HEADER state)
+     * @param byte Received byte
+     */
+    void startFrame(uint8_t byte);
+
+    /**
+     * @brief Decode one minimal-report byte at payloadIndex
+     * @param byte Report byte
+     * @return false if the byte violates the frame format
+     */
+    bool decodeMinimal(uint8_t byte);
+
+    /**
+     * @brief Decode one standard-report payload byte at payloadIndex
+     * @param byte Payload byte
+     * @return false if the byte violates the frame format
+     */
+    bool decodePayload(uint8_t byte);
+
+    /**
+     * @brief Decode one ACK payload byte at payloadIndex
+     * @param byte Payload byte
+     */
+    void decodeAck(uint8_t byte);
+
+    /**
+     * @brief Publish the scratch report as the latest valid frame
+     */
+    void completeFrame();
+
+    /**
+     * @brief Abandon the current frame and look for a header at this byte
+     * @param byte Byte that caused the error
+     */
+    void resync(uint8_t byte);
+};
@@ -6,14 +6,32 @@
  */
 
 #include <Arduino.h>
+#include <driver/uart.h>
 #include "config/DataTypes.h"
+#include "sensors/GateEnergyLog.h"
+#include "sensors/Ld2410FrameParser.h"
 
 /**
  * @class Ld2410sSensor
  * @brief Interface for LD2410S 24GHz mmWave radar sensor
  * 
- * This class wraps the LD2410 library and provides a clean interface
- * for radar-based motion and presence detection.
+ * Report frames are read straight from the ESP-IDF UART driver's RX ring
+ * buffer on UART1 and decoded by Ld2410FrameParser. The driver ISR moves
+ * bytes out of the hardware FIFO, so update() only has to run often enough
+ * that the ring buffer (RX_BUFFER_SIZE) never fills between calls.
+ *
+ * A factory-default LD2410S sends minimal reports (target state and
+ * distance); in engineering mode it is switched to standard output, which
+ * adds per-gate energies to every report, and each such frame is appended
+ * to a GateEnergyLog. The LD2410S reports one target without the LD2410's
+ * moving/stationary split or target energy, so RadarData carries it as a
+ * stationary target with energy 0 and never reports a moving target.
+ *
+ * Output mode changes are sent as the LD2410S configuration sequence
+ * (enable configuration, switch output mode, end configuration). Each
+ * command is sent only after the previous one was acknowledged; a missing
+ * or negative ACK aborts the change with an error and engineering mode
+ * keeps its last confirmed state.
  */
 class Ld2410sSensor {
 public:
@@ -29,10 +47,7 @@ public:
     bool begin();
 
     /**
-     * @brief Update radar sensor reading (non-blocking)
-     * 
-     * This method should be called regularly from the main loop
-     * to read sensor data and update detection status.
+     * @brief Decode all report frames received since the last call (non-blocking)
      */
     void update();
 
@@ -54,9 +69,98 @@ public:
      */
     bool isStationaryTargetDetected();
 
+    /**
+     * @brief Get the last decoded report, including standard-output gate energies
+     * @return Last valid report frame
+     */
+    const Ld2410Report& getReport() const { return parser.getReport(); }
+
+    /**
+     * @brief Switch the radar's engineering (per-gate energy) output on or off
+     * @param enabled true to report per-gate energies
+     */
+    void setEngineeringMode(bool enabled);
+
+    /**
+     * @brief Check whether engineering mode was requested
+     * @return true if engineering mode is on or being switched on
+     */
+    bool isEngineeringMode() const { return engineeringMode; }
+
+    /**
+     * @brief Check whether the radar acknowledged standard output
+     * @return true once the mode change to engineering mode was confirmed
+     */
+    bool isEngineeringActive() const { return engineeringActive; }
+
+    /**
+     * @brief Get the captured engineering-mode frames
+     * @return Per-gate energy log
+     */
+    const GateEnergyLog& getGateLog() const { return gateLog; }
+
+    /**
+     * @brief Get the number of valid report frames decoded since boot
+     * @return Frame count; a change means getData() holds a fresh report
+     */
+    uint32_t getFrameCount() const { return parser.getFrameCount(); }
+    uint32_t getFrameErrorCount() const { return parser.getErrorCount(); }
+
 private:
+    static constexpr uart_port_t UART_PORT = UART_NUM_1;
+    // About a second of standard-output reports (80 bytes at ~10 Hz)
+    static constexpr int RX_BUFFER_SIZE = 1024;
+    static constexpr size_t READ_CHUNK_SIZE = 64;
+
+    // LD2410S configuration commands
+    static constexpr uint16_t CMD_ENABLE_CONFIG = 0x00FF;
+    static constexpr uint16_t CMD_END_CONFIG = 0x00FE;
+    static constexpr uint16_t CMD_OUTPUT_MODE = 0x007A;   // Minimal or standard output
+    static constexpr uint8_t COMMAND_STEPS = 3;     // Enable config, output mode, end config
+    static constexpr uint32_t ACK_TIMEOUT_MS = 500;
+    static constexpr uint8_t MAX_COMMAND_VALUE = 6;   // Longest command value (output mode)
+
     RadarData sensorData;
     unsigned long lastUpdate;
-    
-    // Private helper methods will be implemented in Phase 4
+    bool uartReady = false;
+    Ld2410FrameParser parser;
+
+    GateEnergyLog gateLog;
+    bool engineeringMode = false;
+    bool engineeringActive = false;
+    uint8_t commandStep = COMMAND_STEPS;            // Next command to send, COMMAND_STEPS = idle
+    uint16_t pendingCommand = 0;                    // Command awaiting its ACK, 0 = none
+    uint32_t pendingAckCount = 0;                   // Parser ACK count when it was sent
+    unsigned long commandSentAt = 0;
+
+    /**
+     * @brief Check the last command's ACK and send the next command of a pending mode change
+     */
+    void serviceCommands();
+
+    /**
+     * @brief Send the next command of a pending mode change
+     */
+    void sendNextCommand();
+
+    /**
+     * @brief Abandon a mode change whose command was not acknowledged
+     * @param reason What went wrong, for the log
+     */
+    void abortCommands(const char* reason);
+
+    /**
+     * @brief Write one command frame to the radar
+     * @param command Command word
+     * @param value Command value bytes (may be nullptr)
+     * @param valueLength Number of value bytes
+     */
+    void sendCommand(uint16_t command, const uint8_t* value, uint8_t valueLength);
+
+    /**
+     * @brief Parser frame listener: captures standard-output frames
+     * @param context Ld2410sSensor instance
+     * @param report Frame just decoded
+     */
+    static void onFrame(void* context, const Ld2410Report& report);
 };
@@ -7,6 +7,8 @@
 
 #include <Arduino.h>
 #include "config/DataTypes.h"
+#include "utilities/Scheduler.h"
+#include "utilities/SpscQueue.h"
 
 /**
  * @class PirSensor
@@ -14,9 +16,27 @@
  * 
  * This class provides a clean interface for reading PIR sensor
  * and managing motion detection logic.
+ *
+ * The PIR output is interrupt driven: the ISR only timestamps each edge
+ * (esp_timer us) into a lock-free ring and wakes the sensor task, which
+ * applies the debounce in update(). The first edge after a quiet period
+ * is accepted immediately; further changes within DEBOUNCE_US of it are
+ * held back, and the settled level is taken once the window closes.
+ *
+ * The pin interrupt is level-triggered and flipped to the opposite level
+ * on every edge, which both captures edges and lets the PIR wake the SoC
+ * from light sleep.
  */
 class PirSensor {
 public:
+    /**
+     * @brief Called for every captured edge before debouncing (sensor task)
+     * @param context Listener context
+     * @param level Pin level after the edge
+     * @param micros esp_timer time (low 32 bits) of the edge
+     */
+    typedef void (*RawEdgeListener)(void* context, bool level, uint32_t micros);
+
     /**
      * @brief Constructor
      */
@@ -29,13 +49,38 @@ public:
     bool begin();
 
     /**
-     * @brief Update PIR sensor reading (non-blocking)
-     * 
-     * This method should be called regularly from the main loop
-     * to read sensor state and update motion detection.
+     * @brief Install the edge interrupt (call from the task that runs update())
+     * @param scheduler Scheduler woken on every edge
+     */
+    void enableInterrupt(Scheduler& scheduler);
+
+    /**
+     * @brief Observe raw edges, e.g. for trace recording
+     * @param listener Callback, or nullptr to remove
+     * @param context Passed to the callback
+     */
+    void setRawEdgeListener(RawEdgeListener listener, void* context);
+
+    /**
+     * @brief Debounce the captured edges and update motion state (non-blocking)
+     *
+     * Called from the sensor task whenever getNextDeadline() says so.
      */
     void update();
 
+    /**
+     * @brief Query when update() next has work to do
+     * @param deadline Set to the millis() value update() is due
+     * @return true if edges are queued or a debounce window is pending
+     */
+    bool getNextDeadline(unsigned long& deadline) const;
+
+    /**
+     * @brief Get the ISR timestamp of the last accepted edge
+     * @return esp_timer time (low 32 bits, us) of the edge behind the current state
+     */
+    uint32_t getLastEdgeMicros() const { return acceptedMicros; }
+
     /**
      * @brief Get current PIR sensor data
      * @return PIR sensor data structure
@@ -49,9 +94,50 @@ public:
     bool isMotionDetected();
 
 private:
+    // Time-based debounce after any accepted state change (PRD Phase 4)
+    static constexpr uint32_t DEBOUNCE_US = 200000;
+    static constexpr size_t EDGE_QUEUE_SIZE = 16;
+
+    /**
+     * @brief One captured level change
+     */
+    struct Edge {
+        uint32_t micros;        // esp_timer time (low 32 bits)
+        bool level;             // Pin level after the edge
+    };
+
     PirData sensorData;
-    bool lastState;
+    bool lastState;             // Debounced level
     unsigned long lastUpdate;
-    
-    // Private helper methods will be implemented in Phase 4
+
+    // ISR -> sensor task edge channel
+    SpscQueue<Edge, EDGE_QUEUE_SIZE> edgeQueue;
+    Scheduler* edgeListener = nullptr;
+    uint32_t droppedEdges = 0;
+    RawEdgeListener rawEdgeListener = nullptr;
+    void* rawEdgeContext = nullptr;
+
+    // Debounce state (sensor task only)
+    bool rawLevel = false;          // Latest captured level
+    uint32_t acceptedMicros = 0;    // Time of the last accepted change
+    bool settlePending = false;     // Level changed inside the debounce window
+
+    /**
+     * @brief Apply one captured edge
+     * @param edge Edge from the ISR
+     */
+    void processEdge(const Edge& edge);
+
+    /**
+     * @brief Take a new debounced level
+     * @param level New level
+     * @param micros Time the level became valid
+     */
+    void acceptLevel(bool level, uint32_t micros);
+
+    /**
+     * @brief Edge interrupt: timestamp, re-arm for the opposite level, wake the task
+     * @param arg PirSensor instance
+     */
+    static void IRAM_ATTR onEdge(void* arg);
 };
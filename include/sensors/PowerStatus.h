@@ -6,7 +6,12 @@
  */
 
 #include <Arduino.h>
+#include <driver/adc.h>
+#include <esp_adc_cal.h>
 #include "config/DataTypes.h"
+#include "config/Pins.h"
+#include "config/Settings.h"
+#include "sensors/BatteryFilter.h"
 
 /**
  * @class PowerStatus
@@ -14,6 +19,15 @@
  * 
  * This class provides power monitoring functionality including
  * battery voltage, charging status, and power source detection.
+ *
+ * The battery is sampled by the continuous (DMA) ADC driver in short
+ * bursts: update() starts a burst of BATTERY_BURST_SAMPLES conversions
+ * and returns, and collectBurst() picks the samples up from the DMA
+ * buffer once getNextDeadline() says the burst is complete. Nothing ever
+ * waits for a conversion, and the ADC (with its power-management lock) is
+ * stopped between bursts so light sleep is not held off. Samples are
+ * filtered by BatteryFilter and the result converted to mV with the eFuse
+ * calibration curve.
  */
 class PowerStatus {
 public:
@@ -29,13 +43,23 @@ public:
     bool begin();
 
     /**
-     * @brief Update power status readings (non-blocking)
-     * 
-     * This method should be called regularly from the main loop
-     * to update battery voltage and power status.
+     * @brief Read the power source and start a battery burst (non-blocking)
      */
     void update();
 
+    /**
+     * @brief Query when the running battery burst can be collected
+     * @param deadline Set to the millis() value collectBurst() is due
+     * @return true while a burst is running
+     */
+    bool getNextDeadline(unsigned long& deadline) const;
+
+    /**
+     * @brief Read the burst from the DMA buffer, stop the ADC and update the battery values
+     * @return true if the burst produced a new battery reading
+     */
+    bool collectBurst();
+
     /**
      * @brief Get current power status data
      * @return Power status data structure
@@ -61,8 +85,32 @@ public:
     uint8_t getBatteryPercentage();
 
 private:
+    // ADC1 channel n is GPIO n+1 on the ESP32-S3
+    static_assert(BATTERY_SENSE_PIN >= 1 && BATTERY_SENSE_PIN <= 10, "BATTERY_SENSE_PIN must be an ADC1 pin");
+    static constexpr adc_channel_t BATTERY_CHANNEL = static_cast<adc_channel_t>(BATTERY_SENSE_PIN - 1);
+    static constexpr uint32_t BURST_BYTES = BATTERY_BURST_SAMPLES * sizeof(adc_digi_output_data_t);
+    static constexpr unsigned long BURST_TIME = (BATTERY_BURST_SAMPLES * 1000UL) / BATTERY_SAMPLE_RATE + 10;
+    static constexpr uint32_t DEFAULT_VREF = 1100;     // mV, only used without eFuse calibration
+
     PowerData powerData;
     unsigned long lastUpdate;
-    
-    // Private helper methods will be implemented in Phase 4
+
+    esp_adc_cal_characteristics_t adcCalibration;
+    BatteryFilter batteryFilter;
+    bool adcReady = false;
+    bool burstRunning = false;
+    unsigned long burstStart = 0;
+
+    /**
+     * @brief Set up the continuous ADC driver and calibration
+     * @return true if the battery can be sampled
+     */
+    bool beginAdc();
+
+    /**
+     * @brief Convert a battery voltage to charge (single LiPo cell)
+     * @param millivolts Cell voltage
+     * @return Charge 0-100 %
+     */
+    static uint8_t voltageToPercentage(uint32_t millivolts);
 };
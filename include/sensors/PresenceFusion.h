@@ -0,0 +1,171 @@
+#pragma once
+
+/**
+ * @file PresenceFusion.h
+ * @brief Table-driven PIR + LD2410S presence fusion
+ */
+
+#include <stdint.h>
+
+/**
+ * @brief Tunable fusion parameters
+ */
+struct PresenceConfig {
+    uint32_t cooldownMs;                // PIR must be off this long before presence can clear
+    uint32_t holdMs;                    // Radar dropouts shorter than this keep presence after the cooldown
+    uint16_t movingEnergyMin;           // Moving target counts from this energy (0-100)
+    uint16_t stationaryEnergyMin;       // Stationary target counts from this energy (0-100)
+};
+
+/**
+ * @class PresenceFusion
+ * @brief Combines PIR and radar inputs into a single present/absent state
+ *
+ * Rule (PRD Phase 4): presence is triggered by PIR motion, held while the
+ * radar reports a target, and cleared once PIR has been off for the
+ * cooldown and the radar reports nothing (for longer than the hold time).
+ * The radar alone never triggers presence.
+ *
+ * Every transition is declared in TRANSITIONS, indexed by state and
+ * input, so each input costs one table lookup. Time only advances with
+ * the timestamps passed in: a running cooldown or hold timer is a single
+ * deadline, and an input at or after that deadline first applies the
+ * timeout at the deadline itself. The owner calls advance() when
+ * getDeadline() is reached, so no polling tick is involved.
+ *
+ * Only changes of the fused state are reported, through the transition
+ * listener. Timestamps are millis()-style and may wrap. Plain C++ with no
+ * Arduino dependencies so it can be driven from synthetic timelines.
+ */
+class PresenceFusion {
+public:
+    /**
+     * @brief Called whenever the fused state changes
+     * @param context Listener context
+     * @param present New fused state
+     * @param timestamp Time of the change (ms)
+     */
+    typedef void (*TransitionListener)(void* context, bool present, uint32_t timestamp);
+
+    /**
+     * @brief Constructor
+     * @param config Initial parameters
+     */
+    explicit PresenceFusion(const PresenceConfig& config);
+
+    /**
+     * @brief Set the callback for fused state changes
+     * @param listener Callback, or nullptr to remove
+     * @param context Passed to the callback
+     */
+    void setTransitionListener(TransitionListener listener, void* context);
+
+    /**
+     * @brief Replace the parameters
+     *
+     * A running timer keeps its deadline; new durations apply from the
+     * next timer start and new thresholds from the next radar report.
+     * @param config New parameters
+     */
+    void setConfig(const PresenceConfig& config);
+
+    const PresenceConfig& getConfig() const { return config; }
+
+    /**
+     * @brief Feed a debounced PIR state change
+     * @param motion New PIR state
+     * @param timestamp Time of the change (ms)
+     */
+    void setPir(bool motion, uint32_t timestamp);
+
+    /**
+     * @brief Feed a radar report; only threshold crossings become inputs
+     * @param moving Moving target reported
+     * @param movingEnergy Moving target energy
+     * @param stationary Stationary target reported
+     * @param stationaryEnergy Stationary target energy
+     * @param timestamp Time of the report (ms)
+     */
+    void setRadar(bool moving, uint16_t movingEnergy, bool stationary, uint16_t stationaryEnergy,
+                  uint32_t timestamp);
+
+    /**
+     * @brief Apply an expired timer
+     * @param timestamp Current time (ms)
+     */
+    void advance(uint32_t timestamp);
+
+    /**
+     * @brief Get the time at which advance() must next be called
+     * @param deadline Receives the deadline (ms)
+     * @return true if a timer is running, false if nothing is pending
+     */
+    bool getDeadline(uint32_t& deadline) const;
+
+    /**
+     * @brief Get the fused state
+     * @return true while someone is considered present
+     */
+    bool isPresent() const { return present; }
+
+private:
+    enum State : uint8_t {
+        IDLE,               // Absent, radar clear
+        IDLE_RADAR,         // Absent, radar target without PIR trigger
+        TRIGGERED,          // PIR on, radar clear
+        TRIGGERED_RADAR,    // PIR on, radar target
+        COOLDOWN,           // PIR off for less than the cooldown, radar clear
+        COOLDOWN_RADAR,     // PIR off for less than the cooldown, radar target
+        HELD,               // Cooldown over, held by the radar
+        HOLD_GRACE,         // Cooldown over, radar lost for less than the hold time
+        STATE_COUNT
+    };
+
+    enum Input : uint8_t {
+        PIR_ON,
+        PIR_OFF,
+        RADAR_ON,
+        RADAR_OFF,
+        TIMEOUT,
+        INPUT_COUNT
+    };
+
+    enum Timer : uint8_t {
+        KEEP,               // Leave the timer as it is
+        START_COOLDOWN,
+        START_HOLD,
+        STOP
+    };
+
+    struct Transition {
+        State next;
+        Timer timer;
+    };
+
+    static const Transition TRANSITIONS[STATE_COUNT][INPUT_COUNT];
+    static const bool PRESENT[STATE_COUNT];
+
+    PresenceConfig config;
+    State state = IDLE;
+    bool present = false;
+    bool radarActive = false;
+
+    bool timerRunning = false;
+    uint32_t timerDeadline = 0;
+
+    TransitionListener transitionListener = nullptr;
+    void* listenerContext = nullptr;
+
+    /**
+     * @brief Apply one input at a given time
+     * @param input Input to apply
+     * @param timestamp Time of the input (ms)
+     */
+    void apply(Input input, uint32_t timestamp);
+
+    /**
+     * @brief Apply the timeout first if the timer expired by this time
+     * @param timestamp Time of the next input (ms)
+     */
+    void expireTimer(uint32_t timestamp);
+};
@@ -0,0 +1,159 @@
+#pragma once
+
+/**
+ * @file SensorAggregator.h
+ * @brief Fixed-memory rolling occupancy and sensor statistics
+ */
+
+#include <stdint.h>
+#include "config/DataTypes.h"
+
+/**
+ * @class SensorAggregator
+ * @brief Folds sensor events into per-minute buckets and rolling windows
+ *
+ * Each event only updates the current minute's bucket. When a minute
+ * ends, the bucket is closed into a ring of BUCKET_COUNT buckets and
+ * added to the running totals of every window, while the bucket that just
+ * left each window is subtracted, so window sums never rescan the ring.
+ * Battery minimum/maximum cannot be subtracted, so each window rescans
+ * its buckets for them once per minute.
+ *
+ * Windows cover the last 1, 15 and 60 complete minutes. Occupancy is
+ * accrued as time: a presence interval that spans minute boundaries is
+ * split across the buckets it covers.
+ *
+ * Timestamps are millis()-style and may wrap; inputs slightly older than
+ * the current minute are counted in it. Time only advances with the
+ * timestamps passed in; the owner calls advance() at getDeadline().
+ */
+class SensorAggregator {
+public:
+    static constexpr uint32_t BUCKET_MS = 60000;
+    static constexpr uint8_t BUCKET_COUNT = 60;
+    static constexpr uint8_t WINDOW_MINUTES[SensorAggregates::WINDOW_COUNT] = {1, 15, 60};
+
+    /**
+     * @brief Start the first minute
+     * @param timestamp Current time (ms)
+     */
+    void begin(uint32_t timestamp);
+
+    /**
+     * @brief Record a fused presence change
+     * @param present New fused state
+     * @param timestamp Time of the change (ms)
+     */
+    void setPresence(bool present, uint32_t timestamp);
+
+    /**
+     * @brief Record the start of PIR motion
+     * @param timestamp Time of the edge (ms)
+     */
+    void addMotion(uint32_t timestamp);
+
+    /**
+     * @brief Record a radar report with a target
+     *
+     * The radar is polled more often than it reports, so the same report
+     * can be offered several times; only a new frame number counts.
+     * @param distanceCm Target distance
+     * @param frame Radar frame count of the report (Ld2410sSensor::getFrameCount())
+     * @param timestamp Time of the report (ms)
+     */
+    void addRadarDistance(uint16_t distanceCm, uint32_t frame, uint32_t timestamp);
+
+    /**
+     * @brief Record a battery measurement
+     * @param millivolts Battery voltage
+     * @param timestamp Time of the measurement (ms)
+     */
+    void addBatteryReading(uint16_t millivolts, uint32_t timestamp);
+
+    /**
+     * @brief Close every minute that has ended by this time
+     * @param timestamp Current time (ms)
+     * @return true if a minute was closed since the last call (here or by an input)
+     */
+    bool advance(uint32_t timestamp);
+
+    /**
+     * @brief Get the time the current minute ends
+     * @return Deadline for the next advance() (ms)
+     */
+    uint32_t getDeadline() const { return bucketStart + BUCKET_MS; }
+
+    /**
+     * @brief Get the windows as of the last closed minute
+     * @param aggregates Receives all windows
+     */
+    void getAggregates(SensorAggregates& aggregates) const;
+
+private:
+    struct Bucket {
+        uint32_t occupiedMs;
+        uint16_t motionCount;
+        uint16_t presenceCount;
+        uint16_t distanceHistogram[AggregateWindow::DISTANCE_BINS];
+        uint16_t batteryMinMv;
+        uint16_t batteryMaxMv;
+        uint32_t batterySumMv;
+        uint16_t batteryCount;
+    };
+
+    // Running sums of the buckets inside one window
+    struct WindowTotals {
+        uint32_t occupiedMs;
+        uint32_t motionCount;
+        uint32_t presenceCount;
+        uint32_t distanceHistogram[AggregateWindow::DISTANCE_BINS];
+        uint32_t batterySumMv;
+        uint32_t batteryCount;
+        uint16_t batteryMinMv;
+        uint16_t batteryMaxMv;
+    };
+
+    Bucket buckets[BUCKET_COUNT] = {};      // Closed minutes, ring
+    uint8_t newestBucket = BUCKET_COUNT - 1;
+    uint8_t closedCount = 0;                // Valid buckets in the ring
+    WindowTotals totals[SensorAggregates::WINDOW_COUNT] = {};
+
+    Bucket current = {};
+    uint32_t bucketStart = 0;
+
+    bool present = false;
+    uint32_t accruedUntil = 0;              // Occupancy counted up to here
+    bool radarFrameSeen = false;
+    uint32_t lastRadarFrame = 0;            // Frame of the last distance counted
+    bool windowsChanged = false;            // A minute closed since the last advance()
+
+    /**
+     * @brief Close minutes up to this time, then bring occupancy up to it
+     * @param timestamp Input time (ms)
+     */
+    void catchUp(uint32_t timestamp);
+
+    /**
+     * @brief Add occupied time from accruedUntil to timestamp to the current minute
+     * @param timestamp End of the interval (ms)
+     */
+    void accrue(uint32_t timestamp);
+
+    /**
+     * @brief Move the current minute into the ring and update the windows
+     */
+    void closeBucket();
+
+    /**
+     * @brief Recompute a window's battery minimum/maximum from its buckets
+     * @param window Window index
+     */
+    void rescanBattery(uint8_t window);
+
+    /**
+     * @brief Get the ring bucket a given number of minutes back
+     * @param age 0 for the newest closed bucket
+     * @return Bucket
+     */
+    const Bucket& bucketAt(uint8_t age) const;
+};
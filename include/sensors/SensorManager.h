@@ -9,7 +9,14 @@
 #include "sensors/PirSensor.h"
 #include "sensors/Ld2410sSensor.h"
 #include "sensors/PowerStatus.h"
+#include "sensors/PresenceFusion.h"
+#include "sensors/SensorAggregator.h"
 #include "config/DataTypes.h"
+#include "utilities/Scheduler.h"
+#include "utilities/Seqlock.h"
+#include "utilities/SpscQueue.h"
+#include "utilities/TraceRecorder.h"
+#include "config/Settings.h"
 
 /**
  * @class SensorManager
@@ -17,6 +24,41 @@
  * 
  * This class manages all sensors and provides a unified interface
  * for sensor data collection and processing.
+ *
+ * State changes are published as SensorEvents on a lock-free SPSC queue;
+ * the sensor task is the only producer and the network task the only
+ * consumer.
+ *
+ * PIR edges are captured by PirSensor's interrupt and debounced as soon
+ * as they arrive. The LD2410S interrupt line is armed for the level
+ * opposite to its current one, so any edge wakes the chip from light
+ * sleep and polls the radar immediately instead of at the next 250 ms
+ * tick.
+ *
+ * PIR and radar changes are fed to a PresenceFusion engine as they are
+ * observed; its cooldown/hold timer is a deadline task, and each change
+ * of fused presence is published as a PRESENCE event. Fused presence,
+ * power source and presence setting changes are also pushed on the
+ * EventBus for the other managers.
+ *
+ * When trace recording is enabled, raw PIR edges, debounced PIR changes,
+ * changed radar reports and changed power samples are recorded with the
+ * same timestamps the fusion engine sees, for replay on the host.
+ *
+ * Readings are published as seqlock snapshots (PIR, radar, power and the
+ * combined SensorData) after every sensor update that changes them. Any
+ * lower-priority task can read them without a mutex and skip data whose
+ * generation has not moved.
+ *
+ * PIR motion starts, fused presence, radar distances and battery readings
+ * are also folded into rolling 1 min / 15 min / 1 h aggregates. Each
+ * closed minute is published as a snapshot and wakes the event listener,
+ * so the aggregates can replace the raw event stream.
+ *
+ * Radar engineering mode and gate log streaming are requested from other
+ * tasks and carried out by the sensor task. The log is streamed in small
+ * batches between the other sensor tasks, and only as fast as Serial can
+ * take it, so presence reporting never waits for the stream.
  */
 class SensorManager {
 public:
@@ -40,26 +82,98 @@ public:
     void update();
 
     /**
-     * @brief Get PIR sensor data
-     * @return Current PIR sensor data structure
+     * @brief Register sensor tasks and arm the sensor wake interrupts
+     *
+     * PIR is handled per edge, radar every 250 ms and on its interrupt,
+     * power every 5 s. Must be called from the task that runs the scheduler.
+     * @param scheduler Scheduler to register with
      */
-    PirData getPirData();
+    void registerTasks(Scheduler& scheduler);
 
     /**
-     * @brief Get radar sensor data
-     * @return Current radar sensor data structure
+     * @brief Set the scheduler to wake whenever a new event is queued
+     * @param scheduler Consumer's scheduler
      */
-    RadarData getRadarData();
+    void setEventListener(Scheduler& scheduler);
 
     /**
-     * @brief Get power status data
-     * @return Current power status data structure
+     * @brief Take the oldest pending sensor event (consumer task only)
+     * @param event Receives the event
+     * @return true if an event was returned, false if none are pending
      */
-    PowerData getPowerData();
+    bool popEvent(SensorEvent& event);
 
     /**
-     * @brief Check if any motion is detected
-     * @return true if motion detected by any sensor, false otherwise
+     * @brief Check whether sensor events are waiting
+     * @return true if popEvent() would return an event
+     */
+    bool hasPendingEvents() const;
+
+    /**
+     * @brief Replace the presence fusion parameters (any task)
+     * @param config New cooldown, hold and radar energy thresholds
+     */
+    void setPresenceConfig(const PresenceConfig& config);
+
+    /**
+     * @brief Get the presence fusion parameters (any task)
+     * @param config Receives the current parameters
+     */
+    void getPresenceConfig(PresenceConfig& config);
+
+    /**
+     * @brief Ask the sensor task to switch radar engineering mode (any task)
+     * @param enabled true to capture per-gate energies
+     */
+    void requestEngineeringMode(bool enabled);
+
+    /**
+     * @brief Ask the sensor task to stream gate statistics and the gate log to Serial (any task)
+     */
+    void requestGateStream();
+
+    /**
+     * @brief Get the sensor trace recorder
+     *
+     * Recording is started/stopped from any task; flush() and dump() must
+     * run in one low-priority task.
+     * @return Trace recorder
+     */
+    TraceRecorder& getTraceRecorder() { return traceRecorder; }
+
+    /**
+     * @brief Get the PIR snapshot (read from any lower-priority task)
+     * @return Seqlock holding the latest PIR data
+     */
+    const Seqlock<PirData>& getPirSnapshot() const { return pirSnapshot; }
+
+    /**
+     * @brief Get the radar snapshot (read from any lower-priority task)
+     * @return Seqlock holding the latest radar data
+     */
+    const Seqlock<RadarData>& getRadarSnapshot() const { return radarSnapshot; }
+
+    /**
+     * @brief Get the power snapshot (read from any lower-priority task)
+     * @return Seqlock holding the latest power status
+     */
+    const Seqlock<PowerData>& getPowerSnapshot() const { return powerSnapshot; }
+
+    /**
+     * @brief Get the combined snapshot handed to MqttHandler (read from any lower-priority task)
+     * @return Seqlock holding the latest SensorData
+     */
+    const Seqlock<SensorData>& getSensorSnapshot() const { return sensorSnapshot; }
+
+    /**
+     * @brief Get the rolling aggregates, updated once per minute (read from any lower-priority task)
+     * @return Seqlock holding the latest SensorAggregates
+     */
+    const Seqlock<SensorAggregates>& getAggregateSnapshot() const { return aggregateSnapshot; }
+
+    /**
+     * @brief Check the fused presence state
+     * @return true while PIR/radar fusion considers someone present
      */
     bool isMotionDetected();
 
@@ -68,6 +182,168 @@ private:
     Ld2410sSensor radarSensor;
     PowerStatus powerStatus;
     unsigned long lastUpdate;
-    
-    // Private helper methods will be implemented in Phase 4
+
+    // Sensor task -> network task event channel
+    SpscQueue<SensorEvent, SENSOR_EVENT_QUEUE_SIZE> eventQueue;
+    Scheduler* eventListener = nullptr;
+
+    // Last published states, used to detect changes
+    bool lastPirMotion = false;
+    bool lastRadarPresence = false;
+    bool lastUsbPower = false;
+    bool lastCharging = false;
+
+    // PIR + radar fusion (sensor task); parameters handed over under configLock
+    PresenceFusion presenceFusion;
+    portMUX_TYPE configLock = portMUX_INITIALIZER_UNLOCKED;
+    PresenceConfig presenceConfig;
+    bool configPending = false;
+
+    // Radar wake interrupt (LD2410S)
+    Scheduler* taskScheduler = nullptr;
+    volatile bool wakePending = false;
+    volatile uint32_t wakeMicros = 0;       // Edge time of the pending wake-up
+    uint32_t currentTrigger = 0;            // Attached to events published while handling it
+
+    // Snapshots for other tasks, written by the sensor task only
+    Seqlock<PirData> pirSnapshot;
+    Seqlock<RadarData> radarSnapshot;
+    Seqlock<PowerData> powerSnapshot;
+    Seqlock<SensorData> sensorSnapshot;
+
+    // Rolling statistics (sensor task)
+    SensorAggregator aggregator;
+    Seqlock<SensorAggregates> aggregateSnapshot;
+
+    // Sensor trace (sensor task); last recorded samples to skip repeats
+    TraceRecorder traceRecorder;
+    RadarData tracedRadar = {};
+    PowerData tracedPower = {};
+
+    // Engineering mode / gate log requests from other tasks
+    volatile int8_t engineeringRequest = -1;    // -1 none, 0 off, 1 on
+    volatile bool gateStreamRequested = false;
+
+    // Gate log stream in progress (sensor task)
+    bool gateStreaming = false;
+    bool streamHeaderPending = false;       // Header line not written yet
+    uint8_t streamGate = 0;                 // Next statistics line
+    uint32_t streamSequence = 0;            // Next frame
+    uint32_t streamEnd = 0;                 // Frames recorded when the stream was requested
+    unsigned long lastStreamRun = 0;
+
+    /**
+     * @brief Install the GPIO interrupt on the radar wake pin
+     */
+    void enableWakeInterrupts();
+
+    /**
+     * @brief Re-arm the radar wake pin for the level opposite to its current one
+     */
+    void armWakeInterrupts();
+
+    /**
+     * @brief Poll the radar after a wake interrupt, then re-arm
+     */
+    void handleWakeInterrupt();
+
+    /**
+     * @brief Radar wake pin GPIO interrupt
+     * @param arg SensorManager instance
+     */
+    static void IRAM_ATTR onWakeInterrupt(void* arg);
+
+    /**
+     * @brief Record a radar report if it differs from the last recorded one
+     * @param radar Decoded radar data
+     * @param timestamp Observation time (ms)
+     */
+    void traceRadar(const RadarData& radar, uint32_t timestamp);
+
+    /**
+     * @brief Record a power sample if it differs from the last recorded one
+     * @param power Power status
+     * @param timestamp Observation time (ms)
+     */
+    void tracePower(const PowerData& power, uint32_t timestamp);
+
+    /**
+     * @brief PIR raw edge listener: records the edge
+     * @param context SensorManager instance
+     * @param level Pin level after the edge
+     * @param micros esp_timer time (low 32 bits) of the edge
+     */
+    static void onRawPirEdge(void* context, bool level, uint32_t micros);
+
+    /**
+     * @brief Apply new fusion parameters and any expired fusion timer
+     */
+    void updatePresence();
+
+    /**
+     * @brief Fusion transition listener: publishes a PRESENCE event
+     * @param context SensorManager instance
+     * @param present New fused state
+     * @param timestamp Time of the change (ms)
+     */
+    static void onPresenceChange(void* context, bool present, uint32_t timestamp);
+
+    /**
+     * @brief Apply pending engineering mode / stream requests, then stream a batch
+     */
+    void updateGateStream();
+
+    /**
+     * @brief Write the next stream line to Serial if it fits without blocking
+     *
+     * Lines are the header, one statistics line per gate, one CSV line per
+     * frame and the end marker. Clears gateStreaming after the last line.
+     * @return true if a line was written, false if Serial is busy
+     */
+    bool streamNextLine();
+
+    /**
+     * @brief Report when the gate stream task needs to run
+     * @param deadline Receives the next run time
+     * @return true if there is work pending
+     */
+    bool getGateStreamDeadline(unsigned long& deadline) const;
+
+    /**
+     * @brief Queue a state change and wake the consumer
+     * @param type Kind of change
+     * @param active New state
+     * @param value Type-specific detail
+     */
+    void publishEvent(SensorEventType type, bool active, uint16_t value);
+
+    /**
+     * @brief Collect the battery burst and feed the reading to the aggregates
+     */
+    void updateBattery();
+
+    /**
+     * @brief Close finished aggregation minutes and publish the windows
+     */
+    void updateAggregates();
+
+    /**
+     * @brief Publish the sensors' current data to the snapshots that changed
+     */
+    void publishSnapshots();
+
+    /**
+     * @brief Debounce captured PIR edges and queue any motion change
+     */
+    void updatePirSensor();
+
+    /**
+     * @brief Poll the radar and queue any presence change
+     */
+    void updateRadarSensor();
+
+    /**
+     * @brief Poll power status and queue any power source change
+     */
+    void updatePowerStatus();
 };
@@ -7,6 +7,7 @@
 
 #include <Arduino.h>
 #include "feedback/FeedbackManager.h"
+#include "utilities/Scheduler.h"
 
 /**
  * @class DeviceManager
@@ -36,6 +37,12 @@ public:
      */
     void update();
 
+    /**
+     * @brief Register the factory reset button polling task
+     * @param scheduler Scheduler to register with
+     */
+    void registerTasks(Scheduler& scheduler);
+
     /**
      * @brief Check if factory reset is in progress
      * @return true if factory reset is active, false otherwise
@@ -0,0 +1,178 @@
+#pragma once
+
+/**
+ * @file EventBus.h
+ * @brief Typed, statically allocated publish/subscribe between managers
+ */
+
+#include <Arduino.h>
+#include <atomic>
+#include <type_traits>
+#include "config/DataTypes.h"
+
+/**
+ * @class TypedEventBus
+ * @brief Synchronous publish/subscribe over a fixed list of event types
+ *
+ * Every event type gets its own channel: a fixed array of (function
+ * pointer, context) subscribers plus statistics, all in static storage.
+ * Publishing or subscribing to a type that is not in the list fails to
+ * compile; there is no heap, no std::function and no type erasure.
+ *
+ * publish() calls the subscribers in the publishing task, in subscription
+ * order. Handlers must therefore be short and safe to call from any task
+ * that publishes the type - typically they copy the event into their own
+ * state and notify() their scheduler. Subscribe during boot, before the
+ * producers start; the subscriber count is published with release
+ * ordering, so a concurrent publish sees either the old or the new list.
+ *
+ * Per type, the bus counts published events and measures dispatch time
+ * (from publish() to the last handler returning).
+ *
+ * @tparam Events Event types carried by the bus; each needs a NAME string
+ */
+template <typename... Events>
+class TypedEventBus {
+public:
+    static constexpr uint8_t MAX_SUBSCRIBERS = 4;
+
+    /**
+     * @brief Event handler
+     * @param context User pointer given at subscription
+     * @param event Published event (valid for the duration of the call)
+     */
+    template <typename Event>
+    using Handler = void (*)(void* context, const Event& event);
+
+    /**
+     * @brief Dispatch statistics for one event type
+     */
+    struct Stats {
+        const char* name;
+        uint8_t subscribers;
+        uint32_t published;
+        uint32_t lastDispatchUs;
+        uint32_t maxDispatchUs;
+        uint32_t totalDispatchUs;   // Sum over all dispatches, for the mean
+    };
+
+    /**
+     * @brief Add a handler for an event type
+     * @param handler Function called for each published event
+     * @param context User pointer passed to the handler
+     * @return true if added, false if the type already has MAX_SUBSCRIBERS
+     */
+    template <typename Event>
+    static bool subscribe(Handler<Event> handler, void* context) {
+        static_assert(isCarried<Event>(), "Event type is not carried by this bus");
+        Channel<Event>& channel = channelFor<Event>();
+
+        portENTER_CRITICAL(&channel.lock);
+        const uint8_t count = channel.count.load(std::memory_order_relaxed);
+        const bool added = count < MAX_SUBSCRIBERS;
+        if (added) {
+            channel.subscribers[count] = {handler, context};
+            channel.count.store(count + 1, std::memory_order_release);
+        }
+        portEXIT_CRITICAL(&channel.lock);
+        return added;
+    }
+
+    /**
+     * @brief Deliver an event to every subscriber of its type (any task)
+     * @param event Event to deliver
+     */
+    template <typename Event>
+    static void publish(const Event& event) {
+        static_assert(isCarried<Event>(), "Event type is not carried by this bus");
+        Channel<Event>& channel = channelFor<Event>();
+
+        const int64_t start = esp_timer_get_time();
+        const uint8_t count = channel.count.load(std::memory_order_acquire);
+        for (uint8_t i = 0; i < count; i++) {
+            channel.subscribers[i].handler(channel.subscribers[i].context, event);
+        }
+        const uint32_t elapsed = static_cast<uint32_t>(esp_timer_get_time() - start);
+
+        portENTER_CRITICAL(&channel.lock);
+        channel.published++;
+        channel.lastDispatchUs = elapsed;
+        channel.totalDispatchUs += elapsed;
+        if (elapsed > channel.maxDispatchUs) {
+            channel.maxDispatchUs = elapsed;
+        }
+        portEXIT_CRITICAL(&channel.lock);
+    }
+
+    /**
+     * @brief Get the dispatch statistics of an event type
+     * @param stats Receives a consistent copy
+     */
+    template <typename Event>
+    static void getStats(Stats& stats) {
+        static_assert(isCarried<Event>(), "Event type is not carried by this bus");
+        Channel<Event>& channel = channelFor<Event>();
+
+        portENTER_CRITICAL(&channel.lock);
+        stats.name = Event::NAME;
+        stats.subscribers = channel.count.load(std::memory_order_relaxed);
+        stats.published = channel.published;
+        stats.lastDispatchUs = channel.lastDispatchUs;
+        stats.maxDispatchUs = channel.maxDispatchUs;
+        stats.totalDispatchUs = channel.totalDispatchUs;
+        portEXIT_CRITICAL(&channel.lock);
+    }
+
+    /**
+     * @brief Print the statistics of every event type to Serial
+     */
+    static void printStats() {
+        (printStatsFor<Events>(), ...);
+    }
+
+private:
+    template <typename Event>
+    struct Subscriber {
+        Handler<Event> handler;
+        void* context;
+    };
+
+    template <typename Event>
+    struct Channel {
+        Subscriber<Event> subscribers[MAX_SUBSCRIBERS] = {};
+        std::atomic<uint8_t> count{0};
+        portMUX_TYPE lock = portMUX_INITIALIZER_UNLOCKED;    // Subscription and statistics
+        uint32_t published = 0;
+        uint32_t lastDispatchUs = 0;
+        uint32_t maxDispatchUs = 0;
+        uint32_t totalDispatchUs = 0;
+    };
+
+    template <typename Event>
+    static constexpr bool isCarried() {
+        return (std::is_same<Event, Events>::value || ...);
+    }
+
+    template <typename Event>
+    static Channel<Event>& channelFor() {
+        // Constant-initialized, so no guard or constructor runs at first use
+        static Channel<Event> channel;
+        return channel;
+    }
+
+    template <typename Event>
+    static void printStatsFor() {
+        Stats stats;
+        getStats<Event>(stats);
+        Serial.printf("[BUS] %-10s subs=%u events=%u dispatch=%u/%u/%uus (last/mean/max)\n",
+                      stats.name, stats.subscribers, stats.published, stats.lastDispatchUs,
+                      stats.published > 0 ? stats.totalDispatchUs / stats.published : 0,
+                      stats.maxDispatchUs);
+    }
+};
+
+/**
+ * @brief The application's event bus
+ */
+using EventBus = TypedEventBus<PresenceChanged, PowerSourceChanged, WifiStateChanged, SettingChanged,
+                               SettingRequested>;
@@ -0,0 +1,203 @@
+#pragma once
+
+/**
+ * @file EventJournal.h
+ * @brief Flash-backed store-and-forward queue for state-change events
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include "config/Settings.h"
+
+/**
+ * @brief One queued event as handed back for sending
+ */
+struct JournalEvent {
+    uint32_t sequence;              // Increasing while queued; restarts at 1 after a reboot with an empty journal
+    uint32_t timestamp;             // millis() when the change was observed
+    uint8_t type;                   // SensorEventType
+    bool active;
+    uint16_t value;
+    bool previousBoot;              // timestamp belongs to an earlier boot
+};
+
+/**
+ * @class JournalStorage
+ * @brief Segment files behind EventJournal
+ *
+ * The firmware implements this on LittleFS (JournalStorage.cpp); host
+ * tools link their own definition, e.g. an in-memory fake filesystem.
+ */
+class JournalStorage {
+public:
+    bool begin();
+    size_t size(uint8_t segment);
+    bool read(uint8_t segment, size_t offset, void* data, size_t length);
+    bool append(uint8_t segment, const void* data, size_t length);
+    bool erase(uint8_t segment);
+};
+
+/**
+ * @class EventJournal
+ * @brief Bounded, append-only ring log of events that could not be sent
+ *
+ * Events are fixed-size records with a CRC, appended to a ring of
+ * EVENT_JOURNAL_SEGMENT_COUNT files of EVENT_JOURNAL_SEGMENT_RECORDS
+ * records each. Flash is only written while events cannot be sent, and
+ * only by appending: progress through the queue is persisted as an ACK
+ * record every EVENT_DRAIN_COMMIT acknowledged events, a segment is erased
+ * once fully acknowledged, and everything is erased when the queue
+ * empties. When the ring is full the oldest segment is dropped and its
+ * unsent events are counted.
+ *
+ * Replay is stop-and-wait: drain() hands out one event and the next only
+ * follows once the caller reports the broker's acknowledgement (PUBACK)
+ * through acknowledge(). An event handed to the connection but not yet
+ * acknowledged therefore stays queued, in flash, across a reboot.
+ *
+ * After a reboot the queue resumes after the last ACK, so up to
+ * EVENT_DRAIN_COMMIT events may be sent twice but none are lost; torn
+ * records from a power cut fail their CRC and end their segment.
+ * Timestamps from an earlier boot are flagged as such. Sequence numbers
+ * are recovered from the files, so they only restart once the journal
+ * has emptied.
+ *
+ * Not thread safe: used by the network task only.
+ */
+class EventJournal {
+public:
+    static constexpr size_t RECORD_SIZE = 16;
+
+    /**
+     * @brief Send callback for drain()
+     * @param context Caller context
+     * @param event Oldest queued event
+     * @return true if the event was handed to the broker connection
+     */
+    typedef bool (*Sender)(void* context, const JournalEvent& event);
+
+    /**
+     * @brief Open the storage and recover events queued before a reboot
+     * @return false if the storage is unusable (events are then dropped)
+     */
+    bool begin();
+
+    /**
+     * @brief Queue an event behind any already queued
+     * @param type Event type
+     * @param active New state
+     * @param value Type-specific detail
+     * @param timestamp millis() when the change was observed
+     * @return false if it could not be stored (counted as dropped)
+     */
+    bool push(uint8_t type, bool active, uint16_t value, uint32_t timestamp);
+
+    /**
+     * @brief Send the oldest event if the rate limit allows
+     *
+     * At most one event per EVENT_DRAIN_INTERVAL, so a backlog does not
+     * flood the broker after a reconnect, and none while the last one sent
+     * awaits acknowledge(). The event stays queued until then.
+     * @param now Current time (ms)
+     * @param send Called with the oldest event
+     * @param context Passed to send
+     * @return true if an event was handed to send
+     */
+    bool drain(uint32_t now, Sender send, void* context);
+
+    /**
+     * @brief Remove the event last sent by drain(): the broker has it
+     *
+     * Ignored if no event is awaiting acknowledgement, e.g. when it was
+     * dropped with a full ring in the meantime.
+     */
+    void acknowledge();
+
+    /**
+     * @brief Check whether an event sent by drain() awaits acknowledge()
+     * @return true while the broker's acknowledgement is outstanding
+     */
+    bool isAwaitingAck() const { return sentSequence != 0; }
+
+    uint32_t getDepth() const { return depth; }
+    uint32_t getDroppedCount() const { return droppedCount; }
+    bool isEmpty() const { return depth == 0; }
+
+private:
+    struct Segment {
+        uint16_t records;           // Valid records in the file
+        uint16_t pending;           // Of which events not yet sent
+    };
+
+    JournalStorage storage;
+    bool ready = false;
+    Segment segments[EVENT_JOURNAL_SEGMENT_COUNT] = {};
+    uint8_t tail = 0;               // Segment being appended to
+    bool tailBroken = false;        // Last append failed part-way
+    uint8_t readSegment = 0;        // Read position: oldest unsent event at or after it
+    uint16_t readIndex = 0;
+
+    uint32_t lastSequence = 0;
+    uint32_t ackedSequence = 0;     // Events up to here are acknowledged
+    uint32_t sentSequence = 0;      // Sent by drain(), awaiting acknowledge(); 0 if none
+    uint16_t unackedCount = 0;      // Sent since the last ACK record
+    uint16_t session = 0;           // Boot number stamped into records
+
+    uint32_t depth = 0;
+    uint32_t droppedCount = 0;
+    uint32_t nextDrain = 0;
+
+    /**
+     * @brief Rebuild the ring and read position from the files
+     */
+    void recover();
+
+    /**
+     * @brief Find the oldest unsent event
+     * @param event Receives the event
+     * @return false if the queue is empty or unreadable
+     */
+    bool peek(JournalEvent& event);
+
+    /**
+     * @brief Remove the event returned by peek()
+     * @param sequence Its sequence number
+     */
+    void pop(uint32_t sequence);
+
+    /**
+     * @brief Append a record to the tail segment, moving on when it is full
+     * @param record Encoded record
+     * @return true if written
+     */
+    bool append(const uint8_t* record);
+
+    /**
+     * @brief Make the next segment the tail, dropping it first if in use
+     */
+    void startSegment();
+
+    /**
+     * @brief Delete every segment file and start over at segment 0
+     */
+    void clear();
+
+    /**
+     * @brief Delete a segment file and forget its records
+     * @param segment Segment index
+     */
+    void eraseSegment(uint8_t segment);
+
+    /**
+     * @brief Encode a record with its CRC
+     */
+    void encode(uint8_t* record, uint32_t sequence, uint32_t timestamp,
+                uint8_t type, bool active, uint16_t value) const;
+
+    /**
+     * @brief Check a record's CRC
+     * @param record Encoded record
+     * @return true if intact
+     */
+    static bool isValid(const uint8_t* record);
+};
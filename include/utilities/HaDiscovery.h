@@ -0,0 +1,77 @@
+#pragma once
+
+/**
+ * @file HaDiscovery.h
+ * @brief Home Assistant MQTT discovery messages, built once into one blob
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include "config/Settings.h"
+#include "utilities/MqttTopics.h"
+
+/**
+ * @class HaDiscovery
+ * @brief The device's discovery config topics and payloads, plus their hash
+ *
+ * build() serializes every entity's config (PRD Phase 5: presence,
+ * charging, power, CPU temperature and free heap sensors, brightness and
+ * stealth controls) into a fixed blob of NUL-terminated topic/payload
+ * pairs. Payloads use Home Assistant's abbreviated keys to stay small.
+ *
+ * The FNV-1a hash of the blob covers the firmware version, the device id
+ * and the entity set, so comparing it with the hash of the last set the
+ * broker retained tells whether anything needs resending. Plain C++ with
+ * no Arduino dependencies.
+ */
+class HaDiscovery {
+public:
+    static constexpr uint8_t ENTITY_COUNT = 7;
+
+    /**
+     * @brief Serialize every config message into the blob
+     * @param topics Device topics (state and command topics, device id)
+     * @param prefix Discovery prefix, e.g. "homeassistant"
+     * @param deviceName Device name shown in Home Assistant
+     * @param firmwareVersion Firmware version shown in Home Assistant
+     * @return false if the blob is too small (HA_DISCOVERY_BLOB_SIZE)
+     */
+    bool build(const MqttTopics& topics, const char* prefix, const char* deviceName, const char* firmwareVersion);
+
+    const char* getTopic(uint8_t entity) const { return blob + topicOffsets[entity]; }
+    const char* getPayload(uint8_t entity) const { return blob + payloadOffsets[entity]; }
+    size_t getPayloadLength(uint8_t entity) const { return payloadLengths[entity]; }
+
+    /**
+     * @brief Get the hash of the whole set
+     * @return FNV-1a of the blob, 0 before a successful build()
+     */
+    uint32_t getHash() const { return hash; }
+
+    /**
+     * @brief Get the bytes used in the blob
+     * @return Topics and payloads, terminators included
+     */
+    size_t getSize() const { return used; }
+
+private:
+    struct Entity {
+        const char* component;          // Home Assistant platform
+        const char* object;             // Object id, also the unique id suffix
+        const char* name;
+        const char* deviceClass;        // nullptr for none
+        MqttTopics::Topic state;
+        MqttTopics::Topic command;      // MqttTopics::COUNT for read-only entities
+        const char* unit;               // nullptr for none
+        const char* valueTemplate;      // nullptr if the state is the plain payload
+    };
+
+    static const Entity ENTITIES[ENTITY_COUNT];
+
+    char blob[HA_DISCOVERY_BLOB_SIZE];
+    uint16_t topicOffsets[ENTITY_COUNT] = {};
+    uint16_t payloadOffsets[ENTITY_COUNT] = {};
+    uint16_t payloadLengths[ENTITY_COUNT] = {};
+    size_t used = 0;
+    uint32_t hash = 0;
+};
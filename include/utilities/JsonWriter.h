@@ -0,0 +1,107 @@
+#pragma once
+
+/**
+ * @file JsonWriter.h
+ * @brief Streaming JSON serializer into a caller-provided buffer
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @class JsonWriter
+ * @brief Writes JSON straight into a fixed buffer, with no heap and no document tree
+ *
+ * Values are appended in order; the writer only tracks nesting and
+ * whether a separator is due, so a payload costs one pass over its
+ * bytes. Keys are passed as nullptr for array elements (and for the root
+ * value). Numbers are integers or fixed-point (e.g. millivolts written as
+ * volts with three decimals); no floating point is involved.
+ *
+ * Running out of space, or unbalanced nesting, marks the writer invalid
+ * and finish() then returns 0 instead of a truncated document. Plain C++
+ * with no Arduino dependencies so it can be benchmarked on the host.
+ */
+class JsonWriter {
+public:
+    static constexpr uint8_t MAX_DEPTH = 8;
+
+    /**
+     * @brief Constructor
+     * @param buffer Destination, reused by the caller between payloads
+     * @param size Size of buffer including the terminating NUL
+     */
+    JsonWriter(char* buffer, size_t size);
+
+    JsonWriter& beginObject(const char* key = nullptr);
+    JsonWriter& endObject();
+    JsonWriter& beginArray(const char* key = nullptr);
+    JsonWriter& endArray();
+
+    /**
+     * @brief Add a string value, escaped as needed
+     * @param key Member name, nullptr inside an array
+     * @param value NUL-terminated text
+     */
+    JsonWriter& addString(const char* key, const char* value);
+
+    JsonWriter& addInt(const char* key, int32_t value);
+    JsonWriter& addUint(const char* key, uint32_t value);
+    JsonWriter& addBool(const char* key, bool value);
+
+    /**
+     * @brief Add a fixed-point number
+     * @param key Member name, nullptr inside an array
+     * @param value Scaled integer (e.g. 3712 for 3.712)
+     * @param decimals Number of decimal places in value (0-9)
+     */
+    JsonWriter& addFixed(const char* key, int32_t value, uint8_t decimals);
+
+    /**
+     * @brief Add an already serialized JSON value verbatim
+     * @param key Member name, nullptr inside an array
+     * @param json Valid JSON text (object, array or scalar)
+     */
+    JsonWriter& addRaw(const char* key, const char* json);
+
+    /**
+     * @brief Terminate the document
+     * @return Length without the NUL, or 0 if it did not fit or is unbalanced
+     */
+    size_t finish();
+
+    bool isValid() const { return valid; }
+
+private:
+    char* buffer;
+    size_t size;
+    size_t length = 0;
+    uint8_t depth = 0;
+    uint16_t pendingSeparator = 0;      // Bit per depth: a value was already written there
+    bool valid = true;
+
+    /**
+     * @brief Start a nested object or array
+     * @param key Member name or nullptr
+     * @param bracket Opening character
+     */
+    JsonWriter& open(const char* key, char bracket);
+
+    /**
+     * @brief End the innermost object or array
+     * @param bracket Closing character
+     */
+    JsonWriter& close(char bracket);
+
+    /**
+     * @brief Emit the separator and key that precede a value
+     * @param key Member name or nullptr
+     */
+    void prefix(const char* key);
+
+    void put(char c);
+    void put(const char* text);
+    void put(const char* text, size_t count);
+    void putEscaped(const char* text);
+    void putUnsigned(uint32_t value);
+};
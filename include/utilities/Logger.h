@@ -0,0 +1,142 @@
+#pragma once
+
+/**
+ * @file Logger.h
+ * @brief Deferred, level-filtered logging through a lock-free ring buffer
+ */
+
+#include <Arduino.h>
+#include <atomic>
+#include <type_traits>
+#include "config/Settings.h"
+
+// Log levels (LOG_LEVEL in Settings.h selects the most verbose one compiled in)
+#define LOG_LEVEL_NONE 0
+#define LOG_LEVEL_ERROR 1
+#define LOG_LEVEL_WARN 2
+#define LOG_LEVEL_INFO 3
+#define LOG_LEVEL_DEBUG 4
+#define LOG_LEVEL_VERBOSE 5
+
+/**
+ * @class Logger
+ * @brief Records log calls as (format, raw arguments) and prints them later
+ *
+ * A log call only copies the format pointer, a timestamp and up to
+ * MAX_ARGS word-sized arguments into a bounded multi-producer ring (Vyukov
+ * sequence-per-slot design), so any task or ISR can log without touching
+ * Serial. A low-priority task formats and prints the records. When the
+ * ring is full the record is dropped and counted rather than waiting.
+ *
+ * Arguments are stored as machine words, so formats may only use integer,
+ * character and pointer conversions; %s must point at storage that
+ * outlives the call (string literals). Floats and 64-bit values are
+ * rejected at compile time - scale them to integers first.
+ */
+class Logger {
+public:
+    static constexpr uint8_t MAX_ARGS = 8;
+    static constexpr size_t CAPACITY = 64;      // Records, power of two
+
+    /**
+     * @brief Start the drain task
+     */
+    static void begin();
+
+    /**
+     * @brief Queue one record (use the LOG_* macros instead)
+     * @param level Record level
+     * @param format printf-style format with static storage duration
+     * @param args Arguments converted by toArg()
+     * @return true if queued, false if the ring was full
+     */
+    template <typename... Args>
+    static bool log(uint8_t level, const char* format, Args... args) {
+        static_assert(sizeof...(Args) <= MAX_ARGS, "Too many log arguments");
+        const uintptr_t words[MAX_ARGS] = { toArg(args)... };
+        return write(level, format, words, sizeof...(Args));
+    }
+
+    /**
+     * @brief Print everything queued so far (drain task, or before it exists)
+     */
+    static void drain();
+
+    /**
+     * @brief Change how often the drain task wakes up
+     * @param intervalMs Drain period in ms (longer saves power, needs more ring)
+     */
+    static void setDrainInterval(uint32_t intervalMs) { drainIntervalMs.store(intervalMs, std::memory_order_relaxed); }
+
+    /**
+     * @brief Get the number of records dropped because the ring was full
+     * @return Dropped record count since boot
+     */
+    static uint32_t getDroppedCount() { return droppedCount.load(std::memory_order_relaxed); }
+
+    // Argument conversion: every supported argument fits in one machine word
+    template <typename T>
+    static typename std::enable_if<std::is_integral<T>::value || std::is_enum<T>::value, uintptr_t>::type
+    toArg(T value) {
+        static_assert(sizeof(T) <= sizeof(uintptr_t), "64-bit log arguments are not supported");
+        return static_cast<uintptr_t>(value);
+    }
+    template <typename T>
+    static uintptr_t toArg(const T* pointer) { return reinterpret_cast<uintptr_t>(pointer); }
+    static uintptr_t toArg(float) = delete;
+    static uintptr_t toArg(double) = delete;
+
+private:
+    // Slot sequence is stored relative to the slot index so a zero-initialized
+    // ring is already valid and logging works before begin() / constructors
+    struct Record {
+        std::atomic<size_t> sequence;
+        const char* format;
+        uint32_t timestamp;
+        uint8_t level;
+        uint8_t argCount;
+        uintptr_t args[MAX_ARGS];
+    };
+
+    static Record ring[CAPACITY];
+    static std::atomic<size_t> enqueuePos;
+    static size_t dequeuePos;                   // Drain side only
+    static std::atomic<uint32_t> droppedCount;
+    static uint32_t reportedDrops;
+    static std::atomic<uint32_t> drainIntervalMs;
+
+    static bool write(uint8_t level, const char* format, const uintptr_t* args, uint8_t argCount);
+    static void print(const Record& record);
+    static void drainTask(void* context);
+};
+
+// Disabled levels expand to nothing: no code, no format strings in flash
+#if LOG_LEVEL >= LOG_LEVEL_ERROR
+#define LOG_ERROR(format, ...) Logger::log(LOG_LEVEL_ERROR, format, ##__VA_ARGS__)
+#else
+#define LOG_ERROR(format, ...) do {} while (0)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_WARN
+#define LOG_WARN(format, ...) Logger::log(LOG_LEVEL_WARN, format, ##__VA_ARGS__)
+#else
+#define LOG_WARN(format, ...) do {} while (0)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_INFO
+#define LOG_INFO(format, ...) Logger::log(LOG_LEVEL_INFO, format, ##__VA_ARGS__)
+#else
+#define LOG_INFO(format, ...) do {} while (0)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_DEBUG
+#define LOG_DEBUG(format, ...) Logger::log(LOG_LEVEL_DEBUG, format, ##__VA_ARGS__)
+#else
+#define LOG_DEBUG(format, ...) do {} while (0)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_VERBOSE
+#define LOG_VERBOSE(format, ...) Logger::log(LOG_LEVEL_VERBOSE, format, ##__VA_ARGS__)
+#else
+#define LOG_VERBOSE(format, ...) do {} while (0)
+#endif
@@ -0,0 +1,141 @@
+#pragma once
+
+/**
+ * @file LoopProfiler.h
+ * @brief Duration histograms of manager update() times
+ */
+
+#include <Arduino.h>
+#include <esp_timer.h>
+
+/**
+ * @brief Managers tracked by the LoopProfiler
+ */
+enum class ProfileSlot : uint8_t {
+    FEEDBACK,
+    WIFI,
+    DEVICE,
+    SENSORS,
+    MQTT,
+    COUNT,
+    NONE = 0xFF            // Task is not profiled
+};
+
+/**
+ * @class DurationHistogram
+ * @brief Fixed-size log-bucket histogram of durations in microseconds
+ *
+ * Buckets split every power of two into four sub-buckets (~25% resolution),
+ * covering the full 32-bit range in 124 counters. Recording is O(1).
+ */
+class DurationHistogram {
+public:
+    static constexpr uint8_t BUCKET_COUNT = 124;
+
+    /**
+     * @brief Add one sample
+     * @param durationUs Measured duration in us
+     */
+    void record(uint32_t durationUs);
+
+    /**
+     * @brief Clear all samples
+     */
+    void reset();
+
+    /**
+     * @brief Estimate a percentile (upper bound of the bucket it falls in)
+     * @param permille Percentile in 1/1000 (500 = p50, 999 = p99.9)
+     * @return Duration in us at that percentile, 0 if empty
+     */
+    uint32_t percentile(uint16_t permille) const;
+
+    uint32_t getCount() const { return count; }
+    uint32_t getMin() const { return count ? minMicros : 0; }
+    uint32_t getMax() const { return maxMicros; }
+
+private:
+    uint32_t buckets[BUCKET_COUNT] = {};
+    uint32_t count = 0;
+    uint32_t minMicros = UINT32_MAX;
+    uint32_t maxMicros = 0;
+
+    static uint8_t bucketIndex(uint32_t durationUs);
+    static uint32_t bucketUpperBound(uint8_t index);
+};
+
+/**
+ * @class LoopProfiler
+ * @brief Per-manager update() timing plus overall loop frequency
+ *
+ * Each slot is written by the single task that runs that manager, and may
+ * be read from another task for reporting; a report taken mid-update can
+ * be off by one sample, which is fine for diagnostics.
+ *
+ * Samples are timed with esp_timer rather than the CPU cycle counter, so
+ * they stay correct when DFS or light sleep changes the CPU clock between
+ * or during updates.
+ */
+class LoopProfiler {
+public:
+    /**
+     * @brief RAII helper that times its own lifetime into a slot
+     */
+    class Scope {
+    public:
+        Scope(LoopProfiler* profiler, ProfileSlot slot)
+            : profiler(profiler), slot(slot), startMicros(esp_timer_get_time()) {}
+        ~Scope() {
+            if (profiler != nullptr && slot != ProfileSlot::NONE) {
+                profiler->record(slot, static_cast<uint32_t>(esp_timer_get_time() - startMicros));
+            }
+        }
+
+    private:
+        LoopProfiler* profiler;
+        ProfileSlot slot;
+        int64_t startMicros;
+    };
+
+    /**
+     * @brief Add one update() measurement
+     * @param slot Manager the sample belongs to
+     * @param durationUs Measured duration in us
+     */
+    void record(ProfileSlot slot, uint32_t durationUs);
+
+    /**
+     * @brief Count one main loop iteration (for loop frequency)
+     */
+    void countLoopIteration() { loopIterations++; }
+
+    /**
+     * @brief Clear all histograms and restart the measurement window
+     */
+    void reset();
+
+    /**
+     * @brief Print min/max/p50/p99/p999 per manager and loop frequency to Serial
+     */
+    void printReport() const;
+
+    /**
+     * @brief Format the report as a compact JSON object
+     * @param buffer Destination buffer
+     * @param size Buffer size in bytes
+     * @return Characters written (excluding terminator), 0 if it did not fit
+     */
+    size_t formatJson(char* buffer, size_t size) const;
+
+private:
+    DurationHistogram histograms[static_cast<uint8_t>(ProfileSlot::COUNT)];
+    uint32_t loopIterations = 0;
+    unsigned long windowStart = 0;
+
+    static const char* slotName(uint8_t slot);
+
+    /**
+     * @brief Main loop iterations per second over the current window
+     */
+    uint32_t loopFrequency() const;
+};
@@ -6,14 +6,58 @@
  */
 
 #include <Arduino.h>
+#include <Preferences.h>
+#include <atomic>
 #include "config/DataTypes.h"
+#include "config/Settings.h"
+#include "network/MqttConnection.h"
+#include "utilities/EventJournal.h"
+#include "utilities/HaDiscovery.h"
+#include "utilities/MqttTopics.h"
+#include "utilities/Scheduler.h"
 
 /**
  * @class MqttHandler
  * @brief Handles MQTT communication and Home Assistant discovery
  * 
- * This class wraps PubSubClient library and provides MQTT functionality
+ * This class drives an MqttConnection and provides MQTT functionality
  * including Home Assistant auto-discovery and sensor data publishing.
+ * The broker is only tried while WiFi is connected (WifiStateChanged on
+ * the EventBus); connecting, retries and keep-alive never block the
+ * network task.
+ *
+ * Nothing is allocated per message: topics are formatted once in begin(),
+ * and payloads are serialized with JsonWriter into one reusable buffer
+ * owned by the network task.
+ *
+ * Presence and power changes made while the broker is unreachable are
+ * kept in an EventJournal on LittleFS. On reconnect the current states are
+ * published at once, and the queued changes are replayed in order, rate
+ * limited, on the events topic with their original timestamps; each one
+ * leaves the journal only when its PUBACK arrives. While connected, a
+ * change refused because the QoS 1 window is full is not journaled: the
+ * retained state topic is republished from update() instead.
+ *
+ * State changes are published at QoS 1, pipelined up to
+ * MQTT_INFLIGHT_WINDOW deep; replayed events at QoS 1 one at a time. The
+ * connection retransmits unacknowledged ones after a reconnect.
+ * Availability, aggregates and diagnostics stay QoS 0 as the next value
+ * supersedes them.
+ *
+ * Home Assistant discovery configs are built once at boot and published
+ * retained. The hash of the set the broker holds is kept in NVS, written
+ * only once the configs have left the transmit buffer on the session they
+ * were queued on, so a reconnect or reboot only resends them when the
+ * firmware version, device id or entity set changed, or when Home
+ * Assistant announces a restart on HA_STATUS_TOPIC.
+ *
+ * Every advertised entity has its state published: presence, power and
+ * charging as retained ON/OFF on change, CPU temperature and free heap as
+ * one JSON document every SYSTEM_PUBLISH_INTERVAL, and LED brightness and
+ * stealth mode, retained, from SettingChanged. Commands on brightness/set
+ * (0-255, clamped) and stealth/set (ON/OFF) are passed on as
+ * SettingRequested; anything else is ignored. FeedbackManager applies
+ * them in its own task and its SettingChanged updates the state topics.
  */
 class MqttHandler {
 public:
@@ -31,11 +75,18 @@ public:
     /**
      * @brief Update MQTT connection and message handling (non-blocking)
      * 
-     * This method should be called regularly from the main loop
-     * to maintain MQTT connection and process incoming messages.
+     * This method should be called regularly from the network task
+     * to maintain MQTT connection and process incoming messages. Each
+     * call is bounded: a dead broker costs time-outs, not blocking.
      */
     void update();
 
+    /**
+     * @brief Register the MQTT servicing task
+     * @param scheduler Scheduler to register with
+     */
+    void registerTasks(Scheduler& scheduler);
+
     /**
      * @brief Check if MQTT is connected
      * @return true if connected to MQTT broker, false otherwise
@@ -51,7 +102,61 @@ public:
     void publishSensorData(const PirData& pirData, const RadarData& radarData, const PowerData& powerData);
 
     /**
-     * @brief Send Home Assistant discovery messages
+     * @brief Handle a sensor state change from the sensor task
+     * @param event Event popped from the SensorManager queue
+     */
+    void handleSensorEvent(const SensorEvent& event);
+
+    /**
+     * @brief Take the power and charging states from a snapshot (boot)
+     *
+     * They are published on connect; later changes arrive as sensor events.
+     * @param power Power status snapshot
+     */
+    void setPowerState(const PowerData& power);
+
+    /**
+     * @brief Publish CPU temperature and free heap on the system topic
+     */
+    void publishSystemStatus();
+
+    /**
+     * @brief Publish the rolling occupancy/sensor aggregates
+     * @param aggregates Windows from the SensorManager aggregate snapshot
+     */
+    void publishAggregates(const SensorAggregates& aggregates);
+
+    /**
+     * @brief Choose between raw PIR/radar events and aggregates only
+     *
+     * Fused presence and power source changes are always published.
+     * @param enabled true to drop raw PIR/radar events (e.g. on battery)
+     */
+    void setAggregateOnly(bool enabled);
+
+    /**
+     * @brief Get the number of changes waiting in the journal
+     * @return Queue depth
+     */
+    uint32_t getQueuedEvents() const { return journal.getDepth(); }
+
+    /**
+     * @brief Get the number of changes lost (journal full or unusable)
+     * @return Dropped event count since boot
+     */
+    uint32_t getDroppedEvents() const { return journal.getDroppedCount(); }
+
+    /**
+     * @brief Publish a diagnostics JSON document (e.g. the loop profile)
+     * @param document Null-terminated JSON payload
+     */
+    void publishDiagnostics(const char* document);
+
+    /**
+     * @brief Send all Home Assistant discovery messages again
+     *
+     * They go out from update() while connected, as fast as the transmit
+     * buffer allows.
      */
     void sendDiscoveryMessages();
 
@@ -63,9 +168,131 @@ public:
 
 private:
     MqttState currentState;
-    unsigned long lastReconnectAttempt;
     unsigned long lastHeartbeat;
-    String deviceTopic;
+    MqttConnection connection;
+    bool wifiConnected = false;             // From WifiStateChanged (network task)
+    EventJournal journal;
+    int8_t lastPresence = -1;               // Last known states, -1 until the first event
+    int8_t lastPower = -1;
+    int8_t lastCharging = -1;
+    bool statesStale = false;               // State topics behind the last known states
+    std::atomic<int16_t> brightness{-1};    // From SettingChanged (any task), -1 until known
+    std::atomic<int8_t> stealthMode{-1};
+    std::atomic<bool> settingsStale{false}; // Setting topics behind brightness/stealthMode
+    uint16_t journalPacketId = 0;           // Replayed event awaiting its PUBACK, 0 if none
+    HaDiscovery discovery;
+    uint32_t discoveryHash = 0;             // Set the broker holds (NVS), 0 if none
+    uint8_t discoveryNext = HaDiscovery::ENTITY_COUNT;  // Next config to send, ENTITY_COUNT when done
+    uint32_t discoveryPending = 0;          // Hash to store once the configs are sent, 0 if none
+    unsigned long connectedAt = 0;
+    Preferences preferences;
+    MqttTopics topics;
+    char payload[MQTT_PAYLOAD_SIZE];        // Reused by every publish (network task)
+    bool aggregateOnly = false;
+    uint32_t suppressedEvents = 0;          // Raw events not sent while aggregateOnly
     
-    // Private helper methods will be implemented in Phase 5
+    /**
+     * @brief Publish a payload on one of the device topics
+     * @param topic Topic identifier
+     * @param message NUL-terminated payload
+     * @param length Payload length
+     * @param retain true to have the broker keep the last value
+     * @param qos 0, or 1 to have the connection keep it until acknowledged
+     * @return false if it could not be queued for sending
+     */
+    bool publish(MqttTopics::Topic topic, const char* message, size_t length, bool retain, uint8_t qos = 0);
+
+    /**
+     * @brief Publish a retained ON/OFF state at QoS 1
+     * @param topic State topic
+     * @param active State
+     * @return false if it could not be queued for sending
+     */
+    bool publishState(MqttTopics::Topic topic, bool active);
+
+    static constexpr const char* PREFERENCES_NAMESPACE = "mqtt";
+    static constexpr const char* DISCOVERY_HASH_KEY = "discovery";
+
+    /**
+     * @brief Queue pending discovery configs; the set is recorded by storeDiscoveryHash()
+     */
+    void publishDiscovery();
+
+    /**
+     * @brief Store the hash of the configs sent in NVS once the transmit buffer has drained
+     */
+    void storeDiscoveryHash();
+
+    /**
+     * @brief Connection handler: watch for Home Assistant restarts and setting commands
+     * @param context MqttHandler instance
+     * @param message Incoming message
+     */
+    static void onMessage(void* context, const MqttConnection::Message& message);
+
+    /**
+     * @brief Check whether a message arrived on one of the device topics
+     * @param message Incoming message
+     * @param topic Topic identifier
+     * @return true on an exact match
+     */
+    bool isTopic(const MqttConnection::Message& message, MqttTopics::Topic topic) const;
+
+    /**
+     * @brief Turn a brightness or stealth command into a SettingRequested
+     * @param message Message on a command topic
+     * @param id Setting the topic controls
+     */
+    static void handleSettingCommand(const MqttConnection::Message& message, SettingId id);
+
+    /**
+     * @brief Publish brightness and stealth mode, marking them stale if refused
+     */
+    void publishSettings();
+
+    /**
+     * @brief EventBus handler: note a brightness or stealth change for the state topics
+     * @param context MqttHandler instance
+     * @param event Changed setting
+     */
+    static void onSettingChanged(void* context, const SettingChanged& event);
+
+    /**
+     * @brief Publish the last known states, marking them stale if refused
+     */
+    void publishStates();
+
+    /**
+     * @brief EventJournal sender: publish a replayed change on the events topic
+     * @param context MqttHandler instance
+     * @param event Queued event
+     * @return true if handed to the connection
+     */
+    static bool sendJournalEvent(void* context, const JournalEvent& event);
+
+    /**
+     * @brief Connection handler: a PUBACK for a replayed event removes it from the journal
+     * @param context MqttHandler instance
+     * @param packetId Acknowledged packet ID
+     */
+    static void onAck(void* context, uint16_t packetId);
+
+    /**
+     * @brief Map the connection phase onto the MQTT states
+     * @return State for getState()
+     */
+    MqttState readState() const;
+
+    /**
+     * @brief Log a state change and announce availability on connect
+     * @param state New state
+     */
+    void onStateChange(MqttState state);
+
+    /**
+     * @brief EventBus handler: track whether WiFi is up
+     * @param context MqttHandler instance
+     * @param event WiFi state change
+     */
+    static void onWifiStateChanged(void* context, const WifiStateChanged& event);
 };
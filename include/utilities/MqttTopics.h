@@ -0,0 +1,62 @@
+#pragma once
+
+/**
+ * @file MqttTopics.h
+ * @brief MQTT topic strings, built once at boot into fixed buffers
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @class MqttTopics
+ * @brief Holds every topic the device publishes or subscribes to
+ *
+ * Topics are "<base>/<device id>/<suffix>", formatted once by begin() so
+ * a publish only passes a pointer. Plain C++ with no Arduino
+ * dependencies.
+ */
+class MqttTopics {
+public:
+    static constexpr size_t TOPIC_SIZE = 64;
+    static constexpr size_t DEVICE_ID_SIZE = 24;
+
+    enum Topic : uint8_t {
+        AVAILABILITY,           // "online"/"offline" (last will)
+        PRESENCE,               // Fused presence ON/OFF
+        POWER,                  // External power ON/OFF
+        CHARGING,               // Battery charging ON/OFF
+        AGGREGATES,             // Rolling statistics JSON
+        DIAGNOSTICS,            // Loop profile JSON
+        EVENTS,                 // Changes replayed from the journal, with original time
+        SYSTEM,                 // CPU temperature and free heap JSON
+        BRIGHTNESS_STATE,
+        BRIGHTNESS_COMMAND,
+        STEALTH_STATE,
+        STEALTH_COMMAND,
+        COUNT
+    };
+
+    /**
+     * @brief Format all topics
+     * @param baseTopic Topic prefix (e.g. "hearthguard")
+     * @param deviceId Unique device identifier
+     * @return true if every topic fit its buffer
+     */
+    bool begin(const char* baseTopic, const char* deviceId);
+
+    /**
+     * @brief Get a topic
+     * @param topic Topic identifier
+     * @return NUL-terminated topic, empty before begin()
+     */
+    const char* get(Topic topic) const { return topics[topic]; }
+
+    const char* getDeviceId() const { return deviceId; }
+
+private:
+    static const char* const SUFFIXES[COUNT];
+
+    char deviceId[DEVICE_ID_SIZE] = {};
+    char topics[COUNT][TOPIC_SIZE] = {};
+};
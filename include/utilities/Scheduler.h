@@ -0,0 +1,189 @@
+#pragma once
+
+/**
+ * @file Scheduler.h
+ * @brief Deadline-based cooperative task scheduler
+ */
+
+#include <Arduino.h>
+#include "utilities/LoopProfiler.h"
+
+/**
+ * @class Scheduler
+ * @brief Runs registered tasks when their deadline arrives and sleeps in between
+ *
+ * Each task either runs on a fixed period or reports its own next deadline
+ * through a query function (e.g. LED animations). run() executes every due
+ * task, then blocks the calling FreeRTOS task until the earliest deadline
+ * or until notify() / notifyFromIsr() signals an external event. Lateness
+ * (jitter) and execution time are tracked per task; tasks tagged with a
+ * ProfileSlot also feed the esp_timer duration histograms
+ * (DurationHistogram) of an attached LoopProfiler.
+ */
+class Scheduler {
+public:
+    /**
+     * @brief Task body
+     * @param context User pointer given at registration
+     */
+    typedef void (*TaskFunction)(void* context);
+
+    /**
+     * @brief Query for a task's next deadline
+     * @param context User pointer given at registration
+     * @param deadline Set to the millis() value the task is due
+     * @return true if the task has pending work, false if it can sleep indefinitely
+     */
+    typedef bool (*DeadlineFunction)(void* context, unsigned long& deadline);
+
+    /**
+     * @brief Timing statistics for one task
+     */
+    struct TaskStats {
+        const char* name;
+        uint32_t runs;
+        uint32_t lastLatenessUs;    // How late the last run started
+        uint32_t maxLatenessUs;
+        uint32_t lastDurationUs;    // How long the last run took
+        uint32_t maxDurationUs;
+    };
+
+    // The sensor task alone registers 8; leave room for the loop and network tasks to grow
+    static constexpr uint8_t MAX_TASKS = 16;
+    static constexpr uint8_t INVALID_TASK = 0xFF;
+
+    /**
+     * @brief Bind the scheduler to the calling FreeRTOS task
+     */
+    void begin();
+
+    /**
+     * @brief Register a periodic task
+     * @param name Short task name for statistics
+     * @param function Task body
+     * @param context User pointer passed to the task
+     * @param periodMs Run period in ms
+     * @param initialDelayMs Delay before the first run in ms
+     * @param slot Profiler slot the task's run time is recorded in
+     * @return Task id, or INVALID_TASK if the table is full
+     */
+    uint8_t addTask(const char* name, TaskFunction function, void* context,
+                    uint32_t periodMs, uint32_t initialDelayMs = 0,
+                    ProfileSlot slot = ProfileSlot::NONE);
+
+    /**
+     * @brief Register a task that reports its own next deadline
+     * @param name Short task name for statistics
+     * @param function Task body
+     * @param deadlineFunction Queried before every sleep for the next deadline
+     * @param context User pointer passed to both functions
+     * @param slot Profiler slot the task's run time is recorded in
+     * @return Task id, or INVALID_TASK if the table is full
+     */
+    uint8_t addDeadlineTask(const char* name, TaskFunction function,
+                            DeadlineFunction deadlineFunction, void* context,
+                            ProfileSlot slot = ProfileSlot::NONE);
+
+    /**
+     * @brief Attach a profiler that records tagged task run times
+     * @param loopProfiler Profiler shared by all schedulers
+     */
+    void setProfiler(LoopProfiler& loopProfiler) { profiler = &loopProfiler; }
+
+    /**
+     * @brief Run all due tasks, then block until the next deadline or event
+     */
+    void run();
+
+    /**
+     * @brief Wake the scheduler early (task context)
+     */
+    void notify();
+
+    /**
+     * @brief Wake the scheduler early (interrupt context)
+     */
+    void IRAM_ATTR notifyFromIsr();
+
+    /**
+     * @brief Get timing statistics for a task
+     * @param taskId Id returned at registration
+     * @param stats Filled with the task's statistics
+     * @return true if the id is valid, false otherwise
+     */
+    bool getTaskStats(uint8_t taskId, TaskStats& stats) const;
+
+    /**
+     * @brief Get number of registered tasks
+     * @return Task count
+     */
+    uint8_t getTaskCount() const { return taskCount; }
+
+    /**
+     * @brief Get number of times the scheduler has woken from sleep
+     * @return Wake-up count since begin()
+     */
+    uint32_t getWakeups() const { return wakeups; }
+
+    /**
+     * @brief Print per-task timing statistics to Serial
+     */
+    void printStats() const;
+
+    /**
+     * @brief Get the total time every started scheduler was blocked at once
+     *
+     * This is the window in which the SoC may drop into automatic light
+     * sleep; the rest of the time at least one scheduler task was running.
+     * @return Accumulated all-idle time in us since boot
+     */
+    static int64_t getAllIdleTime();
+
+private:
+    // Longest single sleep, so a task with no deadline is still re-checked
+    static constexpr uint32_t MAX_SLEEP_MS = 1000;
+
+    // System-wide idle accounting across every started scheduler
+    static portMUX_TYPE idleLock;
+    static uint8_t startedCount;
+    static uint8_t blockedCount;
+    static int64_t allIdleSince;
+    static int64_t allIdleUs;
+
+    struct Task {
+        TaskFunction function;
+        DeadlineFunction deadlineFunction;
+        void* context;
+        int64_t periodUs;
+        int64_t nextRunUs;      // esp_timer time the task is due
+        bool pending;           // False while a deadline task has nothing to do
+        ProfileSlot slot;
+        TaskStats stats;
+    };
+
+    Task tasks[MAX_TASKS];
+    uint8_t taskCount = 0;
+    TaskHandle_t ownerTask = nullptr;
+    uint32_t wakeups = 0;
+    LoopProfiler* profiler = nullptr;
+
+    /**
+     * @brief Refresh a deadline task's next run time from its query function
+     * @param task Task to refresh
+     * @param now Current esp_timer time in us
+     */
+    void refreshDeadline(Task& task, int64_t now);
+
+    /**
+     * @brief Run one due task and record its statistics
+     * @param task Task to run
+     * @param now Current esp_timer time in us
+     */
+    void runTask(Task& task, int64_t now);
+
+    /**
+     * @brief Account for the calling scheduler blocking / waking up
+     */
+    static void enterIdle();
+    static void leaveIdle();
+};
@@ -0,0 +1,112 @@
+#pragma once
+
+/**
+ * @file Seqlock.h
+ * @brief Single-writer, lock-free snapshot of a small struct
+ */
+
+#include <Arduino.h>
+#include <atomic>
+#include <string.h>
+#include <type_traits>
+
+/**
+ * @class Seqlock
+ * @brief Publishes a value from one task to any number of readers without a mutex
+ *
+ * The writer makes the sequence counter odd, copies the value in and makes
+ * it even again. A reader copies the value out between two reads of the
+ * counter and retries if the counter was odd or moved, so it never
+ * returns a torn mix of two writes. The writer never waits.
+ *
+ * The even counter divided by two is the value's generation: it only
+ * advances when publish() is given a value that differs from the current
+ * one, so readers can skip unchanged data with changedSince().
+ *
+ * Without an operator== for T, publish() compares raw bytes, so every
+ * byte of a published value must be deterministic, padding included:
+ * value-initialize aggregates ({}) and fill them field by field. A
+ * leftover garbage byte makes every publish() look like a change. Types
+ * with padding that are built by a constructor or copied from elsewhere
+ * should define operator==, which publish() then uses instead.
+ *
+ * A reader retries while a write is in progress, so it must not be able
+ * to preempt the writer on the same core (reader priority <= writer
+ * priority, never from an ISR).
+ *
+ * @tparam T Trivially copyable value type
+ */
+template <typename T>
+class Seqlock {
+    static_assert(std::is_trivially_copyable<T>::value, "Seqlock value must be trivially copyable");
+
+public:
+    /**
+     * @brief Store a new value if it differs from the current one (writer only)
+     * @param value Value to publish
+     * @return true if the value changed and the generation advanced
+     */
+    bool publish(const T& value) {
+        // Only the writer modifies data, so it can compare without the protocol
+        if (equal(data, value)) {
+            return false;
+        }
+
+        const uint32_t sequence = sequenceCounter.load(std::memory_order_relaxed);
+        sequenceCounter.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        memcpy(&data, &value, sizeof(T));
+        sequenceCounter.store(sequence + 2, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Copy out a consistent value (any task, see class notes)
+     * @param value Receives the value
+     * @return Generation of the returned value
+     */
+    uint32_t read(T& value) const {
+        for (;;) {
+            const uint32_t before = sequenceCounter.load(std::memory_order_acquire);
+            if ((before & 1) == 0) {
+                memcpy(&value, &data, sizeof(T));
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (sequenceCounter.load(std::memory_order_relaxed) == before) {
+                    return before >> 1;
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Get the generation of the current value (any task)
+     * @return Number of changes published so far
+     */
+    uint32_t getGeneration() const {
+        return sequenceCounter.load(std::memory_order_acquire) >> 1;
+    }
+
+    /**
+     * @brief Check whether a newer value than one already read exists (any task)
+     * @param generation Generation returned by an earlier read()
+     * @return true if read() would return a different value
+     */
+    bool changedSince(uint32_t generation) const {
+        return getGeneration() != generation;
+    }
+
+private:
+    template <typename U>
+    static auto equal(const U& a, const U& b) -> decltype(a == b) {
+        return a == b;
+    }
+
+    // No operator==: bytewise, see class notes
+    template <typename U, typename... Unused>
+    static bool equal(const U& a, const U& b, Unused...) {
+        return memcmp(&a, &b, sizeof(U)) == 0;
+    }
+
+    T data = {};
+    std::atomic<uint32_t> sequenceCounter{0};
+};
@@ -0,0 +1,100 @@
+#pragma once
+
+/**
+ * @file SleepManager.h
+ * @brief Battery power mode: automatic light sleep between scheduled work
+ */
+
+#include <Arduino.h>
+
+/**
+ * @class SleepManager
+ * @brief Switches the SoC between full-speed (external power) and battery mode
+ *
+ * In battery mode ESP-IDF power management drops the CPU into automatic
+ * light sleep whenever every task is blocked. The schedulers already block
+ * until their next deadline, so the tickless idle hook wakes the chip for
+ * the next timer deadline; the PIR and LD2410S interrupt GPIOs wake it for
+ * sensor edges (see SensorManager). WiFi stays associated through modem
+ * sleep (WifiHandler::setPowerSave).
+ *
+ * Light sleep needs CONFIG_PM_ENABLE and CONFIG_FREERTOS_USE_TICKLESS_IDLE
+ * in sdkconfig; without them battery mode only lowers the log drain rate.
+ * The prebuilt Arduino sdkconfig of [env:esp32s3] has neither, so that
+ * build does not sleep yet.
+ *
+ * Statistics are reset on every mode change so the idle share and the
+ * wake-to-publish latency always describe the current mode.
+ */
+class SleepManager {
+public:
+    /**
+     * @brief Time split and latency for the current power mode
+     */
+    struct SleepStats {
+        bool batteryMode;
+        bool lightSleepAvailable;
+        int64_t modeTimeUs;             // Time since the last mode change
+        int64_t idleTimeUs;             // Of which every scheduler was blocked (sleep-eligible)
+        uint32_t latencySamples;        // Sensor interrupts that led to a publish
+        uint32_t lastWakeLatencyUs;     // Interrupt edge -> event handed to MQTT
+        uint32_t maxWakeLatencyUs;
+    };
+
+    /**
+     * @brief Configure power management (starts in external-power mode)
+     * @return true if automatic light sleep is available, false otherwise
+     */
+    bool begin();
+
+    /**
+     * @brief Enter or leave battery mode
+     * @param onBattery true when running from the battery
+     */
+    void setBatteryMode(bool onBattery);
+
+    /**
+     * @brief Check whether battery mode is active
+     * @return true in battery mode
+     */
+    bool isBatteryMode() const { return batteryMode; }
+
+    /**
+     * @brief Record the delay between a sensor interrupt and publishing its event
+     * @param latencyUs Interrupt-to-publish time in us
+     */
+    void recordWakeLatency(uint32_t latencyUs);
+
+    /**
+     * @brief Get statistics for the current mode
+     * @param stats Filled with the current statistics
+     */
+    void getStats(SleepStats& stats) const;
+
+    /**
+     * @brief Print the current mode statistics to Serial
+     */
+    void printStats() const;
+
+private:
+    // Dynamic frequency range; 80 MHz keeps APB (RMT/LEDC timing) at 80 MHz
+    static constexpr int MAX_CPU_FREQ_MHZ = 240;
+    static constexpr int MIN_CPU_FREQ_MHZ = 80;
+
+    bool batteryMode = false;
+    bool lightSleepAvailable = false;
+
+    // Mode statistics
+    int64_t modeStartUs = 0;
+    int64_t modeStartIdleUs = 0;
+    uint32_t latencySamples = 0;
+    uint32_t lastWakeLatencyUs = 0;
+    uint32_t maxWakeLatencyUs = 0;
+
+    /**
+     * @brief Apply the power-management configuration for a mode
+     * @param lightSleep true to allow automatic light sleep
+     * @return true if the configuration was accepted
+     */
+    bool configurePowerManagement(bool lightSleep);
+};
@@ -0,0 +1,90 @@
+#pragma once
+
+/**
+ * @file SpscQueue.h
+ * @brief Lock-free single-producer/single-consumer ring buffer
+ */
+
+#include <Arduino.h>
+#include <atomic>
+
+/**
+ * @class SpscQueue
+ * @brief Statically allocated, wait-free FIFO between exactly two contexts
+ *
+ * One task (or ISR) may push and one other task may pop, without any
+ * mutex. The producer owns the head index and the consumer owns the tail
+ * index; acquire/release ordering publishes each slot before its index.
+ *
+ * @tparam T Element type (copied in and out)
+ * @tparam Capacity Number of slots, must be a power of two
+ */
+template <typename T, size_t Capacity>
+class SpscQueue {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0,
+                  "SpscQueue capacity must be a power of two");
+
+public:
+    /**
+     * @brief Append an element (producer side only)
+     * @param item Element to copy in
+     * @return true if queued, false if the queue is full
+     */
+    bool push(const T& item) {
+        const size_t head = headIndex.load(std::memory_order_relaxed);
+        if (head - tailIndex.load(std::memory_order_acquire) == Capacity) {
+            droppedCount.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        slots[head & (Capacity - 1)] = item;
+        headIndex.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Remove the oldest element (consumer side only)
+     * @param item Receives the element
+     * @return true if an element was removed, false if the queue is empty
+     */
+    bool pop(T& item) {
+        const size_t tail = tailIndex.load(std::memory_order_relaxed);
+        if (tail == headIndex.load(std::memory_order_acquire)) {
+            return false;
+        }
+
+        item = slots[tail & (Capacity - 1)];
+        tailIndex.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Check for pending elements (either side)
+     * @return true if the queue is empty
+     */
+    bool isEmpty() const {
+        return tailIndex.load(std::memory_order_acquire) == headIndex.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Get the number of pending elements (approximate if the other side is active)
+     * @return Elements waiting to be popped
+     */
+    size_t size() const {
+        return headIndex.load(std::memory_order_acquire) - tailIndex.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Get the number of pushes rejected because the queue was full
+     * @return Dropped element count
+     */
+    uint32_t getDroppedCount() const {
+        return droppedCount.load(std::memory_order_relaxed);
+    }
+
+private:
+    T slots[Capacity];
+    std::atomic<size_t> headIndex{0};   // Next slot to write (producer)
+    std::atomic<size_t> tailIndex{0};   // Next slot to read (consumer)
+    std::atomic<uint32_t> droppedCount{0};
+};
@@ -0,0 +1,96 @@
+#pragma once
+
+/**
+ * @file TraceCodec.h
+ * @brief Compact binary encoding for sensor traces
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Kind of trace record
+ */
+enum class TraceRecordType : uint8_t {
+    HEADER,         // Segment file start: sequence number
+    SYNC,           // Absolute time base, records dropped before it
+    PIR_EDGE,       // Raw PIR edge as captured by the interrupt
+    PIR_STATE,      // Debounced PIR state (fusion input)
+    RADAR,          // Decoded radar report (when it changed)
+    POWER           // Power status sample (when it changed)
+};
+
+/**
+ * @brief One decoded trace record
+ *
+ * Only the fields of the record's type are meaningful.
+ */
+struct TraceRecord {
+    TraceRecordType type;
+    uint32_t timestamp;             // millis(); for HEADER unused
+
+    // HEADER: segment sequence; SYNC: records dropped since the previous SYNC
+    uint32_t value;
+
+    // PIR_EDGE / PIR_STATE
+    bool level;
+
+    // RADAR
+    bool moving;
+    bool stationary;
+    uint16_t movingDistance;
+    uint8_t movingEnergy;
+    uint16_t stationaryDistance;
+    uint8_t stationaryEnergy;
+
+    // POWER
+    bool usbPower;
+    bool batteryLow;
+    uint8_t batteryPercentage;
+    uint16_t batteryMillivolts;
+};
+
+/**
+ * @class TraceCodec
+ * @brief Delta-time, varint encoding of trace records
+ *
+ * Record layout: one tag byte (type in the low nibble, boolean fields in
+ * the high nibble), the time as a zigzag varint delta to the previous
+ * record, then the type's fields as varints or bytes. SYNC carries the
+ * absolute time instead of a delta and resets the time base, so decoding
+ * can start at any SYNC; the recorder starts every buffer it flushes with
+ * one. Typical records take 2-8 bytes.
+ *
+ * Plain C++ with no Arduino dependencies, shared by the firmware and the
+ * host replay tool.
+ */
+class TraceCodec {
+public:
+    static constexpr uint8_t HEADER_MAGIC = 0xA7;
+    static constexpr size_t MAX_RECORD_SIZE = 16;
+
+    /**
+     * @brief Encode one record
+     * @param record Record to encode
+     * @param buffer Output, at least MAX_RECORD_SIZE bytes
+     * @return Number of bytes written
+     */
+    size_t encode(const TraceRecord& record, uint8_t* buffer);
+
+    /**
+     * @brief Decode one record
+     * @param data Encoded bytes
+     * @param length Number of bytes available
+     * @param record Receives the decoded record
+     * @return Bytes consumed, or 0 if the data is truncated or invalid
+     */
+    size_t decode(const uint8_t* data, size_t length, TraceRecord& record);
+
+    /**
+     * @brief Forget the time base (next record should be a SYNC)
+     */
+    void reset() { lastTimestamp = 0; }
+
+private:
+    uint32_t lastTimestamp = 0;
+};
@@ -0,0 +1,120 @@
+#pragma once
+
+/**
+ * @file TraceRecorder.h
+ * @brief Sensor trace recording to a bounded LittleFS ring of files
+ */
+
+#include <Arduino.h>
+#include <FS.h>
+#include <atomic>
+#include "config/Settings.h"
+#include "utilities/TraceCodec.h"
+
+/**
+ * @class TraceRecorder
+ * @brief Buffers encoded trace records in RAM and writes them to flash
+ *
+ * The flash budget is TRACE_SEGMENT_COUNT files of at most
+ * TRACE_SEGMENT_SIZE bytes each (/traceN.bin). Each file starts with a
+ * HEADER record carrying an increasing sequence number; when the current
+ * one is full the oldest file is overwritten, so the files ordered by
+ * sequence always hold the most recent trace.
+ *
+ * record() runs in the sensor task and only encodes into one of two RAM
+ * buffers. A full buffer, or via poll() one older than
+ * TRACE_FLUSH_INTERVAL, is handed to flush(), which runs in a low-priority
+ * task and does the LittleFS writes, so flash latency never reaches the
+ * sensor task. If the writer falls behind, records are dropped and the
+ * count is carried in the next SYNC record. Each boot starts a new segment.
+ */
+class TraceRecorder {
+public:
+    /**
+     * @brief Mount LittleFS and locate the newest trace segment
+     * @return true if the filesystem is usable, false otherwise
+     */
+    bool begin();
+
+    /**
+     * @brief Start or stop recording (any task)
+     * @param enabled true to record
+     */
+    void setEnabled(bool enabled);
+
+    bool isEnabled() const { return enabled.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Encode a record into the RAM buffer (sensor task only)
+     * @param record Record to add; timestamp in millis()
+     */
+    void record(const TraceRecord& record);
+
+    /**
+     * @brief Hand over a partly filled buffer once it is old enough (sensor task only)
+     */
+    void poll();
+
+    /**
+     * @brief Write a handed-over buffer to flash (writer task only)
+     */
+    void flush();
+
+    /**
+     * @brief Print all segments, oldest first, as hex to Serial (writer task only)
+     *
+     * Convert back with `xxd -r -p` per segment for the replay tool.
+     */
+    void dump();
+
+    uint32_t getDroppedCount() const { return droppedCount; }
+
+private:
+    static constexpr uint32_t NO_SEQUENCE = 0;
+
+    // Double buffer: the sensor task fills one while the writer drains the other
+    uint8_t buffers[2][TRACE_BUFFER_SIZE];
+    size_t bufferLength[2] = {};
+    uint8_t activeBuffer = 0;
+    unsigned long bufferStart = 0;
+    std::atomic<int8_t> pendingBuffer{-1};     // Index handed to flush(), -1 if none
+
+    TraceCodec codec;
+    std::atomic<bool> enabled{false};
+    bool mounted = false;
+    uint32_t droppedCount = 0;
+    uint32_t unreportedDrops = 0;
+
+    // Writer state
+    fs::File segmentFile;
+    uint8_t segmentIndex = 0;
+    uint32_t segmentSequence = NO_SEQUENCE;
+    uint32_t sequences[TRACE_SEGMENT_COUNT] = {};
+
+    /**
+     * @brief Hand the active buffer to the writer and start a new one
+     * @return false if the writer still holds the other buffer
+     */
+    bool handOver();
+
+    /**
+     * @brief Close the current segment and open the oldest one for overwriting
+     * @return true if the new segment is open
+     */
+    bool startSegment();
+
+    /**
+     * @brief Read the sequence number from a segment's header
+     * @param index Segment index
+     * @return Sequence number, NO_SEQUENCE if missing or invalid
+     */
+    uint32_t readSequence(uint8_t index);
+
+    /**
+     * @brief Build the file name of a segment
+     * @param index Segment index
+     * @param path Receives the path
+     * @param size Size of path
+     */
+    static void segmentPath(uint8_t index, char* path, size_t size);
+};
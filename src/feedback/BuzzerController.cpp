@@ -1,214 +1,319 @@
 #include "feedback/BuzzerController.h"
 #include "config/Pins.h"
+#include "feedback/Melodies.h"
+#include "utilities/Logger.h"
 
 void BuzzerController::begin() {
-    #ifdef DEBUG
-    Serial.println("[BUZZER] Initializing BuzzerController...");
-    Serial.flush();
+    LOG_DEBUG("[BUZZER] Initializing BuzzerController...");
+
+    // Configure the dedicated LEDC timer for the buzzer
+    ledc_timer_config_t timerConfig = {};
+    timerConfig.speed_mode = LEDC_MODE;
+    timerConfig.duty_resolution = LEDC_RESOLUTION;
+    timerConfig.timer_num = LEDC_TIMER;
+    timerConfig.freq_hz = LEDC_INITIAL_FREQUENCY;
+    timerConfig.clk_cfg = LEDC_AUTO_CLK;
+
+    if (ledc_timer_config(&timerConfig) != ESP_OK) {
+        LOG_ERROR("[BUZZER] Error: LEDC timer configuration failed");
+        return;
+    }
+
+    // Attach the buzzer pin to its LEDC channel, silent (0% duty) until a tone starts
+    ledc_channel_config_t channelConfig = {};
+    channelConfig.gpio_num = BUZZER_PIN;
+    channelConfig.speed_mode = LEDC_MODE;
+    channelConfig.channel = LEDC_CHANNEL;
+    channelConfig.intr_type = LEDC_INTR_DISABLE;
+    channelConfig.timer_sel = LEDC_TIMER;
+    channelConfig.duty = 0;
+    channelConfig.hpoint = 0;
+
+    if (ledc_channel_config(&channelConfig) != ESP_OK) {
+        LOG_ERROR("[BUZZER] Error: LEDC channel configuration failed");
+        return;
+    }
+
+    // One-shot timer that advances sound sequences without the main loop
+    esp_timer_create_args_t timerArgs = {};
+    timerArgs.callback = &BuzzerController::onStepTimer;
+    timerArgs.arg = this;
+    timerArgs.dispatch_method = ESP_TIMER_TASK;
+    timerArgs.name = "buzzer_step";
+
+    if (esp_timer_create(&timerArgs, &stepTimer) != ESP_OK) {
+        LOG_ERROR("[BUZZER] Error: Failed to create step timer");
+        return;
+    }
+
+    #if CONFIG_PM_ENABLE
+    if (esp_pm_lock_create(ESP_PM_NO_LIGHT_SLEEP, 0, "buzzer", &sleepLock) != ESP_OK) {
+        LOG_WARN("[BUZZER] Could not create sleep lock, tones may stutter in light sleep");
+        sleepLock = nullptr;
+    }
     #endif
-    
-    // Initialize the buzzer pin as output
-    pinMode(BUZZER_PIN, OUTPUT);
-    digitalWrite(BUZZER_PIN, LOW);
-    
+
     buzzerInitialized = true;
-    
+
     // Play boot sound sequence - but only if not in stealth mode
-    if (!stealthMode) {
-        currentSound = SoundState::BOOT;
-        soundStartTime = millis();
-        startTone(TONE_BOOT_LOW);
-    }
-    
-    #ifdef DEBUG
-    Serial.println("[BUZZER] Initialization complete with boot sound");
-    Serial.flush();
-    #endif
+    play(SoundCue::BOOT);
+
+    LOG_INFO("[BUZZER] Initialization complete with boot sound");
 }
 
 void BuzzerController::update() {
-    if (!buzzerInitialized || stealthMode) {
-        return;
+    // Tones are generated by the LEDC peripheral and sequence steps are
+    // advanced by the step timer, so there is nothing to poll here.
+}
+
+void BuzzerController::setStealthMode(bool enabled) {
+    stealthMode = enabled;
+
+    LOG_DEBUG("[BUZZER] Stealth mode %s", enabled ? "enabled" : "disabled");
+
+    // Stop any current sounds and forget queued cues if entering stealth mode
+    if (enabled && buzzerInitialized) {
+        portENTER_CRITICAL(&soundLock);
+        currentMelody = nullptr;
+        queueLength = 0;
+        targetFrequency = 0;
+        stepDeadline = 0;
+        stepGeneration++;
+        portEXIT_CRITICAL(&soundLock);
+
+        syncHardware();
     }
+}
 
-    // Handle software PWM for active tones
-    if (isToneActive) {
-        unsigned long currentTime = micros();
-        if (currentTime - lastToggle >= halfPeriod) {
-            // Toggle the buzzer pin
-            digitalWrite(BUZZER_PIN, !digitalRead(BUZZER_PIN));
-            lastToggle = currentTime;
-        }
+bool BuzzerController::play(SoundCue cue) {
+    if (!buzzerInitialized || stealthMode || cue >= SoundCue::COUNT) {
+        return false;
     }
 
-    // Handle sound state machine
-    unsigned long currentTime = millis();
-    unsigned long elapsed = currentTime - soundStartTime;
+    const Melody& melody = Melodies::CUE_TABLE[static_cast<uint8_t>(cue)];
+    bool accepted = true;
 
-    switch (currentSound) {
-        case SoundState::BOOT:
-            if (elapsed >= DURATION_BOOT) {
-                stopTone();
-                currentSound = SoundState::IDLE;
-            }
-            break;
+    portENTER_CRITICAL(&soundLock);
+    if (currentMelody == nullptr || melody.priority > currentMelody->priority) {
+        // Preempt: the interrupted cue is dropped, queued cues keep their place
+        startMelody(melody);
+    } else {
+        accepted = enqueue(cue);
+    }
+    portEXIT_CRITICAL(&soundLock);
 
-        case SoundState::SUCCESS_NOTE1:
-            if (elapsed >= DURATION_SUCCESS_SHORT) {
-                stopTone();
-                currentSound = SoundState::SUCCESS_GAP;
-                soundStartTime = currentTime;
-            }
-            break;
+    if (accepted) {
+        syncHardware();
+    } else {
+        LOG_WARN("[BUZZER] Queue full, dropped cue %d", static_cast<int>(cue));
+    }
 
-        case SoundState::SUCCESS_GAP:
-            if (elapsed >= DURATION_SUCCESS_GAP) {
-                startTone(TONE_SUCCESS_HIGH);
-                currentSound = SoundState::SUCCESS_NOTE2;
-                soundStartTime = currentTime;
-            }
-            break;
+    return accepted;
+}
 
-        case SoundState::SUCCESS_NOTE2:
-            if (elapsed >= DURATION_SUCCESS_SHORT) {
-                stopTone();
-                currentSound = SoundState::IDLE;
-            }
-            break;
+void BuzzerController::playSuccess() {
+    play(SoundCue::SUCCESS);
+}
 
-        case SoundState::FAILURE:
-            if (elapsed >= DURATION_FAILURE) {
-                stopTone();
-                currentSound = SoundState::IDLE;
-            }
-            break;
+void BuzzerController::playFailure() {
+    play(SoundCue::FAILURE);
+}
 
-        case SoundState::CONFIRM:
-            if (elapsed >= DURATION_CONFIRM) {
-                stopTone();
-                currentSound = SoundState::IDLE;
-            }
-            break;
+void BuzzerController::playConfirm() {
+    play(SoundCue::CONFIRM);
+}
 
-        case SoundState::INTERACTION:
-            if (elapsed >= DURATION_INTERACTION) {
-                stopTone();
-                currentSound = SoundState::IDLE;
-            }
-            break;
+void BuzzerController::playInteraction() {
+    play(SoundCue::INTERACTION);
+}
 
-        case SoundState::IDLE:
-            // Nothing to do
-            break;
-    }
+void BuzzerController::startMelody(const Melody& melody) {
+    currentMelody = &melody;
+    noteIndex = 0;
+    inGap = false;
+    playCurrentNote();
 }
 
-void BuzzerController::setStealthMode(bool enabled) {
-    stealthMode = enabled;
-    
-    #ifdef DEBUG
-    Serial.printf("[BUZZER] Stealth mode %s\n", enabled ? "enabled" : "disabled");
-    #endif
-    
-    // Stop any current sounds if entering stealth mode
-    if (enabled && currentSound != SoundState::IDLE) {
-        stopTone();
-        currentSound = SoundState::IDLE;
+void BuzzerController::playCurrentNote() {
+    const MelodyNote& note = currentMelody->notes[noteIndex];
+
+    targetFrequency = note.frequency;   // REST is 0, i.e. silent
+    scheduleStep(note.duration);
+}
+
+bool BuzzerController::enqueue(SoundCue cue) {
+    const uint8_t priority = Melodies::CUE_TABLE[static_cast<uint8_t>(cue)].priority;
+
+    // The same cue already waiting would only repeat itself
+    for (uint8_t i = 0; i < queueLength; i++) {
+        if (cueQueue[i] == cue) {
+            return true;
+        }
+    }
+
+    if (queueLength == QUEUE_CAPACITY) {
+        // Make room only by evicting the newest, lowest-priority entry
+        const SoundCue last = cueQueue[QUEUE_CAPACITY - 1];
+        if (Melodies::CUE_TABLE[static_cast<uint8_t>(last)].priority >= priority) {
+            return false;
+        }
+        queueLength--;
     }
+
+    // Insert behind every cue of equal or higher priority
+    uint8_t position = queueLength;
+    while (position > 0 &&
+           Melodies::CUE_TABLE[static_cast<uint8_t>(cueQueue[position - 1])].priority < priority) {
+        cueQueue[position] = cueQueue[position - 1];
+        position--;
+    }
+    cueQueue[position] = cue;
+    queueLength++;
+    return true;
 }
 
-void BuzzerController::playSuccess() {
-    if (!buzzerInitialized || stealthMode || currentSound != SoundState::IDLE) {
+void BuzzerController::onStepTimer(void* arg) {
+    static_cast<BuzzerController*>(arg)->advanceSequence();
+}
+
+void BuzzerController::advanceSequence() {
+    portENTER_CRITICAL(&soundLock);
+
+    // Ignore a callback that raced with a preemption and belongs to an older step
+    if (currentMelody == nullptr || esp_timer_get_time() < stepDeadline) {
+        portEXIT_CRITICAL(&soundLock);
         return;
     }
-    
-    #ifdef DEBUG
-    Serial.println("[BUZZER] Playing success sound");
-    #endif
-    
-    currentSound = SoundState::SUCCESS_NOTE1;
-    soundStartTime = millis();
-    startTone(TONE_SUCCESS_LOW);
+
+    const MelodyNote& note = currentMelody->notes[noteIndex];
+
+    if (!inGap && note.gap > 0) {
+        // Tone finished, hold the silence before the next note
+        targetFrequency = 0;
+        inGap = true;
+        scheduleStep(note.gap);
+    } else if (++noteIndex < currentMelody->length) {
+        inGap = false;
+        playCurrentNote();
+    } else if (queueLength > 0) {
+        // Melody finished - start the highest-priority queued cue
+        const SoundCue next = cueQueue[0];
+        queueLength--;
+        for (uint8_t i = 0; i < queueLength; i++) {
+            cueQueue[i] = cueQueue[i + 1];
+        }
+        startMelody(Melodies::CUE_TABLE[static_cast<uint8_t>(next)]);
+    } else {
+        currentMelody = nullptr;
+        targetFrequency = 0;
+        stepDeadline = 0;
+        stepGeneration++;
+    }
+
+    portEXIT_CRITICAL(&soundLock);
+
+    syncHardware();
 }
 
-void BuzzerController::playFailure() {
-    if (!buzzerInitialized || stealthMode || currentSound != SoundState::IDLE) {
-        return;
+void BuzzerController::scheduleStep(uint16_t duration) {
+    stepDeadline = esp_timer_get_time() + static_cast<int64_t>(duration) * 1000;
+    stepGeneration++;
+}
+
+void BuzzerController::syncHardware() {
+    if (syncBusy.exchange(true, std::memory_order_acquire)) {
+        return;     // The running sync sees our stepGeneration bump and applies it
+    }
+
+    for (;;) {
+        portENTER_CRITICAL(&soundLock);
+        const uint32_t generation = stepGeneration;
+        const uint16_t frequency = targetFrequency;
+        const int64_t deadline = stepDeadline;
+        portEXIT_CRITICAL(&soundLock);
+
+        const bool playing = deadline != 0;
+        if (playing && !sleepLockHeld) {
+            keepAwake();
+        }
+
+        if (frequency == Melodies::REST) {
+            if (isToneActive) {
+                stopTone();
+            }
+        } else if (!isToneActive || frequency != currentFrequency) {
+            startTone(frequency);
+        }
+
+        // Re-arm for the newest deadline; a stale callback is filtered by advanceSequence()
+        esp_timer_stop(stepTimer);  // ESP_ERR_INVALID_STATE if idle, which is fine
+        if (playing) {
+            const int64_t remaining = deadline - esp_timer_get_time();
+            esp_timer_start_once(stepTimer, remaining > 0 ? static_cast<uint64_t>(remaining) : 0);
+        } else if (sleepLockHeld) {
+            allowSleep();
+        }
+
+        // Done only if nothing was decided meanwhile; releasing under the
+        // lock means a later decision either sees syncBusy clear or is seen here
+        portENTER_CRITICAL(&soundLock);
+        const bool current = generation == stepGeneration;
+        if (current) {
+            syncBusy.store(false, std::memory_order_release);
+        }
+        portEXIT_CRITICAL(&soundLock);
+
+        if (current) {
+            return;
+        }
     }
-    
-    #ifdef DEBUG
-    Serial.println("[BUZZER] Playing failure sound");
-    #endif
-    
-    currentSound = SoundState::FAILURE;
-    soundStartTime = millis();
-    startTone(TONE_FAILURE);
 }
 
-void BuzzerController::playConfirm() {
-    if (!buzzerInitialized || stealthMode || currentSound != SoundState::IDLE) {
-        return;
+void BuzzerController::keepAwake() {
+    #if CONFIG_PM_ENABLE
+    if (sleepLock != nullptr) {
+        esp_pm_lock_acquire(sleepLock);
     }
-    
-    #ifdef DEBUG
-    Serial.println("[BUZZER] Playing confirmation sound");
     #endif
-    
-    currentSound = SoundState::CONFIRM;
-    soundStartTime = millis();
-    startTone(TONE_CONFIRM);
+    sleepLockHeld = true;
 }
 
-void BuzzerController::playInteraction() {
-    if (!buzzerInitialized || stealthMode || currentSound != SoundState::IDLE) {
-        return;
+void BuzzerController::allowSleep() {
+    #if CONFIG_PM_ENABLE
+    if (sleepLock != nullptr) {
+        esp_pm_lock_release(sleepLock);
     }
-    
-    #ifdef DEBUG
-    Serial.println("[BUZZER] Playing interaction sound");
     #endif
-    
-    currentSound = SoundState::INTERACTION;
-    soundStartTime = millis();
-    startTone(TONE_INTERACTION);
+    sleepLockHeld = false;
 }
 
 void BuzzerController::startTone(uint16_t frequency) {
     if (!buzzerInitialized || stealthMode) {
         return;
     }
-    
+
     // Ensure frequency is within a reasonable range
-    if (frequency < 50 || frequency > 20000) {
-        #ifdef DEBUG
-        Serial.printf("[BUZZER] Warning: Invalid frequency %d Hz, skipping\n", frequency);
-        #endif
+    if (frequency < MIN_FREQUENCY || frequency > MAX_FREQUENCY) {
         return;
     }
-    
-    // Store frequency for software PWM implementation
+
+    // Retune the buzzer timer and drive a 50% square wave
+    ledc_set_freq(LEDC_MODE, LEDC_TIMER, frequency);
+    ledc_set_duty(LEDC_MODE, LEDC_CHANNEL, LEDC_DUTY_HALF);
+    ledc_update_duty(LEDC_MODE, LEDC_CHANNEL);
+
     currentFrequency = frequency;
     isToneActive = true;
-    lastToggle = micros();
-    
-    // Calculate half period in microseconds
-    halfPeriod = (1000000UL / frequency) / 2;
-    
-    #ifdef DEBUG
-    Serial.printf("[BUZZER] Starting software PWM tone at %d Hz (half-period: %lu us)\n", frequency, halfPeriod);
-    #endif
 }
 
 void BuzzerController::stopTone() {
     if (!buzzerInitialized) {
         return;
     }
-    
-    // Stop software PWM
+
+    // Silence the channel; the timer keeps running so the next tone starts glitch-free
+    ledc_set_duty(LEDC_MODE, LEDC_CHANNEL, 0);
+    ledc_update_duty(LEDC_MODE, LEDC_CHANNEL);
+
     isToneActive = false;
-    digitalWrite(BUZZER_PIN, LOW);
-    
-    #ifdef DEBUG
-    Serial.println("[BUZZER] Stopping software PWM tone");
-    #endif
 }
@@ -1,9 +1,9 @@
 #include "feedback/FeedbackManager.h"
+#include "utilities/EventBus.h"
+#include "utilities/Logger.h"
 
 void FeedbackManager::begin() {
-    #ifdef DEBUG
-    Serial.println("[FEEDBACK] Initializing FeedbackManager...");
-    #endif
+    LOG_DEBUG("[FEEDBACK] Initializing FeedbackManager...");
     
     // Load saved settings first
     loadSettings();
@@ -16,39 +16,78 @@ void FeedbackManager::begin() {
     ledController.setBrightness(currentBrightness);
     ledController.setStealthMode(stealthMode);
     buzzerController.setStealthMode(stealthMode);
+
+    EventBus::subscribe<WifiStateChanged>(&FeedbackManager::onWifiStateChanged, this);
+    EventBus::subscribe<PresenceChanged>(&FeedbackManager::onPresenceChanged, this);
+    EventBus::subscribe<SettingRequested>(&FeedbackManager::onSettingRequested, this);
     
-    #ifdef DEBUG
-    Serial.printf("[FEEDBACK] Loaded settings - Brightness: %d, Stealth: %s\n", 
+    LOG_DEBUG("[FEEDBACK] Loaded settings - Brightness: %d, Stealth: %s", 
                   currentBrightness, stealthMode ? "ON" : "OFF");
-    Serial.println("[FEEDBACK] FeedbackManager initialization complete");
-    #endif
+    LOG_INFO("[FEEDBACK] FeedbackManager initialization complete");
 }
 
 void FeedbackManager::update() {
+    applyPendingEvents();
     ledController.update();
     buzzerController.update();
 }
 
+void FeedbackManager::registerTasks(Scheduler& scheduler) {
+    taskScheduler = &scheduler;
+    scheduler.addDeadlineTask("feedback",
+        [](void* context) { static_cast<FeedbackManager*>(context)->update(); },
+        [](void* context, unsigned long& deadline) {
+            return static_cast<const FeedbackManager*>(context)->getNextDeadline(deadline);
+        },
+        this, ProfileSlot::FEEDBACK);
+}
+
 void FeedbackManager::setBrightness(uint8_t brightness) {
     currentBrightness = brightness;
     ledController.setBrightness(brightness);
     
     // Automatically save settings
     saveSettings();
+    EventBus::publish(SettingChanged{SettingId::LED_BRIGHTNESS, brightness});
     
-    #ifdef DEBUG
-    Serial.printf("[FEEDBACK] Brightness set to %d and saved\n", brightness);
-    #endif
+    LOG_DEBUG("[FEEDBACK] Brightness set to %d and saved", brightness);
 }
 
 void FeedbackManager::startAnimation(uint8_t pixelIndex, CRGB color, LedAnimation animation, uint16_t interval) {
     ledController.startAnimation(pixelIndex, color, animation, interval);
 }
 
+void FeedbackManager::startAnimation(uint8_t pixelIndex, CRGB color, LedAnimation animation, uint16_t interval,
+                                     uint16_t repeatCount, LedEndAction endAction) {
+    ledController.startAnimation(pixelIndex, color, animation, interval, repeatCount, endAction);
+}
+
+void FeedbackManager::startTimeline(uint8_t pixelIndex, const LedKeyframe* keyframes, uint8_t count,
+                                    uint16_t repeatCount, LedEndAction endAction) {
+    ledController.startTimeline(pixelIndex, keyframes, count, repeatCount, endAction);
+}
+
+bool FeedbackManager::getNextDeadline(unsigned long& deadline) const {
+    if (pendingWifiState.load(std::memory_order_relaxed) != NO_EVENT ||
+        pendingPresence.load(std::memory_order_relaxed) != NO_EVENT ||
+        pendingBrightness.load(std::memory_order_relaxed) >= 0 ||
+        pendingStealth.load(std::memory_order_relaxed) != NO_EVENT) {
+        deadline = millis();
+        return true;
+    }
+
+    // The buzzer is timer driven, so only the LEDs ever need servicing
+    return ledController.getNextDeadline(deadline);
+}
+
 void FeedbackManager::turnOffLeds() {
     ledController.turnOff();
 }
 
+void FeedbackManager::playCue(SoundCue cue) {
+    buzzerController.play(cue);
+}
+
 void FeedbackManager::playSuccess() {
     buzzerController.playSuccess();
 }
@@ -74,19 +113,103 @@ void FeedbackManager::setStealthMode(bool enabled) {
     
     // Automatically save settings
     saveSettings();
+    EventBus::publish(SettingChanged{SettingId::STEALTH_MODE, enabled ? 1u : 0u});
     
-    #ifdef DEBUG
-    Serial.printf("[FEEDBACK] Stealth mode %s and saved\n", enabled ? "enabled" : "disabled");
-    #endif
+    LOG_DEBUG("[FEEDBACK] Stealth mode %s and saved", enabled ? "enabled" : "disabled");
+}
+
+void FeedbackManager::publishSettings() {
+    EventBus::publish(SettingChanged{SettingId::LED_BRIGHTNESS, currentBrightness});
+    EventBus::publish(SettingChanged{SettingId::STEALTH_MODE, stealthMode ? 1u : 0u});
+}
+
+void FeedbackManager::applyPendingEvents() {
+    const int16_t brightness = pendingBrightness.exchange(-1, std::memory_order_relaxed);
+    if (brightness >= 0) {
+        setBrightness(static_cast<uint8_t>(brightness));
+    }
+
+    const uint8_t stealth = pendingStealth.exchange(NO_EVENT, std::memory_order_relaxed);
+    if (stealth != NO_EVENT) {
+        setStealthMode(stealth != 0);
+    }
+
+    const uint8_t wifiState = pendingWifiState.exchange(NO_EVENT, std::memory_order_relaxed);
+    if (wifiState != NO_EVENT) {
+        showWifiState(static_cast<WifiState>(wifiState));
+    }
+
+    const uint8_t presence = pendingPresence.exchange(NO_EVENT, std::memory_order_relaxed);
+    if (presence == 1) {
+        ledController.startAnimation(PIXEL_ACTIVITY, HearthGuardColors::HEARTHGUARD_BLUE, LedAnimation::BLINK,
+                                     BLINK_INTERVAL, 1, LedEndAction::OFF);
+    }
+}
+
+void FeedbackManager::showWifiState(WifiState state) {
+    using namespace HearthGuardColors;
+
+    switch (state) {
+        case WifiState::AP_MODE:
+            ledController.startAnimation(PIXEL_SYSTEM, HEARTHGUARD_BLUE, LedAnimation::PULSE, PULSE_SLOW_INTERVAL);
+            break;
+        case WifiState::CONNECTING:
+            ledController.startAnimation(PIXEL_SYSTEM, HEARTHGUARD_ORANGE, LedAnimation::BLINK, BLINK_FAST_INTERVAL);
+            break;
+        case WifiState::CONNECTED:
+            ledController.startAnimation(PIXEL_SYSTEM, HEARTHGUARD_GREEN, LedAnimation::BLINK, BLINK_INTERVAL,
+                                         RESULT_BLINK_COUNT, LedEndAction::OFF);
+            playSuccess();
+            break;
+        case WifiState::FAILED:
+            ledController.startAnimation(PIXEL_SYSTEM, HEARTHGUARD_RED, LedAnimation::BLINK, BLINK_INTERVAL,
+                                         RESULT_BLINK_COUNT, LedEndAction::OFF);
+            playFailure();
+            break;
+        default:
+            break;
+    }
+}
+
+void FeedbackManager::onWifiStateChanged(void* context, const WifiStateChanged& event) {
+    FeedbackManager* manager = static_cast<FeedbackManager*>(context);
+    manager->pendingWifiState.store(static_cast<uint8_t>(event.state), std::memory_order_relaxed);
+    manager->wake();
+}
+
+void FeedbackManager::onPresenceChanged(void* context, const PresenceChanged& event) {
+    FeedbackManager* manager = static_cast<FeedbackManager*>(context);
+    manager->pendingPresence.store(event.present ? 1 : 0, std::memory_order_relaxed);
+    manager->wake();
+}
+
+void FeedbackManager::onSettingRequested(void* context, const SettingRequested& event) {
+    FeedbackManager* manager = static_cast<FeedbackManager*>(context);
+    switch (event.id) {
+        case SettingId::LED_BRIGHTNESS:
+            manager->pendingBrightness.store(static_cast<int16_t>(event.value > 255 ? 255 : event.value),
+                                             std::memory_order_relaxed);
+            break;
+        case SettingId::STEALTH_MODE:
+            manager->pendingStealth.store(event.value != 0 ? 1 : 0, std::memory_order_relaxed);
+            break;
+        default:
+            return;     // Not a feedback setting
+    }
+    manager->wake();
+}
+
+void FeedbackManager::wake() {
+    if (taskScheduler != nullptr) {
+        taskScheduler->notify();
+    }
 }
 
 void FeedbackManager::loadSettings() {
     bool success = preferences.begin(SETTINGS_NAMESPACE, true); // Read-only mode
     
     if (!success) {
-        #ifdef DEBUG
-        Serial.println("[FEEDBACK] NVS namespace not found, using defaults (normal on first boot)");
-        #endif
+        LOG_DEBUG("[FEEDBACK] NVS namespace not found, using defaults (normal on first boot)");
         // Use default values
         currentBrightness = 255;
         stealthMode = false;
@@ -103,19 +226,15 @@ void FeedbackManager::loadSettings() {
     
     preferences.end();
     
-    #ifdef DEBUG
-    Serial.printf("[FEEDBACK] Settings loaded - Brightness: %d, Stealth: %s (FORCED OFF)\n", 
+    LOG_DEBUG("[FEEDBACK] Settings loaded - Brightness: %d, Stealth: %s (FORCED OFF)", 
                   currentBrightness, stealthMode ? "ON" : "OFF");
-    #endif
 }
 
 void FeedbackManager::saveSettings() {
     bool success = preferences.begin(SETTINGS_NAMESPACE, false); // Read-write mode
     
     if (!success) {
-        #ifdef DEBUG
-        Serial.println("[FEEDBACK] Failed to open NVS for writing");
-        #endif
+        LOG_ERROR("[FEEDBACK] Failed to open NVS for writing");
         return;
     }
     
@@ -124,7 +243,5 @@ void FeedbackManager::saveSettings() {
     
     preferences.end();
     
-    #ifdef DEBUG
-    Serial.println("[FEEDBACK] Settings saved to NVS");
-    #endif
+    LOG_DEBUG("[FEEDBACK] Settings saved to NVS");
 }
@@ -1,23 +1,34 @@
 #include "feedback/LedController.h"
+#include "feedback/BreathTable.h"
 #include "config/Pins.h"
+#include "utilities/Logger.h"
+
+namespace {
+
+/**
+ * @brief True once a millis() deadline has been reached (wrap-safe)
+ */
+inline bool isDue(unsigned long currentTime, unsigned long deadline) {
+    return static_cast<long>(currentTime - deadline) >= 0;
+}
+
+} // namespace
 
 // Constructor - no hardware initialization per PRD
 LedController::LedController() : ledsInitialized(false) {
     // Initialize all pixels to BLACK
     for (int i = 0; i < LED_COUNT; i++) {
         leds[i] = CRGB::Black;
+        pushed[i] = CRGB::Black;
     }
 }
 
 void LedController::begin() {
     if (ledsInitialized) return;
     
-    #ifdef DEBUG
-    Serial.println("[LED] === FastLED INITIALIZATION (PRD Compliant) ===");
-    Serial.printf("[LED] System LED on pin %d, Activity LED on pin %d\n", SYSTEM_LED_PIN, ACTIVITY_LED_PIN);
-    Serial.println("[LED] Using single CRGB array with dual addLeds calls");
-    Serial.flush();
-    #endif
+    LOG_DEBUG("[LED] === LED INITIALIZATION (PRD Compliant) ===");
+    LOG_DEBUG("[LED] System LED on pin %d, Activity LED on pin %d", SYSTEM_LED_PIN, ACTIVITY_LED_PIN);
+    LOG_DEBUG("[LED] Using single CRGB array with one RMT strand per pin");
     
     // **CRITICAL**: Aggressive GPIO setup to prevent white LED on boot
     pinMode(SYSTEM_LED_PIN, OUTPUT);
@@ -26,86 +37,148 @@ void LedController::begin() {
     digitalWrite(ACTIVITY_LED_PIN, LOW);
     delay(100); // Hold LEDs off
     
-    #ifdef DEBUG
-    Serial.println("[LED] GPIO pins set LOW and held for 100ms");
-    Serial.flush();
-    #endif
-
-    // **PRD REQUIREMENT**: Initialize FastLED with single CRGB array and two addLeds calls
-    FastLED.addLeds<WS2812B, SYSTEM_LED_PIN, GRB>(leds, 0, 1);      // System LED at index 0
-    FastLED.addLeds<WS2812B, ACTIVITY_LED_PIN, GRB>(leds, 1, 1);    // Activity LED at index 1
+    LOG_DEBUG("[LED] GPIO pins set LOW and held for 100ms");
+
+    // **PRD REQUIREMENT**: Single CRGB array, one output per data pin (RMT instead of
+    // FastLED.addLeds so frames are sent in the background, both pins in parallel)
+    if (!rmtDriver.addStrand(SYSTEM_LED_PIN, leds, 0, 1) ||        // System LED at index 0
+        !rmtDriver.addStrand(ACTIVITY_LED_PIN, leds, 1, 1)) {      // Activity LED at index 1
+        LOG_ERROR("[LED] Error: RMT output configuration failed");
+        return;
+    }
     
-    #ifdef DEBUG
-    Serial.println("[LED] FastLED configured with dual addLeds calls");
-    Serial.flush();
-    #endif
+    LOG_DEBUG("[LED] RMT output configured for both LED pins");
     
-    // Set initial brightness and ensure all LEDs are off
-    FastLED.setBrightness(globalBrightness);
-    FastLED.clear();
-    FastLED.show();
+    // Ensure all LEDs are off
+    fill_solid(leds, LED_COUNT, CRGB::Black);
+    updatePushedOutput();
+    rmtDriver.show(globalBrightness);
     
-    #ifdef DEBUG
-    Serial.println("[LED] FastLED initialization complete - LEDs should be OFF");
-    Serial.flush();
-    #endif
+    LOG_DEBUG("[LED] LED output initialization complete - LEDs should be OFF");
     
     // Initialize pixel states
     for (int i = 0; i < LED_COUNT; i++) {
-        pixelStates[i].animation = LedAnimation::SOLID;
-        pixelStates[i].baseColor = CRGB::Black;
-        pixelStates[i].interval = 0;
-        pixelStates[i].lastUpdate = 0;
-        pixelStates[i].isOn = false;
-        pixelStates[i].pulsePhase = 0;
+        pixelStates[i] = PixelState();
+        previousStates[i] = PixelState();
     }
     
     ledsInitialized = true;
     
-    #ifdef DEBUG
-    Serial.println("[LED] LED Controller ready - LEDs should be OFF");
-    Serial.flush();
-    #endif
+    LOG_INFO("[LED] LED Controller ready - LEDs should be OFF");
 }
 
 void LedController::update() {
-    if (!ledsInitialized || stealthMode) {
+    if (!ledsInitialized) {
         return;
     }
     
-    // Update animations for both pixels
-    updatePixelAnimation(PIXEL_SYSTEM);
-    updatePixelAnimation(PIXEL_ACTIVITY);
+    // Update animations for pixels whose deadline has arrived
+    if (!stealthMode) {
+        unsigned long currentTime = millis();
+        for (uint8_t i = 0; i < LED_COUNT; i++) {
+            if (pixelStates[i].active && isDue(currentTime, pixelStates[i].nextDeadline)) {
+                updatePixelAnimation(i, currentTime);
+            }
+        }
+    }
+
+    // Push all changes made since the last frame in a single show()
+    renderFrame();
+}
+
+bool LedController::getPixelDeadline(uint8_t pixelIndex, unsigned long& deadline) const {
+    if (!ledsInitialized || stealthMode || pixelIndex >= LED_COUNT || !pixelStates[pixelIndex].active) {
+        return false;
+    }
+
+    deadline = pixelStates[pixelIndex].nextDeadline;
+    return true;
+}
+
+bool LedController::getNextDeadline(unsigned long& deadline) const {
+    bool pending = false;
+
+    // A dirty frame is due at the next frame slot
+    if (ledsInitialized && frameDirty) {
+        deadline = lastFrameTime + frameInterval;
+        pending = true;
+    }
+
+    for (uint8_t i = 0; i < LED_COUNT; i++) {
+        unsigned long pixelDeadline;
+        if (getPixelDeadline(i, pixelDeadline) &&
+            (!pending || static_cast<long>(pixelDeadline - deadline) < 0)) {
+            deadline = pixelDeadline;
+            pending = true;
+        }
+    }
+
+    return pending;
+}
+
+void LedController::setFrameInterval(uint16_t intervalMs) {
+    frameInterval = intervalMs;
+}
+
+void LedController::renderFrame() {
+    unsigned long currentTime = millis();
+    if (currentTime - lastFrameTime < frameInterval) {
+        return;
+    }
+
+    // Previous frame still on the wire - keep the slot and retry next update
+    if (frameDirty && rmtDriver.isBusy()) {
+        return;
+    }
+    lastFrameTime = currentTime;
+
+    if (!frameDirty) {
+        framesSkipped++;
+        return;
+    }
+    frameDirty = false;
+
+    // Writes that quantise to the bytes already on the wire need no frame
+    if (!updatePushedOutput()) {
+        framesSkipped++;
+        framesUnchanged++;
+        return;
+    }
+
+    // Non-blocking: the RMT channels transmit while we return to the loop
+    rmtDriver.show(globalBrightness);
+    framesPushed++;
+}
+
+bool LedController::updatePushedOutput() {
+    bool changed = false;
+    for (uint8_t i = 0; i < LED_COUNT; i++) {
+        // Same scaling as Ws2812RmtDriver::encodeStrand()
+        CRGB output = leds[i];
+        output.nscale8(globalBrightness);
+        if (output != pushed[i]) {
+            pushed[i] = output;
+            changed = true;
+        }
+    }
+    return changed;
 }
 
 void LedController::setBrightness(uint8_t brightness) {
     globalBrightness = brightness;
     
     if (ledsInitialized) {
-        FastLED.setBrightness(brightness);
-        
-        // Reapply current colors with new brightness
-        for (int i = 0; i < LED_COUNT; i++) {
-            if (pixelStates[i].isOn || pixelStates[i].animation != LedAnimation::SOLID) {
-                updatePixelAnimation(i);
-            }
-        }
-        FastLED.show();
+        // Global brightness is applied while the next frame is encoded
+        frameDirty = true;
     }
     
-    #ifdef DEBUG
-    Serial.printf("[LED] Brightness set to %d\n", brightness);
-    Serial.flush();
-    #endif
+    LOG_DEBUG("[LED] Brightness set to %d", brightness);
 }
 
 void LedController::setStealthMode(bool enabled) {
     stealthMode = enabled;
     
-    #ifdef DEBUG
-    Serial.printf("[LED] Stealth mode %s\n", enabled ? "ENABLED" : "DISABLED");
-    Serial.flush();
-    #endif
+    LOG_DEBUG("[LED] Stealth mode %s", enabled ? "ENABLED" : "DISABLED");
     
     if (enabled) {
         turnOff();
@@ -113,46 +186,92 @@ void LedController::setStealthMode(bool enabled) {
 }
 
 void LedController::startAnimation(uint8_t pixelIndex, CRGB color, LedAnimation animation, uint16_t interval) {
+    startAnimation(pixelIndex, color, animation, interval, 0, LedEndAction::HOLD);
+}
+
+void LedController::startAnimation(uint8_t pixelIndex, CRGB color, LedAnimation animation, uint16_t interval,
+                                   uint16_t repeatCount, LedEndAction endAction) {
     if (!ledsInitialized || stealthMode || pixelIndex >= LED_COUNT) {
-        #ifdef DEBUG
-        if (!ledsInitialized) Serial.println("[LED] Error: LEDs not initialized");
-        if (stealthMode) Serial.println("[LED] Stealth mode active, ignoring animation");
-        if (pixelIndex >= LED_COUNT) Serial.printf("[LED] Error: Invalid pixel index %d\n", pixelIndex);
-        Serial.flush();
-        #endif
+        if (!ledsInitialized) LOG_ERROR("[LED] Error: LEDs not initialized");
+        if (stealthMode) LOG_DEBUG("[LED] Stealth mode active, ignoring animation");
+        if (pixelIndex >= LED_COUNT) LOG_ERROR("[LED] Error: Invalid pixel index %d", pixelIndex);
         return;
     }
     
-    #ifdef DEBUG
-    const char* animationName = 
-        (animation == LedAnimation::SOLID) ? "SOLID" :
-        (animation == LedAnimation::BLINK) ? "BLINK" : "PULSE";
-    
-    Serial.printf("[LED] Pixel %d: %s animation, CRGB(%d,%d,%d), interval=%dms\n", 
-                  pixelIndex, animationName, color.r, color.g, color.b, interval);
-    Serial.flush();
-    #endif
-    
-    PixelState& state = pixelStates[pixelIndex];
-    state.animation = animation;
-    state.baseColor = color;
-    state.interval = interval;
-    state.lastUpdate = 0; // Force immediate update
-    state.isOn = true;
-    state.pulsePhase = 0;
+    LOG_DEBUG("[LED] Pixel %d: %s animation, CRGB(%d,%d,%d), interval=%dms, repeats=%d",
+              pixelIndex,
+              (animation == LedAnimation::SOLID) ? "SOLID" :
+              (animation == LedAnimation::BLINK) ? "BLINK" : "PULSE",
+              color.r, color.g, color.b, interval, repeatCount);
     
-    // Apply initial color immediately
+    // A zero-length blink or breath is just a solid color
+    if (interval == 0) {
+        animation = LedAnimation::SOLID;
+    }
+
+    // Express the animation as a built-in timeline
+    LedKeyframe keyframes[2];
+    uint8_t count = 0;
+
     switch (animation) {
         case LedAnimation::SOLID:
-            applyPixelColor(pixelIndex, color);
+            keyframes[count++] = { color, 0, LedEasing::STEP };
+            repeatCount = 1;
             break;
         case LedAnimation::BLINK:
-            applyPixelColor(pixelIndex, color); // Start with color on
+            keyframes[count++] = { color, interval, LedEasing::STEP };   // Start with color on
+            keyframes[count++] = { CRGB::Black, interval, LedEasing::STEP };
             break;
         case LedAnimation::PULSE:
-            applyPixelColor(pixelIndex, color); // Start at full brightness
+            keyframes[count++] = { color, interval, LedEasing::BREATHE };
             break;
     }
+
+    loadTimeline(pixelIndex, keyframes, count, repeatCount, endAction);
+}
+
+void LedController::startTimeline(uint8_t pixelIndex, const LedKeyframe* keyframes, uint8_t count,
+                                  uint16_t repeatCount, LedEndAction endAction) {
+    if (!ledsInitialized || stealthMode || pixelIndex >= LED_COUNT ||
+        keyframes == nullptr || count == 0 || count > MAX_KEYFRAMES) {
+        LOG_ERROR("[LED] Error: Rejected timeline for pixel %d (%d keyframes)", pixelIndex, count);
+        return;
+    }
+
+    loadTimeline(pixelIndex, keyframes, count, repeatCount, endAction);
+}
+
+void LedController::loadTimeline(uint8_t pixelIndex, const LedKeyframe* keyframes, uint8_t count,
+                                 uint16_t repeatCount, LedEndAction endAction) {
+    PixelState& state = pixelStates[pixelIndex];
+
+    // Remember the running pattern so a finite timeline can hand back to it,
+    // unless we are interrupting another reverting timeline (keep the original)
+    if (endAction == LedEndAction::REVERT &&
+        !(state.active && state.repeatCount > 0 && state.endAction == LedEndAction::REVERT)) {
+        previousStates[pixelIndex] = state;
+    }
+
+    uint32_t cycleDuration = 0;
+    for (uint8_t i = 0; i < count; i++) {
+        state.frames[i] = keyframes[i];
+        // One reciprocal per keyframe; each step is then a multiply and a shift
+        state.frameRates[i] = (keyframes[i].duration > 0) ? (1UL << 24) / keyframes[i].duration : 0;
+        cycleDuration += keyframes[i].duration;
+    }
+
+    state.cycleDuration = cycleDuration;
+    state.frameCount = count;
+    state.frameIndex = 0;
+    state.repeatCount = (cycleDuration == 0) ? 1 : repeatCount;  // Never loop forever on zero time
+    state.cyclesDone = 0;
+    state.endAction = endAction;
+    state.fromColor = state.outputColor;
+    state.frameStart = millis();
+    state.active = true;
+
+    // Render the first keyframe immediately
+    updatePixelAnimation(pixelIndex, state.frameStart);
 }
 
 void LedController::turnOff(uint8_t pixelIndex) {
@@ -160,19 +279,13 @@ void LedController::turnOff(uint8_t pixelIndex) {
         return;
     }
     
-    #ifdef DEBUG
-    Serial.printf("[LED] Turning off pixel %d\n", pixelIndex);
-    Serial.flush();
-    #endif
+    LOG_DEBUG("[LED] Turning off pixel %d", pixelIndex);
     
     // Clear pixel state
-    pixelStates[pixelIndex].animation = LedAnimation::SOLID;
-    pixelStates[pixelIndex].baseColor = CRGB::Black;
-    pixelStates[pixelIndex].isOn = false;
-    pixelStates[pixelIndex].lastUpdate = 0;
-    pixelStates[pixelIndex].pulsePhase = 0;
+    pixelStates[pixelIndex] = PixelState();
+    previousStates[pixelIndex] = PixelState();
     
-    // Turn off hardware
+    // Turn off hardware on the next frame
     applyPixelColor(pixelIndex, CRGB::Black);
 }
 
@@ -181,73 +294,119 @@ void LedController::turnOff() {
         return;
     }
     
-    #ifdef DEBUG
-    Serial.println("[LED] Turning off all LEDs");
-    Serial.flush();
-    #endif
+    LOG_DEBUG("[LED] Turning off all LEDs");
     
     // Clear all pixel states
     for (int i = 0; i < LED_COUNT; i++) {
-        pixelStates[i].animation = LedAnimation::SOLID;
-        pixelStates[i].baseColor = CRGB::Black;
-        pixelStates[i].isOn = false;
-        pixelStates[i].lastUpdate = 0;
-        pixelStates[i].pulsePhase = 0;
+        pixelStates[i] = PixelState();
+        previousStates[i] = PixelState();
     }
     
-    // Turn off hardware
-    FastLED.clear();
-    FastLED.show();
+    // Turn off hardware on the next frame
+    fill_solid(leds, LED_COUNT, CRGB::Black);
+    frameDirty = true;
 }
 
-void LedController::updatePixelAnimation(uint8_t pixelIndex) {
+void LedController::updatePixelAnimation(uint8_t pixelIndex, unsigned long currentTime) {
     if (pixelIndex >= LED_COUNT) {
         return;
     }
     
     PixelState& state = pixelStates[pixelIndex];
-    unsigned long currentTime = millis();
-    
-    switch (state.animation) {
-        case LedAnimation::SOLID:
-            // Static color - only update once
-            if (state.lastUpdate == 0) {
-                applyPixelColor(pixelIndex, state.baseColor);
-                state.lastUpdate = currentTime;
+    if (!state.active) {
+        return;
+    }
+
+    // After a long stall, drop whole cycles of an endless timeline at once
+    if (state.repeatCount == 0 && state.frameIndex == 0 &&
+        currentTime - state.frameStart >= state.cycleDuration) {
+        state.frameStart += ((currentTime - state.frameStart) / state.cycleDuration) * state.cycleDuration;
+    }
+
+    // Step over every keyframe that has already finished
+    while (currentTime - state.frameStart >= state.frames[state.frameIndex].duration) {
+        const LedKeyframe& finished = state.frames[state.frameIndex];
+        state.fromColor = keyframeEndColor(finished);
+        state.frameStart += finished.duration;
+
+        if (++state.frameIndex == state.frameCount) {
+            state.frameIndex = 0;
+            state.cyclesDone++;
+
+            if (state.repeatCount > 0 && state.cyclesDone >= state.repeatCount) {
+                finishTimeline(pixelIndex, currentTime);
+                return;
             }
+        }
+    }
+
+    // Render the current keyframe
+    const LedKeyframe& frame = state.frames[state.frameIndex];
+    const uint32_t elapsed = currentTime - state.frameStart;
+    const uint16_t phase = static_cast<uint16_t>((elapsed * state.frameRates[state.frameIndex]) >> 8);
+    unsigned long deadline = state.frameStart + frame.duration;
+
+    switch (frame.easing) {
+        case LedEasing::STEP:
+            state.outputColor = frame.color;
             break;
-            
-        case LedAnimation::BLINK:
-            if (currentTime - state.lastUpdate >= state.interval) {
-                state.isOn = !state.isOn;
-                state.lastUpdate = currentTime;
-                
-                if (state.isOn) {
-                    applyPixelColor(pixelIndex, state.baseColor);
-                } else {
-                    applyPixelColor(pixelIndex, CRGB::Black);
-                }
-            }
+
+        case LedEasing::LINEAR:
+            state.outputColor = blend(state.fromColor, frame.color, phase >> 8);
             break;
-            
-        case LedAnimation::PULSE:
-            if (currentTime - state.lastUpdate >= FADE_STEP_MS) {
-                // Sine wave breathing effect
-                uint8_t brightness = sineWave(state.pulsePhase);
-                CRGB scaledColor = scaleColor(state.baseColor, brightness);
-                
-                applyPixelColor(pixelIndex, scaledColor);
-                
-                // Advance phase based on interval
-                uint8_t phaseIncrement = (255 * FADE_STEP_MS) / state.interval;
-                state.pulsePhase = (state.pulsePhase + phaseIncrement) % 255;
-                
-                state.lastUpdate = currentTime;
+
+        case LedEasing::BREATHE:
+            // Gamma-corrected breathing effect
+            state.outputColor = scaleColor(frame.color, breathLevel(phase));
+            break;
+    }
+
+    // Eased keyframes need a fresh color every fade step
+    if (frame.easing != LedEasing::STEP && static_cast<long>(deadline - (currentTime + FADE_STEP_MS)) > 0) {
+        deadline = currentTime + FADE_STEP_MS;
+    }
+    state.nextDeadline = deadline;
+
+    applyPixelColor(pixelIndex, state.outputColor);
+}
+
+void LedController::finishTimeline(uint8_t pixelIndex, unsigned long currentTime) {
+    PixelState& state = pixelStates[pixelIndex];
+
+    switch (state.endAction) {
+        case LedEndAction::HOLD:
+            state.outputColor = state.fromColor;
+            state.active = false;
+            applyPixelColor(pixelIndex, state.outputColor);
+            break;
+
+        case LedEndAction::OFF:
+            state = PixelState();
+            applyPixelColor(pixelIndex, CRGB::Black);
+            break;
+
+        case LedEndAction::REVERT:
+            state = previousStates[pixelIndex];
+            previousStates[pixelIndex] = PixelState();
+
+            if (state.active) {
+                // Restart the previous pattern from its first keyframe
+                state.frameIndex = 0;
+                state.cyclesDone = 0;
+                state.frameStart = currentTime;
+                updatePixelAnimation(pixelIndex, currentTime);
+            } else {
+                applyPixelColor(pixelIndex, state.outputColor);
             }
             break;
     }
 }
 
+CRGB LedController::keyframeEndColor(const LedKeyframe& frame) {
+    // A breath ends dark; STEP and LINEAR end on the keyframe color
+    return (frame.easing == LedEasing::BREATHE) ? CRGB(CRGB::Black) : frame.color;
+}
+
 void LedController::applyPixelColor(uint8_t pixelIndex, CRGB color) {
     if (!ledsInitialized || pixelIndex >= LED_COUNT) {
         return;
@@ -257,38 +416,18 @@ void LedController::applyPixelColor(uint8_t pixelIndex, CRGB color) {
         color = CRGB::Black;  // Black in stealth mode
     }
     
-    // Apply to LED array
-    leds[pixelIndex] = color;
-    FastLED.show();
+    // Apply to LED array; the frame is pushed by renderFrame()
+    if (leds[pixelIndex] != color) {
+        leds[pixelIndex] = color;
+        frameDirty = true;
+    }
 }
 
 CRGB LedController::scaleColor(CRGB color, uint8_t brightness) {
-    return CRGB(
-        (color.r * brightness) / 255,
-        (color.g * brightness) / 255,
-        (color.b * brightness) / 255
-    );
+    // nscale8: (channel * (1 + brightness)) >> 8, exact at 0 and 255
+    return color.nscale8(brightness);
 }
 
-uint8_t LedController::sineWave(uint8_t phase) {
-    // Proper sine wave approximation for smooth breathing
-    // Creates a natural 0→peak→0→0→peak breathing pattern
-    
-    // Use a lookup table approach for smoother transitions
-    // This creates a breathing effect with a longer pause at the bottom
-    if (phase < 85) {
-        // Rising phase: 0 to peak (0-255)
-        // Use quadratic easing for smooth acceleration
-        uint16_t scaled = (phase * 3);  // 0-255 range
-        return scaled;
-    } else if (phase < 170) {
-        // Falling phase: peak to 0 (255-0)  
-        uint8_t fallPhase = phase - 85;
-        uint16_t scaled = 255 - (fallPhase * 3);
-        return scaled;
-    } else {
-        // Bottom pause: stay at minimum brightness
-        // This creates the natural "pause" in breathing
-        return 0;
-    }
+uint8_t LedController::breathLevel(uint16_t phase) {
+    return BreathTable::LEVELS.values[phase >> 8];
 }
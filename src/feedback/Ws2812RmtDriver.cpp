@@ -0,0 +1,105 @@
+#include "feedback/Ws2812RmtDriver.h"
+
+bool Ws2812RmtDriver::addStrand(uint8_t pin, const CRGB* pixels, uint8_t offset, uint8_t count) {
+    if (strandCount >= MAX_STRANDS || pixels == nullptr || count == 0 || count > MAX_PIXELS_PER_STRAND) {
+        return false;
+    }
+
+    // Strand N uses RMT TX channel N
+    const rmt_channel_t channel = static_cast<rmt_channel_t>(strandCount);
+
+    rmt_config_t config = {};
+    config.rmt_mode = RMT_MODE_TX;
+    config.channel = channel;
+    config.gpio_num = static_cast<gpio_num_t>(pin);
+    config.clk_div = RMT_CLOCK_DIVIDER;
+    config.mem_block_num = 1;
+    config.tx_config.carrier_en = false;
+    config.tx_config.loop_en = false;
+    config.tx_config.idle_output_en = true;             // Hold the line low between frames (latch)
+    config.tx_config.idle_level = RMT_IDLE_LEVEL_LOW;
+
+    if (rmt_config(&config) != ESP_OK) {
+        return false;
+    }
+
+    if (rmt_driver_install(channel, 0, 0) != ESP_OK) {
+        return false;
+    }
+
+    // One TX-end hook serves every channel
+    if (strandCount == 0) {
+        rmt_register_tx_end_callback(&Ws2812RmtDriver::onTransmitDone, this);
+    }
+
+    Strand& strand = strands[strandCount];
+    strand.channel = channel;
+    strand.pixels = pixels + offset;
+    strand.count = count;
+    strandCount++;
+
+    return true;
+}
+
+bool Ws2812RmtDriver::show(uint8_t brightness) {
+    if (strandCount == 0 || isBusy()) {
+        return false;
+    }
+
+    // Encode every strand first so the channels start back to back
+    for (uint8_t i = 0; i < strandCount; i++) {
+        encodeStrand(strands[i], brightness);
+    }
+
+    busyMask.store(static_cast<uint8_t>((1u << strandCount) - 1), std::memory_order_release);
+
+    for (uint8_t i = 0; i < strandCount; i++) {
+        Strand& strand = strands[i];
+        if (rmt_write_items(strand.channel, strand.items, strand.count * BITS_PER_PIXEL, false) != ESP_OK) {
+            // Atomic: the TX-end ISR may be clearing another strand's bit right now
+            busyMask.fetch_and(static_cast<uint8_t>(~(1u << i)), std::memory_order_acq_rel);
+        }
+    }
+
+    return true;
+}
+
+void Ws2812RmtDriver::setCompletionCallback(CompletionCallback callback, void* context) {
+    completionCallback = callback;
+    completionContext = context;
+}
+
+void Ws2812RmtDriver::encodeStrand(Strand& strand, uint8_t brightness) {
+    rmt_item32_t* item = strand.items;
+
+    for (uint8_t p = 0; p < strand.count; p++) {
+        CRGB pixel = strand.pixels[p];
+        pixel.nscale8(brightness);
+
+        // WS2812B expects GRB, most significant bit first
+        const uint32_t grb = (static_cast<uint32_t>(pixel.g) << 16) |
+                             (static_cast<uint32_t>(pixel.r) << 8) |
+                             pixel.b;
+
+        for (int8_t bit = BITS_PER_PIXEL - 1; bit >= 0; bit--) {
+            const bool one = (grb >> bit) & 1u;
+            item->level0 = 1;
+            item->duration0 = one ? T1H_TICKS : T0H_TICKS;
+            item->level1 = 0;
+            item->duration1 = one ? T1L_TICKS : T0L_TICKS;
+            item++;
+        }
+    }
+}
+
+void IRAM_ATTR Ws2812RmtDriver::onTransmitDone(rmt_channel_t channel, void* arg) {
+    Ws2812RmtDriver* driver = static_cast<Ws2812RmtDriver*>(arg);
+
+    const uint8_t bit = static_cast<uint8_t>(1u << channel);
+    const uint8_t previous = driver->busyMask.fetch_and(static_cast<uint8_t>(~bit), std::memory_order_acq_rel);
+
+    // Only the strand that clears the last bit reports the frame
+    if (previous == bit && driver->completionCallback != nullptr) {
+        driver->completionCallback(driver->completionContext);
+    }
+}
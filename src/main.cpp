@@ -11,7 +11,12 @@
 #include "network/WifiHandler.h"
 #include "setup/DeviceManager.h"
 #include "sensors/SensorManager.h"
+#include "utilities/EventBus.h"
 #include "utilities/MqttHandler.h"
+#include "utilities/Scheduler.h"
+#include "utilities/LoopProfiler.h"
+#include "utilities/Logger.h"
+#include "utilities/SleepManager.h"
 
 // Include color constants and pixel definitions for demo
 #include "feedback/LedController.h"
@@ -28,6 +33,202 @@ WifiHandler wifiHandler;
 DeviceManager deviceManager;
 SensorManager sensorManager;
 MqttHandler mqttHandler;
+SleepManager sleepManager;
+
+// Schedulers - one per FreeRTOS task
+Scheduler scheduler;            // Arduino loop task: feedback, device, demo
+Scheduler sensorScheduler;      // Sensor task: PIR, radar, power
+Scheduler networkScheduler;     // Network task: WiFi, MQTT
+
+// Per-manager update() timing, shared by all schedulers
+LoopProfiler profiler;
+
+// Generation of the last aggregates handed to MQTT (network task)
+static uint32_t publishedAggregates = 0;
+
+// Loop profile JSON document (5 managers at ~80 bytes each)
+static constexpr size_t PROFILE_JSON_SIZE = 512;
+
+// Statically allocated task stacks (ESP-IDF stack sizes are in bytes)
+static StackType_t sensorTaskStack[SENSOR_TASK_STACK_SIZE];
+static StaticTask_t sensorTaskBuffer;
+static StackType_t networkTaskStack[NETWORK_TASK_STACK_SIZE];
+static StaticTask_t networkTaskBuffer;
+
+// Phase 1 Demo timing (ms)
+static constexpr uint32_t DEMO_START_DELAY = 3000;
+static constexpr uint32_t DEMO_STEP_INTERVAL = 5000;
+
+/**
+ * @brief Phase 1 Demo: LED and Buzzer Test Sequence (scheduler task)
+ */
+static void runDemoStep(void* context) {
+    static int demoStep = 0;
+
+    switch (demoStep) {
+        case 0:
+            LOG_DEBUG("[DEMO] Starting LED system status (green pulse)");
+            feedbackManager.startAnimation(PIXEL_SYSTEM, HearthGuardColors::HEARTHGUARD_GREEN, 
+                                         LedAnimation::PULSE, 2000);
+            feedbackManager.playConfirm();
+            break;
+        case 1:
+            LOG_DEBUG("[DEMO] Starting LED activity status (blue blink)");
+            feedbackManager.startAnimation(PIXEL_ACTIVITY, HearthGuardColors::HEARTHGUARD_BLUE, 
+                                         LedAnimation::BLINK, 500);
+            feedbackManager.playInteraction();
+            break;
+        case 2:
+            LOG_DEBUG("[DEMO] Playing success sound and solid orange LED");
+            feedbackManager.startAnimation(PIXEL_SYSTEM, HearthGuardColors::HEARTHGUARD_ORANGE, 
+                                         LedAnimation::SOLID, 0);
+            feedbackManager.playSuccess();
+            break;
+        case 3:
+            LOG_DEBUG("[DEMO] Playing failure sound and red LED");
+            feedbackManager.startAnimation(PIXEL_ACTIVITY, HearthGuardColors::HEARTHGUARD_RED, 
+                                         LedAnimation::SOLID, 0);
+            feedbackManager.playFailure();
+            break;
+        case 4:
+            LOG_DEBUG("[DEMO] Turning off all LEDs");
+            feedbackManager.turnOffLeds();
+            demoStep = -1; // Will become 0 after increment
+            break;
+    }
+    demoStep++;
+}
+
+/**
+ * @brief Serial console: 'p' prints the loop profile, 'r' resets it,
+ *        's' prints sleep statistics, 'e' toggles radar engineering mode,
+ *        'g' streams the radar gate log, 't' toggles sensor trace
+ *        recording, 'd' dumps the trace, 'b' prints event bus statistics
+ *        (scheduler task)
+ */
+static void pollConsole(void* context) {
+    static bool engineeringMode = false;
+
+    while (Serial.available() > 0) {
+        switch (Serial.read()) {
+            case 'p':
+                profiler.printReport();
+                break;
+            case 'r':
+                profiler.reset();
+                Serial.println("[PROFILE] Reset");
+                break;
+            case 's':
+                sleepManager.printStats();
+                break;
+            case 'e':
+                engineeringMode = !engineeringMode;
+                sensorManager.requestEngineeringMode(engineeringMode);
+                break;
+            case 'g':
+                sensorManager.requestGateStream();
+                break;
+            case 't': {
+                TraceRecorder& trace = sensorManager.getTraceRecorder();
+                trace.setEnabled(!trace.isEnabled());
+                break;
+            }
+            case 'd':
+                sensorManager.getTraceRecorder().dump();
+                break;
+            case 'b':
+                EventBus::printStats();
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+/**
+ * @brief High-priority acquisition task, pinned away from the WiFi stack
+ */
+static void sensorTask(void* context) {
+    sensorScheduler.begin();
+    sensorScheduler.setProfiler(profiler);
+    sensorManager.registerTasks(sensorScheduler);
+
+    for (;;) {
+        sensorScheduler.run();
+    }
+}
+
+/**
+ * @brief Switch between battery and external-power operation (network task)
+ * @param externalPower true while POWER_GOOD reports external power
+ */
+static void applyPowerSource(bool externalPower) {
+    sleepManager.setBatteryMode(!externalPower);
+    wifiHandler.setPowerSave(!externalPower);
+    mqttHandler.setAggregateOnly(AGGREGATE_ONLY_ON_BATTERY && !externalPower);
+}
+
+/**
+ * @brief Network task: WiFi supervision, MQTT and sensor event publishing
+ */
+static void networkTask(void* context) {
+    networkScheduler.begin();
+    networkScheduler.setProfiler(profiler);
+    wifiHandler.registerTasks(networkScheduler);
+    mqttHandler.registerTasks(networkScheduler);
+
+    // Power mode changes are owned by this task, starting from the boot reading
+    PowerData power;
+    sensorManager.getPowerSnapshot().read(power);
+    applyPowerSource(power.usbPowerConnected);
+    mqttHandler.setPowerState(power);
+
+    // Drain sensor events as soon as the sensor task signals them
+    networkScheduler.addDeadlineTask("events",
+        [](void* context) {
+            SensorEvent event;
+            while (sensorManager.popEvent(event)) {
+                mqttHandler.handleSensorEvent(event);
+
+                if (event.type == SensorEventType::POWER_SOURCE) {
+                    applyPowerSource(event.active);
+                }
+                if (event.triggerMicros != 0) {
+                    sleepManager.recordWakeLatency(static_cast<uint32_t>(esp_timer_get_time()) - event.triggerMicros);
+                }
+            }
+        },
+        [](void* context, unsigned long& deadline) {
+            deadline = millis();
+            return sensorManager.hasPendingEvents();
+        },
+        nullptr);
+
+    // Rolling aggregates, once per closed minute (the sensor task notifies us)
+    networkScheduler.addDeadlineTask("aggregates",
+        [](void* context) {
+            SensorAggregates aggregates;
+            publishedAggregates = sensorManager.getAggregateSnapshot().read(aggregates);
+            mqttHandler.publishAggregates(aggregates);
+        },
+        [](void* context, unsigned long& deadline) {
+            deadline = millis();
+            return sensorManager.getAggregateSnapshot().changedSince(publishedAggregates);
+        },
+        nullptr);
+
+    // Periodic loop profile for remote diagnostics
+    networkScheduler.addTask("profile", [](void* context) {
+        char payload[PROFILE_JSON_SIZE];
+        if (profiler.formatJson(payload, sizeof(payload)) > 0) {
+            mqttHandler.publishDiagnostics(payload);
+        }
+    }, nullptr, PROFILE_PUBLISH_INTERVAL, PROFILE_PUBLISH_INTERVAL);
+
+    for (;;) {
+        networkScheduler.run();
+    }
+}
 
 void setup() {
     // Initialize LED pins as outputs and ensure they're OFF
@@ -45,16 +246,16 @@ void setup() {
     delay(1000); 
     while (!Serial); 
     
-    #ifdef DEBUG
-    Serial.println("=====================================");
-    Serial.println("    HearthGuard: The Scout v1.0     ");
-    Serial.println("   Medieval Themed IoT HearthGuard   ");
-    Serial.println("=====================================");
-    Serial.printf("Device: %s v%s\n", DEVICE_NAME, FIRMWARE_VERSION);
-    Serial.printf("Build: %s %s\n", __DATE__, __TIME__);
-    Serial.println("=====================================");
-    Serial.println();
-    #endif
+    // Deferred logging: records are printed by a low-priority task from here on
+    Logger::begin();
+
+    LOG_INFO("=====================================");
+    LOG_INFO("    HearthGuard: The Scout v1.0     ");
+    LOG_INFO("   Medieval Themed IoT HearthGuard   ");
+    LOG_INFO("=====================================");
+    LOG_INFO("Device: %s v%s", DEVICE_NAME, FIRMWARE_VERSION);
+    LOG_INFO("Build: %s %s", __DATE__, __TIME__);
+    LOG_INFO("=====================================");
     
     currentState = SystemState::BOOTING;
     lastStateChange = millis();
@@ -67,10 +268,7 @@ void loop() {
         case SystemState::BOOTING:
             // Initialize after brief delay to ensure stable boot
             if (currentTime - bootStartTime > 1000 && !managersInitialized) {
-                #ifdef DEBUG
-                Serial.println("[BOOT] Initializing all subsystems...");
-                Serial.flush();
-                #endif
+                LOG_INFO("[BOOT] Initializing all subsystems...");
                 
                 // Initialize all manager classes
                 feedbackManager.begin();
@@ -78,14 +276,54 @@ void loop() {
                 deviceManager.begin();
                 sensorManager.begin();
                 mqttHandler.begin();
+                sleepManager.begin();
+
+                // Stored brightness and stealth mode for the MQTT state topics
+                feedbackManager.publishSettings();
                 
+                // Loop task: user feedback and device management
+                profiler.reset();
+                scheduler.begin();
+                scheduler.setProfiler(profiler);
+                feedbackManager.registerTasks(scheduler);
+                deviceManager.registerTasks(scheduler);
+
+                // Acquisition and networking run in their own pinned tasks so a
+                // blocking connect can never stall presence detection
+                sensorManager.setEventListener(networkScheduler);
+                xTaskCreateStaticPinnedToCore(networkTask, "network", NETWORK_TASK_STACK_SIZE, nullptr,
+                                              NETWORK_TASK_PRIORITY, networkTaskStack, &networkTaskBuffer,
+                                              NETWORK_TASK_CORE);
+                xTaskCreateStaticPinnedToCore(sensorTask, "sensors", SENSOR_TASK_STACK_SIZE, nullptr,
+                                              SENSOR_TASK_PRIORITY, sensorTaskStack, &sensorTaskBuffer,
+                                              SENSOR_TASK_CORE);
+
+                // Phase 1 Demo: starts 3 seconds after initialization, one step every 5 seconds
+                scheduler.addTask("demo", runDemoStep, nullptr,
+                                  DEMO_STEP_INTERVAL, DEMO_START_DELAY + DEMO_STEP_INTERVAL);
+
+                scheduler.addTask("console", pollConsole, nullptr, CONSOLE_POLL_INTERVAL);
+
+                // Trace flash writes stay in the lowest-priority task
+                scheduler.addTask("trace", [](void* context) {
+                    sensorManager.getTraceRecorder().flush();
+                }, nullptr, TRACE_WRITE_INTERVAL);
+
+                #if LOG_LEVEL >= LOG_LEVEL_DEBUG
+                // Periodic task jitter/runtime report
+                scheduler.addTask("stats", [](void* context) {
+                    scheduler.printStats();
+                    sensorScheduler.printStats();
+                    networkScheduler.printStats();
+                    sleepManager.printStats();
+                    EventBus::printStats();
+                }, nullptr, STATUS_UPDATE_INTERVAL, STATUS_UPDATE_INTERVAL);
+                #endif
+
                 managersInitialized = true;
                 
-                #ifdef DEBUG
-                Serial.println("[BOOT] All subsystems initialized!");
-                Serial.println("[BOOT] The Scout is ready for Phase 1 development");
-                Serial.flush();
-                #endif
+                LOG_INFO("[BOOT] All subsystems initialized!");
+                LOG_INFO("[BOOT] The Scout is ready for Phase 1 development");
                 
                 currentState = SystemState::NORMAL_OPERATION;
                 lastStateChange = millis();
@@ -93,72 +331,9 @@ void loop() {
             break;
             
         case SystemState::NORMAL_OPERATION:
-            // Update all managers in normal operation
-            feedbackManager.update();
-            wifiHandler.update();
-            deviceManager.update();
-            sensorManager.update();
-            mqttHandler.update();
-            
-            // Phase 1 Demo: LED and Buzzer Test Sequence
-            static unsigned long lastDemoUpdate = 0;
-            static int demoStep = 0;
-            static bool demoStarted = false;
-            
-            // Wait 3 seconds after initialization before starting demo
-            if (!demoStarted && millis() - lastStateChange > 3000) {
-                #ifdef DEBUG
-                Serial.println("[DEMO] Starting LED demo sequence...");
-                #endif
-                demoStarted = true;
-                lastDemoUpdate = millis();
-            }
-            
-            if (demoStarted && millis() - lastDemoUpdate > 5000) { // Every 5 seconds
-                switch (demoStep) {
-                    case 0:
-                        #ifdef DEBUG
-                        Serial.println("[DEMO] Starting LED system status (green pulse)");
-                        #endif
-                        feedbackManager.startAnimation(PIXEL_SYSTEM, HearthGuardColors::HEARTHGUARD_GREEN, 
-                                                     LedAnimation::PULSE, 2000);
-                        feedbackManager.playConfirm();
-                        break;
-                    case 1:
-                        #ifdef DEBUG
-                        Serial.println("[DEMO] Starting LED activity status (blue blink)");
-                        #endif
-                        feedbackManager.startAnimation(PIXEL_ACTIVITY, HearthGuardColors::HEARTHGUARD_BLUE, 
-                                                     LedAnimation::BLINK, 500);
-                        feedbackManager.playInteraction();
-                        break;
-                    case 2:
-                        #ifdef DEBUG
-                        Serial.println("[DEMO] Playing success sound and solid orange LED");
-                        #endif
-                        feedbackManager.startAnimation(PIXEL_SYSTEM, HearthGuardColors::HEARTHGUARD_ORANGE, 
-                                                     LedAnimation::SOLID, 0);
-                        feedbackManager.playSuccess();
-                        break;
-                    case 3:
-                        #ifdef DEBUG
-                        Serial.println("[DEMO] Playing failure sound and red LED");
-                        #endif
-                        feedbackManager.startAnimation(PIXEL_ACTIVITY, HearthGuardColors::HEARTHGUARD_RED, 
-                                                     LedAnimation::SOLID, 0);
-                        feedbackManager.playFailure();
-                        break;
-                    case 4:
-                        #ifdef DEBUG
-                        Serial.println("[DEMO] Turning off all LEDs");
-                        #endif
-                        feedbackManager.turnOffLeds();
-                        demoStep = -1; // Will become 0 after increment
-                        break;
-                }
-                demoStep++;
-                lastDemoUpdate = millis();
-            }
+            // Run due manager tasks, then sleep until the next deadline
+            scheduler.run();
+            profiler.countLoopIteration();
             break;
             
         default:
@@ -167,6 +342,8 @@ void loop() {
             break;
     }
     
-    // Small delay for stability  
-    delay(1);
+    // Small delay for stability while booting (the scheduler sleeps on its own)
+    if (currentState != SystemState::NORMAL_OPERATION) {
+        delay(1);
+    }
 }
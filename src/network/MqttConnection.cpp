@@ -0,0 +1,656 @@
+#include "network/MqttConnection.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+
+namespace {
+
+// MQTT 3.1.1 control packet types (upper nibble of the first byte)
+constexpr uint8_t CONNECT = 1;
+constexpr uint8_t CONNACK = 2;
+constexpr uint8_t PUBLISH = 3;
+constexpr uint8_t PUBACK = 4;
+constexpr uint8_t SUBSCRIBE = 8;
+constexpr uint8_t SUBACK = 9;
+constexpr uint8_t PINGREQ = 12;
+constexpr uint8_t PINGRESP = 13;
+
+constexpr uint8_t PROTOCOL_LEVEL = 4;
+
+#ifdef MSG_NOSIGNAL
+constexpr int SEND_FLAGS = MSG_NOSIGNAL;    // A closed socket is an error, not SIGPIPE (host)
+#else
+constexpr int SEND_FLAGS = 0;
+#endif
+
+const char* const CONNACK_ERRORS[] = {
+    "",
+    "broker rejected protocol version",
+    "broker rejected client id",
+    "broker unavailable",
+    "bad user name or password",
+    "not authorized",
+    "invalid CONNACK"
+};
+
+size_t lengthBytes(size_t remaining) {
+    size_t bytes = 1;
+    while (remaining >= 128) {
+        remaining /= 128;
+        bytes++;
+    }
+    return bytes;
+}
+
+uint8_t* putLength(uint8_t* out, size_t remaining) {
+    do {
+        uint8_t digit = remaining % 128;
+        remaining /= 128;
+        if (remaining > 0) {
+            digit |= 0x80;
+        }
+        *out++ = digit;
+    } while (remaining > 0);
+    return out;
+}
+
+uint8_t* putString(uint8_t* out, const char* text, size_t length) {
+    *out++ = static_cast<uint8_t>(length >> 8);
+    *out++ = static_cast<uint8_t>(length);
+    memcpy(out, text, length);
+    return out + length;
+}
+
+size_t stringLength(const char* text) {
+    return text != nullptr ? strlen(text) : 0;
+}
+
+size_t connectRemaining(const MqttConnection::Config& config) {
+    size_t remaining = 10 + 2 + stringLength(config.clientId);
+    if (config.willTopic != nullptr) {
+        remaining += 2 + strlen(config.willTopic) + 2 + stringLength(config.willMessage);
+    }
+    if (config.username != nullptr) {
+        remaining += 2 + strlen(config.username);
+        if (config.password != nullptr) {
+            remaining += 2 + strlen(config.password);
+        }
+    }
+    return remaining;
+}
+
+}
+
+MqttConnection::~MqttConnection() {
+    closeSocket();
+}
+
+bool MqttConnection::begin(const Config& newConfig) {
+    stop();
+    config = newConfig;
+
+    in_addr parsed;
+    if (config.host == nullptr || inet_pton(AF_INET, config.host, &parsed) != 1) {
+        return false;
+    }
+    address = parsed.s_addr;
+
+    const size_t remaining = connectRemaining(config);
+    if (config.clientId == nullptr || 1 + lengthBytes(remaining) + remaining > sizeof(txBuffer)) {
+        return false;
+    }
+
+    random = config.seed != 0 ? config.seed : 1;
+    window = config.inflightWindow > 0 && config.inflightWindow <= MQTT_INFLIGHT_WINDOW
+                 ? config.inflightWindow : MQTT_INFLIGHT_WINDOW;
+    for (InFlight& slot : inFlight) {
+        slot.packetId = 0;
+    }
+    inFlightCount = 0;
+    return true;
+}
+
+void MqttConnection::start(uint32_t now) {
+    if (phase != Phase::IDLE) {
+        return;
+    }
+    phase = Phase::WAITING;
+    nextAttempt = now;
+}
+
+void MqttConnection::stop() {
+    closeSocket();
+    phase = Phase::IDLE;
+    failures = 0;
+    dropped = false;
+}
+
+void MqttConnection::service(uint32_t now) {
+    lastService = now;
+
+    switch (phase) {
+        case Phase::IDLE:
+            return;
+
+        case Phase::WAITING:
+            if (static_cast<int32_t>(now - nextAttempt) >= 0) {
+                openSocket(now);
+            }
+            return;
+
+        case Phase::TCP_CONNECTING: {
+            const int8_t result = checkConnected();
+            if (result < 0) {
+                fail(now, "TCP connect failed");
+                return;
+            }
+            if (result == 0) {
+                if (now - attemptStart >= config.connectTimeoutMs) {
+                    fail(now, "TCP connect timed out");
+                }
+                return;
+            }
+            if (!queueConnect()) {
+                fail(now, "CONNECT does not fit");
+                return;
+            }
+            phase = Phase::MQTT_CONNECTING;
+            break;
+        }
+
+        default:
+            break;
+    }
+
+    // flush() and receive() end the session themselves on errors
+    if (!flush(now) || !receive(now)) {
+        return;
+    }
+
+    if (phase == Phase::MQTT_CONNECTING) {
+        if (now - attemptStart >= config.connectTimeoutMs) {
+            fail(now, "no CONNACK");
+        }
+        return;
+    }
+
+    // Keep-alive: ping when nothing was sent for a keep-alive period
+    if (pingOutstanding) {
+        if (now - pingSentAt >= config.connectTimeoutMs) {
+            fail(now, "no PINGRESP");
+        }
+    } else if (config.keepAliveSeconds > 0 && now - lastSent >= config.keepAliveSeconds * 1000UL) {
+        uint8_t* packet = reserve(2);
+        if (packet != nullptr) {
+            packet[0] = PINGREQ << 4;
+            packet[1] = 0;
+            pingOutstanding = true;
+            pingSentAt = now;
+            flush(now);
+        }
+    }
+}
+
+bool MqttConnection::publish(const char* topic, const char* payload, size_t length, bool retain, uint8_t qos) {
+    if (phase != Phase::CONNECTED || qos > 1) {
+        return false;
+    }
+
+    const size_t topicLength = strlen(topic);
+    const size_t remaining = 2 + topicLength + (qos > 0 ? 2 : 0) + length;
+    const size_t total = 1 + lengthBytes(remaining) + remaining;
+
+    InFlight* slot = nullptr;
+    if (qos > 0) {
+        if (inFlightCount >= window || total > MQTT_INFLIGHT_PACKET_SIZE) {
+            return false;
+        }
+        for (InFlight& candidate : inFlight) {
+            if (candidate.packetId == 0) {
+                slot = &candidate;
+                break;
+            }
+        }
+    }
+
+    uint8_t* packet = reserve(total);
+    if (packet == nullptr) {
+        return false;
+    }
+
+    uint8_t* out = packet;
+    *out++ = (PUBLISH << 4) | (qos << 1) | (retain ? 0x01 : 0x00);
+    out = putLength(out, remaining);
+    out = putString(out, topic, topicLength);
+    if (slot != nullptr) {
+        packetId = nextPacketId();
+        *out++ = static_cast<uint8_t>(packetId >> 8);
+        *out++ = static_cast<uint8_t>(packetId);
+    }
+    memcpy(out, payload, length);
+
+    // Keep a copy until the PUBACK in case the connection drops first
+    if (slot != nullptr) {
+        memcpy(slot->packet, packet, total);
+        slot->length = static_cast<uint16_t>(total);
+        slot->packetId = packetId;
+        slot->order = ++publishOrder;
+        inFlightCount++;
+    }
+
+    // Hand it to the socket now rather than on the next service()
+    flush(lastService);
+    return true;
+}
+
+void MqttConnection::setAckHandler(AckHandler handler, void* context) {
+    ackHandler = handler;
+    ackContext = context;
+}
+
+bool MqttConnection::subscribe(const char* topic) {
+    if (phase != Phase::CONNECTED) {
+        return false;
+    }
+
+    const size_t topicLength = strlen(topic);
+    const size_t remaining = 2 + 2 + topicLength + 1;
+    uint8_t* packet = reserve(1 + lengthBytes(remaining) + remaining);
+    if (packet == nullptr) {
+        return false;
+    }
+
+    const uint16_t id = nextPacketId();
+    *packet++ = (SUBSCRIBE << 4) | 0x02;
+    packet = putLength(packet, remaining);
+    *packet++ = static_cast<uint8_t>(id >> 8);
+    *packet++ = static_cast<uint8_t>(id);
+    packet = putString(packet, topic, topicLength);
+    *packet = 0;            // Requested QoS
+
+    flush(lastService);
+    return true;
+}
+
+void MqttConnection::setMessageHandler(MessageHandler handler, void* context) {
+    messageHandler = handler;
+    messageContext = context;
+}
+
+void MqttConnection::openSocket(uint32_t now) {
+    attempts++;
+    attemptStart = now;
+
+    socketFd = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (socketFd < 0) {
+        fail(now, "no socket");
+        return;
+    }
+
+    const int flags = fcntl(socketFd, F_GETFL, 0);
+    if (flags < 0 || fcntl(socketFd, F_SETFL, flags | O_NONBLOCK) < 0) {
+        fail(now, "socket not non-blocking");
+        return;
+    }
+    const int noDelay = 1;
+    setsockopt(socketFd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+
+    sockaddr_in broker = {};
+    broker.sin_family = AF_INET;
+    broker.sin_port = htons(config.port);
+    broker.sin_addr.s_addr = address;
+
+    // Returns at once: completion is picked up by checkConnected()
+    if (connect(socketFd, reinterpret_cast<sockaddr*>(&broker), sizeof(broker)) < 0 &&
+        errno != EINPROGRESS) {
+        fail(now, "TCP connect failed");
+        return;
+    }
+    phase = Phase::TCP_CONNECTING;
+}
+
+int8_t MqttConnection::checkConnected() {
+    fd_set writable;
+    FD_ZERO(&writable);
+    FD_SET(socketFd, &writable);
+    timeval noWait = {0, 0};
+    const int ready = select(socketFd + 1, nullptr, &writable, nullptr, &noWait);
+    if (ready < 0) {
+        return -1;
+    }
+    if (ready == 0) {
+        return 0;
+    }
+
+    int error = 0;
+    socklen_t errorLength = sizeof(error);
+    if (getsockopt(socketFd, SOL_SOCKET, SO_ERROR, &error, &errorLength) < 0 || error != 0) {
+        return -1;
+    }
+    return 1;
+}
+
+bool MqttConnection::queueConnect() {
+    const size_t remaining = connectRemaining(config);
+    uint8_t* packet = reserve(1 + lengthBytes(remaining) + remaining);
+    if (packet == nullptr) {
+        return false;
+    }
+
+    uint8_t flags = 0x02;   // Clean session
+    if (config.willTopic != nullptr) {
+        flags |= 0x04 | 0x20;   // Will flag, will retain (QoS 0)
+    }
+    if (config.username != nullptr) {
+        flags |= 0x80;
+        if (config.password != nullptr) {
+            flags |= 0x40;
+        }
+    }
+
+    *packet++ = CONNECT << 4;
+    packet = putLength(packet, remaining);
+    packet = putString(packet, "MQTT", 4);
+    *packet++ = PROTOCOL_LEVEL;
+    *packet++ = flags;
+    *packet++ = static_cast<uint8_t>(config.keepAliveSeconds >> 8);
+    *packet++ = static_cast<uint8_t>(config.keepAliveSeconds);
+
+    packet = putString(packet, config.clientId, strlen(config.clientId));
+    if (config.willTopic != nullptr) {
+        packet = putString(packet, config.willTopic, strlen(config.willTopic));
+        packet = putString(packet, config.willMessage, stringLength(config.willMessage));
+    }
+    if (config.username != nullptr) {
+        packet = putString(packet, config.username, strlen(config.username));
+        if (config.password != nullptr) {
+            putString(packet, config.password, strlen(config.password));
+        }
+    }
+    return true;
+}
+
+bool MqttConnection::flush(uint32_t now) {
+    if (txSent == txLength) {
+        return true;
+    }
+
+    const ssize_t sent = send(socketFd, txBuffer + txSent, txLength - txSent, SEND_FLAGS);
+    if (sent < 0) {
+        if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            return true;
+        }
+        fail(now, "send failed");
+        return false;
+    }
+
+    txSent += sent;
+    lastSent = now;
+    if (txSent == txLength) {
+        txSent = 0;
+        txLength = 0;
+    }
+    return true;
+}
+
+bool MqttConnection::receive(uint32_t now) {
+    const ssize_t received = recv(socketFd, rxBuffer + rxLength, sizeof(rxBuffer) - rxLength, 0);
+    if (received == 0) {
+        fail(now, "closed by broker");
+        return false;
+    }
+    if (received < 0) {
+        if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            return true;
+        }
+        fail(now, "receive failed");
+        return false;
+    }
+    rxLength += received;
+
+    size_t offset = 0;
+    for (;;) {
+        if (rxDiscard > 0) {
+            const size_t skip = rxDiscard < rxLength - offset ? rxDiscard : rxLength - offset;
+            offset += skip;
+            rxDiscard -= skip;
+            if (rxDiscard > 0) {
+                break;
+            }
+        }
+
+        // Fixed header: type byte, then a 1-4 byte remaining length
+        size_t remaining = 0;
+        size_t headerLength = 1;
+        bool complete = false;
+        while (offset + headerLength < rxLength) {
+            const uint8_t digit = rxBuffer[offset + headerLength];
+            remaining |= static_cast<size_t>(digit & 0x7F) << (7 * (headerLength - 1));
+            headerLength++;
+            if ((digit & 0x80) == 0) {
+                complete = true;
+                break;
+            }
+            if (headerLength > 4) {
+                fail(now, "malformed packet");
+                return false;
+            }
+        }
+        if (!complete) {
+            break;
+        }
+
+        const size_t total = headerLength + remaining;
+        if (total > sizeof(rxBuffer)) {
+            rxDiscard = total;
+            continue;
+        }
+        if (rxLength - offset < total) {
+            break;
+        }
+        if (!handlePacket(rxBuffer + offset, total, now)) {
+            return false;
+        }
+        offset += total;
+    }
+
+    rxLength -= offset;
+    memmove(rxBuffer, rxBuffer + offset, rxLength);
+    return true;
+}
+
+bool MqttConnection::handlePacket(const uint8_t* packet, size_t length, uint32_t now) {
+    switch (packet[0] >> 4) {
+        case CONNACK: {
+            if (phase != Phase::MQTT_CONNECTING || length != 4) {
+                fail(now, CONNACK_ERRORS[6]);
+                return false;
+            }
+            const uint8_t returnCode = packet[3];
+            if (returnCode != 0) {
+                fail(now, CONNACK_ERRORS[returnCode < 6 ? returnCode : 6]);
+                return false;
+            }
+            phase = Phase::CONNECTED;
+            failures = 0;
+            dropped = false;
+            lastError = "";
+            retransmit();
+            return true;
+        }
+
+        case PUBACK: {
+            if (length != 4) {
+                return true;
+            }
+            const uint16_t acknowledged = static_cast<uint16_t>((packet[2] << 8) | packet[3]);
+            for (InFlight& slot : inFlight) {
+                if (slot.packetId == acknowledged) {
+                    slot.packetId = 0;
+                    inFlightCount--;
+                    ackedCount++;
+                    if (ackHandler != nullptr) {
+                        ackHandler(ackContext, acknowledged);
+                    }
+                    break;
+                }
+            }
+            return true;
+        }
+
+        case PUBLISH:
+            deliver(packet, length);
+            return true;
+
+        case PINGRESP:
+            pingOutstanding = false;
+            return true;
+
+        default:
+            // SUBACK included: a refused subscription just delivers nothing
+            return true;
+    }
+}
+
+void MqttConnection::deliver(const uint8_t* packet, size_t length) {
+    const uint8_t qos = (packet[0] >> 1) & 0x03;
+    size_t offset = 1;
+    while (offset < length && (packet[offset] & 0x80) != 0) {
+        offset++;
+    }
+    offset++;
+
+    if (qos > 1 || offset + 2 > length) {
+        // Only QoS 0 is subscribed, so QoS 2 never comes from a sane broker
+        return;
+    }
+    const size_t topicLength = (packet[offset] << 8) | packet[offset + 1];
+    offset += 2;
+    const size_t idLength = qos > 0 ? 2 : 0;
+    if (offset + topicLength + idLength > length) {
+        return;
+    }
+
+    if (qos > 0) {
+        uint8_t* puback = reserve(4);
+        if (puback != nullptr) {
+            puback[0] = PUBACK << 4;
+            puback[1] = 2;
+            puback[2] = packet[offset + topicLength];
+            puback[3] = packet[offset + topicLength + 1];
+        }
+    }
+
+    if (messageHandler != nullptr) {
+        Message message;
+        message.topic = reinterpret_cast<const char*>(packet + offset);
+        message.topicLength = topicLength;
+        message.payload = reinterpret_cast<const char*>(packet + offset + topicLength + idLength);
+        message.length = length - offset - topicLength - idLength;
+        message.retained = (packet[0] & 0x01) != 0;
+        messageHandler(messageContext, message);
+    }
+}
+
+void MqttConnection::retransmit() {
+    uint32_t after = 0;
+    for (uint8_t sent = 0; sent < inFlightCount; sent++) {
+        // Oldest remaining slot; the window is small enough to search
+        InFlight* oldest = nullptr;
+        for (InFlight& slot : inFlight) {
+            if (slot.packetId != 0 && slot.order > after && (oldest == nullptr || slot.order < oldest->order)) {
+                oldest = &slot;
+            }
+        }
+        if (oldest == nullptr) {
+            break;
+        }
+        after = oldest->order;
+
+        uint8_t* packet = reserve(oldest->length);
+        if (packet == nullptr) {
+            break;
+        }
+        memcpy(packet, oldest->packet, oldest->length);
+        packet[0] |= 0x08;      // DUP
+        retransmitCount++;
+    }
+}
+
+uint16_t MqttConnection::nextPacketId() {
+    for (;;) {
+        if (++packetId == 0) {
+            packetId = 1;
+        }
+        bool used = false;
+        for (const InFlight& slot : inFlight) {
+            used = used || slot.packetId == packetId;
+        }
+        if (!used) {
+            return packetId;
+        }
+    }
+}
+
+uint8_t* MqttConnection::reserve(size_t length) {
+    if (txLength + length > sizeof(txBuffer) && txSent > 0) {
+        txLength -= txSent;
+        memmove(txBuffer, txBuffer + txSent, txLength);
+        txSent = 0;
+    }
+    if (txLength + length > sizeof(txBuffer)) {
+        return nullptr;
+    }
+    uint8_t* start = txBuffer + txLength;
+    txLength += length;
+    return start;
+}
+
+void MqttConnection::fail(uint32_t now, const char* reason) {
+    if (phase == Phase::CONNECTED) {
+        dropped = true;
+    } else {
+        failures++;
+    }
+    lastError = reason;
+    closeSocket();
+    phase = Phase::WAITING;
+    nextAttempt = now + retryDelay();
+}
+
+void MqttConnection::closeSocket() {
+    if (socketFd >= 0) {
+        close(socketFd);
+        socketFd = -1;
+    }
+    txLength = 0;
+    txSent = 0;
+    rxLength = 0;
+    rxDiscard = 0;
+    pingOutstanding = false;
+}
+
+uint32_t MqttConnection::retryDelay() {
+    // Doubles per consecutive failure; a lost session retries at the minimum
+    uint32_t delay = config.retryMinMs;
+    for (uint32_t i = 1; i < failures && delay < config.retryMaxMs; i++) {
+        delay *= 2;
+    }
+    if (delay > config.retryMaxMs) {
+        delay = config.retryMaxMs;
+    }
+
+    // xorshift32
+    random ^= random << 13;
+    random ^= random >> 17;
+    random ^= random << 5;
+
+    const uint32_t spread = delay / 100 * MQTT_RETRY_JITTER;
+    return delay - spread + random % (2 * spread + 1);
+}
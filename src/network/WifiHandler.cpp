@@ -1,15 +1,53 @@
 #include "network/WifiHandler.h" // IMPORTANT: Must include its own header
+#include <WiFi.h>
+#include "config/Settings.h"
+#include "utilities/EventBus.h"
+#include "utilities/Logger.h"
 
 WifiHandler::WifiHandler() {
     // Constructor body can be empty
 }
 
 void WifiHandler::begin() {
-    #ifdef DEBUG
-    Serial.println("WifiHandler::begin() called");
-    #endif
+    LOG_DEBUG("WifiHandler::begin() called");
 }
 
 void WifiHandler::update() {
-    // This method is called in the main loop
+    // Connection management arrives with Phase 2; for now only report changes
+    const WifiState state = readState();
+    if (state != currentState) {
+        const WifiState previous = currentState;
+        currentState = state;
+        EventBus::publish(WifiStateChanged{state, previous});
+    }
+}
+
+void WifiHandler::registerTasks(Scheduler& scheduler) {
+    scheduler.addTask("wifi", [](void* context) {
+        static_cast<WifiHandler*>(context)->update();
+    }, this, WIFI_UPDATE_INTERVAL, 0, ProfileSlot::WIFI);
+}
+
+void WifiHandler::setPowerSave(bool batterySaving) {
+    // Applied immediately if the station is up, otherwise when it starts
+    WiFi.setSleep(batterySaving ? WIFI_PS_MAX_MODEM : WIFI_PS_MIN_MODEM);
+    LOG_DEBUG("[WIFI] Modem sleep %s", batterySaving ? "MAX" : "MIN");
+}
+
+WifiState WifiHandler::readState() {
+    if (WiFi.getMode() & WIFI_MODE_AP) {
+        return WifiState::AP_MODE;
+    }
+
+    switch (WiFi.status()) {
+        case WL_CONNECTED:
+            return WifiState::CONNECTED;
+        case WL_IDLE_STATUS:
+            return WifiState::CONNECTING;   // begin() called, association in progress
+        case WL_NO_SSID_AVAIL:
+        case WL_CONNECT_FAILED:
+            return WifiState::FAILED;
+        default:
+            return WifiState::DISCONNECTED;
+    }
 }
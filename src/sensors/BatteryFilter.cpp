@@ -0,0 +1,60 @@
+#include "sensors/BatteryFilter.h"
+
+void BatteryFilter::beginBurst() {
+    windowFill = 0;
+    sum = 0;
+    count = 0;
+}
+
+void BatteryFilter::addSample(uint16_t raw) {
+    for (uint8_t i = 0; i + 1 < MEDIAN_WINDOW; i++) {
+        window[i] = window[i + 1];
+    }
+    window[MEDIAN_WINDOW - 1] = raw;
+    if (windowFill < MEDIAN_WINDOW) {
+        windowFill++;
+        if (windowFill < MEDIAN_WINDOW) {
+            return;
+        }
+    }
+
+    // Insertion sort of a copy; five elements
+    uint16_t sorted[MEDIAN_WINDOW];
+    for (uint8_t i = 0; i < MEDIAN_WINDOW; i++) {
+        uint16_t value = window[i];
+        uint8_t j = i;
+        while (j > 0 && sorted[j - 1] > value) {
+            sorted[j] = sorted[j - 1];
+            j--;
+        }
+        sorted[j] = value;
+    }
+
+    sum += sorted[MEDIAN_WINDOW / 2];
+    count++;
+}
+
+bool BatteryFilter::endBurst() {
+    if (count == 0) {
+        return false;
+    }
+
+    const int32_t mean = static_cast<int32_t>(((sum << FRACTION_BITS) + count / 2) / count);
+    if (!valid) {
+        state = mean;
+        valid = true;
+    } else {
+        state += (mean - state) / (1 << IIR_SHIFT);
+    }
+    return true;
+}
+
+uint16_t BatteryFilter::getValue() const {
+    return static_cast<uint16_t>((state + (1 << (FRACTION_BITS - 1))) >> FRACTION_BITS);
+}
+
+void BatteryFilter::reset() {
+    beginBurst();
+    state = 0;
+    valid = false;
+}
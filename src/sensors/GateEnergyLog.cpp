@@ -0,0 +1,88 @@
+#include "sensors/GateEnergyLog.h"
+
+void GateEnergyLog::record(const Ld2410Report& report, uint32_t timestamp) {
+    const uint16_t slot = nextSequence & (CAPACITY - 1);
+    timestamps[slot] = timestamp;
+
+    for (uint8_t gate = 0; gate < GATE_COUNT; gate++) {
+        updateGate(gate, slot, report.gateEnergy[gate]);
+    }
+
+    if (count < CAPACITY) {
+        count++;
+    }
+    nextSequence++;
+}
+
+void GateEnergyLog::clear() {
+    count = 0;
+    for (uint8_t gate = 0; gate < GATE_COUNT; gate++) {
+        accumulators[gate] = Accumulator{ 0, 0, 0 };
+    }
+}
+
+bool GateEnergyLog::getStats(uint8_t gate, GateStats& stats) const {
+    if (count == 0 || gate >= GATE_COUNT) {
+        return false;
+    }
+
+    const Accumulator& accumulator = accumulators[gate];
+    stats.min = accumulator.min;
+    stats.max = accumulator.max;
+    stats.mean = static_cast<uint32_t>((accumulator.sum + count / 2) / count);
+    return true;
+}
+
+void GateEnergyLog::updateGate(uint8_t gate, uint16_t slot, uint32_t value) {
+    Accumulator& accumulator = accumulators[gate];
+    uint32_t& cell = energy[gate][slot];
+
+    if (count == CAPACITY) {
+        const uint32_t evicted = cell;
+        accumulator.sum -= evicted;
+        accumulator.sum += value;
+        cell = value;
+
+        // The old extreme left the window and the new value does not replace it
+        if ((evicted == accumulator.min && value > accumulator.min) ||
+            (evicted == accumulator.max && value < accumulator.max)) {
+            rescanGate(gate);
+            return;
+        }
+    } else {
+        accumulator.sum += value;
+        cell = value;
+
+        if (count == 0) {
+            accumulator.min = value;
+            accumulator.max = value;
+            return;
+        }
+    }
+
+    if (value < accumulator.min) {
+        accumulator.min = value;
+    }
+    if (value > accumulator.max) {
+        accumulator.max = value;
+    }
+}
+
+void GateEnergyLog::rescanGate(uint8_t gate) {
+    // Only called on a full log, so every slot holds a frame
+    const uint32_t* column = energy[gate];
+    uint32_t low = column[0];
+    uint32_t high = column[0];
+
+    for (uint16_t i = 1; i < CAPACITY; i++) {
+        if (column[i] < low) {
+            low = column[i];
+        }
+        if (column[i] > high) {
+            high = column[i];
+        }
+    }
+
+    accumulators[gate].min = low;
+    accumulators[gate].max = high;
+}
@@ -0,0 +1,179 @@
+#include "sensors/Ld2410FrameParser.h"
+
+uint8_t Ld2410FrameParser::parse(const uint8_t* data, size_t length) {
+    uint8_t frames = 0;
+    for (size_t i = 0; i < length; i++) {
+        if (consume(data[i]) && frames < UINT8_MAX) {
+            frames++;
+        }
+    }
+    return frames;
+}
+
+void Ld2410FrameParser::setFrameListener(FrameListener listener, void* context) {
+    frameListener = listener;
+    listenerContext = context;
+}
+
+void Ld2410FrameParser::reset() {
+    state = State::HEADER;
+    matchIndex = 0;
+}
+
+bool Ld2410FrameParser::consume(uint8_t byte) {
+    switch (state) {
+        case State::HEADER:
+            if (matchIndex > 0 && byte == header[matchIndex]) {
+                if (++matchIndex == sizeof(HEADER)) {
+                    state = State::LENGTH;
+                    matchIndex = 0;
+                    payloadLength = 0;
+                }
+            } else {
+                // The headers have no repeated bytes, so only a fresh start can match
+                startFrame(byte);
+            }
+            return false;
+
+        case State::MINIMAL:
+            if (!decodeMinimal(byte)) {
+                resync(byte);
+                return false;
+            }
+            if (++payloadIndex < MINIMAL_LENGTH) {
+                return false;
+            }
+            completeFrame();
+            return true;
+
+        case State::LENGTH:
+            payloadLength |= static_cast<uint16_t>(byte) << (8 * matchIndex);
+            if (++matchIndex == 2) {
+                const bool valid = (header == ACK_HEADER)
+                    ? (payloadLength >= ACK_MIN_LENGTH && payloadLength <= ACK_MAX_LENGTH)
+                    : payloadLength == STANDARD_LENGTH;
+                if (!valid) {
+                    resync(byte);
+                    return false;
+                }
+                state = State::PAYLOAD;
+                matchIndex = 0;
+                payloadIndex = 0;
+            }
+            return false;
+
+        case State::PAYLOAD:
+            if (header == ACK_HEADER) {
+                decodeAck(byte);
+            } else if (!decodePayload(byte)) {
+                resync(byte);
+                return false;
+            }
+            if (++payloadIndex == payloadLength) {
+                state = State::TAIL;
+                matchIndex = 0;
+            }
+            return false;
+
+        case State::TAIL:
+            if (byte != ((header == ACK_HEADER) ? ACK_TAIL : TAIL)[matchIndex]) {
+                resync(byte);
+                return false;
+            }
+            if (++matchIndex < sizeof(TAIL)) {
+                return false;
+            }
+            if (header == ACK_HEADER) {
+                ack = scratchAck;
+                ackCount++;
+                reset();
+                return false;
+            }
+            completeFrame();
+            return true;
+    }
+
+    return false;
+}
+
+void Ld2410FrameParser::startFrame(uint8_t byte) {
+    matchIndex = 0;
+    if (byte == HEADER[0]) {
+        header = HEADER;
+        matchIndex = 1;
+    } else if (byte == ACK_HEADER[0]) {
+        header = ACK_HEADER;
+        matchIndex = 1;
+    } else if (byte == MINIMAL_HEAD) {
+        state = State::MINIMAL;
+        payloadIndex = 0;
+    }
+}
+
+bool Ld2410FrameParser::decodeMinimal(uint8_t byte) {
+    switch (payloadIndex) {
+        case 0:
+            scratch.standard = false;
+            scratch.targetState = byte;
+            return byte <= MAX_TARGET_STATE;
+        case 1:  scratch.distance = byte; return true;
+        case 2:  scratch.distance |= static_cast<uint16_t>(byte) << 8; return true;
+        default: return byte == MINIMAL_TAIL;
+    }
+}
+
+bool Ld2410FrameParser::decodePayload(uint8_t byte) {
+    const uint16_t index = payloadIndex;
+
+    switch (index) {
+        case 0:
+            scratch.standard = true;
+            return byte == TYPE_STANDARD;
+        case 1:
+            scratch.targetState = byte;
+            return byte <= MAX_TARGET_STATE;
+        case 2:  scratch.distance = byte; return true;
+        case 3:  scratch.distance |= static_cast<uint16_t>(byte) << 8; return true;
+        case 4:
+        case 5:  return true;   // Reserved
+        default: break;
+    }
+
+    // One 32-bit energy per gate, least significant byte first
+    const uint16_t offset = index - GATES_START;
+    const uint8_t gate = offset / 4;
+    const uint8_t shift = 8 * (offset % 4);
+    if (shift == 0) {
+        scratch.gateEnergy[gate] = byte;
+    } else {
+        scratch.gateEnergy[gate] |= static_cast<uint32_t>(byte) << shift;
+    }
+    return true;
+}
+
+void Ld2410FrameParser::decodeAck(uint8_t byte) {
+    switch (payloadIndex) {
+        case 0:  scratchAck.command = byte; break;
+        case 1:  scratchAck.command |= static_cast<uint16_t>(byte) << 8; break;
+        case 2:  scratchAck.status = byte; break;
+        case 3:  scratchAck.status |= static_cast<uint16_t>(byte) << 8; break;
+        default: break;     // Command specific data (protocol version, parameters)
+    }
+}
+
+void Ld2410FrameParser::completeFrame() {
+    report = scratch;
+    frameCount++;
+    reset();
+    if (frameListener != nullptr) {
+        frameListener(listenerContext, report);
+    }
+}
+
+void Ld2410FrameParser::resync(uint8_t byte) {
+    errorCount++;
+    reset();
+
+    // The byte that broke this frame may start the next one
+    startFrame(byte);
+}
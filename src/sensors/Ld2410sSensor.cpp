@@ -1,5 +1,6 @@
 #include "sensors/Ld2410sSensor.h"
 #include "config/Pins.h"
+#include "utilities/Logger.h"
 
 Ld2410sSensor::Ld2410sSensor() 
     : lastUpdate(0) {
@@ -14,27 +15,188 @@ Ld2410sSensor::Ld2410sSensor()
 }
 
 bool Ld2410sSensor::begin() {
-    Serial.println("Ld2410sSensor::begin() called");
-    // Implementation will be added in Phase 4
+    LOG_DEBUG("Ld2410sSensor::begin() called");
+
+    uart_config_t config = {};
+    config.baud_rate = LD2410S_BAUD_RATE;
+    config.data_bits = UART_DATA_8_BITS;
+    config.parity = UART_PARITY_DISABLE;
+    config.stop_bits = UART_STOP_BITS_1;
+    config.flow_ctrl = UART_HW_FLOWCTRL_DISABLE;
+    config.source_clk = UART_SCLK_APB;
+
+    // No TX buffer: commands are a few bytes and go straight into the FIFO
+    esp_err_t result = uart_driver_install(UART_PORT, RX_BUFFER_SIZE, 0, 0, nullptr, 0);
+    if (result == ESP_OK) {
+        result = uart_param_config(UART_PORT, &config);
+    }
+    if (result == ESP_OK) {
+        result = uart_set_pin(UART_PORT, LD2410S_TX_PIN, LD2410S_RX_PIN, UART_PIN_NO_CHANGE, UART_PIN_NO_CHANGE);
+    }
+    if (result != ESP_OK) {
+        LOG_ERROR("[RADAR] Error: UART setup failed (%d)", result);
+        return false;
+    }
+
+    parser.setFrameListener(&Ld2410sSensor::onFrame, this);
+    uartReady = true;
     return true;
 }
 
 void Ld2410sSensor::update() {
-    // Serial.println("Ld2410sSensor::update() called");
-    // Implementation will be added in Phase 4
+    if (!uartReady) {
+        return;
+    }
+
+    uint8_t chunk[READ_CHUNK_SIZE];
+    uint32_t frames = 0;
+    int length;
+
+    // Zero timeout: only take what the driver has already buffered
+    while ((length = uart_read_bytes(UART_PORT, chunk, sizeof(chunk), 0)) > 0) {
+        frames += parser.parse(chunk, static_cast<size_t>(length));
+    }
+
+    if (commandStep < COMMAND_STEPS) {
+        serviceCommands();
+    }
+
+    if (frames == 0) {
+        return;
+    }
+
+    // Only the newest report matters for presence
+    const Ld2410Report& report = parser.getReport();
+    const bool present = report.targetState >= Ld2410Report::TARGET_PRESENT;
+    sensorData.movingTargetDetected = false;
+    sensorData.stationaryTargetDetected = present;
+    sensorData.movingTargetDistance = 0;
+    sensorData.movingTargetEnergy = 0;
+    sensorData.stationaryTargetDistance = present ? report.distance : 0;
+    sensorData.stationaryTargetEnergy = 0;
+    sensorData.lastUpdateTime = millis();
+    lastUpdate = sensorData.lastUpdateTime;
+}
+
+void Ld2410sSensor::setEngineeringMode(bool enabled) {
+    if (enabled == engineeringMode) {
+        return;
+    }
+
+    engineeringMode = enabled;
+    commandStep = 0;
+    pendingCommand = 0;
+    LOG_INFO("[RADAR] Switching engineering mode %s", enabled ? "on" : "off");
+}
+
+void Ld2410sSensor::serviceCommands() {
+    if (pendingCommand != 0) {
+        if (parser.getAckCount() == pendingAckCount) {
+            if (millis() - commandSentAt >= ACK_TIMEOUT_MS) {
+                abortCommands("not acknowledged");
+            }
+            return;
+        }
+
+        const Ld2410Ack& ack = parser.getAck();
+        if (ack.command != (pendingCommand | Ld2410Ack::ACK_FLAG) || ack.status != 0) {
+            abortCommands("rejected");
+            return;
+        }
+
+        pendingCommand = 0;
+        if (++commandStep == COMMAND_STEPS) {
+            engineeringActive = engineeringMode;
+            LOG_INFO("[RADAR] Engineering mode %s (%s output)", engineeringActive ? "on" : "off",
+                     engineeringActive ? "standard" : "minimal");
+            return;
+        }
+    }
+
+    sendNextCommand();
+}
+
+void Ld2410sSensor::sendNextCommand() {
+    static const uint8_t ENABLE_CONFIG_VALUE[] = { 0x01, 0x00 };
+    static const uint8_t MINIMAL_OUTPUT_VALUE[] = { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 };
+    static const uint8_t STANDARD_OUTPUT_VALUE[] = { 0x00, 0x00, 0x01, 0x00, 0x00, 0x00 };
+
+    switch (commandStep) {
+        case 0:
+            pendingCommand = CMD_ENABLE_CONFIG;
+            sendCommand(CMD_ENABLE_CONFIG, ENABLE_CONFIG_VALUE, sizeof(ENABLE_CONFIG_VALUE));
+            break;
+        case 1:
+            pendingCommand = CMD_OUTPUT_MODE;
+            sendCommand(CMD_OUTPUT_MODE, engineeringMode ? STANDARD_OUTPUT_VALUE : MINIMAL_OUTPUT_VALUE,
+                        sizeof(STANDARD_OUTPUT_VALUE));
+            break;
+        default:
+            pendingCommand = CMD_END_CONFIG;
+            sendCommand(CMD_END_CONFIG, nullptr, 0);
+            break;
+    }
+    pendingAckCount = parser.getAckCount();
+    commandSentAt = millis();
+}
+
+void Ld2410sSensor::abortCommands(const char* reason) {
+    const Ld2410Ack& ack = parser.getAck();
+    LOG_ERROR("[RADAR] Error: Command 0x%04X %s (last ACK 0x%04X status %u), engineering mode stays %s",
+              pendingCommand, reason, ack.command, ack.status, engineeringActive ? "on" : "off");
+
+    // Leave configuration mode if we got into it; nothing waits for this ACK
+    if (pendingCommand != CMD_ENABLE_CONFIG) {
+        sendCommand(CMD_END_CONFIG, nullptr, 0);
+    }
+
+    engineeringMode = engineeringActive;
+    commandStep = COMMAND_STEPS;
+    pendingCommand = 0;
+}
+
+void Ld2410sSensor::sendCommand(uint16_t command, const uint8_t* value, uint8_t valueLength) {
+    static const uint8_t HEADER[] = { 0xFD, 0xFC, 0xFB, 0xFA };
+    static const uint8_t TAIL[] = { 0x04, 0x03, 0x02, 0x01 };
+    uint8_t frame[sizeof(HEADER) + 4 + MAX_COMMAND_VALUE + sizeof(TAIL)];
+    size_t length = 0;
+
+    if (valueLength > MAX_COMMAND_VALUE) {
+        return;
+    }
+
+    const uint16_t dataLength = 2 + valueLength;
+    memcpy(frame, HEADER, sizeof(HEADER));
+    length += sizeof(HEADER);
+    frame[length++] = dataLength & 0xFF;
+    frame[length++] = dataLength >> 8;
+    frame[length++] = command & 0xFF;
+    frame[length++] = command >> 8;
+    if (valueLength > 0) {
+        memcpy(frame + length, value, valueLength);
+        length += valueLength;
+    }
+    memcpy(frame + length, TAIL, sizeof(TAIL));
+    length += sizeof(TAIL);
+
+    uart_write_bytes(UART_PORT, frame, length);
+}
+
+void Ld2410sSensor::onFrame(void* context, const Ld2410Report& report) {
+    if (report.standard) {
+        static_cast<Ld2410sSensor*>(context)->gateLog.record(report, millis());
+    }
 }
 
 RadarData Ld2410sSensor::getData() {
-    Serial.println("Ld2410sSensor::getData() called");
+    LOG_VERBOSE("Ld2410sSensor::getData() called");
     return sensorData;
 }
 
 bool Ld2410sSensor::isMovingTargetDetected() {
-    Serial.println("Ld2410sSensor::isMovingTargetDetected() called");
     return sensorData.movingTargetDetected;
 }
 
 bool Ld2410sSensor::isStationaryTargetDetected() {
-    Serial.println("Ld2410sSensor::isStationaryTargetDetected() called");
     return sensorData.stationaryTargetDetected;
 }
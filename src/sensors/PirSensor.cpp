@@ -1,7 +1,9 @@
 #include "sensors/PirSensor.h"
+#include <driver/gpio.h>
 #include "config/Pins.h"
+#include "utilities/Logger.h"
 
-PirSensor::PirSensor() 
+PirSensor::PirSensor()
     : lastState(false), lastUpdate(0) {
     // Initialize sensor data
     sensorData.motionDetected = false;
@@ -10,22 +12,136 @@ PirSensor::PirSensor()
 }
 
 bool PirSensor::begin() {
-    Serial.println("PirSensor::begin() called");
-    // Implementation will be added in Phase 4
+    LOG_DEBUG("PirSensor::begin() called");
+
+    pinMode(PIR_SENSOR_PIN, INPUT);
+    lastState = digitalRead(PIR_SENSOR_PIN) == HIGH;
+    rawLevel = lastState;
+    sensorData.motionDetected = lastState;
+
+    // No debounce window open at start-up
+    acceptedMicros = static_cast<uint32_t>(esp_timer_get_time()) - DEBOUNCE_US;
     return true;
 }
 
+void PirSensor::enableInterrupt(Scheduler& scheduler) {
+    edgeListener = &scheduler;
+
+    // Another driver may already have installed the shared GPIO ISR service
+    const esp_err_t result = gpio_install_isr_service(0);
+    if (result != ESP_OK && result != ESP_ERR_INVALID_STATE) {
+        LOG_ERROR("[PIR] Error: Failed to install GPIO ISR service (%d)", result);
+        return;
+    }
+
+    const gpio_num_t pin = static_cast<gpio_num_t>(PIR_SENSOR_PIN);
+    gpio_isr_handler_add(pin, &PirSensor::onEdge, this);
+
+    // Wait for the level opposite to the current one (= the next edge)
+    gpio_wakeup_enable(pin, gpio_get_level(pin) ? GPIO_INTR_LOW_LEVEL : GPIO_INTR_HIGH_LEVEL);
+    gpio_intr_enable(pin);
+}
+
+void PirSensor::setRawEdgeListener(RawEdgeListener listener, void* context) {
+    rawEdgeListener = listener;
+    rawEdgeContext = context;
+}
+
 void PirSensor::update() {
-    // Serial.println("PirSensor::update() called");
-    // Implementation will be added in Phase 4
+    Edge edge;
+    while (edgeQueue.pop(edge)) {
+        processEdge(edge);
+    }
+
+    // Edges were lost: resynchronize with the pin itself
+    const uint32_t dropped = edgeQueue.getDroppedCount();
+    if (dropped != droppedEdges) {
+        droppedEdges = dropped;
+        processEdge(Edge{ static_cast<uint32_t>(esp_timer_get_time()), digitalRead(PIR_SENSOR_PIN) == HIGH });
+        LOG_WARN("[PIR] Edge queue overflow, resynchronized");
+    }
+
+    // Debounce window closed with a different level: take the settled level
+    if (settlePending) {
+        const uint32_t now = static_cast<uint32_t>(esp_timer_get_time());
+        if (now - acceptedMicros >= DEBOUNCE_US) {
+            settlePending = false;
+            if (rawLevel != lastState) {
+                acceptLevel(rawLevel, acceptedMicros + DEBOUNCE_US);
+            }
+        }
+    }
+
+    lastUpdate = millis();
+}
+
+bool PirSensor::getNextDeadline(unsigned long& deadline) const {
+    const unsigned long now = millis();
+
+    if (!edgeQueue.isEmpty()) {
+        deadline = now;
+        return true;
+    }
+
+    if (settlePending) {
+        const uint32_t elapsed = static_cast<uint32_t>(esp_timer_get_time()) - acceptedMicros;
+        const uint32_t remaining = (elapsed < DEBOUNCE_US) ? DEBOUNCE_US - elapsed : 0;
+        deadline = now + (remaining + 999) / 1000;
+        return true;
+    }
+
+    return false;
 }
 
 PirData PirSensor::getData() {
-    Serial.println("PirSensor::getData() called");
+    LOG_VERBOSE("PirSensor::getData() called");
     return sensorData;
 }
 
 bool PirSensor::isMotionDetected() {
-    Serial.println("PirSensor::isMotionDetected() called");
     return sensorData.motionDetected;
 }
+
+void PirSensor::processEdge(const Edge& edge) {
+    rawLevel = edge.level;
+    if (rawEdgeListener != nullptr) {
+        rawEdgeListener(rawEdgeContext, edge.level, edge.micros);
+    }
+
+    if (edge.micros - acceptedMicros < DEBOUNCE_US) {
+        // Inside the debounce window: decide once it has closed
+        settlePending = true;
+        return;
+    }
+
+    if (edge.level != lastState) {
+        acceptLevel(edge.level, edge.micros);
+    }
+}
+
+void PirSensor::acceptLevel(bool level, uint32_t micros) {
+    lastState = level;
+    acceptedMicros = micros;
+    sensorData.motionDetected = level;
+
+    if (level) {
+        // Convert the edge timestamp to the millis() time base
+        const uint32_t ageUs = static_cast<uint32_t>(esp_timer_get_time()) - micros;
+        sensorData.detectionCount++;
+        sensorData.lastDetectionTime = millis() - ageUs / 1000;
+    }
+}
+
+void IRAM_ATTR PirSensor::onEdge(void* arg) {
+    PirSensor* sensor = static_cast<PirSensor*>(arg);
+    const gpio_num_t pin = static_cast<gpio_num_t>(PIR_SENSOR_PIN);
+    const int level = gpio_get_level(pin);
+
+    // Flip to the opposite level so the next edge (not this level) fires again
+    gpio_wakeup_enable(pin, level ? GPIO_INTR_LOW_LEVEL : GPIO_INTR_HIGH_LEVEL);
+
+    sensor->edgeQueue.push(Edge{ static_cast<uint32_t>(esp_timer_get_time()), level != 0 });
+    if (sensor->edgeListener != nullptr) {
+        sensor->edgeListener->notifyFromIsr();
+    }
+}
@@ -1,5 +1,19 @@
 #include "sensors/PowerStatus.h"
 #include "config/Pins.h"
+#include "utilities/Logger.h"
+
+namespace {
+// Resting LiPo discharge curve: cell mV -> charge %
+struct ChargePoint {
+    uint16_t millivolts;
+    uint8_t percentage;
+};
+
+constexpr ChargePoint CHARGE_CURVE[] = {
+    { 3300, 0 }, { 3600, 5 }, { 3700, 15 }, { 3750, 25 }, { 3800, 40 }, { 3850, 55 },
+    { 3900, 62 }, { 3950, 70 }, { 4000, 78 }, { 4100, 90 }, { 4200, 100 }
+};
+}
 
 PowerStatus::PowerStatus() 
     : lastUpdate(0) {
@@ -7,37 +21,154 @@ PowerStatus::PowerStatus()
     powerData.batteryVoltage = 0.0;
     powerData.batteryPercentage = 0;
     powerData.usbPowerConnected = false;
+    powerData.charging = false;
     powerData.batteryLow = false;
     powerData.lastUpdateTime = 0;
 }
 
 bool PowerStatus::begin() {
-    Serial.println("PowerStatus::begin() called");
-    // Implementation will be added in Phase 4
+    LOG_DEBUG("PowerStatus::begin() called");
+
+    pinMode(POWER_GOOD_PIN, INPUT);
+    pinMode(CHARGE_STATUS_PIN, INPUT);
+
+    // Power source monitoring works without the battery ADC
+    adcReady = beginAdc();
+    update();
     return true;
 }
 
 void PowerStatus::update() {
-    // Serial.println("PowerStatus::update() called");
-    // Implementation will be added in Phase 4
+    // Power good is HIGH while external power is present
+    powerData.usbPowerConnected = digitalRead(POWER_GOOD_PIN) == HIGH;
+    // Charge status is HIGH while charging; without external power it means nothing
+    powerData.charging = powerData.usbPowerConnected && digitalRead(CHARGE_STATUS_PIN) == HIGH;
+    powerData.lastUpdateTime = millis();
+    lastUpdate = powerData.lastUpdateTime;
+
+    if (adcReady && !burstRunning) {
+        batteryFilter.beginBurst();
+        if (adc_digi_start() == ESP_OK) {
+            burstRunning = true;
+            burstStart = millis();
+        }
+    }
+}
+
+bool PowerStatus::getNextDeadline(unsigned long& deadline) const {
+    deadline = burstStart + BURST_TIME;
+    return burstRunning;
+}
+
+bool PowerStatus::collectBurst() {
+    uint8_t buffer[BURST_BYTES];
+    uint32_t length = 0;
+
+    // Zero timeout: take whatever the DMA has delivered (INVALID_STATE = overrun, data still valid)
+    esp_err_t result;
+    while (((result = adc_digi_read_bytes(buffer, sizeof(buffer), &length, 0)) == ESP_OK ||
+            result == ESP_ERR_INVALID_STATE) && length > 0) {
+        for (uint32_t i = 0; i + sizeof(adc_digi_output_data_t) <= length; i += sizeof(adc_digi_output_data_t)) {
+            const adc_digi_output_data_t* sample = reinterpret_cast<const adc_digi_output_data_t*>(buffer + i);
+            if (sample->type2.unit == 0 && sample->type2.channel == BATTERY_CHANNEL) {
+                batteryFilter.addSample(sample->type2.data);
+            }
+        }
+    }
+
+    adc_digi_stop();
+    burstRunning = false;
+
+    if (!batteryFilter.endBurst()) {
+        LOG_WARN("[POWER] Battery burst returned no samples");
+        return false;
+    }
+
+    const uint32_t millivolts = esp_adc_cal_raw_to_voltage(batteryFilter.getValue(), &adcCalibration) * BATTERY_DIVIDER_RATIO;
+    powerData.batteryVoltage = millivolts / 1000.0f;
+    powerData.batteryPercentage = voltageToPercentage(millivolts);
+    powerData.batteryLow = powerData.batteryPercentage < BATTERY_LOW_PERCENT;
+    return true;
+}
+
+bool PowerStatus::beginAdc() {
+    adc_digi_init_config_t initConfig = {};
+    initConfig.max_store_buf_size = BURST_BYTES * 2;
+    initConfig.conv_num_each_intr = BURST_BYTES;
+    initConfig.adc1_chan_mask = BIT(BATTERY_CHANNEL);
+    initConfig.adc2_chan_mask = 0;
+
+    esp_err_t result = adc_digi_initialize(&initConfig);
+    if (result != ESP_OK) {
+        LOG_ERROR("[POWER] Error: ADC DMA init failed (%d)", result);
+        return false;
+    }
+
+    adc_digi_pattern_config_t pattern = {};
+    pattern.atten = ADC_ATTEN_DB_11;
+    pattern.channel = BATTERY_CHANNEL;
+    pattern.unit = 0;           // ADC1
+    pattern.bit_width = SOC_ADC_DIGI_MAX_BITWIDTH;
+
+    adc_digi_configuration_t config = {};
+    config.conv_limit_en = false;
+    config.conv_limit_num = 250;
+    config.pattern_num = 1;
+    config.adc_pattern = &pattern;
+    config.sample_freq_hz = BATTERY_SAMPLE_RATE;
+    config.conv_mode = ADC_CONV_SINGLE_UNIT_1;
+    config.format = ADC_DIGI_OUTPUT_FORMAT_TYPE2;
+
+    result = adc_digi_controller_configure(&config);
+    if (result != ESP_OK) {
+        LOG_ERROR("[POWER] Error: ADC DMA configuration failed (%d)", result);
+        adc_digi_deinitialize();
+        return false;
+    }
+
+    const esp_adc_cal_value_t source = esp_adc_cal_characterize(ADC_UNIT_1, ADC_ATTEN_DB_11, ADC_WIDTH_BIT_12,
+                                                                 DEFAULT_VREF, &adcCalibration);
+    if (source == ESP_ADC_CAL_VAL_DEFAULT_VREF) {
+        LOG_WARN("[POWER] No eFuse ADC calibration, battery voltage is approximate");
+    }
+    return true;
+}
+
+uint8_t PowerStatus::voltageToPercentage(uint32_t millivolts) {
+    constexpr size_t POINTS = sizeof(CHARGE_CURVE) / sizeof(CHARGE_CURVE[0]);
+    if (millivolts <= CHARGE_CURVE[0].millivolts) {
+        return 0;
+    }
+    if (millivolts >= CHARGE_CURVE[POINTS - 1].millivolts) {
+        return 100;
+    }
+
+    // Linear interpolation between the surrounding points
+    size_t i = 1;
+    while (millivolts > CHARGE_CURVE[i].millivolts) {
+        i++;
+    }
+    const ChargePoint& low = CHARGE_CURVE[i - 1];
+    const ChargePoint& high = CHARGE_CURVE[i];
+    return low.percentage + ((millivolts - low.millivolts) * (high.percentage - low.percentage)) /
+                            (high.millivolts - low.millivolts);
 }
 
 PowerData PowerStatus::getData() {
-    Serial.println("PowerStatus::getData() called");
+    LOG_VERBOSE("PowerStatus::getData() called");
     return powerData;
 }
 
 bool PowerStatus::isUsbPowerConnected() {
-    Serial.println("PowerStatus::isUsbPowerConnected() called");
     return powerData.usbPowerConnected;
 }
 
 bool PowerStatus::isBatteryLow() {
-    Serial.println("PowerStatus::isBatteryLow() called");
+    LOG_VERBOSE("PowerStatus::isBatteryLow() called");
     return powerData.batteryLow;
 }
 
 uint8_t PowerStatus::getBatteryPercentage() {
-    Serial.println("PowerStatus::getBatteryPercentage() called");
+    LOG_VERBOSE("PowerStatus::getBatteryPercentage() called");
     return powerData.batteryPercentage;
 }
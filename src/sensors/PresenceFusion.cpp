@@ -0,0 +1,110 @@
+#include "sensors/PresenceFusion.h"
+
+// Rows: state; columns: PIR_ON, PIR_OFF, RADAR_ON, RADAR_OFF, TIMEOUT
+const PresenceFusion::Transition PresenceFusion::TRANSITIONS[STATE_COUNT][INPUT_COUNT] = {
+    // IDLE
+    { { TRIGGERED, STOP },       { IDLE, KEEP },                      { IDLE_RADAR, KEEP },      { IDLE, KEEP },                   { IDLE, KEEP } },
+    // IDLE_RADAR
+    { { TRIGGERED_RADAR, STOP }, { IDLE_RADAR, KEEP },                { IDLE_RADAR, KEEP },      { IDLE, KEEP },                   { IDLE_RADAR, KEEP } },
+    // TRIGGERED
+    { { TRIGGERED, KEEP },       { COOLDOWN, START_COOLDOWN },        { TRIGGERED_RADAR, KEEP }, { TRIGGERED, KEEP },              { TRIGGERED, KEEP } },
+    // TRIGGERED_RADAR
+    { { TRIGGERED_RADAR, KEEP }, { COOLDOWN_RADAR, START_COOLDOWN },  { TRIGGERED_RADAR, KEEP }, { TRIGGERED, KEEP },              { TRIGGERED_RADAR, KEEP } },
+    // COOLDOWN
+    { { TRIGGERED, STOP },       { COOLDOWN, KEEP },                  { COOLDOWN_RADAR, KEEP },  { COOLDOWN, KEEP },               { IDLE, STOP } },
+    // COOLDOWN_RADAR
+    { { TRIGGERED_RADAR, STOP }, { COOLDOWN_RADAR, KEEP },            { COOLDOWN_RADAR, KEEP },  { COOLDOWN, KEEP },               { HELD, STOP } },
+    // HELD
+    { { TRIGGERED_RADAR, STOP }, { HELD, KEEP },                      { HELD, KEEP },            { HOLD_GRACE, START_HOLD },       { HELD, KEEP } },
+    // HOLD_GRACE
+    { { TRIGGERED, STOP },       { HOLD_GRACE, KEEP },                { HELD, STOP },            { HOLD_GRACE, KEEP },             { IDLE, STOP } },
+};
+
+const bool PresenceFusion::PRESENT[STATE_COUNT] = {
+    false,  // IDLE
+    false,  // IDLE_RADAR
+    true,   // TRIGGERED
+    true,   // TRIGGERED_RADAR
+    true,   // COOLDOWN
+    true,   // COOLDOWN_RADAR
+    true,   // HELD
+    true,   // HOLD_GRACE
+};
+
+PresenceFusion::PresenceFusion(const PresenceConfig& config)
+    : config(config) {
+}
+
+void PresenceFusion::setTransitionListener(TransitionListener listener, void* context) {
+    transitionListener = listener;
+    listenerContext = context;
+}
+
+void PresenceFusion::setConfig(const PresenceConfig& newConfig) {
+    config = newConfig;
+}
+
+void PresenceFusion::setPir(bool motion, uint32_t timestamp) {
+    expireTimer(timestamp);
+    apply(motion ? PIR_ON : PIR_OFF, timestamp);
+}
+
+void PresenceFusion::setRadar(bool moving, uint16_t movingEnergy, bool stationary, uint16_t stationaryEnergy,
+                              uint32_t timestamp) {
+    const bool active = (moving && movingEnergy >= config.movingEnergyMin) ||
+                        (stationary && stationaryEnergy >= config.stationaryEnergyMin);
+    if (active == radarActive) {
+        return;
+    }
+
+    radarActive = active;
+    expireTimer(timestamp);
+    apply(active ? RADAR_ON : RADAR_OFF, timestamp);
+}
+
+void PresenceFusion::advance(uint32_t timestamp) {
+    expireTimer(timestamp);
+}
+
+bool PresenceFusion::getDeadline(uint32_t& deadline) const {
+    deadline = timerDeadline;
+    return timerRunning;
+}
+
+void PresenceFusion::apply(Input input, uint32_t timestamp) {
+    const Transition& transition = TRANSITIONS[state][input];
+    state = transition.next;
+
+    switch (transition.timer) {
+        case START_COOLDOWN:
+            timerRunning = true;
+            timerDeadline = timestamp + config.cooldownMs;
+            break;
+        case START_HOLD:
+            timerRunning = true;
+            timerDeadline = timestamp + config.holdMs;
+            break;
+        case STOP:
+            timerRunning = false;
+            break;
+        case KEEP:
+            break;
+    }
+
+    if (PRESENT[state] != present) {
+        present = PRESENT[state];
+        if (transitionListener != nullptr) {
+            transitionListener(listenerContext, present, timestamp);
+        }
+    }
+
+    // A zero-length timer expires on the spot
+    expireTimer(timestamp);
+}
+
+void PresenceFusion::expireTimer(uint32_t timestamp) {
+    if (timerRunning && static_cast<int32_t>(timestamp - timerDeadline) >= 0) {
+        timerRunning = false;
+        apply(TIMEOUT, timerDeadline);
+    }
+}
@@ -0,0 +1,182 @@
+#include "sensors/SensorAggregator.h"
+
+namespace {
+
+uint16_t saturate(uint32_t value) {
+    return value > UINT16_MAX ? UINT16_MAX : static_cast<uint16_t>(value);
+}
+
+}
+
+void SensorAggregator::begin(uint32_t timestamp) {
+    bucketStart = timestamp;
+    accruedUntil = timestamp;
+}
+
+void SensorAggregator::setPresence(bool nowPresent, uint32_t timestamp) {
+    catchUp(timestamp);
+    if (nowPresent && !present) {
+        current.presenceCount++;
+        // Never count time in a minute that is already closed
+        accruedUntil = static_cast<int32_t>(timestamp - bucketStart) > 0 ? timestamp : bucketStart;
+    }
+    present = nowPresent;
+}
+
+void SensorAggregator::addMotion(uint32_t timestamp) {
+    catchUp(timestamp);
+    current.motionCount++;
+}
+
+void SensorAggregator::addRadarDistance(uint16_t distanceCm, uint32_t frame, uint32_t timestamp) {
+    if (radarFrameSeen && frame == lastRadarFrame) {
+        return;
+    }
+    radarFrameSeen = true;
+    lastRadarFrame = frame;
+
+    catchUp(timestamp);
+    uint16_t bin = distanceCm / AggregateWindow::DISTANCE_BIN_CM;
+    if (bin >= AggregateWindow::DISTANCE_BINS) {
+        bin = AggregateWindow::DISTANCE_BINS - 1;
+    }
+    current.distanceHistogram[bin]++;
+}
+
+void SensorAggregator::addBatteryReading(uint16_t millivolts, uint32_t timestamp) {
+    catchUp(timestamp);
+    if (current.batteryCount == 0 || millivolts < current.batteryMinMv) {
+        current.batteryMinMv = millivolts;
+    }
+    if (current.batteryCount == 0 || millivolts > current.batteryMaxMv) {
+        current.batteryMaxMv = millivolts;
+    }
+    current.batterySumMv += millivolts;
+    current.batteryCount++;
+}
+
+bool SensorAggregator::advance(uint32_t timestamp) {
+    catchUp(timestamp);
+    const bool changed = windowsChanged;
+    windowsChanged = false;
+    return changed;
+}
+
+void SensorAggregator::catchUp(uint32_t timestamp) {
+    uint16_t closes = 0;
+
+    while (static_cast<int32_t>(timestamp - bucketStart) >= static_cast<int32_t>(BUCKET_MS)) {
+        // After the partial minute plus a full ring of idle ones, more closes change nothing
+        if (closes > BUCKET_COUNT) {
+            const uint32_t skipped = (timestamp - bucketStart) / BUCKET_MS;
+            bucketStart += skipped * BUCKET_MS;
+            accruedUntil = bucketStart;
+            break;
+        }
+
+        accrue(bucketStart + BUCKET_MS);
+        closeBucket();
+        bucketStart += BUCKET_MS;
+        closes++;
+    }
+
+    accrue(timestamp);
+}
+
+void SensorAggregator::accrue(uint32_t timestamp) {
+    if (present && static_cast<int32_t>(timestamp - accruedUntil) > 0) {
+        current.occupiedMs += timestamp - accruedUntil;
+        accruedUntil = timestamp;
+    }
+}
+
+void SensorAggregator::closeBucket() {
+    // Take out the bucket each window loses before its ring slot is reused
+    for (uint8_t w = 0; w < SensorAggregates::WINDOW_COUNT; w++) {
+        if (closedCount < WINDOW_MINUTES[w]) {
+            continue;
+        }
+        const Bucket& leaving = bucketAt(WINDOW_MINUTES[w] - 1);
+        WindowTotals& window = totals[w];
+        window.occupiedMs -= leaving.occupiedMs;
+        window.motionCount -= leaving.motionCount;
+        window.presenceCount -= leaving.presenceCount;
+        for (uint8_t bin = 0; bin < AggregateWindow::DISTANCE_BINS; bin++) {
+            window.distanceHistogram[bin] -= leaving.distanceHistogram[bin];
+        }
+        window.batterySumMv -= leaving.batterySumMv;
+        window.batteryCount -= leaving.batteryCount;
+    }
+
+    newestBucket = (newestBucket + 1) % BUCKET_COUNT;
+    buckets[newestBucket] = current;
+    if (closedCount < BUCKET_COUNT) {
+        closedCount++;
+    }
+
+    for (uint8_t w = 0; w < SensorAggregates::WINDOW_COUNT; w++) {
+        WindowTotals& window = totals[w];
+        window.occupiedMs += current.occupiedMs;
+        window.motionCount += current.motionCount;
+        window.presenceCount += current.presenceCount;
+        for (uint8_t bin = 0; bin < AggregateWindow::DISTANCE_BINS; bin++) {
+            window.distanceHistogram[bin] += current.distanceHistogram[bin];
+        }
+        window.batterySumMv += current.batterySumMv;
+        window.batteryCount += current.batteryCount;
+        rescanBattery(w);
+    }
+
+    current = Bucket{};
+    windowsChanged = true;
+}
+
+void SensorAggregator::rescanBattery(uint8_t window) {
+    WindowTotals& totalsForWindow = totals[window];
+    totalsForWindow.batteryMinMv = UINT16_MAX;
+    totalsForWindow.batteryMaxMv = 0;
+
+    const uint8_t count = closedCount < WINDOW_MINUTES[window] ? closedCount : WINDOW_MINUTES[window];
+    for (uint8_t age = 0; age < count; age++) {
+        const Bucket& bucket = bucketAt(age);
+        if (bucket.batteryCount == 0) {
+            continue;
+        }
+        if (bucket.batteryMinMv < totalsForWindow.batteryMinMv) {
+            totalsForWindow.batteryMinMv = bucket.batteryMinMv;
+        }
+        if (bucket.batteryMaxMv > totalsForWindow.batteryMaxMv) {
+            totalsForWindow.batteryMaxMv = bucket.batteryMaxMv;
+        }
+    }
+}
+
+const SensorAggregator::Bucket& SensorAggregator::bucketAt(uint8_t age) const {
+    return buckets[(newestBucket + BUCKET_COUNT - age) % BUCKET_COUNT];
+}
+
+void SensorAggregator::getAggregates(SensorAggregates& aggregates) const {
+    for (uint8_t w = 0; w < SensorAggregates::WINDOW_COUNT; w++) {
+        const WindowTotals& window = totals[w];
+        AggregateWindow& out = aggregates.windows[w];
+
+        out.minutes = closedCount < WINDOW_MINUTES[w] ? closedCount : WINDOW_MINUTES[w];
+        out.occupiedSeconds = window.occupiedMs / 1000;
+        out.motionCount = saturate(window.motionCount);
+        out.presenceCount = saturate(window.presenceCount);
+        for (uint8_t bin = 0; bin < AggregateWindow::DISTANCE_BINS; bin++) {
+            out.distanceHistogram[bin] = saturate(window.distanceHistogram[bin]);
+        }
+
+        if (window.batteryCount > 0) {
+            out.batteryMinMv = window.batteryMinMv;
+            out.batteryMeanMv = static_cast<uint16_t>((window.batterySumMv + window.batteryCount / 2) / window.batteryCount);
+            out.batteryMaxMv = window.batteryMaxMv;
+        } else {
+            out.batteryMinMv = 0;
+            out.batteryMeanMv = 0;
+            out.batteryMaxMv = 0;
+        }
+    }
+    aggregates.timestamp = bucketStart;
+}
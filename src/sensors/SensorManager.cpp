@@ -1,32 +1,60 @@
 #include "sensors/SensorManager.h"
+#include <driver/gpio.h>
+#include "config/Pins.h"
 #include "config/Settings.h"
+#include "utilities/EventBus.h"
+#include "utilities/Logger.h"
+
+namespace {
+// LD2410S presence output: wakes the SoC from light sleep and triggers an immediate poll
+constexpr gpio_num_t RADAR_WAKE_PIN = static_cast<gpio_num_t>(LD2410S_INTERRUPT_PIN);
+
+constexpr PresenceConfig DEFAULT_PRESENCE_CONFIG = {
+    PRESENCE_COOLDOWN, PRESENCE_RADAR_HOLD, PRESENCE_MOVING_ENERGY_MIN, PRESENCE_STATIONARY_ENERGY_MIN
+};
+
+// Longest gate stream line: timestamp plus 16 32-bit gate energies
+constexpr size_t GATE_LINE_SIZE = 200;
+}
 
 SensorManager::SensorManager() 
-    : lastUpdate(0) {
+    : lastUpdate(0),
+      presenceFusion(DEFAULT_PRESENCE_CONFIG),
+      presenceConfig(DEFAULT_PRESENCE_CONFIG) {
+    presenceFusion.setTransitionListener(&SensorManager::onPresenceChange, this);
+    pirSensor.setRawEdgeListener(&SensorManager::onRawPirEdge, this);
 }
 
 bool SensorManager::begin() {
-    Serial.println("SensorManager::begin() called");
+    LOG_DEBUG("SensorManager::begin() called");
     
     // Initialize PIR sensor
     if (!pirSensor.begin()) {
-        Serial.println("SensorManager: Failed to initialize PIR sensor");
+        LOG_ERROR("SensorManager: Failed to initialize PIR sensor");
         return false;
     }
     
     // Initialize radar sensor
     if (!radarSensor.begin()) {
-        Serial.println("SensorManager: Failed to initialize radar sensor");
+        LOG_ERROR("SensorManager: Failed to initialize radar sensor");
         return false;
     }
     
     // Initialize power status
     if (!powerStatus.begin()) {
-        Serial.println("SensorManager: Failed to initialize power status");
+        LOG_ERROR("SensorManager: Failed to initialize power status");
         return false;
     }
+    lastUsbPower = powerStatus.isUsbPowerConnected();
+    lastCharging = powerStatus.getData().charging;
+
+    // Boot readings, before the sensor task takes over as the only writer
+    publishSnapshots();
+
+    // Tracing is optional: run without it if the filesystem is unusable
+    traceRecorder.begin();
     
-    Serial.println("SensorManager initialized successfully");
+    LOG_INFO("SensorManager initialized successfully");
     return true;
 }
 
@@ -38,23 +66,504 @@ void SensorManager::update() {
     // Implementation will be expanded in Phase 4
 }
 
-PirData SensorManager::getPirData() {
-    Serial.println("SensorManager::getPirData() called");
-    return pirSensor.getData();
+void SensorManager::registerTasks(Scheduler& scheduler) {
+    scheduler.addTask("radar", [](void* context) {
+        static_cast<SensorManager*>(context)->updateRadarSensor();
+    }, this, SENSOR_UPDATE_INTERVAL, 0, ProfileSlot::SENSORS);
+
+    // PIR edges are handled as soon as the ISR queues them
+    scheduler.addDeadlineTask("pir",
+        [](void* context) { static_cast<SensorManager*>(context)->updatePirSensor(); },
+        [](void* context, unsigned long& deadline) {
+            return static_cast<const SensorManager*>(context)->pirSensor.getNextDeadline(deadline);
+        },
+        this, ProfileSlot::SENSORS);
+
+    scheduler.addTask("power", [](void* context) {
+        static_cast<SensorManager*>(context)->updatePowerStatus();
+    }, this, POWER_UPDATE_INTERVAL, 0, ProfileSlot::SENSORS);
+
+    // Collects the battery ADC burst started by the power task
+    scheduler.addDeadlineTask("battery",
+        [](void* context) { static_cast<SensorManager*>(context)->updateBattery(); },
+        [](void* context, unsigned long& deadline) {
+            return static_cast<const SensorManager*>(context)->powerStatus.getNextDeadline(deadline);
+        },
+        this, ProfileSlot::SENSORS);
+
+    // Due immediately whenever the radar interrupt pin has fired
+    scheduler.addDeadlineTask("radar-irq",
+        [](void* context) { static_cast<SensorManager*>(context)->handleWakeInterrupt(); },
+        [](void* context, unsigned long& deadline) {
+            deadline = millis();
+            return static_cast<const SensorManager*>(context)->wakePending;
+        },
+        this, ProfileSlot::SENSORS);
+
+    // Presence fusion runs on input events; this only fires its cooldown/hold timer
+    scheduler.addDeadlineTask("presence",
+        [](void* context) { static_cast<SensorManager*>(context)->updatePresence(); },
+        [](void* context, unsigned long& deadline) {
+            const SensorManager* manager = static_cast<const SensorManager*>(context);
+            if (manager->configPending) {
+                deadline = millis();
+                return true;
+            }
+            uint32_t fusionDeadline;
+            if (!manager->presenceFusion.getDeadline(fusionDeadline)) {
+                return false;
+            }
+            deadline = fusionDeadline;
+            return true;
+        },
+        this, ProfileSlot::SENSORS);
+
+    // Engineering mode requests and gate log streaming
+    scheduler.addDeadlineTask("gates",
+        [](void* context) { static_cast<SensorManager*>(context)->updateGateStream(); },
+        [](void* context, unsigned long& deadline) {
+            return static_cast<const SensorManager*>(context)->getGateStreamDeadline(deadline);
+        },
+        this, ProfileSlot::SENSORS);
+
+    // Rolls the aggregation windows at each minute boundary
+    aggregator.begin(millis());
+    scheduler.addDeadlineTask("aggregate",
+        [](void* context) { static_cast<SensorManager*>(context)->updateAggregates(); },
+        [](void* context, unsigned long& deadline) {
+            deadline = static_cast<const SensorManager*>(context)->aggregator.getDeadline();
+            return true;
+        },
+        this, ProfileSlot::SENSORS);
+
+    taskScheduler = &scheduler;
+    pirSensor.enableInterrupt(scheduler);
+    enableWakeInterrupts();
 }
 
-RadarData SensorManager::getRadarData() {
-    Serial.println("SensorManager::getRadarData() called");
-    return radarSensor.getData();
+void SensorManager::setEventListener(Scheduler& scheduler) {
+    eventListener = &scheduler;
 }
 
-PowerData SensorManager::getPowerData() {
-    Serial.println("SensorManager::getPowerData() called");
-    return powerStatus.getData();
+bool SensorManager::popEvent(SensorEvent& event) {
+    return eventQueue.pop(event);
 }
 
-bool SensorManager::isMotionDetected() {
-    Serial.println("SensorManager::isMotionDetected() called");
-    // Implementation will be added in Phase 4
+bool SensorManager::hasPendingEvents() const {
+    return !eventQueue.isEmpty();
+}
+
+void SensorManager::setPresenceConfig(const PresenceConfig& config) {
+    portENTER_CRITICAL(&configLock);
+    const PresenceConfig previous = presenceConfig;
+    presenceConfig = config;
+    configPending = true;
+    portEXIT_CRITICAL(&configLock);
+
+    if (taskScheduler != nullptr) {
+        taskScheduler->notify();
+    }
+
+    // Announce each parameter that actually changed
+    const struct {
+        SettingId id;
+        uint32_t oldValue;
+        uint32_t newValue;
+    } settings[] = {
+        {SettingId::FUSION_COOLDOWN, previous.cooldownMs, config.cooldownMs},
+        {SettingId::FUSION_RADAR_HOLD, previous.holdMs, config.holdMs},
+        {SettingId::FUSION_MOVING_ENERGY, previous.movingEnergyMin, config.movingEnergyMin},
+        {SettingId::FUSION_STATIONARY_ENERGY, previous.stationaryEnergyMin, config.stationaryEnergyMin},
+    };
+    for (const auto& setting : settings) {
+        if (setting.newValue != setting.oldValue) {
+            EventBus::publish(SettingChanged{setting.id, setting.newValue});
+        }
+    }
+}
+
+void SensorManager::getPresenceConfig(PresenceConfig& config) {
+    portENTER_CRITICAL(&configLock);
+    config = presenceConfig;
+    portEXIT_CRITICAL(&configLock);
+}
+
+void SensorManager::requestEngineeringMode(bool enabled) {
+    engineeringRequest = enabled ? 1 : 0;
+    if (taskScheduler != nullptr) {
+        taskScheduler->notify();
+    }
+}
+
+void SensorManager::requestGateStream() {
+    gateStreamRequested = true;
+    if (taskScheduler != nullptr) {
+        taskScheduler->notify();
+    }
+}
+
+void SensorManager::updatePirSensor() {
+    pirSensor.update();
+
+    bool pirMotion = pirSensor.isMotionDetected();
+    if (pirMotion != lastPirMotion) {
+        const uint32_t now = millis();
+        lastPirMotion = pirMotion;
+        currentTrigger = pirSensor.getLastEdgeMicros();
+        publishEvent(SensorEventType::PIR_MOTION, pirMotion, 0);
+
+        TraceRecord record = {};
+        record.type = TraceRecordType::PIR_STATE;
+        record.timestamp = now;
+        record.level = pirMotion;
+        traceRecorder.record(record);
+
+        presenceFusion.setPir(pirMotion, now);
+        if (pirMotion) {
+            aggregator.addMotion(now);
+        }
+        currentTrigger = 0;
+    }
+    publishSnapshots();
+}
+
+void SensorManager::updateRadarSensor() {
+    radarSensor.update();
+
+    const uint32_t now = millis();
+    const RadarData radar = radarSensor.getData();
+    traceRadar(radar, now);
+    presenceFusion.setRadar(radar.movingTargetDetected, radar.movingTargetEnergy,
+                            radar.stationaryTargetDetected, radar.stationaryTargetEnergy, now);
+    if (radar.movingTargetDetected || radar.stationaryTargetDetected) {
+        // Polls between radar reports (and wake-interrupt polls) repeat the last frame
+        aggregator.addRadarDistance(radar.movingTargetDetected ? radar.movingTargetDistance
+                                                               : radar.stationaryTargetDistance,
+                                    radarSensor.getFrameCount(), now);
+    }
+
+    bool radarPresence = radarSensor.isMovingTargetDetected() || radarSensor.isStationaryTargetDetected();
+    if (radarPresence != lastRadarPresence) {
+        lastRadarPresence = radarPresence;
+        publishEvent(SensorEventType::RADAR_PRESENCE, radarPresence, 0);
+    }
+    publishSnapshots();
+}
+
+void SensorManager::updatePowerStatus() {
+    powerStatus.update();
+    tracePower(powerStatus.getData(), millis());
+    traceRecorder.poll();
+
+    bool usbPower = powerStatus.isUsbPowerConnected();
+    if (usbPower != lastUsbPower) {
+        lastUsbPower = usbPower;
+        publishEvent(SensorEventType::POWER_SOURCE, usbPower, 0);
+        EventBus::publish(PowerSourceChanged{usbPower, powerStatus.getBatteryPercentage(),
+                                             static_cast<uint32_t>(millis())});
+    }
+
+    const bool charging = powerStatus.getData().charging;
+    if (charging != lastCharging) {
+        lastCharging = charging;
+        publishEvent(SensorEventType::CHARGING, charging, 0);
+    }
+    publishSnapshots();
+}
+
+void SensorManager::updateBattery() {
+    if (powerStatus.collectBurst()) {
+        const PowerData power = powerStatus.getData();
+        aggregator.addBatteryReading(static_cast<uint16_t>(power.batteryVoltage * 1000.0f + 0.5f), millis());
+    }
+    publishSnapshots();
+}
+
+void SensorManager::updateAggregates() {
+    if (!aggregator.advance(millis())) {
+        return;
+    }
+
+    // Zeroed padding: the seqlock compares the bytes
+    SensorAggregates aggregates{};
+    aggregator.getAggregates(aggregates);
+    aggregateSnapshot.publish(aggregates);
+    if (eventListener != nullptr) {
+        eventListener->notify();
+    }
+}
+
+void SensorManager::publishSnapshots() {
+    const PirData pir = pirSensor.getData();
+    const RadarData radar = radarSensor.getData();
+    const PowerData power = powerStatus.getData();
+
+    bool changed = pirSnapshot.publish(pir);
+    changed |= radarSnapshot.publish(radar);
+    changed |= powerSnapshot.publish(power);
+    if (!changed) {
+        return;
+    }
+
+    SensorData data{};
+    data.pirMotionDetected = pir.motionDetected;
+    data.ld2410sPresenceDetected = radar.movingTargetDetected || radar.stationaryTargetDetected;
+    data.ld2410sMovementDetected = radar.movingTargetDetected;
+    data.isUsbPowered = power.usbPowerConnected;
+    data.isBatteryCharging = power.charging;
+    data.isChargeComplete = power.usbPowerConnected && !power.charging;
+    data.batteryVoltage = power.batteryVoltage;
+    data.ld2410sDistance = radar.movingTargetDetected ? radar.movingTargetDistance : radar.stationaryTargetDistance;
+    data.lastPirTrigger = pir.lastDetectionTime;
+    data.lastLd2410sTrigger = radar.lastUpdateTime;
+    sensorSnapshot.publish(data);
+}
+
+void SensorManager::traceRadar(const RadarData& radar, uint32_t timestamp) {
+    if (!traceRecorder.isEnabled() ||
+        (radar.movingTargetDetected == tracedRadar.movingTargetDetected &&
+         radar.stationaryTargetDetected == tracedRadar.stationaryTargetDetected &&
+         radar.movingTargetDistance == tracedRadar.movingTargetDistance &&
+         radar.movingTargetEnergy == tracedRadar.movingTargetEnergy &&
+         radar.stationaryTargetDistance == tracedRadar.stationaryTargetDistance &&
+         radar.stationaryTargetEnergy == tracedRadar.stationaryTargetEnergy)) {
+        return;
+    }
+    tracedRadar = radar;
+
+    TraceRecord record = {};
+    record.type = TraceRecordType::RADAR;
+    record.timestamp = timestamp;
+    record.moving = radar.movingTargetDetected;
+    record.stationary = radar.stationaryTargetDetected;
+    record.movingDistance = radar.movingTargetDistance;
+    record.movingEnergy = static_cast<uint8_t>(radar.movingTargetEnergy);
+    record.stationaryDistance = radar.stationaryTargetDistance;
+    record.stationaryEnergy = static_cast<uint8_t>(radar.stationaryTargetEnergy);
+    traceRecorder.record(record);
+}
+
+void SensorManager::tracePower(const PowerData& power, uint32_t timestamp) {
+    const uint16_t millivolts = static_cast<uint16_t>(power.batteryVoltage * 1000.0f + 0.5f);
+    if (!traceRecorder.isEnabled() ||
+        (power.usbPowerConnected == tracedPower.usbPowerConnected &&
+         power.batteryLow == tracedPower.batteryLow &&
+         power.batteryPercentage == tracedPower.batteryPercentage &&
+         millivolts == static_cast<uint16_t>(tracedPower.batteryVoltage * 1000.0f + 0.5f))) {
+        return;
+    }
+    tracedPower = power;
+
+    TraceRecord record = {};
+    record.type = TraceRecordType::POWER;
+    record.timestamp = timestamp;
+    record.usbPower = power.usbPowerConnected;
+    record.batteryLow = power.batteryLow;
+    record.batteryPercentage = power.batteryPercentage;
+    record.batteryMillivolts = millivolts;
+    traceRecorder.record(record);
+}
+
+void SensorManager::onRawPirEdge(void* context, bool level, uint32_t micros) {
+    SensorManager* manager = static_cast<SensorManager*>(context);
+    if (!manager->traceRecorder.isEnabled()) {
+        return;
+    }
+
+    // Convert the edge timestamp to the millis() time base
+    const uint32_t ageUs = static_cast<uint32_t>(esp_timer_get_time()) - micros;
+
+    TraceRecord record = {};
+    record.type = TraceRecordType::PIR_EDGE;
+    record.timestamp = millis() - ageUs / 1000;
+    record.level = level;
+    manager->traceRecorder.record(record);
+}
+
+void SensorManager::updatePresence() {
+    if (configPending) {
+        PresenceConfig config;
+        portENTER_CRITICAL(&configLock);
+        config = presenceConfig;
+        configPending = false;
+        portEXIT_CRITICAL(&configLock);
+
+        presenceFusion.setConfig(config);
+        LOG_INFO("[PRESENCE] Cooldown %lu ms, hold %lu ms, energy >= %u moving / %u stationary",
+                 static_cast<unsigned long>(config.cooldownMs), static_cast<unsigned long>(config.holdMs),
+                 config.movingEnergyMin, config.stationaryEnergyMin);
+    }
+
+    presenceFusion.advance(millis());
+}
+
+void SensorManager::onPresenceChange(void* context, bool present, uint32_t timestamp) {
+    SensorManager* manager = static_cast<SensorManager*>(context);
+    manager->publishEvent(SensorEventType::PRESENCE, present, 0);
+    manager->aggregator.setPresence(present, timestamp);
+    EventBus::publish(PresenceChanged{present, timestamp});
+}
+
+void SensorManager::updateGateStream() {
+    const int8_t request = engineeringRequest;
+    if (request >= 0) {
+        engineeringRequest = -1;
+        radarSensor.setEngineeringMode(request != 0);
+    }
+
+    if (gateStreamRequested) {
+        gateStreamRequested = false;
+
+        // Stream what has been captured so far; newer frames wait for the next request
+        const GateEnergyLog& log = radarSensor.getGateLog();
+        if (log.getCount() == 0) {
+            LOG_ERROR("[GATES] Error: No per-gate frames captured, engineering mode is %s",
+                      radarSensor.isEngineeringActive() ? "on but no standard reports arrived" : "off");
+        } else {
+            gateStreaming = true;
+            streamHeaderPending = true;
+            streamGate = 0;
+            streamSequence = log.getFirstSequence();
+            streamEnd = log.getNextSequence();
+        }
+    }
+
+    for (uint8_t i = 0; i < GATE_STREAM_BATCH && gateStreaming; i++) {
+        if (!streamNextLine()) {
+            break;
+        }
+    }
+    lastStreamRun = millis();
+}
+
+bool SensorManager::streamNextLine() {
+    const GateEnergyLog& log = radarSensor.getGateLog();
+    const uint8_t statsLines = GateEnergyLog::GATE_COUNT;
+    char line[GATE_LINE_SIZE];
+    int length;
+    bool endLine = false;
+
+    if (streamHeaderPending) {
+        length = snprintf(line, sizeof(line),
+                          "[GATES] %u frames, %u gates; CSV: G,ms,energy per gate...\n",
+                          log.getCount(), GateEnergyLog::GATE_COUNT);
+    } else if (streamGate < statsLines) {
+        // Rolling statistics first, one line per gate: min/max/mean
+        GateEnergyLog::GateStats stats = {};
+        log.getStats(streamGate, stats);
+        length = snprintf(line, sizeof(line), "[GATES] gate %u %lu/%lu/%lu\n", streamGate,
+                          static_cast<unsigned long>(stats.min), static_cast<unsigned long>(stats.max),
+                          static_cast<unsigned long>(stats.mean));
+    } else {
+        // Frames overwritten while streaming are skipped
+        if (static_cast<int32_t>(streamSequence - log.getFirstSequence()) < 0) {
+            streamSequence = log.getFirstSequence();
+        }
+        endLine = static_cast<int32_t>(streamSequence - streamEnd) >= 0;
+        if (endLine) {
+            length = snprintf(line, sizeof(line), "[GATES] End\n");
+        } else {
+            length = snprintf(line, sizeof(line), "G,%lu",
+                              static_cast<unsigned long>(log.getTimestamp(streamSequence)));
+            for (uint8_t gate = 0; gate < GateEnergyLog::GATE_COUNT; gate++) {
+                length += snprintf(line + length, sizeof(line) - length, ",%lu",
+                                   static_cast<unsigned long>(log.getEnergy(gate, streamSequence)));
+            }
+            length += snprintf(line + length, sizeof(line) - length, "\n");
+        }
+    }
+
+    // Never block the sensor task on a slow or disconnected console
+    if (Serial.availableForWrite() < static_cast<size_t>(length)) {
+        return false;
+    }
+
+    Serial.write(reinterpret_cast<const uint8_t*>(line), length);
+    if (streamHeaderPending) {
+        streamHeaderPending = false;
+    } else if (streamGate < statsLines) {
+        streamGate++;
+    } else if (endLine) {
+        gateStreaming = false;
+    } else {
+        streamSequence++;
+    }
+    return true;
+}
+
+bool SensorManager::getGateStreamDeadline(unsigned long& deadline) const {
+    if (engineeringRequest >= 0 || gateStreamRequested) {
+        deadline = millis();
+        return true;
+    }
+
+    if (gateStreaming) {
+        deadline = lastStreamRun + GATE_STREAM_INTERVAL;
+        return true;
+    }
+
     return false;
 }
+
+void SensorManager::enableWakeInterrupts() {
+    // Another driver may already have installed the shared GPIO ISR service
+    const esp_err_t result = gpio_install_isr_service(0);
+    if (result != ESP_OK && result != ESP_ERR_INVALID_STATE) {
+        LOG_ERROR("SensorManager: Failed to install GPIO ISR service (%d)", result);
+        return;
+    }
+
+    pinMode(RADAR_WAKE_PIN, INPUT);
+    gpio_isr_handler_add(RADAR_WAKE_PIN, &SensorManager::onWakeInterrupt, this);
+    armWakeInterrupts();
+}
+
+void SensorManager::armWakeInterrupts() {
+    // Light sleep can only wake on a level, so wait for the opposite one (= next edge)
+    gpio_wakeup_enable(RADAR_WAKE_PIN, gpio_get_level(RADAR_WAKE_PIN) ? GPIO_INTR_LOW_LEVEL : GPIO_INTR_HIGH_LEVEL);
+    gpio_intr_enable(RADAR_WAKE_PIN);
+}
+
+void SensorManager::handleWakeInterrupt() {
+    wakePending = false;
+
+    currentTrigger = wakeMicros;
+    updateRadarSensor();
+    currentTrigger = 0;
+
+    armWakeInterrupts();
+}
+
+void IRAM_ATTR SensorManager::onWakeInterrupt(void* arg) {
+    SensorManager* manager = static_cast<SensorManager*>(arg);
+
+    // A level interrupt keeps firing until the task has read and re-armed the pin
+    gpio_intr_disable(RADAR_WAKE_PIN);
+
+    if (!manager->wakePending) {
+        manager->wakeMicros = static_cast<uint32_t>(esp_timer_get_time());
+        manager->wakePending = true;
+    }
+    if (manager->taskScheduler != nullptr) {
+        manager->taskScheduler->notifyFromIsr();
+    }
+}
+
+void SensorManager::publishEvent(SensorEventType type, bool active, uint16_t value) {
+    SensorEvent event;
+    event.type = type;
+    event.active = active;
+    event.value = value;
+    event.timestamp = millis();
+    event.triggerMicros = currentTrigger;
+
+    // Never blocks: a full queue drops the event and counts it
+    if (eventQueue.push(event) && eventListener != nullptr) {
+        eventListener->notify();
+    }
+}
+
+bool SensorManager::isMotionDetected() {
+    LOG_VERBOSE("SensorManager::isMotionDetected() called");
+    return presenceFusion.isPresent();
+}
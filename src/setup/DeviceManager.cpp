@@ -1,12 +1,14 @@
 #include "setup/DeviceManager.h"
 #include "config/Pins.h"
+#include "config/Settings.h"
+#include "utilities/Logger.h"
 
 DeviceManager::DeviceManager() 
     : factoryResetActive(false), buttonPressStart(0), lastButtonState(HIGH) {
 }
 
 bool DeviceManager::begin() {
-    Serial.println("DeviceManager::begin() called");
+    LOG_DEBUG("DeviceManager::begin() called");
     // Implementation will be added in Phase 3
     return true;
 }
@@ -16,13 +18,19 @@ void DeviceManager::update() {
     // Implementation will be added in Phase 3
 }
 
+void DeviceManager::registerTasks(Scheduler& scheduler) {
+    scheduler.addTask("device", [](void* context) {
+        static_cast<DeviceManager*>(context)->update();
+    }, this, DEVICE_UPDATE_INTERVAL, 0, ProfileSlot::DEVICE);
+}
+
 bool DeviceManager::isFactoryResetActive() {
-    Serial.println("DeviceManager::isFactoryResetActive() called");
+    LOG_VERBOSE("DeviceManager::isFactoryResetActive() called");
     return factoryResetActive;
 }
 
 void DeviceManager::triggerFactoryReset() {
-    Serial.println("DeviceManager::triggerFactoryReset() called");
+    LOG_DEBUG("DeviceManager::triggerFactoryReset() called");
     factoryResetActive = true;
     // Implementation will be added in Phase 3
 }
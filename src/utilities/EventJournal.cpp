@@ -0,0 +1,323 @@
+#include "utilities/EventJournal.h"
+
+static_assert(EVENT_JOURNAL_SEGMENT_COUNT >= 2, "The journal needs a segment to drop and one to write");
+
+namespace {
+
+// Record layout, little endian:
+//   0 sequence (4), 4 timestamp (4), 8 session (2), 10 type, 11 active,
+//   12 value (2), 14 reserved, 15 CRC-8 of bytes 0-14
+// ACK records carry the last sent event's sequence in the timestamp field.
+constexpr uint8_t TYPE_ACK = 0xFF;
+
+// Records read per storage access while recovering
+constexpr uint8_t RECOVERY_CHUNK = 16;
+
+uint32_t get32(const uint8_t* data) {
+    return data[0] | (data[1] << 8) | (data[2] << 16) | (static_cast<uint32_t>(data[3]) << 24);
+}
+
+uint16_t get16(const uint8_t* data) {
+    return static_cast<uint16_t>(data[0] | (data[1] << 8));
+}
+
+void put32(uint8_t* data, uint32_t value) {
+    for (uint8_t i = 0; i < 4; i++) {
+        data[i] = static_cast<uint8_t>(value >> (8 * i));
+    }
+}
+
+void put16(uint8_t* data, uint16_t value) {
+    data[0] = static_cast<uint8_t>(value);
+    data[1] = static_cast<uint8_t>(value >> 8);
+}
+
+// CRC-8, polynomial 0x07
+uint8_t crc8(const uint8_t* data, size_t length) {
+    uint8_t crc = 0;
+    for (size_t i = 0; i < length; i++) {
+        crc ^= data[i];
+        for (uint8_t bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x80) ? static_cast<uint8_t>((crc << 1) ^ 0x07) : static_cast<uint8_t>(crc << 1);
+        }
+    }
+    return crc;
+}
+
+}
+
+bool EventJournal::begin() {
+    ready = storage.begin();
+    if (ready) {
+        recover();
+    }
+    return ready;
+}
+
+bool EventJournal::push(uint8_t type, bool active, uint16_t value, uint32_t timestamp) {
+    uint8_t record[RECORD_SIZE];
+    encode(record, lastSequence + 1, timestamp, type, active, value);
+    if (!ready || !append(record)) {
+        droppedCount++;
+        return false;
+    }
+
+    lastSequence++;
+    segments[tail].pending++;
+    depth++;
+    return true;
+}
+
+bool EventJournal::drain(uint32_t now, Sender send, void* context) {
+    if (depth == 0 || sentSequence != 0 || static_cast<int32_t>(now - nextDrain) < 0) {
+        return false;
+    }
+
+    JournalEvent event;
+    if (!peek(event) || !send(context, event)) {
+        return false;
+    }
+    // Stays at the read position until the broker acknowledges it
+    sentSequence = event.sequence;
+    nextDrain = now + EVENT_DRAIN_INTERVAL;
+    return true;
+}
+
+void EventJournal::acknowledge() {
+    if (sentSequence == 0) {
+        return;
+    }
+    const uint32_t sequence = sentSequence;
+    sentSequence = 0;
+    pop(sequence);
+}
+
+void EventJournal::recover() {
+    uint8_t chunk[RECOVERY_CHUNK * RECORD_SIZE];
+    uint32_t firstSequence[EVENT_JOURNAL_SEGMENT_COUNT] = {};
+    uint16_t lastSession = 0;
+    bool found = false;
+
+    // Pass 1: valid records per segment, newest sequence and the last ACK
+    for (uint8_t segment = 0; segment < EVENT_JOURNAL_SEGMENT_COUNT; segment++) {
+        size_t available = storage.size(segment) / RECORD_SIZE;
+        if (available > EVENT_JOURNAL_SEGMENT_RECORDS) {
+            available = EVENT_JOURNAL_SEGMENT_RECORDS;
+        }
+
+        uint16_t valid = 0;
+        bool intact = true;
+        while (intact && valid < available) {
+            const size_t count = available - valid < RECOVERY_CHUNK ? available - valid : RECOVERY_CHUNK;
+            if (!storage.read(segment, valid * RECORD_SIZE, chunk, count * RECORD_SIZE)) {
+                break;
+            }
+            for (size_t i = 0; i < count; i++) {
+                const uint8_t* record = chunk + i * RECORD_SIZE;
+                if (!isValid(record)) {
+                    intact = false;
+                    break;
+                }
+                const uint32_t sequence = get32(record);
+                if (valid == 0) {
+                    firstSequence[segment] = sequence;
+                }
+                if (sequence > lastSequence) {
+                    lastSequence = sequence;
+                }
+                if (get16(record + 8) > lastSession) {
+                    lastSession = get16(record + 8);
+                }
+                if (record[10] == TYPE_ACK && get32(record + 4) > ackedSequence) {
+                    ackedSequence = get32(record + 4);
+                }
+                valid++;
+            }
+        }
+
+        if (valid == 0) {
+            // Nothing usable, possibly a torn first record
+            eraseSegment(segment);
+            continue;
+        }
+        segments[segment].records = valid;
+        if (!found || firstSequence[segment] > firstSequence[tail]) {
+            tail = segment;
+            found = true;
+        }
+        // Never append behind a torn record
+        if (tail == segment) {
+            tailBroken = valid < storage.size(segment) / RECORD_SIZE ||
+                         storage.size(segment) % RECORD_SIZE != 0;
+        }
+    }
+    session = lastSession + 1;
+
+    // Pass 2: events after the last ACK are still to be sent
+    for (uint8_t segment = 0; segment < EVENT_JOURNAL_SEGMENT_COUNT; segment++) {
+        for (uint16_t done = 0; done < segments[segment].records;) {
+            const uint16_t count = segments[segment].records - done < RECOVERY_CHUNK
+                                       ? segments[segment].records - done : RECOVERY_CHUNK;
+            if (!storage.read(segment, done * RECORD_SIZE, chunk, count * RECORD_SIZE)) {
+                break;
+            }
+            for (uint16_t i = 0; i < count; i++) {
+                const uint8_t* record = chunk + i * RECORD_SIZE;
+                if (record[10] != TYPE_ACK && get32(record) > ackedSequence) {
+                    segments[segment].pending++;
+                }
+            }
+            done += count;
+        }
+        depth += segments[segment].pending;
+    }
+
+    if (depth == 0) {
+        clear();
+        return;
+    }
+
+    // Oldest segment follows the tail in ring order
+    readSegment = tail;
+    for (uint8_t step = 1; step < EVENT_JOURNAL_SEGMENT_COUNT; step++) {
+        const uint8_t segment = (tail + step) % EVENT_JOURNAL_SEGMENT_COUNT;
+        if (segments[segment].records > 0) {
+            readSegment = segment;
+            break;
+        }
+    }
+    readIndex = 0;
+}
+
+bool EventJournal::peek(JournalEvent& event) {
+    for (;;) {
+        Segment& segment = segments[readSegment];
+        if (readIndex >= segment.records) {
+            if (readSegment == tail) {
+                // Counts and files disagree: give up on what cannot be found
+                droppedCount += depth;
+                depth = 0;
+                clear();
+                return false;
+            }
+            // Fully sent: the segment can go
+            droppedCount += segment.pending;
+            depth -= segment.pending;
+            eraseSegment(readSegment);
+            readSegment = (readSegment + 1) % EVENT_JOURNAL_SEGMENT_COUNT;
+            readIndex = 0;
+            continue;
+        }
+
+        uint8_t record[RECORD_SIZE];
+        if (!storage.read(readSegment, readIndex * RECORD_SIZE, record, RECORD_SIZE)) {
+            return false;
+        }
+        if (!isValid(record)) {
+            // Corrupted since recovery: the segment ends here
+            segment.records = readIndex;
+            if (readSegment == tail) {
+                tailBroken = true;
+            }
+            continue;
+        }
+
+        const uint32_t sequence = get32(record);
+        if (record[10] == TYPE_ACK || sequence <= ackedSequence) {
+            readIndex++;
+            continue;
+        }
+
+        event.sequence = sequence;
+        event.timestamp = get32(record + 4);
+        event.type = record[10];
+        event.active = record[11] != 0;
+        event.value = get16(record + 12);
+        event.previousBoot = get16(record + 8) != session;
+        return true;
+    }
+}
+
+void EventJournal::pop(uint32_t sequence) {
+    readIndex++;
+    segments[readSegment].pending--;
+    depth--;
+    ackedSequence = sequence;
+
+    if (depth == 0) {
+        // Everything is sent: leave no files behind
+        clear();
+        return;
+    }
+
+    if (++unackedCount >= EVENT_DRAIN_COMMIT) {
+        uint8_t record[RECORD_SIZE];
+        encode(record, lastSequence + 1, ackedSequence, TYPE_ACK, false, 0);
+        if (append(record)) {
+            lastSequence++;
+        }
+        unackedCount = 0;
+    }
+}
+
+bool EventJournal::append(const uint8_t* record) {
+    if (tailBroken || segments[tail].records >= EVENT_JOURNAL_SEGMENT_RECORDS) {
+        startSegment();
+    }
+    if (!storage.append(tail, record, RECORD_SIZE)) {
+        tailBroken = true;
+        return false;
+    }
+    segments[tail].records++;
+    return true;
+}
+
+void EventJournal::startSegment() {
+    const uint8_t next = (tail + 1) % EVENT_JOURNAL_SEGMENT_COUNT;
+    if (segments[next].records > 0) {
+        // Ring full: the oldest segment makes room
+        droppedCount += segments[next].pending;
+        depth -= segments[next].pending;
+        if (readSegment == next) {
+            readSegment = (next + 1) % EVENT_JOURNAL_SEGMENT_COUNT;
+            readIndex = 0;
+            sentSequence = 0;       // A late acknowledgement must not pop another event
+        }
+    }
+    eraseSegment(next);
+    tail = next;
+    tailBroken = false;
+}
+
+void EventJournal::clear() {
+    for (uint8_t segment = 0; segment < EVENT_JOURNAL_SEGMENT_COUNT; segment++) {
+        eraseSegment(segment);
+    }
+    tail = 0;
+    tailBroken = false;
+    readSegment = 0;
+    readIndex = 0;
+    unackedCount = 0;
+    sentSequence = 0;
+}
+
+void EventJournal::eraseSegment(uint8_t segment) {
+    storage.erase(segment);
+    segments[segment] = Segment{};
+}
+
+void EventJournal::encode(uint8_t* record, uint32_t sequence, uint32_t timestamp,
+                          uint8_t type, bool active, uint16_t value) const {
+    put32(record, sequence);
+    put32(record + 4, timestamp);
+    put16(record + 8, session);
+    record[10] = type;
+    record[11] = active ? 1 : 0;
+    put16(record + 12, value);
+    record[14] = 0;
+    record[15] = crc8(record, RECORD_SIZE - 1);
+}
+
+bool EventJournal::isValid(const uint8_t* record) {
+    return crc8(record, RECORD_SIZE - 1) == record[RECORD_SIZE - 1];
+}
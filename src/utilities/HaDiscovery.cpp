@@ -0,0 +1,90 @@
+#include "utilities/HaDiscovery.h"
+#include <stdio.h>
+#include "utilities/JsonWriter.h"
+
+const HaDiscovery::Entity HaDiscovery::ENTITIES[ENTITY_COUNT] = {
+    { "binary_sensor", "presence", "Presence", "occupancy",
+      MqttTopics::PRESENCE, MqttTopics::COUNT, nullptr, nullptr },
+    { "binary_sensor", "charging", "Charging", "battery_charging",
+      MqttTopics::CHARGING, MqttTopics::COUNT, nullptr, nullptr },
+    { "binary_sensor", "power", "Power", "power",
+      MqttTopics::POWER, MqttTopics::COUNT, nullptr, nullptr },
+    { "sensor", "cpu_temperature", "CPU Temperature", "temperature",
+      MqttTopics::SYSTEM, MqttTopics::COUNT, "\xC2\xB0" "C", "{{ value_json.temp_c }}" },
+    { "sensor", "free_heap", "Free Heap", "data_size",
+      MqttTopics::SYSTEM, MqttTopics::COUNT, "B", "{{ value_json.free_heap }}" },
+    { "number", "brightness", "LED Brightness", nullptr,
+      MqttTopics::BRIGHTNESS_STATE, MqttTopics::BRIGHTNESS_COMMAND, nullptr, nullptr },
+    { "switch", "stealth", "Stealth Mode", nullptr,
+      MqttTopics::STEALTH_STATE, MqttTopics::STEALTH_COMMAND, nullptr, nullptr },
+};
+
+bool HaDiscovery::build(const MqttTopics& topics, const char* prefix, const char* deviceName,
+                        const char* firmwareVersion) {
+    const char* deviceId = topics.getDeviceId();
+    char uniqueId[MqttTopics::DEVICE_ID_SIZE + 24];
+    used = 0;
+    hash = 0;
+
+    for (uint8_t i = 0; i < ENTITY_COUNT; i++) {
+        const Entity& entity = ENTITIES[i];
+
+        const int topicLength = snprintf(blob + used, sizeof(blob) - used, "%s/%s/%s/%s/config",
+                                         prefix, entity.component, deviceId, entity.object);
+        if (topicLength < 0 || static_cast<size_t>(topicLength) >= sizeof(blob) - used) {
+            return false;
+        }
+        topicOffsets[i] = static_cast<uint16_t>(used);
+        used += topicLength + 1;
+
+        snprintf(uniqueId, sizeof(uniqueId), "%s_%s", deviceId, entity.object);
+        JsonWriter json(blob + used, sizeof(blob) - used);
+        json.beginObject()
+            .addString("name", entity.name)
+            .addString("uniq_id", uniqueId)
+            .addString("stat_t", topics.get(entity.state))
+            .addString("avty_t", topics.get(MqttTopics::AVAILABILITY));
+        if (entity.command != MqttTopics::COUNT) {
+            json.addString("cmd_t", topics.get(entity.command));
+        }
+        if (entity.deviceClass != nullptr) {
+            json.addString("dev_cla", entity.deviceClass);
+        }
+        if (entity.unit != nullptr) {
+            json.addString("unit_of_meas", entity.unit)
+                .addString("stat_cla", "measurement");
+        }
+        if (entity.valueTemplate != nullptr) {
+            json.addString("val_tpl", entity.valueTemplate)
+                .addString("ent_cat", "diagnostic");
+        }
+        if (entity.command == MqttTopics::BRIGHTNESS_COMMAND) {
+            json.addUint("min", 0)
+                .addUint("max", 255);
+        }
+        json.beginObject("dev")
+                .beginArray("ids").addString(nullptr, deviceId).endArray()
+                .addString("name", deviceName)
+                .addString("mf", "HearthGuard")
+                .addString("mdl", "The Scout")
+                .addString("sw", firmwareVersion)
+            .endObject()
+            .endObject();
+
+        const size_t payloadLength = json.finish();
+        if (payloadLength == 0) {
+            return false;
+        }
+        payloadOffsets[i] = static_cast<uint16_t>(used);
+        payloadLengths[i] = static_cast<uint16_t>(payloadLength);
+        used += payloadLength + 1;
+    }
+
+    // FNV-1a over topics and payloads alike
+    uint32_t value = 2166136261u;
+    for (size_t i = 0; i < used; i++) {
+        value = (value ^ static_cast<uint8_t>(blob[i])) * 16777619u;
+    }
+    hash = value != 0 ? value : 1;
+    return true;
+}
@@ -0,0 +1,58 @@
+#include "utilities/EventJournal.h"
+#include <Arduino.h>
+#include <LittleFS.h>
+
+namespace {
+
+void segmentPath(uint8_t segment, char* path, size_t size) {
+    snprintf(path, size, "/events%u.bin", segment);
+}
+
+}
+
+bool JournalStorage::begin() {
+    // Shared with TraceRecorder; mounting again is a no-op
+    return LittleFS.begin(true);
+}
+
+size_t JournalStorage::size(uint8_t segment) {
+    char path[24];
+    segmentPath(segment, path, sizeof(path));
+    if (!LittleFS.exists(path)) {
+        return 0;
+    }
+    fs::File file = LittleFS.open(path, "r");
+    const size_t length = file ? file.size() : 0;
+    file.close();
+    return length;
+}
+
+bool JournalStorage::read(uint8_t segment, size_t offset, void* data, size_t length) {
+    char path[24];
+    segmentPath(segment, path, sizeof(path));
+    fs::File file = LittleFS.open(path, "r");
+    if (!file) {
+        return false;
+    }
+    const bool ok = file.seek(offset) && file.read(static_cast<uint8_t*>(data), length) == length;
+    file.close();
+    return ok;
+}
+
+bool JournalStorage::append(uint8_t segment, const void* data, size_t length) {
+    char path[24];
+    segmentPath(segment, path, sizeof(path));
+    fs::File file = LittleFS.open(path, "a");
+    if (!file) {
+        return false;
+    }
+    const bool ok = file.write(static_cast<const uint8_t*>(data), length) == length;
+    file.close();
+    return ok;
+}
+
+bool JournalStorage::erase(uint8_t segment) {
+    char path[24];
+    segmentPath(segment, path, sizeof(path));
+    return !LittleFS.exists(path) || LittleFS.remove(path);
+}
@@ -0,0 +1,194 @@
+#include "utilities/JsonWriter.h"
+#include <string.h>
+
+JsonWriter::JsonWriter(char* buffer, size_t size)
+    : buffer(buffer), size(size) {
+    valid = buffer != nullptr && size > 0;
+}
+
+JsonWriter& JsonWriter::beginObject(const char* key) {
+    return open(key, '{');
+}
+
+JsonWriter& JsonWriter::endObject() {
+    return close('}');
+}
+
+JsonWriter& JsonWriter::beginArray(const char* key) {
+    return open(key, '[');
+}
+
+JsonWriter& JsonWriter::endArray() {
+    return close(']');
+}
+
+JsonWriter& JsonWriter::addString(const char* key, const char* value) {
+    prefix(key);
+    put('"');
+    putEscaped(value);
+    put('"');
+    return *this;
+}
+
+JsonWriter& JsonWriter::addInt(const char* key, int32_t value) {
+    prefix(key);
+    if (value < 0) {
+        put('-');
+        putUnsigned(0u - static_cast<uint32_t>(value));
+    } else {
+        putUnsigned(static_cast<uint32_t>(value));
+    }
+    return *this;
+}
+
+JsonWriter& JsonWriter::addUint(const char* key, uint32_t value) {
+    prefix(key);
+    putUnsigned(value);
+    return *this;
+}
+
+JsonWriter& JsonWriter::addBool(const char* key, bool value) {
+    prefix(key);
+    put(value ? "true" : "false");
+    return *this;
+}
+
+JsonWriter& JsonWriter::addFixed(const char* key, int32_t value, uint8_t decimals) {
+    static const uint32_t POWERS[] = {1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000};
+    if (decimals > 9) {
+        valid = false;
+        return *this;
+    }
+
+    prefix(key);
+    uint32_t magnitude = static_cast<uint32_t>(value);
+    if (value < 0) {
+        put('-');
+        magnitude = 0u - magnitude;
+    }
+    putUnsigned(magnitude / POWERS[decimals]);
+    if (decimals > 0) {
+        put('.');
+        // Leading zeros of the fraction
+        uint32_t fraction = magnitude % POWERS[decimals];
+        for (uint8_t i = decimals - 1; i > 0 && fraction < POWERS[i]; i--) {
+            put('0');
+        }
+        putUnsigned(fraction);
+    }
+    return *this;
+}
+
+JsonWriter& JsonWriter::addRaw(const char* key, const char* json) {
+    prefix(key);
+    put(json);
+    return *this;
+}
+
+size_t JsonWriter::finish() {
+    if (!valid || depth != 0 || length >= size) {
+        if (size > 0 && buffer != nullptr) {
+            buffer[0] = '\0';
+        }
+        return 0;
+    }
+    buffer[length] = '\0';
+    return length;
+}
+
+JsonWriter& JsonWriter::open(const char* key, char bracket) {
+    prefix(key);
+    put(bracket);
+    if (depth + 1 >= MAX_DEPTH) {
+        valid = false;
+        return *this;
+    }
+    depth++;
+    pendingSeparator &= ~(1u << depth);
+    return *this;
+}
+
+JsonWriter& JsonWriter::close(char bracket) {
+    if (depth == 0) {
+        valid = false;
+        return *this;
+    }
+    depth--;
+    put(bracket);
+    return *this;
+}
+
+void JsonWriter::prefix(const char* key) {
+    const uint16_t bit = 1u << depth;
+    if (pendingSeparator & bit) {
+        put(',');
+    }
+    pendingSeparator |= bit;
+
+    if (key != nullptr) {
+        put('"');
+        putEscaped(key);
+        put("\":", 2);
+    }
+}
+
+void JsonWriter::put(char c) {
+    // Keep one byte for the terminating NUL
+    if (length + 1 < size) {
+        buffer[length++] = c;
+    } else {
+        valid = false;
+    }
+}
+
+void JsonWriter::put(const char* text) {
+    put(text, strlen(text));
+}
+
+void JsonWriter::put(const char* text, size_t count) {
+    if (length + count < size) {
+        memcpy(buffer + length, text, count);
+        length += count;
+    } else {
+        valid = false;
+    }
+}
+
+void JsonWriter::putEscaped(const char* text) {
+    static const char HEX_DIGITS[] = "0123456789abcdef";
+
+    for (;;) {
+        // Copy the run of characters that need no escaping in one go
+        const char* run = text;
+        while (static_cast<uint8_t>(*text) >= 0x20 && *text != '"' && *text != '\\') {
+            text++;
+        }
+        put(run, text - run);
+
+        const char c = *text++;
+        switch (c) {
+            case '\0': return;
+            case '"':  put("\\\"", 2); break;
+            case '\\': put("\\\\", 2); break;
+            case '\n': put("\\n", 2); break;
+            case '\r': put("\\r", 2); break;
+            case '\t': put("\\t", 2); break;
+            default:
+                put("\\u00", 4);
+                put(HEX_DIGITS[c >> 4]);
+                put(HEX_DIGITS[c & 0x0F]);
+                break;
+        }
+    }
+}
+
+void JsonWriter::putUnsigned(uint32_t value) {
+    // Digits are produced least significant first, so fill from the end
+    char digits[10];
+    uint8_t start = sizeof(digits);
+    do {
+        digits[--start] = static_cast<char>('0' + value % 10);
+        value /= 10;
+    } while (value != 0);
+    put(digits + start, sizeof(digits) - start);
+}
@@ -0,0 +1,99 @@
+#include "utilities/Logger.h"
+
+Logger::Record Logger::ring[Logger::CAPACITY];
+std::atomic<size_t> Logger::enqueuePos{0};
+size_t Logger::dequeuePos = 0;
+std::atomic<uint32_t> Logger::droppedCount{0};
+uint32_t Logger::reportedDrops = 0;
+std::atomic<uint32_t> Logger::drainIntervalMs{LOG_DRAIN_INTERVAL};
+
+// Drain task storage
+static StackType_t logTaskStack[LOG_TASK_STACK_SIZE];
+static StaticTask_t logTaskBuffer;
+
+// Longest formatted line, longer messages are truncated
+static constexpr size_t LINE_BUFFER_SIZE = 192;
+
+void Logger::begin() {
+    xTaskCreateStaticPinnedToCore(drainTask, "log", LOG_TASK_STACK_SIZE, nullptr,
+                                  LOG_TASK_PRIORITY, logTaskStack, &logTaskBuffer, LOG_TASK_CORE);
+}
+
+bool Logger::write(uint8_t level, const char* format, const uintptr_t* args, uint8_t argCount) {
+    size_t pos = enqueuePos.load(std::memory_order_relaxed);
+    Record* record;
+
+    // Claim a slot: it is free when its sequence equals our position
+    for (;;) {
+        const size_t slot = pos & (CAPACITY - 1);
+        record = &ring[slot];
+        const size_t sequence = record->sequence.load(std::memory_order_acquire) + slot;
+        const intptr_t difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+
+        if (difference == 0) {
+            if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (difference < 0) {
+            droppedCount.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        } else {
+            pos = enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+
+    record->format = format;
+    record->timestamp = millis();
+    record->level = level;
+    record->argCount = argCount;
+    for (uint8_t i = 0; i < argCount; i++) {
+        record->args[i] = args[i];
+    }
+
+    // Publish to the drain side
+    record->sequence.store(pos + 1 - (pos & (CAPACITY - 1)), std::memory_order_release);
+    return true;
+}
+
+void Logger::drain() {
+    for (;;) {
+        const size_t slot = dequeuePos & (CAPACITY - 1);
+        Record& record = ring[slot];
+        const size_t sequence = record.sequence.load(std::memory_order_acquire) + slot;
+        if (sequence != dequeuePos + 1) {
+            break;          // Empty, or the producer has not finished writing
+        }
+
+        print(record);
+
+        // Hand the slot back to producers one lap later
+        record.sequence.store(dequeuePos + CAPACITY - slot, std::memory_order_release);
+        dequeuePos++;
+    }
+
+    const uint32_t dropped = droppedCount.load(std::memory_order_relaxed);
+    if (dropped != reportedDrops) {
+        Serial.printf("[LOG] %u records dropped (ring full)\n", dropped - reportedDrops);
+        reportedDrops = dropped;
+    }
+}
+
+void Logger::print(const Record& record) {
+    static const char LEVEL_TAGS[] = { ' ', 'E', 'W', 'I', 'D', 'V' };
+    char line[LINE_BUFFER_SIZE];
+
+    // Every argument occupies one word, so they can be replayed positionally;
+    // unused trailing arguments are ignored by printf
+    const uintptr_t* a = record.args;
+    snprintf(line, sizeof(line), record.format, a[0], a[1], a[2], a[3], a[4], a[5], a[6], a[7]);
+
+    const char tag = (record.level < sizeof(LEVEL_TAGS)) ? LEVEL_TAGS[record.level] : '?';
+    Serial.printf("%c %8lu %s\n", tag, static_cast<unsigned long>(record.timestamp), line);
+}
+
+void Logger::drainTask(void* context) {
+    for (;;) {
+        drain();
+        vTaskDelay(pdMS_TO_TICKS(drainIntervalMs.load(std::memory_order_relaxed)));
+    }
+}
@@ -0,0 +1,142 @@
+#include "utilities/LoopProfiler.h"
+
+// ==========================================
+// DurationHistogram
+// ==========================================
+
+void DurationHistogram::record(uint32_t durationUs) {
+    buckets[bucketIndex(durationUs)]++;
+    count++;
+    if (durationUs < minMicros) {
+        minMicros = durationUs;
+    }
+    if (durationUs > maxMicros) {
+        maxMicros = durationUs;
+    }
+}
+
+void DurationHistogram::reset() {
+    for (uint8_t i = 0; i < BUCKET_COUNT; i++) {
+        buckets[i] = 0;
+    }
+    count = 0;
+    minMicros = UINT32_MAX;
+    maxMicros = 0;
+}
+
+uint32_t DurationHistogram::percentile(uint16_t permille) const {
+    if (count == 0) {
+        return 0;
+    }
+
+    // Smallest bucket whose cumulative count reaches the target rank
+    const uint64_t target = (static_cast<uint64_t>(count) * permille + 999) / 1000;
+    uint64_t cumulative = 0;
+
+    for (uint8_t i = 0; i < BUCKET_COUNT; i++) {
+        cumulative += buckets[i];
+        if (cumulative >= target) {
+            const uint32_t upper = bucketUpperBound(i);
+            return (upper < maxMicros) ? upper : maxMicros;
+        }
+    }
+    return maxMicros;
+}
+
+uint8_t DurationHistogram::bucketIndex(uint32_t durationUs) {
+    if (durationUs < 4) {
+        return static_cast<uint8_t>(durationUs);
+    }
+
+    // Octave from the most significant bit, sub-bucket from the next two bits
+    const uint8_t msb = 31 - __builtin_clz(durationUs);
+    const uint8_t sub = (durationUs >> (msb - 2)) & 0x3;
+    return static_cast<uint8_t>(4 + (msb - 2) * 4 + sub);
+}
+
+uint32_t DurationHistogram::bucketUpperBound(uint8_t index) {
+    if (index < 4) {
+        return index;
+    }
+
+    const uint8_t msb = (index - 4) / 4 + 2;
+    const uint8_t sub = (index - 4) % 4;
+    const uint32_t width = 1UL << (msb - 2);
+    const uint32_t lower = (1UL << msb) | (static_cast<uint32_t>(sub) << (msb - 2));
+    return lower + (width - 1);
+}
+
+// ==========================================
+// LoopProfiler
+// ==========================================
+
+void LoopProfiler::record(ProfileSlot slot, uint32_t durationUs) {
+    if (slot < ProfileSlot::COUNT) {
+        histograms[static_cast<uint8_t>(slot)].record(durationUs);
+    }
+}
+
+void LoopProfiler::reset() {
+    for (uint8_t i = 0; i < static_cast<uint8_t>(ProfileSlot::COUNT); i++) {
+        histograms[i].reset();
+    }
+    loopIterations = 0;
+    windowStart = millis();
+}
+
+void LoopProfiler::printReport() const {
+    Serial.printf("[PROFILE] Loop: %u Hz over %lu ms\n", loopFrequency(), millis() - windowStart);
+    Serial.println("[PROFILE] manager       count     min     p50     p99    p999     max (us)");
+
+    for (uint8_t i = 0; i < static_cast<uint8_t>(ProfileSlot::COUNT); i++) {
+        const DurationHistogram& histogram = histograms[i];
+        Serial.printf("[PROFILE] %-10s %8u %7u %7u %7u %7u %7u\n",
+                      slotName(i), histogram.getCount(),
+                      histogram.getMin(),
+                      histogram.percentile(500),
+                      histogram.percentile(990),
+                      histogram.percentile(999),
+                      histogram.getMax());
+    }
+}
+
+size_t LoopProfiler::formatJson(char* buffer, size_t size) const {
+    int written = snprintf(buffer, size, "{\"loop_hz\":%u", loopFrequency());
+    if (written < 0 || static_cast<size_t>(written) >= size) {
+        return 0;
+    }
+    size_t length = written;
+
+    for (uint8_t i = 0; i < static_cast<uint8_t>(ProfileSlot::COUNT); i++) {
+        const DurationHistogram& histogram = histograms[i];
+        written = snprintf(buffer + length, size - length,
+                           ",\"%s\":{\"n\":%u,\"min\":%u,\"p50\":%u,\"p99\":%u,\"p999\":%u,\"max\":%u}",
+                           slotName(i), histogram.getCount(),
+                           histogram.getMin(),
+                           histogram.percentile(500),
+                           histogram.percentile(990),
+                           histogram.percentile(999),
+                           histogram.getMax());
+        if (written < 0 || static_cast<size_t>(written) >= size - length) {
+            return 0;
+        }
+        length += written;
+    }
+
+    if (length + 1 >= size) {
+        return 0;
+    }
+    buffer[length++] = '}';
+    buffer[length] = '\0';
+    return length;
+}
+
+const char* LoopProfiler::slotName(uint8_t slot) {
+    static const char* const NAMES[] = { "feedback", "wifi", "device", "sensors", "mqtt" };
+    return (slot < static_cast<uint8_t>(ProfileSlot::COUNT)) ? NAMES[slot] : "?";
+}
+
+uint32_t LoopProfiler::loopFrequency() const {
+    const unsigned long elapsed = millis() - windowStart;
+    return (elapsed > 0) ? static_cast<uint32_t>((static_cast<uint64_t>(loopIterations) * 1000) / elapsed) : 0;
+}
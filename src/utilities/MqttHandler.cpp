@@ -1,38 +1,478 @@
 #include "utilities/MqttHandler.h"
 #include "config/Settings.h"
+#include "utilities/EventBus.h"
+#include "utilities/JsonWriter.h"
+#include "utilities/Logger.h"
 
 MqttHandler::MqttHandler() 
-    : currentState(MqttState::DISCONNECTED), lastReconnectAttempt(0), 
-      lastHeartbeat(0) {
+    : currentState(MqttState::DISCONNECTED), lastHeartbeat(0) {
 }
 
 bool MqttHandler::begin() {
-    Serial.println("MqttHandler::begin() called");
-    // Implementation will be added in Phase 5
+    LOG_DEBUG("MqttHandler::begin() called");
+
+    // Device id from the factory MAC, e.g. scout-1a2b3c
+    char deviceId[MqttTopics::DEVICE_ID_SIZE];
+    snprintf(deviceId, sizeof(deviceId), "scout-%06x", static_cast<unsigned>(ESP.getEfuseMac() >> 24) & 0xFFFFFF);
+    if (!topics.begin(MQTT_BASE_TOPIC, deviceId)) {
+        LOG_ERROR("[MQTT] Error: Topic prefix too long");
+        return false;
+    }
+    LOG_INFO("[MQTT] Device topics: %s", topics.get(MqttTopics::AVAILABILITY));
+
+    MqttConnection::Config config = {};
+    config.host = MQTT_BROKER;
+    config.port = MQTT_PORT;
+    config.clientId = topics.getDeviceId();
+    config.username = MQTT_USER;
+    config.password = MQTT_PASSWORD;
+    config.willTopic = topics.get(MqttTopics::AVAILABILITY);
+    config.willMessage = "offline";
+    config.keepAliveSeconds = MQTT_KEEPALIVE;
+    config.connectTimeoutMs = MQTT_CONNECT_TIMEOUT;
+    config.retryMinMs = MQTT_RETRY_INTERVAL;
+    config.retryMaxMs = MQTT_RETRY_MAX;
+    config.seed = esp_random();
+    config.inflightWindow = MQTT_INFLIGHT_WINDOW;
+    if (!connection.begin(config)) {
+        LOG_ERROR("[MQTT] Error: Broker must be an IPv4 address: %s", MQTT_BROKER);
+        return false;
+    }
+    connection.setMessageHandler(&MqttHandler::onMessage, this);
+    connection.setAckHandler(&MqttHandler::onAck, this);
+
+    if (!discovery.build(topics, HA_DISCOVERY_PREFIX, DEVICE_NAME, FIRMWARE_VERSION)) {
+        LOG_ERROR("[MQTT] Error: Discovery messages exceed %u bytes", HA_DISCOVERY_BLOB_SIZE);
+    }
+    if (preferences.begin(PREFERENCES_NAMESPACE, true)) {
+        discoveryHash = preferences.getUInt(DISCOVERY_HASH_KEY, 0);
+        preferences.end();
+    }
+
+    if (!journal.begin()) {
+        LOG_ERROR("[MQTT] Error: Event journal unavailable, changes made offline will be lost");
+    } else if (!journal.isEmpty()) {
+        LOG_INFO("[MQTT] %u queued events recovered", journal.getDepth());
+    }
+
+    EventBus::subscribe<WifiStateChanged>(&MqttHandler::onWifiStateChanged, this);
+    EventBus::subscribe<SettingChanged>(&MqttHandler::onSettingChanged, this);
     return true;
 }
 
 void MqttHandler::update() {
-    // Serial.println("MqttHandler::update() called");
-    // Implementation will be added in Phase 5
+    const unsigned long now = millis();
+
+    // PRD Phase 5: only try the broker while WiFi is connected
+    if (wifiConnected) {
+        connection.start(now);
+    } else if (connection.getPhase() != MqttConnection::Phase::IDLE) {
+        connection.stop();
+    }
+    connection.service(now);
+
+    const MqttState state = readState();
+    if (state != currentState) {
+        currentState = state;
+        onStateChange(state);
+    }
+
+    if (state == MqttState::CONNECTED && discoveryNext < HaDiscovery::ENTITY_COUNT) {
+        publishDiscovery();
+    }
+    if (state == MqttState::CONNECTED && discoveryPending != 0) {
+        storeDiscoveryHash();
+    }
+
+    // Retry states refused while the QoS 1 window was full
+    if (state == MqttState::CONNECTED && statesStale) {
+        publishStates();
+    }
+    if (state == MqttState::CONNECTED && settingsStale.load(std::memory_order_relaxed)) {
+        publishSettings();
+    }
+
+    // One queued change at a time; onAck() removes it from the journal
+    if (state == MqttState::CONNECTED) {
+        journal.drain(now, &MqttHandler::sendJournalEvent, this);
+    }
+}
+
+void MqttHandler::registerTasks(Scheduler& scheduler) {
+    scheduler.addTask("mqtt", [](void* context) {
+        static_cast<MqttHandler*>(context)->update();
+    }, this, MQTT_UPDATE_INTERVAL, 0, ProfileSlot::MQTT);
+
+    scheduler.addTask("system", [](void* context) {
+        static_cast<MqttHandler*>(context)->publishSystemStatus();
+    }, this, SYSTEM_PUBLISH_INTERVAL, SYSTEM_PUBLISH_INTERVAL);
 }
 
 bool MqttHandler::isConnected() {
-    Serial.println("MqttHandler::isConnected() called");
+    LOG_VERBOSE("MqttHandler::isConnected() called");
     return currentState == MqttState::CONNECTED;
 }
 
 void MqttHandler::publishSensorData(const PirData& pirData, const RadarData& radarData, const PowerData& powerData) {
-    Serial.println("MqttHandler::publishSensorData() called");
+    LOG_VERBOSE("MqttHandler::publishSensorData() called");
     // Implementation will be added in Phase 5
 }
 
+void MqttHandler::handleSensorEvent(const SensorEvent& event) {
+    if (aggregateOnly &&
+        (event.type == SensorEventType::PIR_MOTION || event.type == SensorEventType::RADAR_PRESENCE)) {
+        suppressedEvents++;
+        return;
+    }
+
+    LOG_DEBUG("[MQTT] Sensor event type=%d active=%d at %lu ms",
+                  static_cast<int>(event.type), event.active, event.timestamp);
+
+    MqttTopics::Topic topic;
+    switch (event.type) {
+        case SensorEventType::PRESENCE:
+            topic = MqttTopics::PRESENCE;
+            lastPresence = event.active;
+            break;
+        case SensorEventType::POWER_SOURCE:
+            topic = MqttTopics::POWER;
+            lastPower = event.active;
+            break;
+        case SensorEventType::CHARGING:
+            topic = MqttTopics::CHARGING;
+            lastCharging = event.active;
+            break;
+        default:
+            // Raw PIR/radar changes only feed the aggregates for now
+            return;
+    }
+
+    if (publishState(topic, event.active)) {
+        return;
+    }
+    if (connection.isConnected()) {
+        // Window full: the retained state topic catches up from update()
+        statesStale = true;
+        return;
+    }
+    // Offline, the change waits in the journal for the events topic
+    if (!journal.push(static_cast<uint8_t>(event.type), event.active, event.value, event.timestamp)) {
+        LOG_WARN("[MQTT] Event journal full or unavailable, %u events dropped", journal.getDroppedCount());
+    }
+}
+
+void MqttHandler::setPowerState(const PowerData& power) {
+    lastPower = power.usbPowerConnected;
+    lastCharging = power.charging;
+}
+
+void MqttHandler::publishSystemStatus() {
+    JsonWriter json(payload, sizeof(payload));
+    json.beginObject()
+        .addFixed("temp_c", static_cast<int32_t>(lroundf(temperatureRead() * 10.0f)), 1)
+        .addUint("free_heap", ESP.getFreeHeap())
+        .endObject();
+
+    const size_t length = json.finish();
+    if (length > 0) {
+        publish(MqttTopics::SYSTEM, payload, length, false);
+    }
+}
+
+void MqttHandler::publishAggregates(const SensorAggregates& aggregates) {
+    // Window keys follow SensorAggregator::WINDOW_MINUTES
+    static const char* const WINDOW_KEYS[SensorAggregates::WINDOW_COUNT] = { "1m", "15m", "1h" };
+
+    JsonWriter json(payload, sizeof(payload));
+    json.beginObject()
+        .addUint("suppressed", suppressedEvents)
+        .addUint("queued", journal.getDepth())
+        .addUint("dropped", journal.getDroppedCount());
+    for (uint8_t w = 0; w < SensorAggregates::WINDOW_COUNT; w++) {
+        const AggregateWindow& window = aggregates.windows[w];
+        json.beginObject(WINDOW_KEYS[w])
+            .addUint("minutes", window.minutes)
+            .addUint("occupied_s", window.occupiedSeconds)
+            .addUint("motion", window.motionCount)
+            .addUint("presence", window.presenceCount)
+            .beginArray("distance");
+        for (uint8_t bin = 0; bin < AggregateWindow::DISTANCE_BINS; bin++) {
+            json.addUint(nullptr, window.distanceHistogram[bin]);
+        }
+        json.endArray();
+        if (window.batteryMeanMv > 0) {
+            json.addFixed("battery_min_v", window.batteryMinMv, 3)
+                .addFixed("battery_avg_v", window.batteryMeanMv, 3)
+                .addFixed("battery_max_v", window.batteryMaxMv, 3);
+        }
+        json.endObject();
+    }
+    json.endObject();
+
+    const size_t length = json.finish();
+    if (length == 0) {
+        LOG_ERROR("[MQTT] Error: Aggregates payload exceeds %u bytes", sizeof(payload));
+        return;
+    }
+    publish(MqttTopics::AGGREGATES, payload, length, false);
+}
+
+void MqttHandler::setAggregateOnly(bool enabled) {
+    aggregateOnly = enabled;
+}
+
+void MqttHandler::publishDiagnostics(const char* document) {
+    publish(MqttTopics::DIAGNOSTICS, document, strlen(document), false);
+}
+
+bool MqttHandler::publish(MqttTopics::Topic topic, const char* message, size_t length, bool retain, uint8_t qos) {
+    if (!connection.publish(topics.get(topic), message, length, retain, qos)) {
+        LOG_DEBUG("[MQTT] Not sent %s (%u bytes): not connected, window or buffer full", topics.get(topic), length);
+        return false;
+    }
+    LOG_VERBOSE("[MQTT] %s (%u bytes)", topics.get(topic), length);
+    return true;
+}
+
+bool MqttHandler::publishState(MqttTopics::Topic topic, bool active) {
+    return active ? publish(topic, "ON", 2, true, 1) : publish(topic, "OFF", 3, true, 1);
+}
+
+void MqttHandler::publishStates() {
+    // Retained, so only the latest value matters
+    const bool presenceSent = lastPresence < 0 || publishState(MqttTopics::PRESENCE, lastPresence);
+    const bool powerSent = lastPower < 0 || publishState(MqttTopics::POWER, lastPower);
+    const bool chargingSent = lastCharging < 0 || publishState(MqttTopics::CHARGING, lastCharging);
+    statesStale = !presenceSent || !powerSent || !chargingSent;
+}
+
+void MqttHandler::publishSettings() {
+    settingsStale.store(false, std::memory_order_relaxed);
+
+    // Retained, so only the latest value matters
+    const int16_t level = brightness.load(std::memory_order_relaxed);
+    const int8_t stealth = stealthMode.load(std::memory_order_relaxed);
+    char text[4];
+    const int length = snprintf(text, sizeof(text), "%d", level);
+    const bool brightnessSent = level < 0 || publish(MqttTopics::BRIGHTNESS_STATE, text, length, true, 1);
+    const bool stealthSent = stealth < 0 || publishState(MqttTopics::STEALTH_STATE, stealth);
+    if (!brightnessSent || !stealthSent) {
+        settingsStale.store(true, std::memory_order_relaxed);
+    }
+}
+
+bool MqttHandler::sendJournalEvent(void* context, const JournalEvent& event) {
+    MqttHandler* handler = static_cast<MqttHandler*>(context);
+
+    const char* name = "sensor";
+    switch (static_cast<SensorEventType>(event.type)) {
+        case SensorEventType::PRESENCE:     name = "presence"; break;
+        case SensorEventType::POWER_SOURCE: name = "power"; break;
+        case SensorEventType::CHARGING:     name = "charging"; break;
+        default: break;
+    }
+
+    JsonWriter json(handler->payload, sizeof(handler->payload));
+    json.beginObject()
+        .addUint("seq", event.sequence)
+        .addString("event", name)
+        .addString("state", event.active ? "ON" : "OFF")
+        .addUint("ts_ms", event.timestamp);
+    if (event.previousBoot) {
+        json.addBool("previous_boot", true);
+    } else {
+        json.addUint("age_ms", millis() - event.timestamp);
+    }
+    json.endObject();
+
+    const size_t length = json.finish();
+    if (length == 0 || !handler->publish(MqttTopics::EVENTS, handler->payload, length, false, 1)) {
+        return false;
+    }
+    handler->journalPacketId = handler->connection.getLastPacketId();
+    return true;
+}
+
+void MqttHandler::onAck(void* context, uint16_t packetId) {
+    MqttHandler* handler = static_cast<MqttHandler*>(context);
+    if (packetId != 0 && packetId == handler->journalPacketId) {
+        handler->journalPacketId = 0;
+        handler->journal.acknowledge();
+        if (handler->journal.isEmpty()) {
+            LOG_INFO("[MQTT] Event backlog sent");
+        }
+    }
+}
+
+MqttState MqttHandler::readState() const {
+    switch (connection.getPhase()) {
+        case MqttConnection::Phase::IDLE:
+            return MqttState::DISCONNECTED;
+        case MqttConnection::Phase::CONNECTED:
+            return MqttState::CONNECTED;
+        case MqttConnection::Phase::WAITING:
+            if (connection.hasFailed()) {
+                return MqttState::FAILED;
+            }
+            return connection.wasDropped() ? MqttState::RECONNECTING : MqttState::CONNECTING;
+        default:
+            return connection.hasFailed() || connection.wasDropped() ? MqttState::RECONNECTING
+                                                                      : MqttState::CONNECTING;
+    }
+}
+
+void MqttHandler::onStateChange(MqttState state) {
+    if (state != MqttState::CONNECTED) {
+        // Configs still in the transmit buffer went with the session
+        discoveryPending = 0;
+    }
+
+    switch (state) {
+        case MqttState::CONNECTED:
+            LOG_INFO("[MQTT] Connected to %s:%d as %s", MQTT_BROKER, MQTT_PORT, topics.getDeviceId());
+            publish(MqttTopics::AVAILABILITY, "online", 6, true);
+            connectedAt = millis();
+            connection.subscribe(HA_STATUS_TOPIC);
+            connection.subscribe(topics.get(MqttTopics::BRIGHTNESS_COMMAND));
+            connection.subscribe(topics.get(MqttTopics::STEALTH_COMMAND));
+            if (discovery.getHash() != 0 && discovery.getHash() != discoveryHash) {
+                sendDiscoveryMessages();
+            } else {
+                LOG_DEBUG("[MQTT] Discovery unchanged (%08x), not resent", discoveryHash);
+            }
+            // Current states first; queued changes follow on the events topic
+            statesStale = true;
+            publishStates();
+            settingsStale.store(true, std::memory_order_relaxed);
+            publishSettings();
+            if (!journal.isEmpty()) {
+                LOG_INFO("[MQTT] Replaying %u queued events", journal.getDepth());
+            }
+            break;
+        case MqttState::FAILED:
+            LOG_WARN("[MQTT] Broker unavailable (%s), retry %u in %lu ms", connection.getLastError(),
+                     connection.getFailureCount(), connection.getNextAttempt() - millis());
+            break;
+        case MqttState::RECONNECTING:
+            if (connection.wasDropped() && connection.getPhase() == MqttConnection::Phase::WAITING) {
+                LOG_WARN("[MQTT] Connection lost (%s)", connection.getLastError());
+            }
+            break;
+        case MqttState::DISCONNECTED:
+            LOG_INFO("[MQTT] Disconnected (WiFi down)");
+            break;
+        default:
+            break;
+    }
+}
+
+void MqttHandler::onWifiStateChanged(void* context, const WifiStateChanged& event) {
+    static_cast<MqttHandler*>(context)->wifiConnected = event.state == WifiState::CONNECTED;
+}
+
 void MqttHandler::sendDiscoveryMessages() {
-    Serial.println("MqttHandler::sendDiscoveryMessages() called");
-    // Implementation will be added in Phase 5
+    if (discovery.getHash() != 0) {
+        discoveryNext = 0;
+        discoveryPending = 0;
+    }
+}
+
+void MqttHandler::publishDiscovery() {
+    // Retained QoS 0: the configs are too large for the QoS 1 slots
+    while (discoveryNext < HaDiscovery::ENTITY_COUNT) {
+        if (!connection.publish(discovery.getTopic(discoveryNext), discovery.getPayload(discoveryNext),
+                                discovery.getPayloadLength(discoveryNext), true)) {
+            return;     // Transmit buffer full, continue on the next update
+        }
+        discoveryNext++;
+    }
+    LOG_INFO("[MQTT] Discovery queued (%u bytes) %lu ms after connecting", discovery.getSize(),
+             millis() - connectedAt);
+    if (discoveryHash != discovery.getHash()) {
+        discoveryPending = discovery.getHash();
+    }
+}
+
+void MqttHandler::storeDiscoveryHash() {
+    // Queued is not sent: a session lost before the buffer drains resends them
+    if (connection.getPendingBytes() > 0) {
+        return;
+    }
+    if (preferences.begin(PREFERENCES_NAMESPACE, false)) {
+        discoveryHash = discoveryPending;
+        preferences.putUInt(DISCOVERY_HASH_KEY, discoveryHash);
+        preferences.end();
+    }
+    discoveryPending = 0;
+}
+
+void MqttHandler::onMessage(void* context, const MqttConnection::Message& message) {
+    static const size_t STATUS_LENGTH = strlen(HA_STATUS_TOPIC);
+    MqttHandler* handler = static_cast<MqttHandler*>(context);
+
+    // A retained "online" is old news; only a live one means HA restarted
+    if (message.topicLength == STATUS_LENGTH && memcmp(message.topic, HA_STATUS_TOPIC, STATUS_LENGTH) == 0 &&
+        message.length == 6 && memcmp(message.payload, "online", 6) == 0 && !message.retained) {
+        LOG_INFO("[MQTT] Home Assistant restarted, resending discovery");
+        handler->sendDiscoveryMessages();
+    } else if (handler->isTopic(message, MqttTopics::BRIGHTNESS_COMMAND)) {
+        handleSettingCommand(message, SettingId::LED_BRIGHTNESS);
+    } else if (handler->isTopic(message, MqttTopics::STEALTH_COMMAND)) {
+        handleSettingCommand(message, SettingId::STEALTH_MODE);
+    }
+}
+
+bool MqttHandler::isTopic(const MqttConnection::Message& message, MqttTopics::Topic topic) const {
+    const char* name = topics.get(topic);
+    return message.topicLength == strlen(name) && memcmp(message.topic, name, message.topicLength) == 0;
+}
+
+void MqttHandler::handleSettingCommand(const MqttConnection::Message& message, SettingId id) {
+    // A retained command is a stale one; the broker should not hold any
+    if (message.retained) {
+        return;
+    }
+
+    uint32_t value = 0;
+    bool valid = message.length > 0;
+    if (id == SettingId::STEALTH_MODE) {
+        valid = (message.length == 2 && memcmp(message.payload, "ON", 2) == 0) ||
+                (message.length == 3 && memcmp(message.payload, "OFF", 3) == 0);
+        value = message.length == 2 ? 1 : 0;
+    } else {
+        // Decimal digits only; anything above 255 is clamped
+        for (size_t i = 0; i < message.length && valid; i++) {
+            const char digit = message.payload[i];
+            valid = digit >= '0' && digit <= '9';
+            value = value > 255 ? value : value * 10 + (digit - '0');
+        }
+        value = value > 255 ? 255 : value;
+    }
+
+    if (!valid) {
+        LOG_WARN("[MQTT] Ignored invalid %s command (%u bytes)",
+                 id == SettingId::STEALTH_MODE ? "stealth" : "brightness", message.length);
+        return;
+    }
+    EventBus::publish(SettingRequested{id, value});
+}
+
+void MqttHandler::onSettingChanged(void* context, const SettingChanged& event) {
+    MqttHandler* handler = static_cast<MqttHandler*>(context);
+    switch (event.id) {
+        case SettingId::LED_BRIGHTNESS:
+            handler->brightness.store(static_cast<int16_t>(event.value), std::memory_order_relaxed);
+            break;
+        case SettingId::STEALTH_MODE:
+            handler->stealthMode.store(event.value != 0 ? 1 : 0, std::memory_order_relaxed);
+            break;
+        default:
+            return;     // Not published
+    }
+    handler->settingsStale.store(true, std::memory_order_relaxed);
 }
 
 MqttState MqttHandler::getState() {
-    Serial.println("MqttHandler::getState() called");
+    LOG_VERBOSE("MqttHandler::getState() called");
     return currentState;
 }
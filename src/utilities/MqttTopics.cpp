@@ -0,0 +1,29 @@
+#include "utilities/MqttTopics.h"
+#include <stdio.h>
+
+const char* const MqttTopics::SUFFIXES[COUNT] = {
+    "status",
+    "presence",
+    "power",
+    "charging",
+    "aggregates",
+    "diagnostics",
+    "events",
+    "system",
+    "brightness",
+    "brightness/set",
+    "stealth",
+    "stealth/set",
+};
+
+bool MqttTopics::begin(const char* baseTopic, const char* id) {
+    bool fits = snprintf(deviceId, sizeof(deviceId), "%s", id) < static_cast<int>(sizeof(deviceId));
+
+    for (uint8_t i = 0; i < COUNT; i++) {
+        const int written = snprintf(topics[i], TOPIC_SIZE, "%s/%s/%s", baseTopic, deviceId, SUFFIXES[i]);
+        if (written < 0 || written >= static_cast<int>(TOPIC_SIZE)) {
+            fits = false;
+        }
+    }
+    return fits;
+}
@@ -0,0 +1,204 @@
+#include "utilities/Scheduler.h"
+#include "utilities/Logger.h"
+
+portMUX_TYPE Scheduler::idleLock = portMUX_INITIALIZER_UNLOCKED;
+uint8_t Scheduler::startedCount = 0;
+uint8_t Scheduler::blockedCount = 0;
+int64_t Scheduler::allIdleSince = 0;
+int64_t Scheduler::allIdleUs = 0;
+
+void Scheduler::begin() {
+    ownerTask = xTaskGetCurrentTaskHandle();
+
+    portENTER_CRITICAL(&idleLock);
+    startedCount++;
+    portEXIT_CRITICAL(&idleLock);
+}
+
+uint8_t Scheduler::addTask(const char* name, TaskFunction function, void* context,
+                           uint32_t periodMs, uint32_t initialDelayMs, ProfileSlot slot) {
+    if (taskCount >= MAX_TASKS) {
+        LOG_ERROR("[SCHED] Error: Task table full (%u), '%s' not registered", MAX_TASKS, name);
+        return INVALID_TASK;
+    }
+    if (function == nullptr || periodMs == 0) {
+        LOG_ERROR("[SCHED] Error: Invalid task '%s' not registered", name);
+        return INVALID_TASK;
+    }
+
+    Task& task = tasks[taskCount];
+    task.function = function;
+    task.deadlineFunction = nullptr;
+    task.context = context;
+    task.periodUs = static_cast<int64_t>(periodMs) * 1000;
+    task.nextRunUs = esp_timer_get_time() + static_cast<int64_t>(initialDelayMs) * 1000;
+    task.pending = true;
+    task.slot = slot;
+    task.stats = TaskStats{ name, 0, 0, 0, 0, 0 };
+
+    return taskCount++;
+}
+
+uint8_t Scheduler::addDeadlineTask(const char* name, TaskFunction function,
+                                   DeadlineFunction deadlineFunction, void* context,
+                                   ProfileSlot slot) {
+    if (taskCount >= MAX_TASKS) {
+        LOG_ERROR("[SCHED] Error: Task table full (%u), '%s' not registered", MAX_TASKS, name);
+        return INVALID_TASK;
+    }
+    if (function == nullptr || deadlineFunction == nullptr) {
+        LOG_ERROR("[SCHED] Error: Invalid task '%s' not registered", name);
+        return INVALID_TASK;
+    }
+
+    Task& task = tasks[taskCount];
+    task.function = function;
+    task.deadlineFunction = deadlineFunction;
+    task.context = context;
+    task.periodUs = 0;
+    task.nextRunUs = 0;
+    task.pending = false;
+    task.slot = slot;
+    task.stats = TaskStats{ name, 0, 0, 0, 0, 0 };
+
+    return taskCount++;
+}
+
+void Scheduler::run() {
+    int64_t now = esp_timer_get_time();
+
+    // Run everything that is due
+    for (uint8_t i = 0; i < taskCount; i++) {
+        Task& task = tasks[i];
+        refreshDeadline(task, now);
+        if (task.pending && now >= task.nextRunUs) {
+            runTask(task, now);
+            now = esp_timer_get_time();
+        }
+    }
+
+    // Find the earliest deadline (tasks may have rescheduled each other)
+    int64_t earliest = now + static_cast<int64_t>(MAX_SLEEP_MS) * 1000;
+    for (uint8_t i = 0; i < taskCount; i++) {
+        Task& task = tasks[i];
+        refreshDeadline(task, now);
+        if (task.pending && task.nextRunUs < earliest) {
+            earliest = task.nextRunUs;
+        }
+    }
+
+    // Block until then, or until notify() wakes us for an external event
+    const int64_t waitUs = earliest - esp_timer_get_time();
+    if (waitUs > 0) {
+        const int64_t tickUs = static_cast<int64_t>(portTICK_PERIOD_MS) * 1000;
+        const TickType_t ticks = static_cast<TickType_t>((waitUs + tickUs - 1) / tickUs);
+        enterIdle();
+        ulTaskNotifyTake(pdTRUE, ticks);
+        leaveIdle();
+        wakeups++;
+    }
+}
+
+void Scheduler::notify() {
+    if (ownerTask != nullptr) {
+        xTaskNotifyGive(ownerTask);
+    }
+}
+
+void IRAM_ATTR Scheduler::notifyFromIsr() {
+    if (ownerTask != nullptr) {
+        BaseType_t higherPriorityTaskWoken = pdFALSE;
+        vTaskNotifyGiveFromISR(ownerTask, &higherPriorityTaskWoken);
+        portYIELD_FROM_ISR(higherPriorityTaskWoken);
+    }
+}
+
+bool Scheduler::getTaskStats(uint8_t taskId, TaskStats& stats) const {
+    if (taskId >= taskCount) {
+        return false;
+    }
+
+    stats = tasks[taskId].stats;
+    return true;
+}
+
+void Scheduler::printStats() const {
+    Serial.printf("[SCHED] %u wake-ups\n", wakeups);
+    for (uint8_t i = 0; i < taskCount; i++) {
+        const TaskStats& stats = tasks[i].stats;
+        Serial.printf("[SCHED] %-10s runs=%u late=%u/%uus run=%u/%uus (last/max)\n",
+                      stats.name, stats.runs,
+                      stats.lastLatenessUs, stats.maxLatenessUs,
+                      stats.lastDurationUs, stats.maxDurationUs);
+    }
+}
+
+int64_t Scheduler::getAllIdleTime() {
+    portENTER_CRITICAL(&idleLock);
+    int64_t idle = allIdleUs;
+    if (startedCount > 0 && blockedCount == startedCount) {
+        idle += esp_timer_get_time() - allIdleSince;
+    }
+    portEXIT_CRITICAL(&idleLock);
+    return idle;
+}
+
+void Scheduler::enterIdle() {
+    portENTER_CRITICAL(&idleLock);
+    if (++blockedCount == startedCount) {
+        allIdleSince = esp_timer_get_time();
+    }
+    portEXIT_CRITICAL(&idleLock);
+}
+
+void Scheduler::leaveIdle() {
+    portENTER_CRITICAL(&idleLock);
+    if (blockedCount-- == startedCount) {
+        allIdleUs += esp_timer_get_time() - allIdleSince;
+    }
+    portEXIT_CRITICAL(&idleLock);
+}
+
+void Scheduler::refreshDeadline(Task& task, int64_t now) {
+    if (task.deadlineFunction == nullptr) {
+        return;
+    }
+
+    unsigned long deadline;
+    task.pending = task.deadlineFunction(task.context, deadline);
+    if (task.pending) {
+        // Convert the millis() deadline to esp_timer time (wrap-safe)
+        const long deltaMs = static_cast<long>(deadline - millis());
+        task.nextRunUs = now + static_cast<int64_t>(deltaMs) * 1000;
+    }
+}
+
+void Scheduler::runTask(Task& task, int64_t now) {
+    const uint32_t lateness = static_cast<uint32_t>(now - task.nextRunUs);
+
+    {
+        LoopProfiler::Scope scope(profiler, task.slot);
+        task.function(task.context);
+    }
+
+    const uint32_t duration = static_cast<uint32_t>(esp_timer_get_time() - now);
+
+    // Periodic tasks keep their phase; resync if we fell a whole period behind
+    if (task.periodUs > 0) {
+        task.nextRunUs += task.periodUs;
+        if (task.nextRunUs <= now) {
+            task.nextRunUs = now + task.periodUs;
+        }
+    }
+
+    TaskStats& stats = task.stats;
+    stats.runs++;
+    stats.lastLatenessUs = lateness;
+    stats.lastDurationUs = duration;
+    if (lateness > stats.maxLatenessUs) {
+        stats.maxLatenessUs = lateness;
+    }
+    if (duration > stats.maxDurationUs) {
+        stats.maxDurationUs = duration;
+    }
+}
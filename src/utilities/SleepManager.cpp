@@ -0,0 +1,96 @@
+#include "utilities/SleepManager.h"
+#include <esp_pm.h>
+#include <esp_sleep.h>
+#include "config/Settings.h"
+#include "utilities/Logger.h"
+#include "utilities/Scheduler.h"
+
+bool SleepManager::begin() {
+    #if CONFIG_PM_ENABLE && CONFIG_FREERTOS_USE_TICKLESS_IDLE
+    // GPIO wake-up sources are armed per pin by SensorManager
+    esp_sleep_enable_gpio_wakeup();
+    lightSleepAvailable = configurePowerManagement(false);
+    #else
+    LOG_WARN("[SLEEP] Light sleep not available (needs CONFIG_PM_ENABLE and tickless idle)");
+    #endif
+
+    modeStartUs = esp_timer_get_time();
+    modeStartIdleUs = Scheduler::getAllIdleTime();
+    return lightSleepAvailable;
+}
+
+void SleepManager::setBatteryMode(bool onBattery) {
+    if (onBattery == batteryMode) {
+        return;
+    }
+
+    batteryMode = onBattery;
+    if (lightSleepAvailable) {
+        configurePowerManagement(onBattery);
+    }
+
+    // Waking every 20 ms just to empty the log ring would defeat light sleep
+    Logger::setDrainInterval(onBattery ? LOG_DRAIN_INTERVAL_BATTERY : LOG_DRAIN_INTERVAL);
+
+    // Start a fresh measurement window for the new mode
+    modeStartUs = esp_timer_get_time();
+    modeStartIdleUs = Scheduler::getAllIdleTime();
+    latencySamples = 0;
+    lastWakeLatencyUs = 0;
+    maxWakeLatencyUs = 0;
+
+    LOG_INFO("[SLEEP] %s mode%s", onBattery ? "Battery" : "External power",
+             (onBattery && lightSleepAvailable) ? ", automatic light sleep enabled" : "");
+}
+
+void SleepManager::recordWakeLatency(uint32_t latencyUs) {
+    latencySamples++;
+    lastWakeLatencyUs = latencyUs;
+    if (latencyUs > maxWakeLatencyUs) {
+        maxWakeLatencyUs = latencyUs;
+    }
+}
+
+void SleepManager::getStats(SleepStats& stats) const {
+    stats.batteryMode = batteryMode;
+    stats.lightSleepAvailable = lightSleepAvailable;
+    stats.modeTimeUs = esp_timer_get_time() - modeStartUs;
+    stats.idleTimeUs = Scheduler::getAllIdleTime() - modeStartIdleUs;
+    stats.latencySamples = latencySamples;
+    stats.lastWakeLatencyUs = lastWakeLatencyUs;
+    stats.maxWakeLatencyUs = maxWakeLatencyUs;
+}
+
+void SleepManager::printStats() const {
+    SleepStats stats;
+    getStats(stats);
+
+    const uint32_t modeMs = static_cast<uint32_t>(stats.modeTimeUs / 1000);
+    const uint32_t idleMs = static_cast<uint32_t>(stats.idleTimeUs / 1000);
+    const uint32_t idlePermille = (modeMs > 0) ? static_cast<uint32_t>((static_cast<uint64_t>(idleMs) * 1000) / modeMs) : 0;
+
+    Serial.printf("[SLEEP] %s mode for %u ms: idle %u ms (%u.%u%%), awake %u ms, light sleep %s\n",
+                  stats.batteryMode ? "Battery" : "External power", modeMs,
+                  idleMs, idlePermille / 10, idlePermille % 10, modeMs - idleMs,
+                  (stats.batteryMode && stats.lightSleepAvailable) ? "on" : "off");
+    Serial.printf("[SLEEP] Wake-to-publish: %u samples, last %u us, max %u us\n",
+                  stats.latencySamples, stats.lastWakeLatencyUs, stats.maxWakeLatencyUs);
+}
+
+bool SleepManager::configurePowerManagement(bool lightSleep) {
+    #if CONFIG_PM_ENABLE && CONFIG_FREERTOS_USE_TICKLESS_IDLE
+    esp_pm_config_esp32s3_t config = {};
+    config.max_freq_mhz = MAX_CPU_FREQ_MHZ;
+    config.min_freq_mhz = lightSleep ? MIN_CPU_FREQ_MHZ : MAX_CPU_FREQ_MHZ;
+    config.light_sleep_enable = lightSleep;
+
+    const esp_err_t result = esp_pm_configure(&config);
+    if (result != ESP_OK) {
+        LOG_ERROR("[SLEEP] Error: esp_pm_configure failed (%d)", result);
+        return false;
+    }
+    return true;
+    #else
+    return false;
+    #endif
+}
@@ -0,0 +1,187 @@
+#include "utilities/TraceCodec.h"
+
+namespace {
+
+size_t putVarint(uint8_t* buffer, uint32_t value) {
+    size_t length = 0;
+    while (value >= 0x80) {
+        buffer[length++] = static_cast<uint8_t>(value) | 0x80;
+        value >>= 7;
+    }
+    buffer[length++] = static_cast<uint8_t>(value);
+    return length;
+}
+
+// Returns bytes read, 0 if truncated or longer than 5 bytes
+size_t getVarint(const uint8_t* data, size_t length, uint32_t& value) {
+    value = 0;
+    for (size_t i = 0; i < length && i < 5; i++) {
+        value |= static_cast<uint32_t>(data[i] & 0x7F) << (7 * i);
+        if ((data[i] & 0x80) == 0) {
+            return i + 1;
+        }
+    }
+    return 0;
+}
+
+uint32_t zigzag(int32_t value) {
+    return (static_cast<uint32_t>(value) << 1) ^ static_cast<uint32_t>(value >> 31);
+}
+
+int32_t unzigzag(uint32_t value) {
+    return static_cast<int32_t>(value >> 1) ^ -static_cast<int32_t>(value & 1);
+}
+
+// Boolean fields packed into the tag's high nibble
+constexpr uint8_t FLAG_LEVEL = 0x10;
+constexpr uint8_t FLAG_MOVING = 0x10;
+constexpr uint8_t FLAG_STATIONARY = 0x20;
+constexpr uint8_t FLAG_USB_POWER = 0x10;
+constexpr uint8_t FLAG_BATTERY_LOW = 0x20;
+
+}
+
+size_t TraceCodec::encode(const TraceRecord& record, uint8_t* buffer) {
+    uint8_t tag = static_cast<uint8_t>(record.type);
+    size_t length = 1;
+
+    switch (record.type) {
+        case TraceRecordType::HEADER:
+            buffer[length++] = HEADER_MAGIC;
+            length += putVarint(buffer + length, record.value);
+            break;
+
+        case TraceRecordType::SYNC:
+            length += putVarint(buffer + length, record.timestamp);
+            length += putVarint(buffer + length, record.value);
+            lastTimestamp = record.timestamp;
+            break;
+
+        default:
+            // Raw PIR edges may be slightly older than the previous record
+            length += putVarint(buffer + length, zigzag(static_cast<int32_t>(record.timestamp - lastTimestamp)));
+            lastTimestamp = record.timestamp;
+            break;
+    }
+
+    switch (record.type) {
+        case TraceRecordType::PIR_EDGE:
+        case TraceRecordType::PIR_STATE:
+            tag |= record.level ? FLAG_LEVEL : 0;
+            break;
+
+        case TraceRecordType::RADAR:
+            tag |= (record.moving ? FLAG_MOVING : 0) | (record.stationary ? FLAG_STATIONARY : 0);
+            length += putVarint(buffer + length, record.movingDistance);
+            buffer[length++] = record.movingEnergy;
+            length += putVarint(buffer + length, record.stationaryDistance);
+            buffer[length++] = record.stationaryEnergy;
+            break;
+
+        case TraceRecordType::POWER:
+            tag |= (record.usbPower ? FLAG_USB_POWER : 0) | (record.batteryLow ? FLAG_BATTERY_LOW : 0);
+            buffer[length++] = record.batteryPercentage;
+            length += putVarint(buffer + length, record.batteryMillivolts);
+            break;
+
+        default:
+            break;
+    }
+
+    buffer[0] = tag;
+    return length;
+}
+
+size_t TraceCodec::decode(const uint8_t* data, size_t length, TraceRecord& record) {
+    if (length == 0) {
+        return 0;
+    }
+
+    const uint8_t tag = data[0];
+    const uint8_t type = tag & 0x0F;
+    if (type > static_cast<uint8_t>(TraceRecordType::POWER)) {
+        return 0;
+    }
+
+    record = TraceRecord{};
+    record.type = static_cast<TraceRecordType>(type);
+    size_t offset = 1;
+    size_t used;
+    uint32_t value;
+
+    switch (record.type) {
+        case TraceRecordType::HEADER:
+            if (offset >= length || data[offset++] != HEADER_MAGIC) {
+                return 0;
+            }
+            if ((used = getVarint(data + offset, length - offset, record.value)) == 0) {
+                return 0;
+            }
+            offset += used;
+            return offset;
+
+        case TraceRecordType::SYNC:
+            if ((used = getVarint(data + offset, length - offset, record.timestamp)) == 0) {
+                return 0;
+            }
+            offset += used;
+            if ((used = getVarint(data + offset, length - offset, record.value)) == 0) {
+                return 0;
+            }
+            offset += used;
+            lastTimestamp = record.timestamp;
+            return offset;
+
+        default:
+            if ((used = getVarint(data + offset, length - offset, value)) == 0) {
+                return 0;
+            }
+            offset += used;
+            record.timestamp = lastTimestamp + static_cast<uint32_t>(unzigzag(value));
+            break;
+    }
+
+    switch (record.type) {
+        case TraceRecordType::PIR_EDGE:
+        case TraceRecordType::PIR_STATE:
+            record.level = (tag & FLAG_LEVEL) != 0;
+            break;
+
+        case TraceRecordType::RADAR:
+            record.moving = (tag & FLAG_MOVING) != 0;
+            record.stationary = (tag & FLAG_STATIONARY) != 0;
+            if ((used = getVarint(data + offset, length - offset, value)) == 0 || offset + used >= length) {
+                return 0;
+            }
+            offset += used;
+            record.movingDistance = static_cast<uint16_t>(value);
+            record.movingEnergy = data[offset++];
+            if ((used = getVarint(data + offset, length - offset, value)) == 0 || offset + used >= length) {
+                return 0;
+            }
+            offset += used;
+            record.stationaryDistance = static_cast<uint16_t>(value);
+            record.stationaryEnergy = data[offset++];
+            break;
+
+        case TraceRecordType::POWER:
+            record.usbPower = (tag & FLAG_USB_POWER) != 0;
+            record.batteryLow = (tag & FLAG_BATTERY_LOW) != 0;
+            if (offset >= length) {
+                return 0;
+            }
+            record.batteryPercentage = data[offset++];
+            if ((used = getVarint(data + offset, length - offset, value)) == 0) {
+                return 0;
+            }
+            offset += used;
+            record.batteryMillivolts = static_cast<uint16_t>(value);
+            break;
+
+        default:
+            break;
+    }
+
+    lastTimestamp = record.timestamp;
+    return offset;
+}
@@ -0,0 +1,218 @@
+#include "utilities/TraceRecorder.h"
+#include <LittleFS.h>
+#include "utilities/Logger.h"
+
+bool TraceRecorder::begin() {
+    // Formats the partition on first use
+    mounted = LittleFS.begin(true);
+    if (!mounted) {
+        LOG_ERROR("[TRACE] Error: LittleFS mount failed");
+        return false;
+    }
+
+    for (uint8_t i = 0; i < TRACE_SEGMENT_COUNT; i++) {
+        sequences[i] = readSequence(i);
+    }
+    return true;
+}
+
+void TraceRecorder::setEnabled(bool enable) {
+    enabled.store(enable, std::memory_order_relaxed);
+    LOG_INFO("[TRACE] Recording %s", enable ? "started" : "stopped");
+}
+
+void TraceRecorder::record(const TraceRecord& record) {
+    if (!isEnabled()) {
+        return;
+    }
+
+    uint8_t encoded[TraceCodec::MAX_RECORD_SIZE];
+
+    for (uint8_t attempt = 0; attempt < 2; attempt++) {
+        size_t& length = bufferLength[activeBuffer];
+        uint8_t* buffer = buffers[activeBuffer];
+
+        // Every buffer is decodable on its own: it starts with the absolute time
+        if (length == 0) {
+            TraceRecord sync = {};
+            sync.type = TraceRecordType::SYNC;
+            sync.timestamp = record.timestamp;
+            sync.value = unreportedDrops;
+            length = codec.encode(sync, buffer);
+            unreportedDrops = 0;
+            bufferStart = millis();
+        }
+
+        // Keep the time base unchanged if the record cannot be stored
+        const TraceCodec saved = codec;
+        const size_t size = codec.encode(record, encoded);
+        if (length + size <= TRACE_BUFFER_SIZE) {
+            memcpy(buffer + length, encoded, size);
+            length += size;
+            return;
+        }
+        codec = saved;
+
+        if (!handOver()) {
+            break;
+        }
+    }
+
+    droppedCount++;
+    unreportedDrops++;
+}
+
+void TraceRecorder::poll() {
+    const size_t length = bufferLength[activeBuffer];
+    if (length > 0 && (!isEnabled() || millis() - bufferStart >= TRACE_FLUSH_INTERVAL)) {
+        handOver();
+    }
+}
+
+bool TraceRecorder::handOver() {
+    if (pendingBuffer.load(std::memory_order_acquire) >= 0) {
+        return false;
+    }
+
+    pendingBuffer.store(static_cast<int8_t>(activeBuffer), std::memory_order_release);
+    activeBuffer ^= 1;
+    bufferLength[activeBuffer] = 0;
+    return true;
+}
+
+void TraceRecorder::flush() {
+    const int8_t index = pendingBuffer.load(std::memory_order_acquire);
+    if (index < 0) {
+        return;
+    }
+
+    const size_t length = bufferLength[index];
+    if (mounted) {
+        if (!segmentFile || segmentFile.size() + length > TRACE_SEGMENT_SIZE) {
+            startSegment();
+        }
+        if (segmentFile) {
+            segmentFile.write(buffers[index], length);
+            segmentFile.flush();
+        }
+    }
+
+    pendingBuffer.store(-1, std::memory_order_release);
+}
+
+void TraceRecorder::dump() {
+    if (!mounted) {
+        Serial.println("[TRACE] No filesystem");
+        return;
+    }
+
+    // Close so everything written so far is visible to the reader
+    const bool wasOpen = static_cast<bool>(segmentFile);
+    if (wasOpen) {
+        segmentFile.close();
+    }
+
+    // Oldest first; selection sort over a handful of segments
+    bool printed[TRACE_SEGMENT_COUNT] = {};
+    for (uint8_t n = 0; n < TRACE_SEGMENT_COUNT; n++) {
+        int8_t oldest = -1;
+        for (uint8_t i = 0; i < TRACE_SEGMENT_COUNT; i++) {
+            if (!printed[i] && sequences[i] != NO_SEQUENCE &&
+                (oldest < 0 || sequences[i] < sequences[oldest])) {
+                oldest = i;
+            }
+        }
+        if (oldest < 0) {
+            break;
+        }
+        printed[oldest] = true;
+
+        char path[24];
+        segmentPath(oldest, path, sizeof(path));
+        fs::File file = LittleFS.open(path, "r");
+        if (!file) {
+            continue;
+        }
+
+        Serial.printf("[TRACE] Segment %u (%u bytes)\n", sequences[oldest], static_cast<unsigned>(file.size()));
+        uint8_t chunk[32];
+        size_t length;
+        while ((length = file.read(chunk, sizeof(chunk))) > 0) {
+            char line[sizeof(chunk) * 2 + 1];
+            for (size_t i = 0; i < length; i++) {
+                snprintf(line + i * 2, 3, "%02x", chunk[i]);
+            }
+            Serial.println(line);
+        }
+        file.close();
+    }
+    Serial.println("[TRACE] End");
+
+    if (wasOpen) {
+        char path[24];
+        segmentPath(segmentIndex, path, sizeof(path));
+        segmentFile = LittleFS.open(path, "a");
+    }
+}
+
+bool TraceRecorder::startSegment() {
+    if (segmentFile) {
+        segmentFile.close();
+    }
+
+    // Overwrite the oldest (or an unused) segment
+    uint8_t oldest = 0;
+    uint32_t newest = NO_SEQUENCE;
+    for (uint8_t i = 0; i < TRACE_SEGMENT_COUNT; i++) {
+        if (sequences[i] < sequences[oldest]) {
+            oldest = i;
+        }
+        if (sequences[i] > newest) {
+            newest = sequences[i];
+        }
+    }
+
+    char path[24];
+    segmentPath(oldest, path, sizeof(path));
+    segmentFile = LittleFS.open(path, "w");
+    if (!segmentFile) {
+        LOG_ERROR("[TRACE] Error: Cannot open segment %u", oldest);
+        return false;
+    }
+
+    segmentIndex = oldest;
+    segmentSequence = newest + 1;
+    sequences[oldest] = segmentSequence;
+
+    TraceRecord header = {};
+    header.type = TraceRecordType::HEADER;
+    header.value = segmentSequence;
+    uint8_t encoded[TraceCodec::MAX_RECORD_SIZE];
+    TraceCodec headerCodec;
+    segmentFile.write(encoded, headerCodec.encode(header, encoded));
+    return true;
+}
+
+uint32_t TraceRecorder::readSequence(uint8_t index) {
+    char path[24];
+    segmentPath(index, path, sizeof(path));
+    if (!LittleFS.exists(path)) {
+        return NO_SEQUENCE;
+    }
+
+    fs::File file = LittleFS.open(path, "r");
+    uint8_t data[TraceCodec::MAX_RECORD_SIZE];
+    const size_t length = file ? file.read(data, sizeof(data)) : 0;
+    file.close();
+
+    TraceCodec headerCodec;
+    TraceRecord header;
+    if (headerCodec.decode(data, length, header) == 0 || header.type != TraceRecordType::HEADER) {
+        return NO_SEQUENCE;
+    }
+    return header.value;
+}
+
+void TraceRecorder::segmentPath(uint8_t index, char* path, size_t size) {
+    snprintf(path, size, "/trace%u.bin", index);
+}
@@ -0,0 +1,163 @@
+/**
+ * @file breath_kernel_bench.cpp
+ * @brief Host tool: old vs new LED breathing kernel, speed and behavior
+ *
+ * Times one PULSE step of each kernel over many pixels with mixed
+ * intervals:
+ *   - old: piecewise-triangle sineWave(), three divides by 255 in
+ *          scaleColor(), and a per-step (255 * FADE_STEP_MS) / interval
+ *          phase increment (the pre-LUT LedController, kept as a model)
+ *   - new: the firmware's BreathTable lookup, nscale8() and the Q8.8
+ *          phase from a reciprocal taken once per timeline
+ * then reports, per interval, how far the phase gets in one breath and
+ * the largest level jump between consecutive 50 ms steps. The old kernel
+ * divides by zero at interval 0 and freezes above 12750 ms.
+ *
+ * Build and run from the repository root (see tools/Makefile):
+ *   make -C tools && tools/build/breath_kernel_bench [steps in millions]
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <FastLED.h>
+#include "feedback/BreathTable.h"
+
+namespace {
+
+constexpr uint32_t FADE_STEP_MS = 50;
+constexpr size_t PIXELS = 64;
+
+// ---- Old kernel (as LedController had it before the LUT) ----
+
+struct OldPixel {
+    CRGB color;
+    uint16_t interval;
+    uint8_t phase;
+};
+
+uint8_t oldSineWave(uint8_t phase) {
+    if (phase < 85) {
+        return phase * 3;
+    }
+    if (phase < 170) {
+        return 255 - (phase - 85) * 3;
+    }
+    return 0;
+}
+
+CRGB oldStep(OldPixel& pixel) {
+    const uint8_t level = oldSineWave(pixel.phase);
+    const CRGB out((pixel.color.r * level) / 255, (pixel.color.g * level) / 255, (pixel.color.b * level) / 255);
+    const uint8_t increment = (255 * FADE_STEP_MS) / pixel.interval;
+    pixel.phase = (pixel.phase + increment) % 255;
+    return out;
+}
+
+// ---- New kernel (LedController::updatePixelAnimation, BREATHE easing) ----
+
+struct NewPixel {
+    CRGB color;
+    uint16_t interval;
+    uint32_t rate;          // (1 << 24) / interval, once per timeline
+    uint32_t elapsed;       // ms into the current breath
+};
+
+CRGB newStep(NewPixel& pixel) {
+    const uint16_t phase = static_cast<uint16_t>((pixel.elapsed * pixel.rate) >> 8);
+    CRGB out = pixel.color;
+    out.nscale8(BreathTable::LEVELS.values[phase >> 8]);
+    pixel.elapsed += FADE_STEP_MS;
+    if (pixel.elapsed >= pixel.interval) {
+        pixel.elapsed -= pixel.interval;
+    }
+    return out;
+}
+
+const uint16_t INTERVALS[] = {250, 500, 1000, 2000, 3000, 5000, 8000, 12000};
+
+void runSpeed(uint64_t steps) {
+    OldPixel oldPixels[PIXELS];
+    NewPixel newPixels[PIXELS];
+    srand(1);
+    for (size_t i = 0; i < PIXELS; i++) {
+        const CRGB color(rand() & 0xFF, rand() & 0xFF, rand() & 0xFF);
+        const uint16_t interval = INTERVALS[rand() % (sizeof(INTERVALS) / sizeof(INTERVALS[0]))];
+        oldPixels[i] = {color, interval, static_cast<uint8_t>(rand() % 255)};
+        newPixels[i] = {color, interval, static_cast<uint32_t>((1UL << 24) / interval),
+                        static_cast<uint32_t>(rand() % interval)};
+    }
+
+    uint32_t oldSum = 0;
+    uint32_t newSum = 0;
+    const auto oldStart = std::chrono::steady_clock::now();
+    for (uint64_t n = 0; n < steps; n++) {
+        const CRGB c = oldStep(oldPixels[n % PIXELS]);
+        oldSum += c.r + c.g + c.b;
+    }
+    const auto oldEnd = std::chrono::steady_clock::now();
+    for (uint64_t n = 0; n < steps; n++) {
+        const CRGB c = newStep(newPixels[n % PIXELS]);
+        newSum += c.r + c.g + c.b;
+    }
+    const auto newEnd = std::chrono::steady_clock::now();
+
+    const double oldNs = std::chrono::duration<double, std::nano>(oldEnd - oldStart).count() / steps;
+    const double newNs = std::chrono::duration<double, std::nano>(newEnd - oldEnd).count() / steps;
+    printf("speed      %llu steps over %zu pixels (checksums %u / %u)\n",
+           static_cast<unsigned long long>(steps), PIXELS, oldSum, newSum);
+    printf("           old %6.2f ns/step   new %6.2f ns/step   %.1fx\n", oldNs, newNs, oldNs / newNs);
+}
+
+// One breath of a full-white pixel: how much of the curve is covered, and how smoothly
+void runBehavior() {
+    const uint16_t intervals[] = {0, 100, 2000, 12750, 12800, 20000, 60000};
+    printf("behavior   %-9s %-24s %s\n", "interval", "old (phase span, max jump)", "new (phase span, max jump)");
+    for (uint16_t interval : intervals) {
+        char oldText[40];
+        if (interval == 0) {
+            snprintf(oldText, sizeof(oldText), "divide by zero");
+        } else if ((255 * FADE_STEP_MS) / interval == 0) {
+            snprintf(oldText, sizeof(oldText), "frozen (increment 0)");
+        } else {
+            OldPixel pixel = {CRGB(255, 255, 255), interval, 0};
+            int previous = -1;
+            int maxJump = 0;
+            uint32_t span = 0;
+            for (uint32_t t = 0; t < interval; t += FADE_STEP_MS) {
+                const int level = oldStep(pixel).r;
+                maxJump = previous >= 0 && abs(level - previous) > maxJump ? abs(level - previous) : maxJump;
+                previous = level;
+                span += (255 * FADE_STEP_MS) / interval;
+            }
+            snprintf(oldText, sizeof(oldText), "%u/255, %d", span, maxJump);
+        }
+
+        char newText[40];
+        if (interval == 0) {
+            snprintf(newText, sizeof(newText), "solid (no breath)");
+        } else {
+            NewPixel pixel = {CRGB(255, 255, 255), interval, static_cast<uint32_t>((1UL << 24) / interval), 0};
+            int previous = -1;
+            int maxJump = 0;
+            uint32_t lastPhase = 0;
+            for (uint32_t t = 0; t < interval; t += FADE_STEP_MS) {
+                lastPhase = static_cast<uint16_t>((pixel.elapsed * pixel.rate) >> 8);
+                const int level = newStep(pixel).r;
+                maxJump = previous >= 0 && abs(level - previous) > maxJump ? abs(level - previous) : maxJump;
+                previous = level;
+            }
+            snprintf(newText, sizeof(newText), "%u/65535, %d", lastPhase, maxJump);
+        }
+        printf("           %7u ms %-26s %s\n", interval, oldText, newText);
+    }
+}
+
+}
+
+int main(int argc, char** argv) {
+    const double millions = argc > 1 ? atof(argv[1]) : 200.0;
+    runSpeed(static_cast<uint64_t>(millions * 1e6));
+    runBehavior();
+    return 0;
+}
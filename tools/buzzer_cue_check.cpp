@@ -0,0 +1,344 @@
+/**
+ * @file buzzer_cue_check.cpp
+ * @brief Host tool: BuzzerController against a stubbed LEDC and esp_timer
+ *
+ * Links the firmware's BuzzerController with recording stand-ins for the
+ * LEDC driver, esp_timer and the PM lock (tools/host), runs the step timer
+ * on a simulated clock, and checks:
+ *   - cues:     every CUE_TABLE entry played from idle produces exactly its
+ *               tone/silence timeline at 50% duty and ends silent
+ *   - preempt:  a higher-priority cue cuts the current one off at once
+ *   - queue:    lower/equal-priority cues wait and play in priority, then
+ *               FIFO order; a full queue drops the lowest priority
+ *   - stealth:  stealth mode silences, disarms the timer and refuses cues
+ * and that no driver, timer or PM call is made inside soundLock, and the
+ * sleep lock is held exactly while something is playing.
+ *
+ * Build and run from the repository root (see tools/Makefile):
+ *   make -C tools && tools/build/buzzer_cue_check
+ */
+
+#include <cstdio>
+#include <vector>
+#include "HostCheck.h"
+#include "feedback/BuzzerController.h"
+#include "feedback/Melodies.h"
+#include "utilities/Logger.h"
+
+namespace {
+
+/**
+ * @brief What the stubs saw: LEDC output changes, the one-shot timer and the PM lock
+ */
+struct FakeHardware {
+    struct Change {
+        int64_t timeUs;
+        uint32_t frequency;
+        uint32_t duty;
+    };
+
+    int64_t nowUs = 0;
+    uint32_t frequency = 0;
+    uint32_t pendingDuty = 0;
+    uint32_t duty = 0;
+    std::vector<Change> changes;
+
+    esp_timer_cb_t callback = nullptr;
+    void* callbackArg = nullptr;
+    bool armed = false;
+    int64_t dueUs = 0;
+
+    int sleepLocks = 0;
+    uint32_t callsInCritical = 0;
+
+    void noteCall() {
+        callsInCritical += hostCriticalDepth != 0 ? 1 : 0;
+    }
+
+    // Fire the step timer for every deadline up to untilUs
+    void runUntil(int64_t untilUs) {
+        while (armed && dueUs <= untilUs) {
+            nowUs = dueUs;
+            armed = false;
+            callback(callbackArg);
+        }
+        nowUs = untilUs > nowUs ? untilUs : nowUs;
+    }
+
+    void runToIdle() {
+        while (armed) {
+            runUntil(dueUs);
+        }
+    }
+};
+
+FakeHardware hw;
+
+}
+
+bool Logger::write(uint8_t, const char*, const uintptr_t*, uint8_t) {
+    return true;
+}
+
+esp_err_t ledc_timer_config(const ledc_timer_config_t* config) {
+    hw.frequency = config->freq_hz;
+    return ESP_OK;
+}
+
+esp_err_t ledc_channel_config(const ledc_channel_config_t* config) {
+    hw.duty = hw.pendingDuty = config->duty;
+    return ESP_OK;
+}
+
+esp_err_t ledc_set_freq(ledc_mode_t, ledc_timer_t, uint32_t frequency) {
+    hw.noteCall();
+    hw.frequency = frequency;
+    return ESP_OK;
+}
+
+esp_err_t ledc_set_duty(ledc_mode_t, ledc_channel_t, uint32_t duty) {
+    hw.noteCall();
+    hw.pendingDuty = duty;
+    return ESP_OK;
+}
+
+esp_err_t ledc_update_duty(ledc_mode_t, ledc_channel_t) {
+    hw.noteCall();
+    hw.duty = hw.pendingDuty;
+    hw.changes.push_back({hw.nowUs, hw.frequency, hw.duty});
+    return ESP_OK;
+}
+
+int64_t esp_timer_get_time() {
+    return hw.nowUs;
+}
+
+esp_err_t esp_timer_create(const esp_timer_create_args_t* args, esp_timer_handle_t* handle) {
+    hw.callback = args->callback;
+    hw.callbackArg = args->arg;
+    *handle = reinterpret_cast<esp_timer_handle_t>(&hw);
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_start_once(esp_timer_handle_t, uint64_t timeoutUs) {
+    hw.noteCall();
+    if (hw.armed) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    hw.armed = true;
+    hw.dueUs = hw.nowUs + static_cast<int64_t>(timeoutUs);
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_stop(esp_timer_handle_t) {
+    hw.noteCall();
+    if (!hw.armed) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    hw.armed = false;
+    return ESP_OK;
+}
+
+esp_err_t esp_pm_lock_create(esp_pm_lock_type_t, int, const char*, esp_pm_lock_handle_t* handle) {
+    *handle = reinterpret_cast<esp_pm_lock_handle_t>(&hw);
+    return ESP_OK;
+}
+
+esp_err_t esp_pm_lock_acquire(esp_pm_lock_handle_t) {
+    hw.noteCall();
+    hw.sleepLocks++;
+    return ESP_OK;
+}
+
+esp_err_t esp_pm_lock_release(esp_pm_lock_handle_t) {
+    hw.noteCall();
+    if (hw.sleepLocks == 0) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    hw.sleepLocks--;
+    return ESP_OK;
+}
+
+namespace {
+
+/**
+ * @brief An audible stretch of the timeline: [startMs, endMs) at frequency
+ */
+struct Tone {
+    int64_t startMs;
+    int64_t endMs;
+    uint32_t frequency;
+
+    bool operator==(const Tone& other) const {
+        return startMs == other.startMs && endMs == other.endMs && frequency == other.frequency;
+    }
+};
+
+// Turn the recorded LEDC changes since index `from` into audible stretches
+std::vector<Tone> tonesSince(size_t from) {
+    std::vector<Tone> tones;
+    bool sounding = false;
+    for (size_t i = from; i < hw.changes.size(); i++) {
+        const FakeHardware::Change& change = hw.changes[i];
+        if (sounding) {
+            tones.back().endMs = change.timeUs / 1000;
+            sounding = false;
+        }
+        if (change.duty != 0) {
+            check(change.duty == (1u << (LEDC_TIMER_10_BIT - 1)), "ledc", "tone not at 50% duty");
+            tones.push_back({change.timeUs / 1000, -1, change.frequency});
+            sounding = true;
+        }
+    }
+    return tones;
+}
+
+// What a melody started at startMs should sound like, cut off at stopMs
+std::vector<Tone> expectedTones(const Melody& melody, int64_t startMs, int64_t stopMs = INT64_MAX) {
+    std::vector<Tone> tones;
+    int64_t t = startMs;
+    for (uint8_t i = 0; i < melody.length && t < stopMs; i++) {
+        const MelodyNote& note = melody.notes[i];
+        const int64_t end = t + note.duration < stopMs ? t + note.duration : stopMs;
+        if (note.frequency != Melodies::REST) {
+            if (!tones.empty() && tones.back().endMs == t && tones.back().frequency == note.frequency) {
+                tones.back().endMs = end;
+            } else {
+                tones.push_back({t, end, note.frequency});
+            }
+        }
+        t += note.duration + note.gap;
+    }
+    return tones;
+}
+
+const Melody& melodyOf(SoundCue cue) {
+    return Melodies::CUE_TABLE[static_cast<uint8_t>(cue)];
+}
+
+int64_t lengthMs(const Melody& melody) {
+    int64_t total = 0;
+    for (uint8_t i = 0; i < melody.length; i++) {
+        total += melody.notes[i].duration + melody.notes[i].gap;
+    }
+    return total;
+}
+
+void append(std::vector<Tone>& to, const std::vector<Tone>& tones) {
+    to.insert(to.end(), tones.begin(), tones.end());
+}
+
+void checkIdle(const char* scenario) {
+    check(!hw.armed, scenario, "step timer still armed");
+    check(hw.duty == 0, scenario, "buzzer not silent at the end");
+    check(hw.sleepLocks == 0, scenario, "sleep lock still held");
+}
+
+const char* const CUE_NAMES[] = {"BOOT", "SUCCESS", "FAILURE", "CONFIRM", "INTERACTION", "ALARM", "LOW_BATTERY"};
+
+void runCues(BuzzerController& buzzer) {
+    for (uint8_t i = 0; i < static_cast<uint8_t>(SoundCue::COUNT); i++) {
+        const SoundCue cue = static_cast<SoundCue>(i);
+        const size_t from = hw.changes.size();
+        const int64_t startMs = hw.nowUs / 1000;
+
+        check(buzzer.play(cue), "cues", "cue refused from idle");
+        check(hw.sleepLocks == 1, "cues", "sleep lock not held while playing");
+        hw.runToIdle();
+
+        const std::vector<Tone> got = tonesSince(from);
+        const bool matches = got == expectedTones(melodyOf(cue), startMs);
+        const int64_t tookMs = hw.nowUs / 1000 - startMs;
+        printf("cues       %-11s %zu tone(s), %3lld ms %s\n", CUE_NAMES[i], got.size(),
+               static_cast<long long>(tookMs), matches ? "ok" : "MISMATCH");
+        check(matches, "cues", "timeline differs from CUE_TABLE");
+        check(tookMs == lengthMs(melodyOf(cue)), "cues", "wrong total length");
+        checkIdle("cues");
+        hw.runUntil(hw.nowUs + 100000);
+    }
+}
+
+void runPreempt(BuzzerController& buzzer) {
+    const size_t from = hw.changes.size();
+    const int64_t startMs = hw.nowUs / 1000;
+
+    buzzer.play(SoundCue::BOOT);
+    hw.runUntil(hw.nowUs + 200000);     // Into BOOT's second note
+    buzzer.play(SoundCue::ALARM);
+    hw.runToIdle();
+
+    std::vector<Tone> expected = expectedTones(melodyOf(SoundCue::BOOT), startMs, startMs + 200);
+    append(expected, expectedTones(melodyOf(SoundCue::ALARM), startMs + 200));
+    const bool matches = tonesSince(from) == expected;
+    printf("preempt    ALARM cuts BOOT at 200 ms: %s\n", matches ? "ok" : "MISMATCH");
+    check(matches, "preempt", "BOOT not cut off or ALARM not started at once");
+    checkIdle("preempt");
+    hw.runUntil(hw.nowUs + 100000);
+}
+
+void runQueue(BuzzerController& buzzer) {
+    const size_t from = hw.changes.size();
+    const int64_t startMs = hw.nowUs / 1000;
+
+    buzzer.play(SoundCue::ALARM);
+    check(buzzer.play(SoundCue::INTERACTION), "queue", "tick refused");
+    check(buzzer.play(SoundCue::SUCCESS), "queue", "SUCCESS refused");
+    check(buzzer.play(SoundCue::CONFIRM), "queue", "CONFIRM refused");
+    check(buzzer.play(SoundCue::SUCCESS), "queue", "duplicate not absorbed");
+    check(buzzer.play(SoundCue::LOW_BATTERY), "queue", "LOW_BATTERY refused");
+    check(buzzer.play(SoundCue::FAILURE), "queue", "FAILURE did not evict the tick");
+    check(!buzzer.play(SoundCue::INTERACTION), "queue", "tick accepted into a full queue");
+    hw.runToIdle();
+
+    // Priority order, FIFO within a priority; the tick was evicted
+    const SoundCue order[] = {SoundCue::ALARM, SoundCue::LOW_BATTERY, SoundCue::FAILURE, SoundCue::SUCCESS,
+                              SoundCue::CONFIRM};
+    std::vector<Tone> expected;
+    int64_t t = startMs;
+    for (SoundCue cue : order) {
+        append(expected, expectedTones(melodyOf(cue), t));
+        t += lengthMs(melodyOf(cue));
+    }
+    const bool matches = tonesSince(from) == expected;
+    printf("queue      ALARM, LOW_BATTERY, FAILURE, SUCCESS, CONFIRM back to back in %lld ms: %s\n",
+           static_cast<long long>(hw.nowUs / 1000 - startMs), matches ? "ok" : "MISMATCH");
+    check(matches, "queue", "queued cues out of order or with gaps");
+    check(hw.nowUs / 1000 == t, "queue", "dead time between queued cues");
+    checkIdle("queue");
+    hw.runUntil(hw.nowUs + 100000);
+}
+
+void runStealth(BuzzerController& buzzer) {
+    buzzer.play(SoundCue::ALARM);
+    buzzer.play(SoundCue::SUCCESS);
+    hw.runUntil(hw.nowUs + 300000);
+    buzzer.setStealthMode(true);
+    const size_t from = hw.changes.size();
+    check(!buzzer.play(SoundCue::FAILURE), "stealth", "cue accepted in stealth mode");
+    hw.runUntil(hw.nowUs + 5000000);
+
+    printf("stealth    silenced mid-ALARM, %zu LEDC changes afterwards\n", hw.changes.size() - from);
+    check(hw.changes.size() == from, "stealth", "buzzer driven in stealth mode");
+    checkIdle("stealth");
+    buzzer.setStealthMode(false);
+}
+
+}
+
+int main() {
+    BuzzerController buzzer;
+    buzzer.begin();
+    hw.runToIdle();     // Boot melody
+    hw.runUntil(hw.nowUs + 100000);
+
+    runCues(buzzer);
+    runPreempt(buzzer);
+    runQueue(buzzer);
+    runStealth(buzzer);
+
+    printf("locking    %u driver/timer/PM call(s) inside soundLock\n", hw.callsInCritical);
+    check(hw.callsInCritical == 0, "locking", "driver called with soundLock held");
+
+    printf("\n%s\n", allPassed ? "PASS" : "FAIL");
+    return allPassed ? 0 : 1;
+}
@@ -0,0 +1,209 @@
+/**
+ * @file event_bus_check.cpp
+ * @brief Host tool: TypedEventBus subscription, dispatch, statistics and cost
+ *
+ * Instantiates the firmware's TypedEventBus template (tools/host stubs
+ * for the clock and critical sections) and checks:
+ *   - order:     handlers run in subscription order with their own context
+ *   - channels:  each event type has its own subscribers and counters
+ *   - capacity:  MAX_SUBSCRIBERS per type, the next subscribe() fails
+ *   - unlocked:  handlers run outside the channel's critical section, so
+ *                they may notify a scheduler or publish another type
+ *   - stats:     published count and last/max/total dispatch time, with a
+ *                scripted clock that advances inside the handlers
+ *   - app bus:   the application's EventBus carries its four event types
+ * then times publish() with 0, 1 and 4 subscribers. Publishing a type the
+ * bus does not carry is a compile error (static_assert) and is not run.
+ *
+ * Build and run from the repository root (see tools/Makefile):
+ *   make -C tools && tools/build/event_bus_check [publishes in millions]
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <esp_timer.h>
+#include "HostCheck.h"
+#include "utilities/EventBus.h"
+
+namespace {
+
+int64_t nowUs = 0;
+
+}
+
+int64_t esp_timer_get_time() {
+    return nowUs;
+}
+
+namespace {
+
+struct Ping {
+    static constexpr const char* NAME = "ping";
+    uint32_t value;
+};
+
+struct Pong {
+    static constexpr const char* NAME = "pong";
+    uint32_t value;
+};
+
+struct Tick {
+    static constexpr const char* NAME = "tick";
+    uint32_t value;
+};
+
+using TestBus = TypedEventBus<Ping, Pong>;
+using BenchBus = TypedEventBus<Tick>;
+
+struct Recorder {
+    char calls[32];
+    size_t length = 0;
+    uint32_t lastValue = 0;
+    int criticalDepth = -1;
+    uint32_t advanceUs = 0;         // Clock advance per call (dispatch time)
+};
+
+Recorder recorder;
+
+void onPing(void* context, const Ping& event) {
+    // Context is the tag, to check it is passed per subscriber
+    recorder.calls[recorder.length++] = *static_cast<const char*>(context);
+    recorder.lastValue = event.value;
+    recorder.criticalDepth = hostCriticalDepth;
+    nowUs += recorder.advanceUs;
+}
+
+uint32_t pongs = 0;
+
+void onPong(void*, const Pong& event) {
+    pongs += event.value;
+}
+
+// A handler that publishes another type from inside a dispatch
+void onPingRepublish(void*, const Ping& event) {
+    TestBus::publish(Pong{event.value});
+}
+
+void runOrderAndCapacity() {
+    static const char tags[] = "ABCDE";
+    const bool a = TestBus::subscribe<Ping>(&onPing, const_cast<char*>(&tags[0]));
+    const bool b = TestBus::subscribe<Ping>(&onPing, const_cast<char*>(&tags[1]));
+    const bool c = TestBus::subscribe<Ping>(&onPingRepublish, nullptr);
+    const bool d = TestBus::subscribe<Ping>(&onPing, const_cast<char*>(&tags[3]));
+    const bool e = TestBus::subscribe<Ping>(&onPing, const_cast<char*>(&tags[4]));
+    check(a && b && c && d, "capacity", "the first MAX_SUBSCRIBERS subscriptions must succeed");
+    check(!e, "capacity", "a fifth subscription must fail");
+
+    TestBus::publish(Ping{7});
+    recorder.calls[recorder.length] = '\0';
+    check(recorder.length == 3 && recorder.calls[0] == 'A' && recorder.calls[1] == 'B' && recorder.calls[2] == 'D',
+          "order", "handlers must run in subscription order with their own context");
+    check(recorder.lastValue == 7, "order", "event not passed through");
+    check(recorder.criticalDepth == 0, "unlocked", "handler ran inside the channel lock");
+
+    printf("order      ABD from A,B,(republish),D; fifth subscribe %s\n", e ? "accepted" : "refused");
+}
+
+void runChannels() {
+    // No Pong subscribers yet: the republish above was counted but went nowhere
+    TestBus::Stats pong;
+    TestBus::getStats<Pong>(pong);
+    check(pong.subscribers == 0 && pong.published == 1, "channels", "republished Pong must be counted");
+
+    TestBus::subscribe<Pong>(&onPong, nullptr);
+    recorder.length = 0;
+    TestBus::publish(Ping{5});          // Republished as Pong{5}
+    TestBus::publish(Pong{10});
+
+    TestBus::Stats ping;
+    TestBus::getStats<Ping>(ping);
+    TestBus::getStats<Pong>(pong);
+    check(ping.subscribers == 4 && ping.published == 2, "channels", "Ping counters");
+    check(pong.subscribers == 1 && pong.published == 3 && pongs == 15, "channels", "Pong counters or delivery");
+    check(ping.name == Ping::NAME && pong.name == Pong::NAME, "channels", "names");
+    printf("channels   ping subs=%u events=%u, pong subs=%u events=%u (sum %u)\n", ping.subscribers,
+           ping.published, pong.subscribers, pong.published, pongs);
+}
+
+void runStats() {
+    TestBus::Stats before;
+    TestBus::getStats<Ping>(before);
+
+    // Each of the three recording handlers advances the clock
+    recorder.advanceUs = 10;
+    TestBus::publish(Ping{1});          // 30 us
+    recorder.advanceUs = 100;
+    TestBus::publish(Ping{2});          // 300 us
+    recorder.advanceUs = 5;
+    TestBus::publish(Ping{3});          // 15 us
+    recorder.advanceUs = 0;
+
+    TestBus::Stats stats;
+    TestBus::getStats<Ping>(stats);
+    check(stats.published == before.published + 3, "stats", "published count");
+    check(stats.lastDispatchUs == 15, "stats", "last dispatch time");
+    check(stats.maxDispatchUs == 300, "stats", "max dispatch time");
+    check(stats.totalDispatchUs - before.totalDispatchUs == 345, "stats", "total dispatch time");
+    check(hostCriticalDepth == 0, "stats", "critical sections unbalanced");
+    printf("stats      last=%u max=%u total=+%u us\n", stats.lastDispatchUs, stats.maxDispatchUs,
+           stats.totalDispatchUs - before.totalDispatchUs);
+}
+
+void onPresence(void* context, const PresenceChanged& event) {
+    *static_cast<bool*>(context) = event.present;
+}
+
+void runAppBus() {
+    bool present = false;
+    EventBus::subscribe<PresenceChanged>(&onPresence, &present);
+    EventBus::publish(PresenceChanged{true, 1234});
+    EventBus::publish(PowerSourceChanged{true, 80, 1234});
+    EventBus::publish(WifiStateChanged{});
+    EventBus::publish(SettingChanged{});
+
+    EventBus::Stats stats;
+    EventBus::getStats<PresenceChanged>(stats);
+    check(present && stats.published == 1 && stats.subscribers == 1, "app bus", "PresenceChanged delivery");
+    EventBus::getStats<SettingChanged>(stats);
+    check(stats.published == 1 && stats.subscribers == 0, "app bus", "SettingChanged counters");
+    printf("app bus    4 types published, presence delivered\n");
+}
+
+uint32_t tickSum = 0;
+
+void onTick(void*, const Tick& event) {
+    tickSum += event.value;
+}
+
+double timePublish(uint64_t count) {
+    const auto start = std::chrono::steady_clock::now();
+    for (uint64_t i = 0; i < count; i++) {
+        BenchBus::publish(Tick{static_cast<uint32_t>(i)});
+    }
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / count;
+}
+
+void runCost(uint64_t count) {
+    const double none = timePublish(count);
+    BenchBus::subscribe<Tick>(&onTick, nullptr);
+    const double one = timePublish(count);
+    for (int i = 0; i < 3; i++) {
+        BenchBus::subscribe<Tick>(&onTick, nullptr);
+    }
+    const double four = timePublish(count);
+    printf("cost       publish(): %.1f ns with 0, %.1f ns with 1, %.1f ns with 4 subscribers (checksum %u)\n", none,
+           one, four, tickSum);
+}
+
+}
+
+int main(int argc, char** argv) {
+    runOrderAndCapacity();
+    runChannels();
+    runStats();
+    runAppBus();
+    runCost(static_cast<uint64_t>((argc > 1 ? atof(argv[1]) : 20.0) * 1e6));
+    printf("\n%s\n", allPassed ? "PASS" : "FAIL");
+    return allPassed ? 0 : 1;
+}
@@ -0,0 +1,500 @@
+/**
+ * @file event_journal_check.cpp
+ * @brief Host tool: EventJournal on a fake filesystem, replayed to a stand-in broker
+ *
+ * Links the firmware's EventJournal against an in-memory JournalStorage
+ * (with fault injection) instead of LittleFS, and checks:
+ *   - replay:   changes queued while offline reach a loopback broker
+ *               through MqttConnection in order, with their original
+ *               timestamps, no faster than EVENT_DRAIN_INTERVAL, each
+ *               removed by its PUBACK, and the files are gone afterwards
+ *   - reboot:   a restart mid-replay resumes after the last ACK record,
+ *               flags the old timestamps, and loses nothing
+ *   - puback:   nothing more is sent while an event awaits acknowledge();
+ *               an unacknowledged event survives a reboot, the last one
+ *               keeps the files until acknowledged, and a late
+ *               acknowledgement for a dropped event removes nothing
+ *   - overflow: a full ring drops the oldest segment and counts it
+ *   - torn:     a failed append and a record cut by power loss are skipped
+ * and reports the flash bytes written per queued event.
+ *
+ * Build and run from the repository root (see tools/Makefile):
+ *   make -C tools && tools/build/event_journal_check
+ */
+
+#include <cstring>
+#include <mutex>
+#include <string>
+#include "HostCheck.h"
+#include "StandInBroker.h"
+#include "network/MqttConnection.h"
+#include "utilities/EventJournal.h"
+#include "utilities/JsonWriter.h"
+
+namespace {
+
+// SensorEventType values as stored in the journal
+constexpr uint8_t TYPE_PRESENCE = 2;
+constexpr uint8_t TYPE_POWER = 3;
+
+constexpr uint32_t CAPACITY = EVENT_JOURNAL_SEGMENT_COUNT * EVENT_JOURNAL_SEGMENT_RECORDS;
+
+/**
+ * @brief In-memory segment files with write accounting and fault injection
+ */
+struct FakeFilesystem {
+    std::vector<uint8_t> files[EVENT_JOURNAL_SEGMENT_COUNT];
+    bool exists[EVENT_JOURNAL_SEGMENT_COUNT] = {};
+    bool mountable = true;
+    long failNextAppendAfter = -1;      // Bytes written before the next append fails, -1 off
+    uint64_t bytesWritten = 0;
+    uint32_t erases = 0;
+
+    void reset() {
+        *this = FakeFilesystem();
+    }
+
+    uint32_t fileCount() const {
+        uint32_t count = 0;
+        for (bool present : exists) {
+            count += present ? 1 : 0;
+        }
+        return count;
+    }
+};
+
+FakeFilesystem fakeFs;
+
+}
+
+bool JournalStorage::begin() {
+    return fakeFs.mountable;
+}
+
+size_t JournalStorage::size(uint8_t segment) {
+    return fakeFs.exists[segment] ? fakeFs.files[segment].size() : 0;
+}
+
+bool JournalStorage::read(uint8_t segment, size_t offset, void* data, size_t length) {
+    const std::vector<uint8_t>& file = fakeFs.files[segment];
+    if (!fakeFs.exists[segment] || offset + length > file.size()) {
+        return false;
+    }
+    memcpy(data, file.data() + offset, length);
+    return true;
+}
+
+bool JournalStorage::append(uint8_t segment, const void* data, size_t length) {
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    size_t writable = length;
+    if (fakeFs.failNextAppendAfter >= 0) {
+        writable = static_cast<size_t>(fakeFs.failNextAppendAfter);
+        fakeFs.failNextAppendAfter = -1;
+    }
+    fakeFs.exists[segment] = true;
+    fakeFs.files[segment].insert(fakeFs.files[segment].end(), bytes, bytes + writable);
+    fakeFs.bytesWritten += writable;
+    return writable == length;
+}
+
+bool JournalStorage::erase(uint8_t segment) {
+    if (fakeFs.exists[segment]) {
+        fakeFs.erases++;
+    }
+    fakeFs.exists[segment] = false;
+    fakeFs.files[segment].clear();
+    return true;
+}
+
+namespace {
+
+struct Pushed {
+    uint32_t timestamp;
+    uint8_t type;
+    bool active;
+};
+
+// Outage pattern: presence toggles every 5 s, a power change every 7th event
+void pushOutage(EventJournal& journal, std::vector<Pushed>& pushed, uint32_t count, uint32_t start) {
+    for (uint32_t i = 0; i < count; i++) {
+        const Pushed event = {start + i * 5000, static_cast<uint8_t>(i % 7 == 6 ? TYPE_POWER : TYPE_PRESENCE),
+                              i % 2 == 0};
+        journal.push(event.type, event.active, 0, event.timestamp);
+        pushed.push_back(event);
+    }
+}
+
+/**
+ * @brief Sender that records what the journal hands over
+ */
+struct Collector {
+    std::vector<JournalEvent> sent;
+    std::vector<uint32_t> sentAt;
+    uint32_t now = 0;
+    uint32_t limit = UINT32_MAX;        // Refuse after this many
+
+    static bool send(void* context, const JournalEvent& event) {
+        Collector* collector = static_cast<Collector*>(context);
+        if (collector->sent.size() >= collector->limit) {
+            return false;
+        }
+        collector->sent.push_back(event);
+        collector->sentAt.push_back(collector->now);
+        return true;
+    }
+};
+
+/**
+ * @brief Drain one event and acknowledge it at once, as a prompt PUBACK would
+ */
+bool drainAndAck(EventJournal& journal, Collector& collector, uint32_t now) {
+    if (!journal.drain(now, &Collector::send, &collector)) {
+        return false;
+    }
+    journal.acknowledge();
+    return true;
+}
+
+void runReboot() {
+    fakeFs.reset();
+    std::vector<Pushed> pushed;
+    Collector collector;
+
+    {
+        EventJournal journal;
+        journal.begin();
+        pushOutage(journal, pushed, 40, 1000);
+        collector.limit = 20;
+        for (uint32_t now = 300000; collector.sent.size() < 20 || journal.isAwaitingAck(); now += 10) {
+            collector.now = now;
+            drainAndAck(journal, collector, now);
+        }
+    }
+
+    // Power cycle: a new journal over the same files
+    EventJournal journal;
+    journal.begin();
+    const uint32_t recovered = journal.getDepth();
+    const uint32_t expected = 40 - (20 / EVENT_DRAIN_COMMIT) * EVENT_DRAIN_COMMIT;
+    collector.limit = UINT32_MAX;
+    for (uint32_t now = 0; !journal.isEmpty() && now < 60000; now += 10) {
+        collector.now = now;
+        drainAndAck(journal, collector, now);
+    }
+
+    bool ordered = true;
+    bool flagged = true;
+    uint32_t resend = 0;
+    for (size_t i = 20; i < collector.sent.size(); i++) {
+        const JournalEvent& event = collector.sent[i];
+        ordered = ordered && (i == 20 || event.sequence > collector.sent[i - 1].sequence);
+        flagged = flagged && event.previousBoot;
+        resend += event.sequence <= collector.sent[19].sequence ? 1 : 0;
+    }
+    const JournalEvent& last = collector.sent.back();
+
+    printf("reboot     queued 40, sent 20, recovered %u (expected %u), resent %u, files left %u\n",
+           recovered, expected, resend, fakeFs.fileCount());
+    check(recovered == expected, "reboot", "wrong depth after reboot");
+    check(ordered && flagged, "reboot", "replay after reboot out of order or not flagged");
+    check(last.timestamp == pushed.back().timestamp && last.sequence == 40, "reboot", "last event lost");
+    check(resend == 20 % EVENT_DRAIN_COMMIT, "reboot", "more resends than since the last ACK");
+    check(fakeFs.fileCount() == 0 && journal.getDroppedCount() == 0, "reboot", "files left or events dropped");
+}
+
+void runOverflow() {
+    fakeFs.reset();
+    EventJournal journal;
+    journal.begin();
+    std::vector<Pushed> pushed;
+    const uint32_t count = CAPACITY + 100;
+    pushOutage(journal, pushed, count, 0);
+
+    Collector collector;
+    for (uint32_t now = 0; !journal.isEmpty(); now += EVENT_DRAIN_INTERVAL) {
+        collector.now = now;
+        drainAndAck(journal, collector, now);
+    }
+    bool ordered = true;
+    for (size_t i = 1; i < collector.sent.size(); i++) {
+        ordered = ordered && collector.sent[i].sequence == collector.sent[i - 1].sequence + 1;
+    }
+    const uint32_t firstKept = collector.sent.empty() ? 0 : collector.sent.front().sequence;
+
+    printf("overflow   pushed %u into %u slots: sent %zu, dropped %u, oldest kept #%u\n",
+           count, CAPACITY, collector.sent.size(), journal.getDroppedCount(), firstKept);
+    check(collector.sent.size() + journal.getDroppedCount() == count, "overflow", "events unaccounted for");
+    check(journal.getDroppedCount() == EVENT_JOURNAL_SEGMENT_RECORDS, "overflow", "expected one segment dropped");
+    check(firstKept == EVENT_JOURNAL_SEGMENT_RECORDS + 1 && ordered, "overflow", "oldest not dropped first");
+}
+
+void runTorn() {
+    fakeFs.reset();
+    std::vector<Pushed> pushed;
+    {
+        EventJournal journal;
+        journal.begin();
+        pushOutage(journal, pushed, 10, 0);
+        fakeFs.failNextAppendAfter = 7;     // e.g. filesystem full mid-record
+        check(!journal.push(TYPE_PRESENCE, true, 0, 99999), "torn", "failed append reported success");
+        check(journal.getDroppedCount() == 1, "torn", "failed append not counted");
+        pushOutage(journal, pushed, 5, 100000);
+    }
+    // Power cut in the middle of the next record
+    for (int segment = 0; segment < EVENT_JOURNAL_SEGMENT_COUNT; segment++) {
+        if (fakeFs.exists[segment] && fakeFs.files[segment].size() == 5 * EventJournal::RECORD_SIZE) {
+            fakeFs.files[segment].insert(fakeFs.files[segment].end(), 9, 0xA5);
+        }
+    }
+
+    EventJournal journal;
+    journal.begin();
+    const uint32_t recovered = journal.getDepth();
+    pushOutage(journal, pushed, 3, 200000);
+
+    Collector collector;
+    for (uint32_t now = 0; !journal.isEmpty() && now < 60000; now += 10) {
+        collector.now = now;
+        drainAndAck(journal, collector, now);
+    }
+    bool matches = collector.sent.size() == pushed.size();
+    for (size_t i = 0; matches && i < pushed.size(); i++) {
+        matches = collector.sent[i].timestamp == pushed[i].timestamp && collector.sent[i].type == pushed[i].type &&
+                  collector.sent[i].active == pushed[i].active;
+    }
+
+    printf("torn       recovered %u of 15 after a failed append and a cut record, replayed %zu of %zu\n",
+           recovered, collector.sent.size(), pushed.size());
+    check(recovered == 15, "torn", "intact records lost");
+    check(matches, "torn", "replay differs from what was queued");
+}
+
+void runPuback() {
+    fakeFs.reset();
+    std::vector<Pushed> pushed;
+    Collector collector;
+    bool held;
+    {
+        EventJournal journal;
+        journal.begin();
+        pushOutage(journal, pushed, 5, 0);
+        journal.drain(0, &Collector::send, &collector);
+        held = !journal.drain(10 * EVENT_DRAIN_INTERVAL, &Collector::send, &collector) &&
+               collector.sent.size() == 1 && journal.isAwaitingAck() && journal.getDepth() == 5;
+    }
+
+    // Power cut before the PUBACK: the event must still be queued
+    EventJournal journal;
+    journal.begin();
+    const uint32_t recovered = journal.getDepth();
+    for (uint32_t now = 0; collector.sent.size() < 6 && now < 60000; now += EVENT_DRAIN_INTERVAL) {
+        // Every event but the last is acknowledged
+        if (journal.drain(now, &Collector::send, &collector) && collector.sent.size() < 6) {
+            journal.acknowledge();
+        }
+    }
+    const bool resent = collector.sent.size() == 6 && collector.sent[1].sequence == 1;
+    const uint32_t filesBeforeAck = fakeFs.fileCount();
+    const uint32_t depthBeforeAck = journal.getDepth();
+    journal.acknowledge();
+    const uint32_t filesAfterAck = fakeFs.fileCount();
+
+    // Ring overflow while the oldest event awaits its PUBACK
+    fakeFs.reset();
+    EventJournal ring;
+    ring.begin();
+    std::vector<Pushed> filler;
+    pushOutage(ring, filler, CAPACITY, 0);
+    Collector late;
+    ring.drain(0, &Collector::send, &late);
+    pushOutage(ring, filler, 1, 9999999);
+    const uint32_t depthAfterDrop = ring.getDepth();
+    ring.acknowledge();
+    const bool lateIgnored = !ring.isAwaitingAck() && ring.getDepth() == depthAfterDrop;
+    ring.drain(EVENT_DRAIN_INTERVAL, &Collector::send, &late);
+    const uint32_t nextSent = late.sent.size() == 2 ? late.sent[1].sequence : 0;
+
+    printf("puback     second drain while waiting %s, recovered %u after a reboot before the PUBACK, "
+           "files %u -> %u on the last ack, after a drop next #%u\n", held ? "refused" : "allowed", recovered,
+           filesBeforeAck, filesAfterAck, nextSent);
+    check(held, "puback", "drain() sent again before acknowledge()");
+    check(recovered == 5 && resent, "puback", "unacknowledged event lost across a reboot");
+    check(depthBeforeAck == 1 && filesBeforeAck > 0 && filesAfterAck == 0 && journal.isEmpty(), "puback",
+          "journal must keep the last event until its acknowledgement");
+    check(lateIgnored && nextSent == EVENT_JOURNAL_SEGMENT_RECORDS + 1, "puback",
+          "late acknowledgement of a dropped event removed another");
+}
+
+/**
+ * @brief Minimal broker: CONNACK, PUBACK for QoS 1, then collects PUBLISH payloads
+ */
+struct JournalBroker : StandInBroker {
+    std::mutex lock;
+    std::vector<std::string> topics;
+    std::vector<std::string> payloads;
+
+    size_t received() {
+        std::lock_guard<std::mutex> guard(lock);
+        return payloads.size();
+    }
+
+protected:
+    void session(int client) override {
+        std::vector<uint8_t> body;
+        uint8_t type;
+        if (!readPacket(client, type, body, 20) || type != 0x10) {
+            return;
+        }
+        sendConnack(client, 0);
+
+        while (running) {
+            if (!readPacket(client, type, body, 20)) {
+                continue;
+            }
+            if ((type >> 4) == 3 && body.size() >= 2) {
+                const size_t topicLength = (body[0] << 8) | body[1];
+                const size_t idLength = (type & 0x06) != 0 ? 2 : 0;
+                if (idLength > 0) {
+                    sendPuback(client, publishPacketId(body.data()));
+                }
+                std::lock_guard<std::mutex> guard(lock);
+                topics.emplace_back(reinterpret_cast<char*>(body.data()) + 2, topicLength);
+                payloads.emplace_back(reinterpret_cast<char*>(body.data()) + 2 + topicLength + idLength,
+                                      body.size() - 2 - topicLength - idLength);
+            }
+        }
+    }
+};
+
+/**
+ * @brief Publishes replayed events the way MqttHandler::sendJournalEvent() does
+ */
+struct BrokerSender {
+    MqttConnection* connection;
+    EventJournal* journal;
+    uint32_t now;
+    uint16_t packetId;                  // Awaiting PUBACK, as MqttHandler::journalPacketId
+    uint32_t acks;
+    std::vector<uint32_t> sentAt;
+    char payload[MQTT_PAYLOAD_SIZE];
+
+    static bool send(void* context, const JournalEvent& event) {
+        BrokerSender* sender = static_cast<BrokerSender*>(context);
+        JsonWriter json(sender->payload, sizeof(sender->payload));
+        json.beginObject()
+            .addUint("seq", event.sequence)
+            .addString("event", event.type == TYPE_PRESENCE ? "presence" : "power")
+            .addString("state", event.active ? "ON" : "OFF")
+            .addUint("ts_ms", event.timestamp);
+        if (event.previousBoot) {
+            json.addBool("previous_boot", true);
+        } else {
+            json.addUint("age_ms", sender->now - event.timestamp);
+        }
+        json.endObject();
+        const size_t length = json.finish();
+        if (length == 0 || !sender->connection->publish("hearthguard/scout-test/events", sender->payload, length, false, 1)) {
+            return false;
+        }
+        sender->packetId = sender->connection->getLastPacketId();
+        sender->sentAt.push_back(sender->now);
+        return true;
+    }
+
+    // As MqttHandler::onAck()
+    static void onAck(void* context, uint16_t packetId) {
+        BrokerSender* sender = static_cast<BrokerSender*>(context);
+        if (packetId != 0 && packetId == sender->packetId) {
+            sender->packetId = 0;
+            sender->acks++;
+            sender->journal->acknowledge();
+        }
+    }
+};
+
+void runReplay() {
+    fakeFs.reset();
+    EventJournal journal;
+    journal.begin();
+    std::vector<Pushed> pushed;
+
+    // Broker down for the whole outage: every change goes to the journal
+    pushOutage(journal, pushed, 60, 1000);
+    const uint64_t outageBytes = fakeFs.bytesWritten;
+
+    JournalBroker broker;
+    broker.start();
+    MqttConnection connection;
+    MqttConnection::Config config = {};
+    config.host = "127.0.0.1";
+    config.port = broker.port;
+    config.clientId = "scout-test";
+    config.keepAliveSeconds = 60;
+    config.connectTimeoutMs = MQTT_CONNECT_TIMEOUT;
+    config.retryMinMs = MQTT_RETRY_INTERVAL;
+    config.retryMaxMs = MQTT_RETRY_MAX;
+    config.seed = 7;
+    connection.begin(config);
+
+    BrokerSender sender = {};
+    sender.connection = &connection;
+    sender.journal = &journal;
+    connection.setAckHandler(&BrokerSender::onAck, &sender);
+    uint32_t now = 400000;
+    connection.start(now);
+    for (uint32_t ticks = 0; ticks < 100000 && !journal.isEmpty(); ticks++) {
+        connection.service(now);
+        if (connection.isConnected()) {
+            sender.now = now;
+            journal.drain(now, &BrokerSender::send, &sender);
+        }
+        now += 10;
+        usleep(20);
+    }
+    for (int wait = 0; wait < 100 && broker.received() < pushed.size(); wait++) {
+        usleep(10000);
+    }
+    broker.stop();
+
+    uint32_t minGap = UINT32_MAX;
+    for (size_t i = 1; i < sender.sentAt.size(); i++) {
+        const uint32_t gap = sender.sentAt[i] - sender.sentAt[i - 1];
+        minGap = gap < minGap ? gap : minGap;
+    }
+
+    // Payloads must come back in order with the original timestamps
+    bool inOrder = broker.payloads.size() == pushed.size();
+    for (size_t i = 0; inOrder && i < pushed.size(); i++) {
+        char expected[96];
+        snprintf(expected, sizeof(expected), "{\"seq\":%zu,\"event\":\"%s\",\"state\":\"%s\",\"ts_ms\":%u,",
+                 i + 1, pushed[i].type == TYPE_PRESENCE ? "presence" : "power", pushed[i].active ? "ON" : "OFF",
+                 pushed[i].timestamp);
+        inOrder = broker.payloads[i].compare(0, strlen(expected), expected) == 0 &&
+                  broker.topics[i] == "hearthguard/scout-test/events";
+    }
+
+    printf("replay     %zu of %zu events at the broker, %u PUBACKs, min spacing %u ms, files left %u\n",
+           broker.payloads.size(), pushed.size(), sender.acks, minGap, fakeFs.fileCount());
+    if (!broker.payloads.empty()) {
+        printf("           first: %s\n", broker.payloads.front().c_str());
+    }
+    printf("           flash: %.1f bytes per queued event during the outage, %.1f including replay ACKs\n",
+           static_cast<double>(outageBytes) / pushed.size(),
+           static_cast<double>(fakeFs.bytesWritten) / pushed.size());
+    check(inOrder, "replay", "broker payloads missing, out of order or with wrong timestamps");
+    check(minGap >= EVENT_DRAIN_INTERVAL, "replay", "replay faster than the rate limit");
+    check(sender.acks == pushed.size() && journal.isEmpty(), "replay", "every event must leave on its PUBACK");
+    check(fakeFs.fileCount() == 0, "replay", "journal files left after the backlog was sent");
+}
+
+}
+
+int main() {
+    runReplay();
+    runReboot();
+    runOverflow();
+    runTorn();
+    runPuback();
+    printf("\n%s\n", allPassed ? "PASS" : "FAIL");
+    return allPassed ? 0 : 1;
+}
@@ -0,0 +1,439 @@
+/**
+ * @file ha_discovery_check.cpp
+ * @brief Host tool: cached Home Assistant discovery against a stand-in broker
+ *
+ * Builds the firmware's HaDiscovery set and publishes it through
+ * MqttConnection the way MqttHandler does, with the NVS hash held in a
+ * variable, and checks that configs are sent:
+ *   - on first boot (no stored hash)
+ *   - not on a reconnect or a reboot with the same set
+ *   - again after a firmware version change
+ *   - again when Home Assistant announces "online" live on its status
+ *     topic, but not for a retained "online" delivered on subscribe
+ *   - again after a session lost before the configs left the transmit
+ *     buffer: the hash is only stored once it has drained
+ * and that every config points at a state topic MqttHandler publishes
+ * and, for the brightness and stealth controls, at a command topic it
+ * subscribes to.
+ *
+ * For each connect it reports the bytes the broker received and the
+ * connect-to-ready time: from CONNACK to the last packet of the connect
+ * burst, with the broker reading at --link-kbps to stand in for WiFi and
+ * broker load. A reconnect is compared against resending every time, as
+ * before the cache.
+ *
+ * Build and run from the repository root (see tools/Makefile):
+ *   make -C tools && tools/build/ha_discovery_check [--link-kbps N, default 500]
+ */
+
+#include <chrono>
+#include <cstring>
+#include <string>
+#include "HostCheck.h"
+#include "StandInBroker.h"
+#include "network/MqttConnection.h"
+#include "utilities/HaDiscovery.h"
+#include "utilities/MqttTopics.h"
+
+namespace {
+
+uint32_t linkKbps = 500;
+
+uint64_t nowUs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+/**
+ * @brief Broker stand-in: counts what arrives after CONNACK, reading at the link rate
+ */
+struct DiscoveryBroker : StandInBroker {
+    std::atomic<bool> announce{false};          // Send a live "online" on the HA status topic
+    std::atomic<bool> retainedOnline{false};    // Deliver a retained "online" on subscribe
+    std::atomic<bool> stall{false};             // Stop reading, so the socket backs up
+
+    // Current session, reset on CONNECT
+    std::atomic<uint32_t> bytes{0};
+    std::atomic<uint32_t> configs{0};
+    std::atomic<uint32_t> retainedConfigs{0};
+    std::atomic<uint32_t> subscriptions{0};
+    std::atomic<uint64_t> lastPacketUs{0};      // After CONNACK
+
+protected:
+    static void sendStatus(int client, bool retain) {
+        static const char TOPIC[] = HA_STATUS_TOPIC;
+        uint8_t packet[64];
+        const size_t topicLength = sizeof(TOPIC) - 1;
+        packet[0] = 0x30 | (retain ? 0x01 : 0x00);
+        packet[1] = static_cast<uint8_t>(2 + topicLength + 6);
+        packet[2] = 0;
+        packet[3] = static_cast<uint8_t>(topicLength);
+        memcpy(packet + 4, TOPIC, topicLength);
+        memcpy(packet + 4 + topicLength, "online", 6);
+        sendPacket(client, packet, 4 + topicLength + 6);
+    }
+
+    void session(int client) override {
+        std::vector<uint8_t> input;
+        uint8_t chunk[512];
+        bool connected = false;
+
+        while (running && !dropClient) {
+            if (stall) {
+                usleep(1000);
+                continue;
+            }
+            if (announce && connected) {
+                announce = false;
+                sendStatus(client, false);
+            }
+            pollfd readable = {client, POLLIN, 0};
+            if (poll(&readable, 1, 5) <= 0) {
+                continue;
+            }
+            // Small reads paced to the link rate
+            const ssize_t count = recv(client, chunk, sizeof(chunk), 0);
+            if (count <= 0) {
+                break;
+            }
+            if (linkKbps > 0) {
+                usleep(static_cast<useconds_t>(count * 8000ULL / linkKbps));
+            }
+            input.insert(input.end(), chunk, chunk + count);
+
+            size_t offset = 0;
+            Packet packet;
+            while (nextPacket(input, offset, packet)) {
+                const uint8_t type = packet.type;
+                const uint8_t* body = packet.body;
+
+                if (type == 0x10) {
+                    sendConnack(client, 0);
+                    connected = true;
+                    bytes = 0;
+                    configs = 0;
+                    retainedConfigs = 0;
+                    lastPacketUs = nowUs();
+                } else {
+                    bytes += packet.size;
+                    lastPacketUs = nowUs();
+                    if ((type >> 4) == 3) {
+                        const size_t topicLength = (body[0] << 8) | body[1];
+                        const std::string topic(reinterpret_cast<const char*>(body) + 2, topicLength);
+                        if (topic.compare(0, strlen(HA_DISCOVERY_PREFIX "/"), HA_DISCOVERY_PREFIX "/") == 0 &&
+                            topic.size() > 7 && topic.compare(topic.size() - 7, 7, "/config") == 0) {
+                            configs++;
+                            retainedConfigs += type & 0x01;
+                        }
+                        if ((type & 0x06) != 0) {
+                            sendPuback(client, publishPacketId(body));
+                        }
+                    } else if ((type >> 4) == 8) {
+                        const uint8_t suback[5] = {0x90, 0x03, body[0], body[1], 0x00};
+                        sendPacket(client, suback, sizeof(suback));
+                        subscriptions++;
+                        if (retainedOnline) {
+                            sendStatus(client, true);
+                        }
+                    } else if (type == 0xC0) {
+                        sendPingresp(client);
+                    }
+                }
+            }
+            input.erase(input.begin(), input.begin() + offset);
+        }
+    }
+};
+
+/**
+ * @brief Mirrors the discovery part of MqttHandler on a simulated clock
+ */
+struct Device {
+    MqttConnection connection;
+    MqttTopics topics;
+    HaDiscovery discovery;
+    uint32_t* storedHash;                       // Stands in for NVS
+    bool cached = true;                         // false: resend on every connect
+    uint8_t next = HaDiscovery::ENTITY_COUNT;
+    uint32_t pendingHash = 0;                   // As MqttHandler::discoveryPending
+    bool wasConnected = false;
+    uint32_t now = 1000;
+    uint32_t connects = 0;
+    uint64_t connackUs = 0;
+
+    static void onMessage(void* context, const MqttConnection::Message& message) {
+        static const size_t STATUS_LENGTH = strlen(HA_STATUS_TOPIC);
+        Device* device = static_cast<Device*>(context);
+        if (message.topicLength == STATUS_LENGTH && memcmp(message.topic, HA_STATUS_TOPIC, STATUS_LENGTH) == 0 &&
+            message.length == 6 && memcmp(message.payload, "online", 6) == 0 && !message.retained) {
+            device->next = 0;
+        }
+    }
+
+    void begin(uint16_t port, const char* firmwareVersion, uint32_t* hash) {
+        storedHash = hash;
+        topics.begin("hearthguard", "scout-1a2b3c");
+        if (!discovery.build(topics, HA_DISCOVERY_PREFIX, "HearthGuard Scout", firmwareVersion)) {
+            fprintf(stderr, "discovery set exceeds HA_DISCOVERY_BLOB_SIZE\n");
+            exit(1);
+        }
+
+        MqttConnection::Config config = {};
+        config.host = "127.0.0.1";
+        config.port = port;
+        config.clientId = topics.getDeviceId();
+        config.willTopic = topics.get(MqttTopics::AVAILABILITY);
+        config.willMessage = "offline";
+        config.keepAliveSeconds = MQTT_KEEPALIVE;
+        config.connectTimeoutMs = MQTT_CONNECT_TIMEOUT;
+        config.retryMinMs = 200;
+        config.retryMaxMs = 200;
+        config.seed = 1;
+        connection.begin(config);
+        connection.setMessageHandler(&Device::onMessage, this);
+        connection.start(now);
+    }
+
+    // One MqttHandler::update()
+    void update() {
+        connection.service(now);
+        if (connection.isConnected() && !wasConnected) {
+            connects++;
+            connection.publish(topics.get(MqttTopics::AVAILABILITY), "online", 6, true);
+            connection.subscribe(HA_STATUS_TOPIC);
+            if (!cached || discovery.getHash() != *storedHash) {
+                next = 0;
+                pendingHash = 0;
+            }
+        }
+        wasConnected = connection.isConnected();
+
+        if (wasConnected) {
+            publishConfigs();
+        } else {
+            pendingHash = 0;
+        }
+        now += MQTT_UPDATE_INTERVAL;
+        usleep(2000);
+    }
+
+    // MqttHandler::publishDiscovery() and storeDiscoveryHash()
+    void publishConfigs() {
+        while (next < HaDiscovery::ENTITY_COUNT &&
+               connection.publish(discovery.getTopic(next), discovery.getPayload(next),
+                                  discovery.getPayloadLength(next), true)) {
+            if (++next == HaDiscovery::ENTITY_COUNT && discovery.getHash() != *storedHash) {
+                pendingHash = discovery.getHash();
+            }
+        }
+        if (pendingHash != 0 && connection.getPendingBytes() == 0) {
+            *storedHash = pendingHash;
+            pendingHash = 0;
+        }
+    }
+
+    // Update until the next connect has settled (nothing arrives for a while)
+    bool settle(DiscoveryBroker& broker, uint32_t connectsBefore) {
+        for (int i = 0; i < 200 && connects == connectsBefore; i++) {
+            update();
+        }
+        for (int quiet = 0; quiet < 100; quiet++) {
+            const uint64_t last = broker.lastPacketUs;
+            update();
+            if (broker.lastPacketUs == last && nowUs() - last > 100000) {
+                break;
+            }
+        }
+        return connects > connectsBefore;
+    }
+};
+
+struct Outcome {
+    uint32_t configs;
+    uint32_t bytes;
+    double readyMs;
+};
+
+Outcome measure(DiscoveryBroker& broker, uint64_t sessionStartUs) {
+    return { broker.configs.load(), broker.bytes.load(),
+             (broker.lastPacketUs.load() - sessionStartUs) / 1000.0 };
+}
+
+void report(const char* scenario, const Outcome& outcome) {
+    printf("%-24s configs %u  bytes %5u  connect-to-ready %7.1f ms\n",
+           scenario, outcome.configs, outcome.bytes, outcome.readyMs);
+}
+
+// Connect (or reconnect) and wait for the burst to finish
+Outcome connect(DiscoveryBroker& broker, Device& device, bool dropFirst) {
+    const uint32_t before = device.connects;
+    if (dropFirst) {
+        broker.dropClient = true;
+        usleep(50000);
+    }
+    uint64_t sessionStart = 0;
+    for (int i = 0; i < 400 && device.connects == before; i++) {
+        sessionStart = nowUs();
+        device.update();
+    }
+    device.settle(broker, before);
+    return measure(broker, sessionStart);
+}
+
+}
+
+int main(int argc, char** argv) {
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (strcmp(argv[i], "--link-kbps") == 0) {
+            linkKbps = static_cast<uint32_t>(strtoul(argv[i + 1], nullptr, 10));
+        }
+    }
+
+    DiscoveryBroker broker;
+    broker.start();
+    uint32_t nvsHash = 0;
+
+    Device device;
+    device.begin(broker.port, FIRMWARE_VERSION, &nvsHash);
+    printf("discovery set: %u entities, %zu byte blob, hash %08x\n", HaDiscovery::ENTITY_COUNT,
+           device.discovery.getSize(), device.discovery.getHash());
+    printf("  %s\n  %s\n\n", device.discovery.getTopic(0), device.discovery.getPayload(0));
+    check(device.discovery.getSize() <= HA_DISCOVERY_BLOB_SIZE, "build", "blob overflow");
+    // What MqttHandler publishes and subscribes to
+    const MqttTopics::Topic STATES[] = { MqttTopics::PRESENCE, MqttTopics::POWER, MqttTopics::CHARGING,
+                                         MqttTopics::SYSTEM, MqttTopics::BRIGHTNESS_STATE,
+                                         MqttTopics::STEALTH_STATE };
+    const MqttTopics::Topic COMMANDS[] = { MqttTopics::BRIGHTNESS_COMMAND, MqttTopics::STEALTH_COMMAND };
+    auto mentions = [&](const std::string& payload, const char* key, MqttTopics::Topic topic) {
+        return payload.find(std::string("\"") + key + "\":\"" + device.topics.get(topic) + "\"") !=
+               std::string::npos;
+    };
+    uint32_t controls = 0;
+    for (uint8_t i = 0; i < HaDiscovery::ENTITY_COUNT; i++) {
+        const std::string payload = device.discovery.getPayload(i);
+        bool published = false;
+        for (MqttTopics::Topic topic : STATES) {
+            published |= mentions(payload, "stat_t", topic);
+        }
+        bool handled = payload.find("\"cmd_t\"") == std::string::npos;
+        for (MqttTopics::Topic topic : COMMANDS) {
+            handled |= mentions(payload, "cmd_t", topic);
+        }
+        controls += handled && payload.find("\"cmd_t\"") != std::string::npos;
+        check(published && handled, "build", "config advertises a topic nothing publishes or subscribes to");
+    }
+    check(controls == 2, "build", "expected the brightness and stealth controls");
+
+    Outcome first = connect(broker, device, false);
+    report("first boot", first);
+    check(first.configs == HaDiscovery::ENTITY_COUNT && broker.retainedConfigs == first.configs,
+          "first boot", "expected every config, retained");
+    check(nvsHash == device.discovery.getHash(), "first boot", "hash not stored");
+
+    Outcome cached = connect(broker, device, true);
+    report("reconnect, cached", cached);
+    check(cached.configs == 0, "reconnect", "configs resent although unchanged");
+
+    device.cached = false;
+    Outcome uncached = connect(broker, device, true);
+    report("reconnect, uncached", uncached);
+    device.cached = true;
+
+    device.connection.stop();
+    broker.dropClient = true;
+    usleep(50000);
+    {
+        Device rebooted;
+        rebooted.begin(broker.port, FIRMWARE_VERSION, &nvsHash);
+        Outcome reboot = connect(broker, rebooted, false);
+        report("reboot, same firmware", reboot);
+        check(reboot.configs == 0, "reboot", "configs resent although unchanged");
+        rebooted.connection.stop();
+        broker.dropClient = true;
+        usleep(50000);
+    }
+    {
+        Device updated;
+        updated.begin(broker.port, "99.0.0", &nvsHash);
+        Outcome upgrade = connect(broker, updated, false);
+        report("reboot, new firmware", upgrade);
+        check(upgrade.configs == HaDiscovery::ENTITY_COUNT, "new firmware", "configs not resent");
+        check(nvsHash == updated.discovery.getHash(), "new firmware", "hash not updated");
+
+        // Home Assistant restarts: a live "online" brings everything back
+        const uint32_t configsBefore = broker.configs;
+        const uint32_t bytesBefore = broker.bytes;
+        const uint32_t connects = updated.connects;
+        const uint64_t announcedUs = nowUs();
+        broker.announce = true;
+        for (int i = 0; i < 50; i++) {
+            updated.update();
+        }
+        const Outcome restart = { broker.configs - configsBefore, broker.bytes - bytesBefore,
+                                  (broker.lastPacketUs - announcedUs) / 1000.0 };
+        report("HA restart (live)", restart);
+        check(restart.configs == HaDiscovery::ENTITY_COUNT && updated.connects == connects,
+              "HA restart", "configs not resent on the same session");
+
+        // A retained "online" arrives on every subscribe and must not trigger it
+        broker.retainedOnline = true;
+        Outcome retained = connect(broker, updated, true);
+        report("reconnect, retained HA", retained);
+        check(retained.configs == 0, "retained status", "retained \"online\" caused a resend");
+        updated.connection.stop();
+    }
+    {
+        // Session lost with the configs still queued: nothing may be stored
+        uint32_t lostHash = 0;
+        Device lost;
+        lost.begin(broker.port, FIRMWARE_VERSION, &lostHash);
+        for (int i = 0; i < 400 && !lost.connection.isConnected(); i++) {
+            lost.connection.service(lost.now);
+            lost.now += MQTT_UPDATE_INTERVAL;
+            usleep(2000);
+        }
+        // The head of the set goes out normally; then the broker stalls and
+        // small publishes fill the socket, so the last config stays queued
+        lost.wasConnected = true;
+        for (lost.next = 0; lost.next + 1 < HaDiscovery::ENTITY_COUNT; lost.next++) {
+            for (int i = 0; i < 1000 && !lost.connection.publish(lost.discovery.getTopic(lost.next),
+                                                                  lost.discovery.getPayload(lost.next),
+                                                                  lost.discovery.getPayloadLength(lost.next), true); i++) {
+                lost.connection.service(lost.now);
+                usleep(1000);
+            }
+        }
+        broker.stall = true;
+        char filler[100] = {};
+        for (int i = 0; i < 1000000 && lost.connection.getPendingBytes() == 0; i++) {
+            lost.connection.publish("hearthguard/scout-1a2b3c/filler", filler, sizeof(filler), false);
+        }
+        lost.publishConfigs();
+        lost.connection.service(lost.now);
+        const size_t queued = lost.connection.getPendingBytes();
+        const bool allQueued = lost.next == HaDiscovery::ENTITY_COUNT;
+        lost.connection.stop();
+        const bool notStored = lostHash == 0;
+        broker.dropClient = true;
+        broker.stall = false;
+        usleep(50000);
+
+        lost.wasConnected = false;
+        lost.connection.start(lost.now);
+        Outcome again = connect(broker, lost, false);
+        report("lost before drained", again);
+        printf("%-24s %zu bytes queued when the session went, hash stored %s, then %s\n", "", queued,
+               notStored ? "no" : "yes", lostHash == lost.discovery.getHash() ? "stored" : "not stored");
+        check(allQueued && queued > 0 && notStored, "lost session", "hash stored before the configs left the buffer");
+        check(again.configs == HaDiscovery::ENTITY_COUNT && lostHash == lost.discovery.getHash(), "lost session",
+              "configs not resent and recorded on the next session");
+        lost.connection.stop();
+    }
+    broker.stop();
+
+    printf("\nper reconnect: %u -> %u bytes (%.0f%% less), connect-to-ready %.1f -> %.1f ms at %u kbit/s\n",
+           uncached.bytes, cached.bytes, 100.0 * (uncached.bytes - cached.bytes) / uncached.bytes,
+           uncached.readyMs, cached.readyMs, linkKbps);
+    printf("\n%s\n", allPassed ? "PASS" : "FAIL");
+    return allPassed ? 0 : 1;
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+/**
+ * @file Arduino.h
+ * @brief Host stand-in for the parts of the Arduino-ESP32 core the host tools touch
+ *
+ * Only declarations and trivial macros live here. Each tool defines the
+ * functions it actually links against (millis(), ledc_set_freq(), ...) so
+ * it can record or script them.
+ *
+ * Critical sections count their nesting in hostCriticalDepth, which lets a
+ * tool assert that driver calls never happen with "interrupts masked".
+ */
+
+#include <math.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "esp_err.h"
+
+#define IRAM_ATTR
+
+// FreeRTOS handles only appear as opaque members on the host
+typedef void* TaskHandle_t;
+typedef void* SemaphoreHandle_t;
+typedef uint32_t TickType_t;
+typedef uint8_t StackType_t;
+
+struct portMUX_TYPE {
+    int owner;
+};
+#define portMUX_INITIALIZER_UNLOCKED {0}
+
+inline int hostCriticalDepth = 0;
+
+#define portENTER_CRITICAL(mux) (++hostCriticalDepth)
+#define portEXIT_CRITICAL(mux) (--hostCriticalDepth)
+#define portENTER_CRITICAL_ISR(mux) (++hostCriticalDepth)
+#define portEXIT_CRITICAL_ISR(mux) (--hostCriticalDepth)
+
+#define HIGH 1
+#define LOW 0
+#define INPUT 0x01
+#define OUTPUT 0x03
+
+unsigned long millis();
+unsigned long micros();
+void delay(uint32_t ms);
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t value);
+int digitalRead(uint8_t pin);
+
+/**
+ * @brief Serial goes to stdout
+ */
+struct HostSerial {
+    int printf(const char* format, ...) __attribute__((format(printf, 2, 3))) {
+        va_list args;
+        va_start(args, format);
+        const int written = vprintf(format, args);
+        va_end(args);
+        return written;
+    }
+    size_t println(const char* text) { return static_cast<size_t>(::printf("%s\n", text)); }
+    size_t print(const char* text) { return static_cast<size_t>(::printf("%s", text)); }
+    int availableForWrite() { return 4096; }
+};
+
+inline HostSerial Serial;
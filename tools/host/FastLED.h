@@ -0,0 +1,73 @@
+#pragma once
+
+/**
+ * @file FastLED.h
+ * @brief Host stand-in for the FastLED pieces the firmware uses
+ *
+ * CRGB with the named colors the firmware references, nscale8() and
+ * blend() with FastLED's arithmetic, and fill_solid(). FastLED.show() is
+ * counted in FastLEDClass::showCount.
+ */
+
+#include <stdint.h>
+
+typedef uint8_t fract8;
+
+inline uint8_t scale8(uint8_t value, uint8_t scale) {
+    return static_cast<uint8_t>((static_cast<uint16_t>(value) * (1 + static_cast<uint16_t>(scale))) >> 8);
+}
+
+struct CRGB {
+    uint8_t r;
+    uint8_t g;
+    uint8_t b;
+
+    enum HTMLColorCode : uint32_t {
+        Black = 0x000000,
+        Blue = 0x0000FF,
+        Green = 0x008000,
+        OrangeRed = 0xFF4500,
+        Red = 0xFF0000,
+        White = 0xFFFFFF,
+        Yellow = 0xFFFF00
+    };
+
+    CRGB() = default;
+    constexpr CRGB(uint8_t red, uint8_t green, uint8_t blue) : r(red), g(green), b(blue) {}
+    constexpr CRGB(HTMLColorCode code)
+        : r(static_cast<uint8_t>(code >> 16)), g(static_cast<uint8_t>(code >> 8)), b(static_cast<uint8_t>(code)) {}
+
+    CRGB& nscale8(uint8_t scale) {
+        r = scale8(r, scale);
+        g = scale8(g, scale);
+        b = scale8(b, scale);
+        return *this;
+    }
+
+    bool operator==(const CRGB& other) const { return r == other.r && g == other.g && b == other.b; }
+    bool operator!=(const CRGB& other) const { return !(*this == other); }
+};
+
+inline CRGB blend(const CRGB& from, const CRGB& to, fract8 amount) {
+    const auto mix = [amount](uint8_t a, uint8_t b) {
+        return static_cast<uint8_t>(scale8(a, 255 - amount) + scale8(b, amount));
+    };
+    return CRGB(mix(from.r, to.r), mix(from.g, to.g), mix(from.b, to.b));
+}
+
+inline void fill_solid(CRGB* leds, int count, const CRGB& color) {
+    for (int i = 0; i < count; i++) {
+        leds[i] = color;
+    }
+}
+
+struct FastLEDClass {
+    uint32_t showCount = 0;
+    uint8_t brightness = 255;
+
+    void show() { showCount++; }
+    void clear() {}
+    void setBrightness(uint8_t value) { brightness = value; }
+};
+
+inline FastLEDClass FastLED;
@@ -0,0 +1,27 @@
+#pragma once
+
+/**
+ * @file HostCheck.h
+ * @brief Pass/fail bookkeeping shared by the host check tools
+ *
+ * A tool calls check() for every expectation and ends main() with
+ *   printf("\n%s\n", allPassed ? "PASS" : "FAIL");
+ *   return allPassed ? 0 : 1;
+ */
+
+#include <cstdio>
+
+inline bool allPassed = true;
+
+/**
+ * @brief Record one expectation, printing it if it failed
+ * @param condition Expectation that must hold
+ * @param scenario Short scenario name, as in the tool's report lines
+ * @param what What went wrong
+ */
+inline void check(bool condition, const char* scenario, const char* what) {
+    if (!condition) {
+        printf("  FAIL %s: %s\n", scenario, what);
+        allPassed = false;
+    }
+}
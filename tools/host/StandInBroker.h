@@ -0,0 +1,191 @@
+#pragma once
+
+/**
+ * @file StandInBroker.h
+ * @brief Loopback MQTT broker stand-in shared by the network host tools
+ */
+
+#include <arpa/inet.h>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <netinet/in.h>
+#include <poll.h>
+#include <stdint.h>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+/**
+ * @brief Listen on an ephemeral loopback port, exiting on failure
+ * @param backlog listen() backlog
+ * @param port Receives the port number
+ * @return Listening socket
+ */
+inline int listenLoopback(int backlog, uint16_t& port) {
+    const int fd = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t length = sizeof(address);
+    if (fd < 0 || bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0 ||
+        listen(fd, backlog) < 0 || getsockname(fd, reinterpret_cast<sockaddr*>(&address), &length) < 0) {
+        perror("listen");
+        exit(1);
+    }
+    port = ntohs(address.sin_port);
+    return fd;
+}
+
+/**
+ * @class StandInBroker
+ * @brief One client at a time on a loopback port, served on its own thread
+ *
+ * start() listens and accepts; each client is handed to session(), which
+ * a tool overrides with the broker behaviour it needs, and closed when
+ * session() returns. session() must return soon after running clears
+ * or dropClient is set; dropClient is reset after every session.
+ *
+ * Two ways to read packets:
+ *   - readPacket():  blocking, one packet at a time with a poll timeout
+ *   - nextPacket():  splits a receive buffer filled by the session, for
+ *                    sessions that must not block (delayed or paced replies)
+ */
+class StandInBroker {
+public:
+    /**
+     * @brief One complete packet inside a receive buffer
+     */
+    struct Packet {
+        uint8_t type;               // First header byte, flags included
+        const uint8_t* body;        // Variable header and payload
+        size_t length;              // Body bytes
+        size_t size;                // Whole packet, fixed header included
+    };
+
+    uint16_t port = 0;
+    std::atomic<bool> dropClient{false};    // End the current session
+
+    virtual ~StandInBroker() = default;
+
+    void start() {
+        listener = listenLoopback(4, port);
+        thread = std::thread([this] { serve(); });
+    }
+
+    // Must be called before the derived broker is destroyed
+    void stop() {
+        running = false;
+        thread.join();
+        close(listener);
+    }
+
+protected:
+    std::atomic<bool> running{true};
+
+    /**
+     * @brief Serve one accepted client until it leaves or is dropped
+     * @param client Connected socket, closed by the caller
+     */
+    virtual void session(int client) = 0;
+
+    static bool readExactly(int fd, uint8_t* out, size_t length, int timeoutMs) {
+        while (length > 0) {
+            pollfd readable = {fd, POLLIN, 0};
+            if (poll(&readable, 1, timeoutMs) <= 0) {
+                return false;
+            }
+            const ssize_t got = recv(fd, out, length, 0);
+            if (got <= 0) {
+                return false;
+            }
+            out += got;
+            length -= got;
+        }
+        return true;
+    }
+
+    // Read one packet; false on timeout or close
+    static bool readPacket(int fd, uint8_t& type, std::vector<uint8_t>& body, int timeoutMs) {
+        uint8_t byte;
+        if (!readExactly(fd, &type, 1, timeoutMs)) {
+            return false;
+        }
+        size_t length = 0;
+        for (int shift = 0;; shift += 7) {
+            if (!readExactly(fd, &byte, 1, timeoutMs)) {
+                return false;
+            }
+            length |= static_cast<size_t>(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0) {
+                break;
+            }
+        }
+        body.resize(length);
+        return length == 0 || readExactly(fd, body.data(), length, timeoutMs);
+    }
+
+    // Next complete packet at offset, which it advances; false until more bytes arrive
+    static bool nextPacket(const std::vector<uint8_t>& input, size_t& offset, Packet& packet) {
+        size_t length = 0;
+        size_t header = 1;
+        for (int shift = 0; offset + header < input.size(); shift += 7) {
+            const uint8_t byte = input[offset + header++];
+            length |= static_cast<size_t>(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0) {
+                if (offset + header + length > input.size()) {
+                    return false;
+                }
+                packet = { input[offset], input.data() + offset + header, length, header + length };
+                offset += packet.size;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    static void sendPacket(int client, const uint8_t* packet, size_t size) {
+        send(client, packet, size, MSG_NOSIGNAL);
+    }
+
+    static void sendConnack(int client, uint8_t returnCode) {
+        const uint8_t connack[4] = {0x20, 0x02, 0x00, returnCode};
+        sendPacket(client, connack, sizeof(connack));
+    }
+
+    static void sendPuback(int client, uint16_t packetId) {
+        const uint8_t puback[4] = {0x40, 0x02, static_cast<uint8_t>(packetId >> 8), static_cast<uint8_t>(packetId)};
+        sendPacket(client, puback, sizeof(puback));
+    }
+
+    static void sendPingresp(int client) {
+        const uint8_t pingresp[2] = {0xD0, 0x00};
+        sendPacket(client, pingresp, sizeof(pingresp));
+    }
+
+    // Packet ID of a QoS 1/2 PUBLISH body
+    static uint16_t publishPacketId(const uint8_t* body) {
+        const size_t topicLength = (body[0] << 8) | body[1];
+        return static_cast<uint16_t>((body[2 + topicLength] << 8) | body[3 + topicLength]);
+    }
+
+private:
+    int listener = -1;
+    std::thread thread;
+
+    void serve() {
+        while (running) {
+            pollfd pending = {listener, POLLIN, 0};
+            if (poll(&pending, 1, 10) <= 0) {
+                continue;
+            }
+            const int client = accept(listener, nullptr, nullptr);
+            if (client >= 0) {
+                session(client);
+                close(client);
+                dropClient = false;
+            }
+        }
+    }
+};
@@ -0,0 +1,18 @@
+#pragma once
+
+/**
+ * @file rmt.h
+ * @brief Host stand-in for the ESP-IDF legacy RMT driver types
+ */
+
+#include <stdint.h>
+#include "esp_err.h"
+
+typedef enum { RMT_CHANNEL_0, RMT_CHANNEL_1, RMT_CHANNEL_2, RMT_CHANNEL_3 } rmt_channel_t;
+
+typedef struct {
+    uint32_t duration0 : 15;
+    uint32_t level0 : 1;
+    uint32_t duration1 : 15;
+    uint32_t level1 : 1;
+} rmt_item32_t;
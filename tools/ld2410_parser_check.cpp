@@ -0,0 +1,360 @@
+/**
+ * @file ld2410_parser_check.cpp
+ * @brief Host tool: LD2410S report frame parser corpus and throughput
+ *
+ * Runs the firmware's Ld2410FrameParser over a byte corpus built from the
+ * LD2410S report layouts (see Ld2410FrameParser.h). Checks:
+ *   - minimal:   one minimal report (6E .. 62), every field decoded
+ *   - standard:  one standard report, target data and 16 32-bit gate energies
+ *   - split:     mixed frames (with an ACK) cut at every possible position
+ *   - bytewise:  one byte per parse() call
+ *   - b2b:       back-to-back frames in one chunk, each one reported
+ *   - garbage:   noise and false header starts before a frame
+ *   - corrupted: bad length, type, target state and tails, each followed
+ *                by a good frame that must still be found
+ *   - restart:   a frame cut short by the next header loses only itself
+ *   - ld2410:    LD2410/LD2410B basic frames are rejected, not decoded
+ *   - ack:       command ACKs decoded, kept apart from reports
+ * then times the parser over a long stream in 1-, 16- and 64-byte chunks.
+ *
+ * Build and run from the repository root (see tools/Makefile):
+ *   make -C tools && tools/build/ld2410_parser_check [stream size in MB]
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include "HostCheck.h"
+#include "sensors/Ld2410FrameParser.h"
+
+namespace {
+
+typedef std::vector<uint8_t> Bytes;
+
+void append(Bytes& out, const Bytes& bytes) {
+    out.insert(out.end(), bytes.begin(), bytes.end());
+}
+
+// Energy reported for `gate` in a standard frame built from `seed`; spreads
+// across all four bytes so byte order mistakes show up
+uint32_t gateEnergy(uint32_t seed, uint8_t gate) {
+    return seed * 0x00100000u + gate * 0x00010203u + 1;
+}
+
+// Minimal report: 6E, target state, distance (2), 62
+Bytes minimalFrame(uint8_t state, uint16_t distance) {
+    return {0x6E, state, static_cast<uint8_t>(distance & 0xFF), static_cast<uint8_t>(distance >> 8), 0x62};
+}
+
+// Standard report: type 01, target data, reserved word, 16 gate energies
+Bytes standardFrame(uint8_t state, uint16_t distance, uint32_t seed) {
+    Bytes payload = {0x01, state, static_cast<uint8_t>(distance & 0xFF), static_cast<uint8_t>(distance >> 8),
+                     0x00, 0x00};
+    for (uint8_t gate = 0; gate < Ld2410Report::MAX_GATES; gate++) {
+        const uint32_t energy = gateEnergy(seed, gate);
+        for (uint8_t shift = 0; shift < 32; shift += 8) {
+            payload.push_back(static_cast<uint8_t>(energy >> shift));
+        }
+    }
+
+    Bytes frame = {0xF4, 0xF3, 0xF2, 0xF1};
+    frame.push_back(payload.size() & 0xFF);
+    frame.push_back(payload.size() >> 8);
+    append(frame, payload);
+    append(frame, {0xF8, 0xF7, 0xF6, 0xF5});
+    return frame;
+}
+
+// Command ACK: command word | 0x0100, status, then `extra` command specific bytes
+Bytes ackFrame(uint16_t command, uint16_t status, uint8_t extra) {
+    const uint16_t length = 4 + extra;
+    Bytes frame = {0xFD, 0xFC, 0xFB, 0xFA, static_cast<uint8_t>(length & 0xFF), static_cast<uint8_t>(length >> 8),
+                   static_cast<uint8_t>(command & 0xFF), static_cast<uint8_t>((command >> 8) | 0x01),
+                   static_cast<uint8_t>(status & 0xFF), static_cast<uint8_t>(status >> 8)};
+    for (uint8_t i = 0; i < extra; i++) {
+        frame.push_back(0xF4 + i);      // Header-like bytes must not restart the parser
+    }
+    append(frame, {0x04, 0x03, 0x02, 0x01});
+    return frame;
+}
+
+struct Capture {
+    std::vector<Ld2410Report> reports;
+};
+
+void onFrame(void* context, const Ld2410Report& report) {
+    static_cast<Capture*>(context)->reports.push_back(report);
+}
+
+// Feed `stream` in chunks of `chunk` bytes; returns what the listener saw
+Capture run(const Bytes& stream, size_t chunk, uint32_t* returned = nullptr, uint32_t* errors = nullptr) {
+    Ld2410FrameParser parser;
+    Capture capture;
+    parser.setFrameListener(&onFrame, &capture);
+    uint32_t frames = 0;
+    for (size_t i = 0; i < stream.size(); i += chunk) {
+        const size_t length = (stream.size() - i < chunk) ? stream.size() - i : chunk;
+        frames += parser.parse(stream.data() + i, length);
+    }
+    if (returned != nullptr) {
+        *returned = frames;
+    }
+    if (errors != nullptr) {
+        *errors = parser.getErrorCount();
+    }
+    return capture;
+}
+
+void runMinimal() {
+    uint32_t frames;
+    const Capture capture = run(minimalFrame(0x03, 0x0123), 64, &frames);
+    check(frames == 1 && capture.reports.size() == 1, "minimal", "expected one frame");
+    if (capture.reports.size() == 1) {
+        const Ld2410Report& report = capture.reports[0];
+        check(report.targetState == 0x03, "minimal", "target state");
+        check(report.distance == 0x0123, "minimal", "distance");
+        check(!report.standard, "minimal", "flagged as standard");
+    }
+    printf("minimal    1 frame, fields decoded\n");
+}
+
+void runStandard() {
+    const Capture capture = run(standardFrame(0x02, 250, 7), 64);
+    check(capture.reports.size() == 1, "standard", "expected one frame");
+    if (capture.reports.size() == 1) {
+        const Ld2410Report& report = capture.reports[0];
+        check(report.standard, "standard", "not flagged as standard");
+        check(report.targetState == 0x02 && report.distance == 250, "standard", "target data");
+        bool energies = true;
+        for (uint8_t gate = 0; gate < Ld2410Report::MAX_GATES; gate++) {
+            energies = energies && report.gateEnergy[gate] == gateEnergy(7, gate);
+        }
+        check(energies, "standard", "gate energies");
+    }
+    printf("standard   16 gates decoded\n");
+}
+
+// The reference stream used by the split and bytewise scenarios
+Bytes referenceStream() {
+    Bytes stream;
+    append(stream, minimalFrame(0x02, 50));
+    append(stream, standardFrame(0x03, 120, 1));
+    append(stream, ackFrame(0x00FF, 0, 4));
+    append(stream, minimalFrame(0x00, 0));
+    return stream;
+}
+
+bool sameReports(const Capture& capture, const Bytes& stream) {
+    const Capture whole = run(stream, stream.size());
+    if (capture.reports.size() != whole.reports.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < whole.reports.size(); i++) {
+        const Ld2410Report& a = capture.reports[i];
+        const Ld2410Report& b = whole.reports[i];
+        if (a.targetState != b.targetState || a.distance != b.distance || a.standard != b.standard) {
+            return false;
+        }
+        for (uint8_t gate = 0; a.standard && gate < Ld2410Report::MAX_GATES; gate++) {
+            if (a.gateEnergy[gate] != b.gateEnergy[gate]) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+void runSplit() {
+    const Bytes stream = referenceStream();
+    uint32_t failures = 0;
+    for (size_t cut = 1; cut < stream.size(); cut++) {
+        Ld2410FrameParser parser;
+        Capture capture;
+        parser.setFrameListener(&onFrame, &capture);
+        parser.parse(stream.data(), cut);
+        parser.parse(stream.data() + cut, stream.size() - cut);
+        if (capture.reports.size() != 3 || parser.getAckCount() != 1 || parser.getErrorCount() != 0 ||
+            !sameReports(capture, stream)) {
+            failures++;
+        }
+    }
+    check(failures == 0, "split", "a cut position lost or changed a frame");
+    printf("split      %zu cut positions, %u bad\n", stream.size() - 1, failures);
+}
+
+void runBytewise() {
+    const Bytes stream = referenceStream();
+    uint32_t frames;
+    uint32_t errors;
+    const Capture capture = run(stream, 1, &frames, &errors);
+    check(frames == 3 && errors == 0 && sameReports(capture, stream), "bytewise", "one byte per call differs");
+    printf("bytewise   %zu calls, %u frames\n", stream.size(), frames);
+}
+
+void runBackToBack() {
+    Bytes stream;
+    for (uint8_t i = 0; i < 10; i++) {
+        append(stream, (i % 2 == 0) ? minimalFrame(0x02, i) : standardFrame(0x02, i, i));
+    }
+    uint32_t frames;
+    const Capture capture = run(stream, stream.size(), &frames);
+    bool ordered = capture.reports.size() == 10;
+    for (size_t i = 0; ordered && i < 10; i++) {
+        ordered = capture.reports[i].distance == i && capture.reports[i].standard == (i % 2 == 1);
+    }
+    check(frames == 10 && ordered, "b2b", "every frame of one chunk must reach the listener in order");
+    printf("b2b        10 frames in one chunk, parse() returned %u\n", frames);
+}
+
+void runGarbage() {
+    Bytes stream = {0x00, 0xFF, 0xF4, 0xF3, 0x12, 0x6E, 0x09, 0xF4, 0xF4, 0xF3, 0xF2, 0x00, 0x6E, 0x01, 0x02};
+    append(stream, {0xF4});                          // False start right before the real header
+    append(stream, standardFrame(0x02, 42, 5));
+    uint32_t frames;
+    const Capture capture = run(stream, 64, &frames);
+    check(frames == 1 && capture.reports.size() == 1 && capture.reports[0].distance == 42,
+          "garbage", "frame after noise lost");
+    printf("garbage    %zu noise bytes, frame found\n", stream.size() - standardFrame(0, 0, 0).size());
+}
+
+void runCorrupted() {
+    struct Case {
+        const char* name;
+        bool standard;          // Corrupt a standard frame, else a minimal one
+        size_t offset;          // Byte of the first frame to overwrite
+        uint8_t value;
+    };
+    const Case cases[] = {
+        {"state", false, 1, 0x04},
+        {"tail", false, 4, 0x00},
+        {"tail", false, 4, 0x6E},   // The bad byte starts the next minimal frame
+        {"length", true, 4, 0x45},  // One short of a standard report
+        {"length", true, 5, 0x01},
+        {"type", true, 6, 0x02},
+        {"state", true, 7, 0x04},
+        {"tail", true, 76, 0x00},
+        {"tail", true, 79, 0x00},
+        {"tail", true, 78, 0xF4},   // The bad byte starts the next header
+    };
+
+    uint32_t failures = 0;
+    for (const Case& c : cases) {
+        Bytes stream = c.standard ? standardFrame(0x02, 1, 1) : minimalFrame(0x02, 1);
+        const Bytes next = c.standard ? standardFrame(0x02, 2, 2) : minimalFrame(0x02, 2);
+        stream[c.offset] = c.value;
+        if (c.value == next[0]) {
+            // Next frame begins at the corrupting byte
+            stream.resize(c.offset);
+        }
+        append(stream, next);
+        uint32_t errors;
+        const Capture capture = run(stream, 64, nullptr, &errors);
+        const bool good = capture.reports.size() == 1 && capture.reports[0].distance == 2 && errors >= 1;
+        if (!good) {
+            printf("  %s at %zu: %zu frame(s), %u error(s)\n", c.name, c.offset, capture.reports.size(), errors);
+            failures++;
+        }
+    }
+    check(failures == 0, "corrupted", "a corrupted frame was accepted or hid the next one");
+    printf("corrupted  %zu cases, %u bad\n", sizeof(cases) / sizeof(cases[0]), failures);
+}
+
+void runRestart() {
+    // A standard frame cut after its target data, then two complete frames.
+    // The cut frame swallows the start of the next as payload and fails its
+    // tail; only the frame after that is guaranteed
+    Bytes stream = standardFrame(0x02, 1, 1);
+    stream.resize(10);
+    append(stream, standardFrame(0x02, 2, 2));
+    append(stream, standardFrame(0x02, 3, 3));
+    uint32_t errors;
+    const Capture capture = run(stream, 64, nullptr, &errors);
+    const bool lastFound = !capture.reports.empty() && capture.reports.back().distance == 3;
+    bool noGhost = true;
+    for (const Ld2410Report& report : capture.reports) {
+        noGhost = noGhost && report.distance != 1;
+    }
+    check(lastFound && noGhost && errors >= 1, "restart", "truncated frame accepted or recovery failed");
+    printf("restart    truncated frame dropped, %zu later frame(s) found\n", capture.reports.size());
+}
+
+void runLd2410() {
+    // LD2410/LD2410B basic report: same header, 13-byte payload (02 AA ... 55 00)
+    Bytes stream = {0xF4, 0xF3, 0xF2, 0xF1, 0x0D, 0x00, 0x02, 0xAA, 0x03, 0x2C, 0x01, 0x40,
+                    0x2C, 0x01, 0x20, 0x2C, 0x01, 0x55, 0x00, 0xF8, 0xF7, 0xF6, 0xF5};
+    append(stream, minimalFrame(0x02, 9));
+    uint32_t errors;
+    const Capture capture = run(stream, 64, nullptr, &errors);
+    check(capture.reports.size() == 1 && capture.reports[0].distance == 9 && errors >= 1, "ld2410",
+          "LD2410 frame decoded or hid the next frame");
+    printf("ld2410     basic frame rejected, %zu LD2410S frame(s) found\n", capture.reports.size());
+}
+
+void runAck() {
+    Ld2410FrameParser parser;
+    Capture capture;
+    parser.setFrameListener(&onFrame, &capture);
+    Bytes stream = ackFrame(0x00FF, 0, 4);
+    append(stream, minimalFrame(0x02, 5));
+    append(stream, ackFrame(0x007A, 1, 0));
+    const uint8_t frames = parser.parse(stream.data(), stream.size());
+    const Ld2410Ack& ack = parser.getAck();
+    check(frames == 1 && capture.reports.size() == 1, "ack", "ACKs counted as reports");
+    check(parser.getAckCount() == 2 && parser.getErrorCount() == 0, "ack", "expected two ACKs");
+    check(ack.command == 0x017A && ack.status == 1, "ack", "last ACK command or status");
+
+    // An ACK with a length outside the protocol's range is an error, not an ACK
+    Bytes bad = ackFrame(0x00FE, 0, 0);
+    bad[4] = 0x02;
+    parser.parse(bad.data(), bad.size());
+    check(parser.getAckCount() == 2 && parser.getErrorCount() >= 1, "ack", "short ACK accepted");
+    printf("ack        %u ACKs decoded, last 0x%04X status %u\n", parser.getAckCount(), ack.command, ack.status);
+}
+
+void runThroughput(double megabytes) {
+    // Realistic mix: minimal reports with a standard report every fourth
+    Bytes pattern;
+    for (uint8_t i = 0; i < 4; i++) {
+        append(pattern, i == 3 ? standardFrame(0x03, 90, 4) : minimalFrame(0x02, i * 25));
+    }
+    Bytes stream;
+    const size_t target = static_cast<size_t>(megabytes * 1024 * 1024);
+    while (stream.size() < target) {
+        append(stream, pattern);
+    }
+
+    const size_t chunks[] = {1, 16, 64};
+    for (size_t chunk : chunks) {
+        Ld2410FrameParser parser;
+        uint32_t frames = 0;
+        const auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < stream.size(); i += chunk) {
+            const size_t length = (stream.size() - i < chunk) ? stream.size() - i : chunk;
+            frames += parser.parse(stream.data() + i, length);
+        }
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        printf("throughput %2zu-byte chunks: %7.1f MB/s, %6.2f ns/byte, %5.0f k frames/s (%u frames)\n", chunk,
+               stream.size() / seconds / (1024 * 1024), seconds * 1e9 / stream.size(), frames / seconds / 1000,
+               frames);
+        check(parser.getErrorCount() == 0, "throughput", "errors on a clean stream");
+    }
+}
+
+}
+
+int main(int argc, char** argv) {
+    runMinimal();
+    runStandard();
+    runSplit();
+    runBytewise();
+    runBackToBack();
+    runGarbage();
+    runCorrupted();
+    runRestart();
+    runLd2410();
+    runAck();
+    runThroughput(argc > 1 ? atof(argv[1]) : 16.0);
+    printf("\n%s\n", allPassed ? "PASS" : "FAIL");
+    return allPassed ? 0 : 1;
+}
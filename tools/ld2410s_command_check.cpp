@@ -0,0 +1,248 @@
+/**
+ * @file ld2410s_command_check.cpp
+ * @brief Host tool: Ld2410sSensor output mode commands against a scripted radar
+ *
+ * Links the firmware's Ld2410sSensor with a stand-in UART (tools/host)
+ * whose far end is a scripted LD2410S, and checks:
+ *   - on:       enable config, output mode (standard), end config, each
+ *               sent only after the previous ACK; standard reports then
+ *               fill the gate log and minimal reports do not
+ *   - off:      switching back sends the minimal output value
+ *   - noack:    a command the radar ignores aborts the change after the
+ *               ACK timeout with one error, leaves configuration mode and
+ *               keeps engineering mode off
+ *   - rejected: a negative ACK, or an ACK for another command, aborts at once
+ *
+ * Build and run from the repository root (see tools/Makefile):
+ *   make -C tools && tools/build/ld2410s_command_check
+ */
+
+#include <cstdio>
+#include <vector>
+#include "HostCheck.h"
+#include "sensors/Ld2410sSensor.h"
+#include "utilities/Logger.h"
+
+namespace {
+
+typedef std::vector<uint8_t> Bytes;
+
+constexpr uint16_t CMD_ENABLE_CONFIG = 0x00FF;
+constexpr uint16_t CMD_END_CONFIG = 0x00FE;
+constexpr uint16_t CMD_OUTPUT_MODE = 0x007A;
+constexpr unsigned long POLL_MS = 250;
+
+/**
+ * @brief The LD2410S on the far side of the UART
+ */
+struct FakeRadar {
+    struct Command {
+        uint16_t word;
+        Bytes value;
+    };
+
+    unsigned long nowMs = 0;
+    Bytes rx;                       // Bytes waiting for uart_read_bytes()
+    std::vector<Command> commands;  // Every command frame written
+    uint32_t errors = 0;            // LOG_ERROR calls
+
+    uint16_t ignore = 0;            // Command word never acknowledged
+    uint16_t rejectStatus = 0;      // Status returned for every ACK
+    bool wrongCommand = false;      // ACK every command as if it were end config
+
+    void reset() {
+        *this = FakeRadar();
+    }
+
+    void push(const Bytes& bytes) {
+        rx.insert(rx.end(), bytes.begin(), bytes.end());
+    }
+
+    void acknowledge(uint16_t word) {
+        if (word == ignore) {
+            return;
+        }
+        const uint16_t acked = (wrongCommand ? CMD_END_CONFIG : word) | 0x0100;
+        push({0xFD, 0xFC, 0xFB, 0xFA, 0x04, 0x00, static_cast<uint8_t>(acked & 0xFF),
+               static_cast<uint8_t>(acked >> 8), static_cast<uint8_t>(rejectStatus & 0xFF),
+               static_cast<uint8_t>(rejectStatus >> 8), 0x04, 0x03, 0x02, 0x01});
+    }
+};
+
+FakeRadar radar;
+
+Bytes standardFrame() {
+    Bytes frame = {0xF4, 0xF3, 0xF2, 0xF1, 70, 0x00, 0x01, 0x02, 0x64, 0x00, 0x00, 0x00};
+    for (uint8_t gate = 0; gate < Ld2410Report::MAX_GATES; gate++) {
+        frame.insert(frame.end(), {static_cast<uint8_t>(gate * 3), 0x01, 0x00, 0x00});
+    }
+    frame.insert(frame.end(), {0xF8, 0xF7, 0xF6, 0xF5});
+    return frame;
+}
+
+// Poll like the sensor task does until nothing is in flight or `polls` runs out
+void poll(Ld2410sSensor& sensor, uint8_t polls) {
+    for (uint8_t i = 0; i < polls; i++) {
+        sensor.update();
+        radar.nowMs += POLL_MS;
+    }
+}
+
+bool sentInOrder(const std::vector<uint16_t>& expected) {
+    if (radar.commands.size() != expected.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < expected.size(); i++) {
+        if (radar.commands[i].word != expected[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void runOn() {
+    radar.reset();
+    Ld2410sSensor sensor;
+    sensor.begin();
+    sensor.setEngineeringMode(true);
+
+    // One update per command: each ACK arrives between polls
+    sensor.update();
+    check(radar.commands.size() == 1, "on", "more than one command before the first ACK");
+    poll(sensor, 4);
+
+    check(sentInOrder({CMD_ENABLE_CONFIG, CMD_OUTPUT_MODE, CMD_END_CONFIG}), "on", "command sequence");
+    check(radar.commands.size() > 1 && radar.commands[1].value == Bytes({0x00, 0x00, 0x01, 0x00, 0x00, 0x00}),
+          "on", "standard output value");
+    check(sensor.isEngineeringActive() && radar.errors == 0, "on", "mode not confirmed");
+
+    radar.push(standardFrame());
+    radar.push({0x6E, 0x02, 0x64, 0x00, 0x62});
+    sensor.update();
+    check(sensor.getGateLog().getCount() == 1, "on", "expected one gate log frame");
+    check(sensor.getGateLog().getEnergy(5, 0) == 0x10F, "on", "gate energy");
+    printf("on         %zu commands, gate log %u frame(s)\n", radar.commands.size(), sensor.getGateLog().getCount());
+}
+
+void runOff() {
+    radar.reset();
+    Ld2410sSensor sensor;
+    sensor.begin();
+    sensor.setEngineeringMode(true);
+    poll(sensor, 4);
+    radar.commands.clear();
+
+    sensor.setEngineeringMode(false);
+    poll(sensor, 4);
+    check(sentInOrder({CMD_ENABLE_CONFIG, CMD_OUTPUT_MODE, CMD_END_CONFIG}), "off", "command sequence");
+    check(radar.commands.size() > 1 && radar.commands[1].value == Bytes(6, 0x00), "off", "minimal output value");
+    check(!sensor.isEngineeringActive() && radar.errors == 0, "off", "mode not confirmed");
+    printf("off        %zu commands, minimal output confirmed\n", radar.commands.size());
+}
+
+void runNoAck() {
+    radar.reset();
+    radar.ignore = CMD_OUTPUT_MODE;
+    Ld2410sSensor sensor;
+    sensor.begin();
+    sensor.setEngineeringMode(true);
+
+    // Inside the timeout nothing more may be sent and nothing fails yet
+    sensor.update();
+    sensor.update();
+    check(radar.commands.size() == 2 && radar.errors == 0, "noack", "sent past an unacknowledged command");
+
+    poll(sensor, 4);
+    check(radar.errors == 1, "noack", "expected exactly one error");
+    check(sentInOrder({CMD_ENABLE_CONFIG, CMD_OUTPUT_MODE, CMD_END_CONFIG}), "noack", "config mode not left");
+    check(!sensor.isEngineeringActive() && !sensor.isEngineeringMode(), "noack", "engineering mode still on");
+
+    const size_t sent = radar.commands.size();
+    poll(sensor, 4);
+    check(radar.commands.size() == sent && radar.errors == 1, "noack", "kept sending after the abort");
+    printf("noack      aborted after %zu commands, %u error(s)\n", sent, radar.errors);
+}
+
+void runRejected() {
+    struct Case {
+        const char* name;
+        uint16_t status;
+        bool wrongCommand;
+    };
+    const Case cases[] = {
+        {"status", 1, false},
+        {"command", 0, true},
+    };
+
+    uint32_t failures = 0;
+    for (const Case& c : cases) {
+        radar.reset();
+        radar.rejectStatus = c.status;
+        radar.wrongCommand = c.wrongCommand;
+        Ld2410sSensor sensor;
+        sensor.begin();
+        sensor.setEngineeringMode(true);
+        sensor.update();        // Enable config, ACKed badly
+        sensor.update();        // Sees the bad ACK
+        const bool good = radar.errors == 1 && radar.commands.size() == 1 && !sensor.isEngineeringActive() &&
+                          !sensor.isEngineeringMode();
+        if (!good) {
+            printf("  %s: %zu command(s), %u error(s)\n", c.name, radar.commands.size(), radar.errors);
+            failures++;
+        }
+    }
+    check(failures == 0, "rejected", "a bad ACK did not abort the change");
+    printf("rejected   %zu cases, %u bad\n", sizeof(cases) / sizeof(cases[0]), failures);
+}
+
+}
+
+bool Logger::write(uint8_t level, const char*, const uintptr_t*, uint8_t) {
+    if (level == LOG_LEVEL_ERROR) {
+        radar.errors++;
+    }
+    return true;
+}
+
+unsigned long millis() {
+    return radar.nowMs;
+}
+
+esp_err_t uart_driver_install(uart_port_t, int, int, int, QueueHandle_t*, int) {
+    return ESP_OK;
+}
+
+esp_err_t uart_param_config(uart_port_t, const uart_config_t*) {
+    return ESP_OK;
+}
+
+esp_err_t uart_set_pin(uart_port_t, int, int, int, int) {
+    return ESP_OK;
+}
+
+int uart_read_bytes(uart_port_t, void* buffer, uint32_t length, uint32_t) {
+    const size_t count = radar.rx.size() < length ? radar.rx.size() : length;
+    memcpy(buffer, radar.rx.data(), count);
+    radar.rx.erase(radar.rx.begin(), radar.rx.begin() + count);
+    return static_cast<int>(count);
+}
+
+int uart_write_bytes(uart_port_t, const void* data, size_t length) {
+    // FD FC FB FA | length (2) | command (2) | value | 04 03 02 01
+    const uint8_t* frame = static_cast<const uint8_t*>(data);
+    FakeRadar::Command command;
+    command.word = frame[6] | (frame[7] << 8);
+    command.value.assign(frame + 8, frame + length - 4);
+    radar.commands.push_back(command);
+    radar.acknowledge(command.word);
+    return static_cast<int>(length);
+}
+
+int main() {
+    runOn();
+    runOff();
+    runNoAck();
+    runRejected();
+    printf("\n%s\n", allPassed ? "PASS" : "FAIL");
+    return allPassed ? 0 : 1;
+}
@@ -0,0 +1,285 @@
+/**
+ * @file led_frame_count.cpp
+ * @brief Host tool: LED frames pushed by the main.cpp demo, before and after coalescing
+ *
+ * Runs the Phase 1 demo sequence from main.cpp (green pulse, blue blink,
+ * solid orange, solid red, all off, every 5 s) on a simulated 1 ms loop
+ * against two LED controllers sharing a mocked output:
+ *   - legacy:  the pre-coalescing controller, which called FastLED.show()
+ *              on every pixel write, brightness change and turnOff()
+ *              (kept here as a model, the firmware no longer has it)
+ *   - current: the firmware's LedController, whose Ws2812RmtDriver::show()
+ *              calls are counted instead
+ * and prints the outputs per demo step and in total, plus the frames the
+ * current controller skipped because nothing changed, and how many of
+ * those were dirty but quantised to the bytes already sent. The demo runs
+ * at full brightness and again at a lower one, where more breath steps
+ * collapse onto the same output. A burst scenario (brightness, stealth
+ * and both pixels changed within one loop pass) shows the coalescing on
+ * its own.
+ *
+ * Build and run from the repository root (see tools/Makefile):
+ *   make -C tools && tools/build/led_frame_count [demo cycles] [dimmed brightness, default 32]
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include "feedback/LedController.h"
+#include "utilities/Logger.h"
+
+namespace {
+
+unsigned long nowMs = 0;
+uint32_t rmtShows = 0;
+
+}
+
+unsigned long millis() {
+    return nowMs;
+}
+
+void delay(uint32_t ms) {
+    nowMs += ms;
+}
+
+void pinMode(uint8_t, uint8_t) {}
+void digitalWrite(uint8_t, uint8_t) {}
+
+bool Logger::write(uint8_t, const char*, const uintptr_t*, uint8_t) {
+    return true;
+}
+
+bool Ws2812RmtDriver::addStrand(uint8_t, const CRGB*, uint8_t, uint8_t) {
+    return true;
+}
+
+bool Ws2812RmtDriver::show(uint8_t) {
+    rmtShows++;     // Transmission completes at once, busyMask stays clear
+    return true;
+}
+
+namespace {
+
+/**
+ * @brief The LedController as it was before frames were coalesced
+ *
+ * Same animations and timing, same public calls used by the demo; every
+ * pixel write is pushed straight to the strip with FastLED.show().
+ */
+class LegacyLedController {
+public:
+    void begin() {
+        FastLED.clear();
+        FastLED.show();
+    }
+
+    void update() {
+        for (uint8_t i = 0; i < 2; i++) {
+            updatePixel(i);
+        }
+    }
+
+    void setBrightness(uint8_t brightness) {
+        for (uint8_t i = 0; i < 2; i++) {
+            if (states[i].isOn || states[i].animation != LedAnimation::SOLID) {
+                updatePixel(i);
+            }
+        }
+        FastLED.setBrightness(brightness);
+        FastLED.show();
+    }
+
+    void startAnimation(uint8_t pixel, CRGB color, LedAnimation animation, uint16_t interval) {
+        states[pixel] = {animation, color, interval, 0, true, 0};
+        apply(pixel, color);
+    }
+
+    void turnOff() {
+        states[0] = states[1] = State();
+        FastLED.clear();
+        FastLED.show();
+    }
+
+private:
+    struct State {
+        LedAnimation animation = LedAnimation::SOLID;
+        CRGB baseColor = CRGB::Black;
+        uint16_t interval = 0;
+        unsigned long lastUpdate = 0;
+        bool isOn = false;
+        uint8_t pulsePhase = 0;
+    };
+
+    static constexpr uint8_t FADE_STEP_MS = 50;
+
+    State states[2];
+    CRGB leds[2] = {CRGB::Black, CRGB::Black};
+
+    void apply(uint8_t pixel, CRGB color) {
+        leds[pixel] = color;
+        FastLED.show();
+    }
+
+    static uint8_t sineWave(uint8_t phase) {
+        if (phase < 85) {
+            return phase * 3;
+        }
+        if (phase < 170) {
+            return 255 - (phase - 85) * 3;
+        }
+        return 0;
+    }
+
+    void updatePixel(uint8_t pixel) {
+        State& state = states[pixel];
+        switch (state.animation) {
+            case LedAnimation::SOLID:
+                if (state.lastUpdate == 0) {
+                    apply(pixel, state.baseColor);
+                    state.lastUpdate = nowMs;
+                }
+                break;
+            case LedAnimation::BLINK:
+                if (nowMs - state.lastUpdate >= state.interval) {
+                    state.isOn = !state.isOn;
+                    state.lastUpdate = nowMs;
+                    apply(pixel, state.isOn ? state.baseColor : CRGB(CRGB::Black));
+                }
+                break;
+            case LedAnimation::PULSE:
+                if (nowMs - state.lastUpdate >= FADE_STEP_MS) {
+                    const uint8_t level = sineWave(state.pulsePhase);
+                    apply(pixel, CRGB(state.baseColor.r * level / 255, state.baseColor.g * level / 255,
+                                      state.baseColor.b * level / 255));
+                    state.pulsePhase = (state.pulsePhase + (255 * FADE_STEP_MS) / state.interval) % 255;
+                    state.lastUpdate = nowMs;
+                }
+                break;
+        }
+    }
+};
+
+// main.cpp demo timing: managers up 1 s after boot, first step 3 s + 5 s later
+constexpr unsigned long BOOT_MS = 1000;
+constexpr unsigned long DEMO_FIRST_STEP = BOOT_MS + 3000 + 5000;
+constexpr unsigned long DEMO_STEP_INTERVAL = 5000;
+constexpr int DEMO_STEPS = 5;
+
+const char* const STEP_NAMES[DEMO_STEPS] = {
+    "green pulse 2000 ms", "blue blink 500 ms", "solid orange", "solid red", "all off"
+};
+
+template <typename Controller>
+void demoStep(Controller& leds, int step) {
+    switch (step) {
+        case 0:
+            leds.startAnimation(PIXEL_SYSTEM, HearthGuardColors::HEARTHGUARD_GREEN, LedAnimation::PULSE, 2000);
+            break;
+        case 1:
+            leds.startAnimation(PIXEL_ACTIVITY, HearthGuardColors::HEARTHGUARD_BLUE, LedAnimation::BLINK, 500);
+            break;
+        case 2:
+            leds.startAnimation(PIXEL_SYSTEM, HearthGuardColors::HEARTHGUARD_ORANGE, LedAnimation::SOLID, 0);
+            break;
+        case 3:
+            leds.startAnimation(PIXEL_ACTIVITY, HearthGuardColors::HEARTHGUARD_RED, LedAnimation::SOLID, 0);
+            break;
+        default:
+            leds.turnOff();
+            break;
+    }
+}
+
+void runDemo(int cycles, uint8_t brightness) {
+    FastLED.showCount = 0;
+    rmtShows = 0;
+    LegacyLedController legacy;
+    LedController current;
+
+    // FeedbackManager::begin(): controller up, then the saved brightness applied
+    nowMs = BOOT_MS;
+    legacy.begin();
+    legacy.setBrightness(brightness);
+    current.begin();
+    current.setBrightness(brightness);
+
+    uint32_t legacyPerStep[DEMO_STEPS] = {};
+    uint32_t currentPerStep[DEMO_STEPS] = {};
+    const uint32_t legacyBoot = FastLED.showCount;
+
+    const unsigned long end = DEMO_FIRST_STEP + static_cast<unsigned long>(cycles) * DEMO_STEPS * DEMO_STEP_INTERVAL;
+    int step = -1;
+    for (; nowMs < end; nowMs++) {
+        if (nowMs >= DEMO_FIRST_STEP && (nowMs - DEMO_FIRST_STEP) % DEMO_STEP_INTERVAL == 0) {
+            step = static_cast<int>((nowMs - DEMO_FIRST_STEP) / DEMO_STEP_INTERVAL) % DEMO_STEPS;
+            demoStep(legacy, step);
+            demoStep(current, step);
+        }
+
+        const uint32_t legacyBefore = FastLED.showCount;
+        const uint32_t currentBefore = rmtShows;
+        legacy.update();
+        current.update();
+        if (step >= 0) {
+            legacyPerStep[step] += FastLED.showCount - legacyBefore;
+            currentPerStep[step] += rmtShows - currentBefore;
+        }
+    }
+
+    const double seconds = (end - BOOT_MS) / 1000.0;
+    printf("demo       %d cycle(s) at brightness %u, %.0f s simulated at one loop pass per ms\n", cycles,
+           brightness, seconds);
+    printf("           %-22s %10s %10s\n", "step (5 s each)", "legacy", "current");
+    for (int i = 0; i < DEMO_STEPS; i++) {
+        printf("           %-22s %10u %10u\n", STEP_NAMES[i], legacyPerStep[i], currentPerStep[i]);
+    }
+    printf("           %-22s %10u %10u\n", "total incl. boot", FastLED.showCount, rmtShows);
+    printf("           legacy boot %u show(s); current skipped %u empty frame slot(s), %u of them with "
+           "unchanged output bytes\n", legacyBoot, current.getFramesSkipped(), current.getFramesUnchanged());
+    printf("           reduction %.1fx; legacy show() blocks, current show() returns at once (RMT)\n",
+           rmtShows > 0 ? static_cast<double>(FastLED.showCount) / rmtShows : 0.0);
+}
+
+// Brightness, stealth toggle and both pixels restarted inside one loop pass
+void runBurst() {
+    FastLED.showCount = 0;
+    rmtShows = 0;
+    LegacyLedController legacy;
+    LedController current;
+    nowMs = 100000;
+    legacy.begin();
+    current.begin();
+    const uint32_t legacyStart = FastLED.showCount;
+    const uint32_t currentStart = rmtShows;
+
+    for (int burst = 0; burst < 10; burst++) {
+        for (uint8_t level = 0; level < 8; level++) {
+            legacy.setBrightness(level * 32);
+            current.setBrightness(level * 32);
+        }
+        legacy.turnOff();
+        current.turnOff();
+        legacy.startAnimation(PIXEL_SYSTEM, HearthGuardColors::HEARTHGUARD_RED, LedAnimation::SOLID, 0);
+        current.startAnimation(PIXEL_SYSTEM, HearthGuardColors::HEARTHGUARD_RED, LedAnimation::SOLID, 0);
+        legacy.startAnimation(PIXEL_ACTIVITY, HearthGuardColors::HEARTHGUARD_YELLOW, LedAnimation::SOLID, 0);
+        current.startAnimation(PIXEL_ACTIVITY, HearthGuardColors::HEARTHGUARD_YELLOW, LedAnimation::SOLID, 0);
+        for (int ms = 0; ms < 100; ms++, nowMs++) {
+            legacy.update();
+            current.update();
+        }
+    }
+
+    printf("burst      10 x (8 brightness changes, turnOff, 2 pixel writes): legacy %u, current %u\n",
+           FastLED.showCount - legacyStart, rmtShows - currentStart);
+}
+
+}
+
+int main(int argc, char** argv) {
+    const int cycles = argc > 1 ? atoi(argv[1]) : 4;
+    const int dimmed = argc > 2 ? atoi(argv[2]) : 32;
+    runDemo(cycles > 0 ? cycles : 1, 255);
+    runDemo(cycles > 0 ? cycles : 1, static_cast<uint8_t>(dimmed));
+    runBurst();
+    return 0;
+}
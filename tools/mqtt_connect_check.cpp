@@ -0,0 +1,309 @@
+/**
+ * @file mqtt_connect_check.cpp
+ * @brief Host tool: MqttConnection against stand-in brokers on localhost
+ *
+ * Drives the firmware's MqttConnection the way the network task does,
+ * one service() call per tick on a simulated millisecond clock, against:
+ *   - refused:   nothing listens on the port (connect fails at once)
+ *   - no-answer: the listen backlog is full, so the SYN is never answered
+ *   - silent:    TCP is accepted but no CONNACK ever comes
+ *   - rejecting: CONNACK with "not authorized"
+ *   - accepting: a minimal broker that accepts, answers pings and then
+ *                drops the session to force a reconnect
+ * and checks the outcome of each, the jittered retry delays, and the
+ * worst-case wall time of a single service() call.
+ *
+ * Build and run from the repository root (see tools/Makefile):
+ *   make -C tools && tools/build/mqtt_connect_check [max service() us, default 2000]
+ */
+
+#include <chrono>
+#include <cstring>
+#include "HostCheck.h"
+#include "StandInBroker.h"
+#include "network/MqttConnection.h"
+
+namespace {
+
+constexpr uint32_t TICK_MS = 10;            // Simulated time per service() call
+constexpr uint32_t TICK_SLEEP_US = 20;      // Real time per tick, lets loopback TCP progress
+constexpr uint16_t KEEPALIVE_SECONDS = 2;
+
+uint32_t maxServiceUs = 2000;
+double worstServiceUs = 0;
+
+const char* phaseName(MqttConnection::Phase phase) {
+    switch (phase) {
+        case MqttConnection::Phase::IDLE:            return "IDLE";
+        case MqttConnection::Phase::WAITING:         return "WAITING";
+        case MqttConnection::Phase::TCP_CONNECTING:  return "TCP_CONNECTING";
+        case MqttConnection::Phase::MQTT_CONNECTING: return "MQTT_CONNECTING";
+        case MqttConnection::Phase::CONNECTED:       return "CONNECTED";
+    }
+    return "?";
+}
+
+/**
+ * @brief Simulated clock plus the per-call timing of service()
+ */
+struct Harness {
+    MqttConnection connection;
+    uint32_t now = 1000;
+    uint32_t calls = 0;
+    double worstUs = 0;
+
+    // Retry delays seen after failures, checked against the backoff schedule
+    uint32_t checkedDelays = 0;
+    uint32_t badDelays = 0;
+    uint32_t lastFailures = 0;
+
+    void configure(uint16_t port, uint32_t seed) {
+        static const char* const WILL_TOPIC = "hearthguard/scout-test/status";
+        MqttConnection::Config config = {};
+        config.host = "127.0.0.1";
+        config.port = port;
+        config.clientId = "scout-test";
+        config.username = "mqtt-user";
+        config.password = "secret";
+        config.willTopic = WILL_TOPIC;
+        config.willMessage = "offline";
+        config.keepAliveSeconds = KEEPALIVE_SECONDS;
+        config.connectTimeoutMs = MQTT_CONNECT_TIMEOUT;
+        config.retryMinMs = MQTT_RETRY_INTERVAL;
+        config.retryMaxMs = MQTT_RETRY_MAX;
+        config.seed = seed;
+        if (!connection.begin(config)) {
+            fprintf(stderr, "configuration rejected\n");
+            exit(1);
+        }
+        connection.start(now);
+    }
+
+    void tick() {
+        const auto start = std::chrono::steady_clock::now();
+        connection.service(now);
+        const double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+        if (us > worstUs) {
+            worstUs = us;
+        }
+        calls++;
+
+        const uint32_t failures = connection.getFailureCount();
+        if (failures > lastFailures) {
+            checkDelay(failures);
+        }
+        lastFailures = failures;
+
+        now += TICK_MS;
+        usleep(TICK_SLEEP_US);
+    }
+
+    void checkDelay(uint32_t failures) {
+        uint32_t expected = MQTT_RETRY_INTERVAL;
+        for (uint32_t i = 1; i < failures && expected < MQTT_RETRY_MAX; i++) {
+            expected *= 2;
+        }
+        if (expected > MQTT_RETRY_MAX) {
+            expected = MQTT_RETRY_MAX;
+        }
+        const uint32_t delay = connection.getNextAttempt() - now;
+        const uint32_t spread = expected / 100 * MQTT_RETRY_JITTER;
+        checkedDelays++;
+        if (delay < expected - spread || delay > expected + spread) {
+            badDelays++;
+        }
+    }
+
+    template <typename Predicate>
+    bool runUntil(uint32_t limitMs, Predicate done) {
+        const uint32_t end = now + limitMs;
+        while (static_cast<int32_t>(now - end) < 0) {
+            tick();
+            if (done()) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void report(const char* scenario) {
+        printf("%-10s %6u calls  worst %7.1f us  attempts %3u  failures %3u  phase %-15s  %s\n",
+               scenario, calls, worstUs, connection.getAttemptCount(), connection.getFailureCount(),
+               phaseName(connection.getPhase()), connection.getLastError());
+        check(worstUs <= maxServiceUs, scenario, "service() exceeded the time limit");
+        check(badDelays == 0, scenario, "retry delay outside the jittered backoff");
+        if (worstUs > worstServiceUs) {
+            worstServiceUs = worstUs;
+        }
+    }
+};
+
+// Ten simulated minutes covers the whole backoff ramp up to MQTT_RETRY_MAX
+constexpr uint32_t FAILING_RUN_MS = 10 * 60 * 1000;
+
+void runRefused() {
+    uint16_t port;
+    close(listenLoopback(1, port));     // Port is now closed
+
+    Harness harness;
+    harness.configure(port, 1);
+    harness.runUntil(FAILING_RUN_MS, [] { return false; });
+    harness.report("refused");
+    check(harness.connection.getFailureCount() >= 5, "refused", "expected repeated failures");
+    check(strcmp(harness.connection.getLastError(), "TCP connect failed") == 0, "refused", "wrong error");
+}
+
+void runNoAnswer() {
+    // Backlog 0 and two queued connections: further SYNs are dropped
+    uint16_t port;
+    const int listener = listenLoopback(0, port);
+    int fillers[2];
+    for (int& filler : fillers) {
+        filler = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK, 0);
+        sockaddr_in address = {};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(port);
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        connect(filler, reinterpret_cast<sockaddr*>(&address), sizeof(address));
+    }
+    usleep(10000);
+
+    Harness harness;
+    harness.configure(port, 2);
+    harness.runUntil(2 * 60 * 1000, [] { return false; });
+    harness.report("no-answer");
+    check(harness.connection.getFailureCount() >= 2, "no-answer", "expected time-outs");
+    check(!harness.connection.isConnected(), "no-answer", "connected to a full backlog");
+
+    for (int filler : fillers) {
+        close(filler);
+    }
+    close(listener);
+}
+
+void runSilent() {
+    // The kernel completes the handshake; nobody reads the CONNECT
+    uint16_t port;
+    const int listener = listenLoopback(16, port);
+
+    Harness harness;
+    harness.configure(port, 3);
+    harness.runUntil(2 * 60 * 1000, [] { return false; });
+    harness.report("silent");
+    check(harness.connection.getFailureCount() >= 2, "silent", "expected time-outs");
+    check(strcmp(harness.connection.getLastError(), "no CONNACK") == 0, "silent", "wrong error");
+    close(listener);
+}
+
+/**
+ * @brief Minimal broker: CONNACK with a chosen return code, PINGRESP, counts PUBLISH
+ */
+struct ConnectBroker : StandInBroker {
+    uint8_t returnCode = 0;
+    std::atomic<uint32_t> sessions{0};
+    std::atomic<uint32_t> publishes{0};
+    std::atomic<uint32_t> pings{0};
+    std::atomic<bool> badConnect{false};
+
+    void start(uint8_t code) {
+        returnCode = code;
+        StandInBroker::start();
+    }
+
+protected:
+    void session(int client) override {
+        std::vector<uint8_t> body;
+        uint8_t type;
+        if (!readPacket(client, type, body, 50) || type != 0x10 ||
+            body.size() < 10 || memcmp(body.data(), "\x00\x04MQTT\x04", 7) != 0) {
+            badConnect = true;
+            return;
+        }
+        sendConnack(client, returnCode);
+        sessions++;
+
+        while (running && returnCode == 0 && !dropClient) {
+            if (!readPacket(client, type, body, 50)) {
+                continue;
+            }
+            if ((type >> 4) == 3) {
+                publishes++;
+            } else if (type == 0xC0) {
+                pings++;
+                sendPingresp(client);
+            }
+        }
+    }
+};
+
+void runRejecting() {
+    ConnectBroker broker;
+    broker.start(5);
+
+    Harness harness;
+    harness.configure(broker.port, 4);
+    harness.runUntil(FAILING_RUN_MS, [] { return false; });
+    harness.report("rejecting");
+    check(broker.sessions >= 5, "rejecting", "broker saw too few CONNECTs");
+    check(!broker.badConnect, "rejecting", "malformed CONNECT");
+    check(strcmp(harness.connection.getLastError(), "not authorized") == 0, "rejecting", "wrong error");
+    broker.stop();
+}
+
+void runAccepting() {
+    ConnectBroker broker;
+    broker.start(0);
+
+    Harness harness;
+    harness.configure(broker.port, 5);
+    MqttConnection& connection = harness.connection;
+    check(harness.runUntil(MQTT_CONNECT_TIMEOUT, [&] { return connection.isConnected(); }),
+          "accepting", "no session");
+
+    static const char PAYLOAD[] = "{\"suppressed\":0}";
+    check(connection.publish("hearthguard/scout-test/aggregates", PAYLOAD, sizeof(PAYLOAD) - 1, false),
+          "accepting", "publish refused");
+    check(harness.runUntil(1000, [&] { return broker.publishes == 1; }), "accepting", "publish not delivered");
+
+    // Idle past a few keep-alive periods: pings must keep the session up
+    harness.runUntil(KEEPALIVE_SECONDS * 4000, [] { return false; });
+    check(connection.isConnected(), "accepting", "keep-alive lost the session");
+    check(broker.pings >= 3, "accepting", "no PINGREQ");
+
+    // Broker drops the session: reconnect after the minimum retry delay
+    broker.dropClient = true;
+    usleep(200000);     // The broker polls in real time
+    check(harness.runUntil(1000, [&] { return connection.wasDropped(); }), "accepting", "drop not seen");
+    check(connection.getFailureCount() == 0, "accepting", "a drop is not a failed attempt");
+    const uint32_t droppedAt = harness.now;
+    check(harness.runUntil(MQTT_RETRY_MAX, [&] { return connection.isConnected(); }),
+          "accepting", "no reconnect");
+    const uint32_t gap = harness.now - droppedAt;
+    const uint32_t spread = MQTT_RETRY_INTERVAL / 100 * MQTT_RETRY_JITTER;
+    check(gap >= MQTT_RETRY_INTERVAL - spread && gap <= MQTT_RETRY_INTERVAL + spread + 100,
+          "accepting", "reconnect outside the retry window");
+    check(broker.sessions == 2 && !broker.badConnect, "accepting", "unexpected sessions");
+
+    harness.report("accepting");
+    printf("           publishes %u  pings %u  reconnect after %u ms\n",
+           broker.publishes.load(), broker.pings.load(), gap);
+    broker.stop();
+}
+
+}
+
+int main(int argc, char** argv) {
+    if (argc > 1) {
+        maxServiceUs = static_cast<uint32_t>(strtoul(argv[1], nullptr, 10));
+    }
+
+    runRefused();
+    runNoAnswer();
+    runSilent();
+    runRejecting();
+    runAccepting();
+
+    printf("\nworst service() call %.1f us (limit %u us): %s\n",
+           worstServiceUs, maxServiceUs, allPassed ? "PASS" : "FAIL");
+    return allPassed ? 0 : 1;
+}
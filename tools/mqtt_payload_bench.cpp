@@ -0,0 +1,185 @@
+/**
+ * @file mqtt_payload_bench.cpp
+ * @brief Host tool: heap use and serialization time of MQTT payloads
+ *
+ * Serializes the aggregates payload MqttHandler publishes (three rolling
+ * windows with a distance histogram and battery statistics) and measures,
+ * per publish, the bytes allocated and the time taken:
+ *   - JsonWriter into a reused buffer, topics from MqttTopics (firmware)
+ *   - std::string topic concatenation, standing in for the old
+ *     Arduino String deviceTopic + suffix
+ *
+ * There is no ArduinoJson baseline: the library is not vendored, so the
+ * old serialization path cannot be built or measured here.
+ *
+ * Build and run from the repository root (see tools/Makefile):
+ *   make -C tools && tools/build/mqtt_payload_bench [iterations]
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <string>
+#include "utilities/JsonWriter.h"
+#include "utilities/MqttTopics.h"
+
+namespace {
+
+// Every operator new in the process is counted
+size_t allocationCount = 0;
+size_t allocatedBytes = 0;
+
+constexpr uint8_t WINDOW_COUNT = 3;
+constexpr uint8_t DISTANCE_BINS = 8;
+constexpr size_t PAYLOAD_SIZE = 1024;   // MQTT_PAYLOAD_SIZE
+
+struct Window {
+    uint16_t minutes;
+    uint32_t occupiedSeconds;
+    uint16_t motionCount;
+    uint16_t presenceCount;
+    uint16_t distanceHistogram[DISTANCE_BINS];
+    uint16_t batteryMinMv;
+    uint16_t batteryMeanMv;
+    uint16_t batteryMaxMv;
+};
+
+const char* const WINDOW_KEYS[WINDOW_COUNT] = { "1m", "15m", "1h" };
+
+void makeWindows(Window* windows, uint32_t seed) {
+    const uint16_t minutes[WINDOW_COUNT] = { 1, 15, 60 };
+    for (uint8_t w = 0; w < WINDOW_COUNT; w++) {
+        Window& window = windows[w];
+        window.minutes = minutes[w];
+        window.occupiedSeconds = (seed * 7 + w * 600) % (minutes[w] * 60 + 1);
+        window.motionCount = static_cast<uint16_t>((seed + w) % 50 * minutes[w]);
+        window.presenceCount = static_cast<uint16_t>((seed >> 2) % 5 * minutes[w]);
+        for (uint8_t bin = 0; bin < DISTANCE_BINS; bin++) {
+            window.distanceHistogram[bin] = static_cast<uint16_t>((seed * (bin + 3) + w) % 240 * minutes[w]);
+        }
+        window.batteryMinMv = static_cast<uint16_t>(3600 + seed % 40);
+        window.batteryMeanMv = static_cast<uint16_t>(window.batteryMinMv + 15);
+        window.batteryMaxMv = static_cast<uint16_t>(window.batteryMinMv + 32);
+    }
+}
+
+// Same document as MqttHandler::publishAggregates()
+size_t writeWithJsonWriter(const Window* windows, uint32_t suppressed, char* buffer, size_t size) {
+    JsonWriter json(buffer, size);
+    json.beginObject()
+        .addUint("suppressed", suppressed)
+        .addUint("queued", 0)
+        .addUint("dropped", 0);
+    for (uint8_t w = 0; w < WINDOW_COUNT; w++) {
+        const Window& window = windows[w];
+        json.beginObject(WINDOW_KEYS[w])
+            .addUint("minutes", window.minutes)
+            .addUint("occupied_s", window.occupiedSeconds)
+            .addUint("motion", window.motionCount)
+            .addUint("presence", window.presenceCount)
+            .beginArray("distance");
+        for (uint8_t bin = 0; bin < DISTANCE_BINS; bin++) {
+            json.addUint(nullptr, window.distanceHistogram[bin]);
+        }
+        json.endArray();
+        if (window.batteryMeanMv > 0) {
+            json.addFixed("battery_min_v", window.batteryMinMv, 3)
+                .addFixed("battery_avg_v", window.batteryMeanMv, 3)
+                .addFixed("battery_max_v", window.batteryMaxMv, 3);
+        }
+        json.endObject();
+    }
+    json.endObject();
+    return json.finish();
+}
+
+struct Result {
+    double nsPerPublish;
+    double allocationsPerPublish;
+    double bytesPerPublish;
+};
+
+template <typename Publish>
+Result measure(uint32_t iterations, Publish publish) {
+    const size_t countBefore = allocationCount;
+    const size_t bytesBefore = allocatedBytes;
+    const auto start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < iterations; i++) {
+        publish(i);
+    }
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+
+    Result result;
+    result.nsPerPublish = std::chrono::duration<double, std::nano>(elapsed).count() / iterations;
+    result.allocationsPerPublish = static_cast<double>(allocationCount - countBefore) / iterations;
+    result.bytesPerPublish = static_cast<double>(allocatedBytes - bytesBefore) / iterations;
+    return result;
+}
+
+void printResult(const char* name, const Result& result) {
+    printf("%-28s %9.1f ns  %6.2f allocs  %8.1f bytes per publish\n",
+           name, result.nsPerPublish, result.allocationsPerPublish, result.bytesPerPublish);
+}
+
+// Keeps the optimizer from discarding the output
+volatile size_t sink = 0;
+
+}
+
+void* operator new(size_t size) {
+    allocationCount++;
+    allocatedBytes += size;
+    if (void* pointer = malloc(size > 0 ? size : 1)) {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* pointer) noexcept {
+    free(pointer);
+}
+
+void operator delete(void* pointer, size_t) noexcept {
+    free(pointer);
+}
+
+int main(int argc, char** argv) {
+    const uint32_t iterations = argc > 1 ? static_cast<uint32_t>(strtoul(argv[1], nullptr, 10)) : 200000;
+    if (iterations == 0) {
+        fprintf(stderr, "usage: %s [iterations]\n", argv[0]);
+        return 1;
+    }
+
+    // Boot: topics and the payload buffer exist once, before any publish
+    static MqttTopics topics;
+    if (!topics.begin("hearthguard", "scout-1a2b3c")) {
+        fprintf(stderr, "topic prefix too long\n");
+        return 1;
+    }
+    static char payload[PAYLOAD_SIZE];
+
+    static Window windows[WINDOW_COUNT];
+    makeWindows(windows, 1);
+    const size_t length = writeWithJsonWriter(windows, 3, payload, sizeof(payload));
+    if (length == 0) {
+        fprintf(stderr, "payload does not fit %zu bytes\n", sizeof(payload));
+        return 1;
+    }
+    printf("%s (%zu bytes):\n%s\n\n", topics.get(MqttTopics::AGGREGATES), length, payload);
+
+    printResult("JsonWriter + MqttTopics", measure(iterations, [&](uint32_t i) {
+        windows[0].motionCount = static_cast<uint16_t>(i);
+        const char* topic = topics.get(MqttTopics::AGGREGATES);
+        sink += writeWithJsonWriter(windows, i, payload, sizeof(payload)) + topic[0];
+    }));
+
+    const std::string deviceTopic = std::string("hearthguard/") + topics.getDeviceId();
+    printResult("String topic concatenation", measure(iterations, [&](uint32_t i) {
+        const std::string topic = deviceTopic + "/aggregates";
+        sink += topic.size() + i;
+    }));
+
+    return 0;
+}
@@ -0,0 +1,318 @@
+/**
+ * @file mqtt_qos_bench.cpp
+ * @brief Host tool: QoS 1 throughput and ack latency of MqttConnection
+ *
+ * Publishes a stream of event-sized QoS 1 messages through the firmware's
+ * MqttConnection, keeping the in-flight window full, and reports sustained
+ * messages per second and PUBACK latency (p50/p99) for stop-and-wait
+ * (window 1) against the pipelined window (MQTT_INFLIGHT_WINDOW).
+ *
+ * By default it runs against a stand-in broker on localhost that answers
+ * each PUBLISH after a simulated round trip (--rtt-ms, repeated for
+ * several). It then checks retransmission: the broker drops the session
+ * with publishes unacknowledged, and they must come back after the
+ * reconnect, in order, with the same packet IDs and the DUP flag.
+ *
+ * With --host/--port it measures against a real broker instead (e.g. a
+ * local mosquitto); the retransmission check is skipped.
+ *
+ * Build and run from the repository root (see tools/Makefile):
+ *   make -C tools && tools/build/mqtt_qos_bench [--messages N] [--rtt-ms MS]... [--host IPV4 --port N]
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <mutex>
+#include "HostCheck.h"
+#include "StandInBroker.h"
+#include "network/MqttConnection.h"
+
+namespace {
+
+constexpr const char* TOPIC = "hearthguard/scout-bench/events";
+constexpr uint32_t RETRY_MS = 50;           // Short retries keep the drop check quick
+
+uint32_t nowMs() {
+    return static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+uint64_t nowUs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+/**
+ * @brief Broker stand-in: CONNACK, delayed PUBACK, PINGRESP
+ */
+struct AckingBroker : StandInBroker {
+    struct Received {
+        uint16_t packetId;
+        bool dup;
+    };
+
+    uint32_t rttMs = 0;
+    std::atomic<bool> acking{true};
+    std::atomic<uint32_t> sessions{0};
+    std::mutex lock;
+    std::vector<Received> received;         // QoS 1 publishes, guarded by lock
+
+    void start(uint32_t rtt) {
+        rttMs = rtt;
+        StandInBroker::start();
+    }
+
+protected:
+    // Parse whatever arrives, answering PUBLISH once its round trip is up
+    void session(int client) override {
+        struct Due {
+            uint64_t atUs;
+            uint16_t packetId;
+        };
+        std::vector<Due> acks;
+        std::vector<uint8_t> input;
+        uint8_t chunk[4096];
+        bool connected = false;
+
+        while (running && !dropClient) {
+            const uint64_t now = nowUs();
+            size_t sent = 0;
+            while (sent < acks.size() && acks[sent].atUs <= now) {
+                sendPuback(client, acks[sent].packetId);
+                sent++;
+            }
+            acks.erase(acks.begin(), acks.begin() + sent);
+
+            // Sleep until data or the next PUBACK is due (the host may have one core)
+            pollfd readable = {client, POLLIN, 0};
+            const uint64_t waitUs = acks.empty() ? 10000 : acks.front().atUs - now;
+            const timespec timeout = {0, static_cast<long>(waitUs * 1000)};
+            if (ppoll(&readable, 1, &timeout, nullptr) <= 0) {
+                continue;
+            }
+            const ssize_t count = recv(client, chunk, sizeof(chunk), 0);
+            if (count <= 0) {
+                break;
+            }
+            input.insert(input.end(), chunk, chunk + count);
+
+            // Complete packets only; the rest waits for more bytes
+            size_t offset = 0;
+            Packet packet;
+            while (nextPacket(input, offset, packet)) {
+                const uint8_t type = packet.type;
+                if (type == 0x10 && !connected) {
+                    sendConnack(client, 0);
+                    connected = true;
+                    sessions++;
+                } else if ((type >> 4) == 3 && ((type >> 1) & 0x03) == 1) {
+                    const uint16_t packetId = publishPacketId(packet.body);
+                    {
+                        std::lock_guard<std::mutex> guard(lock);
+                        received.push_back({packetId, (type & 0x08) != 0});
+                    }
+                    if (acking) {
+                        acks.push_back({nowUs() + rttMs * 1000ULL, packetId});
+                    }
+                } else if (type == 0xC0) {
+                    sendPingresp(client);
+                }
+            }
+            input.erase(input.begin(), input.begin() + offset);
+        }
+    }
+};
+
+/**
+ * @brief Publisher: keeps the window full and times every PUBACK
+ */
+struct Publisher {
+    MqttConnection connection;
+    std::vector<uint64_t> sentAtUs = std::vector<uint64_t>(65536, 0);
+    std::vector<uint32_t> latenciesUs;
+
+    static void onAck(void* context, uint16_t packetId) {
+        Publisher* publisher = static_cast<Publisher*>(context);
+        publisher->latenciesUs.push_back(static_cast<uint32_t>(nowUs() - publisher->sentAtUs[packetId]));
+    }
+
+    bool connect(const char* host, uint16_t port, uint8_t window) {
+        MqttConnection::Config config = {};
+        config.host = host;
+        config.port = port;
+        config.clientId = "scout-bench";
+        config.keepAliveSeconds = MQTT_KEEPALIVE;
+        config.connectTimeoutMs = MQTT_CONNECT_TIMEOUT;
+        config.retryMinMs = RETRY_MS;
+        config.retryMaxMs = RETRY_MS;
+        config.seed = 1;
+        config.inflightWindow = window;
+        if (!connection.begin(config)) {
+            fprintf(stderr, "configuration rejected\n");
+            exit(1);
+        }
+        connection.setAckHandler(&Publisher::onAck, this);
+        connection.start(nowMs());
+        return serviceUntil(MQTT_CONNECT_TIMEOUT, [this] { return connection.isConnected(); });
+    }
+
+    template <typename Predicate>
+    bool serviceUntil(uint32_t limitMs, Predicate done) {
+        const uint32_t end = nowMs() + limitMs;
+        while (static_cast<int32_t>(nowMs() - end) < 0) {
+            connection.service(nowMs());
+            if (done()) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool publishOne(uint32_t sequence) {
+        const uint64_t start = nowUs();
+        char payload[96];
+        const int length = snprintf(payload, sizeof(payload),
+                                    "{\"seq\":%u,\"event\":\"presence\",\"state\":\"%s\",\"ts_ms\":%u}",
+                                    sequence, sequence % 2 ? "ON" : "OFF", nowMs());
+        if (!connection.publish(TOPIC, payload, length, false, 1)) {
+            return false;
+        }
+        sentAtUs[connection.getLastPacketId()] = start;
+        return true;
+    }
+
+    // Keep the window full until `messages` are acknowledged; msgs/s
+    double run(uint32_t messages) {
+        uint32_t published = 0;
+        const uint64_t start = nowUs();
+        while (connection.getAckedCount() < messages) {
+            connection.service(nowMs());
+            if (!connection.isConnected()) {
+                return 0;
+            }
+            bool idle = true;
+            while (published < messages && publishOne(published)) {
+                published++;
+                idle = false;
+            }
+            if (idle) {
+                usleep(10);     // Window full: let the broker run
+            }
+        }
+        return messages * 1e6 / static_cast<double>(nowUs() - start);
+    }
+
+    uint32_t percentile(double fraction) {
+        std::sort(latenciesUs.begin(), latenciesUs.end());
+        return latenciesUs.empty() ? 0 : latenciesUs[static_cast<size_t>(fraction * (latenciesUs.size() - 1))];
+    }
+};
+
+void bench(const char* host, uint16_t port, uint32_t rttMs, uint32_t messages) {
+    double rates[2] = {};
+    const uint8_t windows[2] = {1, MQTT_INFLIGHT_WINDOW};
+
+    for (uint8_t i = 0; i < 2; i++) {
+        AckingBroker broker;
+        if (host == nullptr) {
+            broker.start(rttMs);
+        }
+        Publisher publisher;
+        if (!publisher.connect(host != nullptr ? host : "127.0.0.1", host != nullptr ? port : broker.port,
+                               windows[i])) {
+            printf("  no session\n");
+            allPassed = false;
+        } else {
+            rates[i] = publisher.run(messages);
+            check(rates[i] > 0, "bench", "session lost during the run");
+            check(publisher.latenciesUs.size() == messages, "bench", "acknowledgements missing");
+            printf("%-6s rtt %3u ms  window %u  %8.0f msg/s  ack p50 %7u us  p99 %7u us\n",
+                   host != nullptr ? "broker" : "stand", rttMs, windows[i], rates[i],
+                   publisher.percentile(0.50), publisher.percentile(0.99));
+        }
+        publisher.connection.stop();
+        if (host == nullptr) {
+            broker.stop();
+        }
+    }
+    if (rates[0] > 0) {
+        printf("                               pipelined / stop-and-wait: %.1fx\n", rates[1] / rates[0]);
+    }
+}
+
+void checkRetransmission() {
+    AckingBroker broker;
+    broker.start(0);
+    Publisher publisher;
+    MqttConnection& connection = publisher.connection;
+    check(publisher.connect("127.0.0.1", broker.port, MQTT_INFLIGHT_WINDOW), "retransmit", "no session");
+
+    // Fill the window with the broker not acknowledging
+    broker.acking = false;
+    uint16_t ids[MQTT_INFLIGHT_WINDOW];
+    for (uint8_t i = 0; i < MQTT_INFLIGHT_WINDOW; i++) {
+        check(publisher.publishOne(i), "retransmit", "publish refused");
+        ids[i] = connection.getLastPacketId();
+    }
+    check(!publisher.publishOne(MQTT_INFLIGHT_WINDOW), "retransmit", "publish beyond the window accepted");
+    publisher.serviceUntil(100, [] { return false; });
+
+    // Drop the session; the next one must see the same publishes again
+    broker.acking = true;
+    broker.dropClient = true;
+    check(publisher.serviceUntil(2000, [&] { return connection.wasDropped(); }), "retransmit", "drop not seen");
+    check(publisher.serviceUntil(2000, [&] { return connection.isConnected(); }), "retransmit", "no reconnect");
+    check(publisher.serviceUntil(1000, [&] { return connection.getInFlightCount() == 0; }),
+          "retransmit", "publishes not acknowledged after the reconnect");
+
+    std::lock_guard<std::mutex> guard(broker.lock);
+    check(broker.received.size() == 2 * MQTT_INFLIGHT_WINDOW, "retransmit", "wrong publish count");
+    for (uint8_t i = 0; i < MQTT_INFLIGHT_WINDOW && MQTT_INFLIGHT_WINDOW + i < static_cast<int>(broker.received.size()); i++) {
+        const AckingBroker::Received& again = broker.received[MQTT_INFLIGHT_WINDOW + i];
+        check(again.packetId == ids[i] && again.dup, "retransmit", "wrong order, ID or DUP flag");
+    }
+    printf("\nretransmit: %u unacknowledged, %u resent after reconnect, %u acknowledged, sessions %u\n",
+           MQTT_INFLIGHT_WINDOW, connection.getRetransmitCount(), connection.getAckedCount(),
+           broker.sessions.load());
+
+    connection.stop();
+    broker.stop();
+}
+
+}
+
+int main(int argc, char** argv) {
+    uint32_t messages = 5000;
+    const char* host = nullptr;
+    uint16_t port = 1883;
+    std::vector<uint32_t> rtts;
+
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (strcmp(argv[i], "--messages") == 0) {
+            messages = static_cast<uint32_t>(strtoul(argv[i + 1], nullptr, 10));
+        } else if (strcmp(argv[i], "--rtt-ms") == 0) {
+            rtts.push_back(static_cast<uint32_t>(strtoul(argv[i + 1], nullptr, 10)));
+        } else if (strcmp(argv[i], "--host") == 0) {
+            host = argv[i + 1];
+        } else if (strcmp(argv[i], "--port") == 0) {
+            port = static_cast<uint16_t>(strtoul(argv[i + 1], nullptr, 10));
+        }
+    }
+    if (host != nullptr) {
+        rtts.assign(1, 0);
+    } else if (rtts.empty()) {
+        rtts = {0, 2, 10};
+    }
+
+    for (uint32_t rtt : rtts) {
+        // Long round trips are slow at window 1; scale the run down
+        bench(host, port, rtt, rtt > 0 ? std::min<uint32_t>(messages, 20000 / rtt) : messages);
+    }
+    if (host == nullptr) {
+        checkRetransmission();
+    }
+
+    printf("\n%s\n", allPassed ? "PASS" : "FAIL");
+    return allPassed ? 0 : 1;
+}
@@ -0,0 +1,262 @@
+/**
+ * @file pir_debounce_check.cpp
+ * @brief Host tool: PIR edge capture and 200 ms debounce on scripted edge trains
+ *
+ * Links the firmware's PirSensor against a scripted GPIO pin and clock
+ * (tools/host). Each scenario drives the pin through an edge train; every
+ * edge calls the real edge ISR, which pushes into the SPSC queue, and the
+ * "sensor task" runs update() whenever the ISR notified it or
+ * getNextDeadline() came due, exactly as SensorManager does. Checks:
+ *   - clean:    well separated edges are accepted at the ISR timestamp
+ *   - bounce:   contact bounce on both edges gives one rise and one fall
+ *   - glitch:   a spike shorter than the window is held for one window,
+ *               then the settled level wins
+ *   - settle:   a real change inside the window lands when it closes
+ *   - overflow: more edges than queue slots resynchronize to the pin
+ *   - wrap:     a train across the 32-bit microsecond wrap still debounces
+ * plus detection counts and that update() never runs without cause.
+ *
+ * Build and run from the repository root (see tools/Makefile):
+ *   make -C tools && tools/build/pir_debounce_check
+ */
+
+#include <cstdio>
+#include <vector>
+#include <driver/gpio.h>
+#include "HostCheck.h"
+#include "sensors/PirSensor.h"
+#include "utilities/Logger.h"
+
+namespace {
+
+int64_t nowUs = 0;
+int pinLevel = 0;
+gpio_isr_t isrHandler = nullptr;
+void* isrArg = nullptr;
+uint32_t notifications = 0;
+
+}
+
+int64_t esp_timer_get_time() {
+    return nowUs;
+}
+
+unsigned long millis() {
+    return static_cast<unsigned long>(nowUs / 1000);
+}
+
+void pinMode(uint8_t, uint8_t) {}
+
+int digitalRead(uint8_t) {
+    return pinLevel;
+}
+
+esp_err_t gpio_install_isr_service(int) {
+    return ESP_OK;
+}
+
+esp_err_t gpio_isr_handler_add(gpio_num_t, gpio_isr_t handler, void* arg) {
+    isrHandler = handler;
+    isrArg = arg;
+    return ESP_OK;
+}
+
+esp_err_t gpio_wakeup_enable(gpio_num_t, gpio_int_type_t) {
+    return ESP_OK;
+}
+
+esp_err_t gpio_intr_enable(gpio_num_t) {
+    return ESP_OK;
+}
+
+int gpio_get_level(gpio_num_t) {
+    return pinLevel;
+}
+
+void Scheduler::notifyFromIsr() {
+    notifications++;
+}
+
+bool Logger::write(uint8_t, const char*, const uintptr_t*, uint8_t) {
+    return true;
+}
+
+namespace {
+
+constexpr int64_t MS = 1000;
+
+struct Edge {
+    int64_t timeUs;
+    int level;
+};
+
+struct Transition {
+    int64_t timeMs;
+    bool level;
+
+    bool operator==(const Transition& other) const { return timeMs == other.timeMs && level == other.level; }
+};
+
+struct Result {
+    std::vector<Transition> transitions;
+    uint32_t updates = 0;
+    uint32_t detections = 0;
+};
+
+/**
+ * @brief Play an edge train into a fresh sensor and run it like the sensor task
+ * @param startUs Clock value the scenario starts at
+ * @param edges Pin changes, absolute times
+ * @param endUs When to stop
+ * @param updateEveryEdge false to let edges pile up until endUs (overflow)
+ */
+Result play(int64_t startUs, const std::vector<Edge>& edges, int64_t endUs, bool updateEveryEdge = true) {
+    nowUs = startUs;
+    pinLevel = 0;
+    notifications = 0;
+
+    PirSensor sensor;
+    sensor.begin();
+    Scheduler scheduler;
+    sensor.enableInterrupt(scheduler);
+
+    Result result;
+    bool state = sensor.isMotionDetected();
+    uint32_t handledNotifications = 0;
+    size_t next = 0;
+
+    const auto runTask = [&]() {
+        sensor.update();
+        result.updates++;
+        if (sensor.isMotionDetected() != state) {
+            state = sensor.isMotionDetected();
+            // Report the time the sensor says the change happened
+            result.transitions.push_back({static_cast<int64_t>(sensor.getLastEdgeMicros()) / MS, state});
+        }
+    };
+
+    while (nowUs < endUs) {
+        // Next thing to happen: an edge, or the deadline the task asked for
+        int64_t wakeUs = endUs;
+        unsigned long deadlineMs;
+        if (sensor.getNextDeadline(deadlineMs) && updateEveryEdge) {
+            wakeUs = static_cast<int64_t>(deadlineMs) * MS;
+        }
+        if (next < edges.size() && edges[next].timeUs < wakeUs) {
+            wakeUs = edges[next].timeUs;
+        }
+        nowUs = wakeUs > nowUs ? wakeUs : nowUs;
+
+        while (next < edges.size() && edges[next].timeUs <= nowUs) {
+            pinLevel = edges[next++].level;
+            isrHandler(isrArg);
+        }
+
+        const bool notified = notifications != handledNotifications;
+        handledNotifications = notifications;
+        if ((notified && updateEveryEdge) || (sensor.getNextDeadline(deadlineMs) && updateEveryEdge &&
+                                              static_cast<int64_t>(deadlineMs) * MS <= nowUs)) {
+            runTask();
+        } else if (nowUs >= endUs) {
+            break;
+        }
+    }
+
+    nowUs = endUs;
+    runTask();
+    unsigned long deadlineMs;
+    while (sensor.getNextDeadline(deadlineMs)) {
+        nowUs = static_cast<int64_t>(deadlineMs) * MS > nowUs ? static_cast<int64_t>(deadlineMs) * MS : nowUs + MS;
+        runTask();
+    }
+    result.detections = sensor.getData().detectionCount;
+    return result;
+}
+
+// Contact bounce: `count` toggles 0.3-1.5 ms apart, ending on `level`
+void bounce(std::vector<Edge>& edges, int64_t atUs, int level, int count) {
+    int64_t t = atUs;
+    for (int i = 0; i < count; i++) {
+        const int current = ((count - 1 - i) % 2 == 0) ? level : !level;
+        edges.push_back({t, current});
+        t += 300 + (i * 379) % 1200;
+    }
+}
+
+void report(const char* name, const Result& result, const std::vector<Transition>& expected, uint32_t detections) {
+    printf("%-10s", name);
+    for (const Transition& transition : result.transitions) {
+        printf(" %s@%lld", transition.level ? "ON" : "off", static_cast<long long>(transition.timeMs));
+    }
+    printf("  (%u update(s), %u detection(s))\n", result.updates, result.detections);
+    check(result.transitions == expected, name, "debounced transitions differ");
+    check(result.detections == detections, name, "wrong detection count");
+}
+
+void runClean() {
+    const int64_t base = 10000 * MS;
+    const Result result = play(base, {{base + 1000 * MS, 1}, {base + 4000 * MS, 0}, {base + 4500 * MS, 1},
+                                      {base + 9000 * MS, 0}}, base + 12000 * MS);
+    report("clean", result, {{11000, true}, {14000, false}, {14500, true}, {19000, false}}, 2);
+    check(result.updates <= 4 + 1, "clean", "update() ran without an edge or deadline");
+}
+
+void runBounce() {
+    const int64_t base = 20000 * MS;
+    std::vector<Edge> edges;
+    bounce(edges, base + 1000 * MS, 1, 9);
+    bounce(edges, base + 3000 * MS, 0, 7);
+    const Result result = play(base, edges, base + 5000 * MS);
+    report("bounce", result, {{21000, true}, {23000, false}}, 1);
+}
+
+void runGlitch() {
+    const int64_t base = 30000 * MS;
+    const Result result = play(base, {{base + 1000 * MS, 1}, {base + 1005 * MS, 0}}, base + 3000 * MS);
+    report("glitch", result, {{31000, true}, {31200, false}}, 1);
+}
+
+void runSettle() {
+    const int64_t base = 40000 * MS;
+    std::vector<Edge> edges = {{base + 1000 * MS, 1}, {base + 1120 * MS, 0}};
+    bounce(edges, base + 1150 * MS, 1, 5);      // Back on, still inside the window: stays on
+    edges.push_back({base + 2000 * MS, 0});
+    edges.push_back({base + 2100 * MS, 1});     // Off then on within the window: ends on
+    edges.push_back({base + 2150 * MS, 0});     // ...and off again before it closes
+    const Result result = play(base, edges, base + 4000 * MS);
+    report("settle", result, {{41000, true}, {42000, false}}, 1);
+}
+
+void runOverflow() {
+    const int64_t base = 50000 * MS;
+    std::vector<Edge> edges;
+    bounce(edges, base + 1000 * MS, 0, 40);     // More edges than EDGE_QUEUE_SIZE, no task in between
+    const Result result = play(base, edges, base + 2000 * MS, false);
+    // One update() takes the queued rise (a detection) and then resyncs to the
+    // low pin, so the task sees motion end where it started: off
+    report("overflow", result, {}, 1);
+}
+
+void runWrap() {
+    const int64_t wrap = int64_t(1) << 32;
+    const int64_t base = wrap - 1100 * MS;
+    std::vector<Edge> edges;
+    bounce(edges, wrap - 100 * MS, 1, 5);
+    bounce(edges, wrap - 50 * MS, 0, 3);        // Fall inside the window, which closes after the wrap
+    const Result result = play(base, edges, wrap + 2000 * MS);
+    // getLastEdgeMicros() is the low 32 bits, so the settled fall lands just past 0
+    report("wrap", result, {{(wrap - 100 * MS) / MS, true}, {100, false}}, 1);
+}
+
+}
+
+int main() {
+    runClean();
+    runBounce();
+    runGlitch();
+    runSettle();
+    runOverflow();
+    runWrap();
+    printf("\n%s\n", allPassed ? "PASS" : "FAIL");
+    return allPassed ? 0 : 1;
+}
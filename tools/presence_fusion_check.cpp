@@ -0,0 +1,379 @@
+/**
+ * @file presence_fusion_check.cpp
+ * @brief Host tool: PresenceFusion against the presence rule, cell by cell
+ *
+ * Drives the firmware's PresenceFusion only through its public inputs
+ * (setPir, setRadar, advance) on synthetic timelines. For each of the
+ * eight fusion states a timeline reaches the state, then each of the five
+ * inputs is applied and the result compared with the rule from
+ * PresenceFusion.h:
+ *   - the state reached (told apart by presence, PIR/radar levels, the
+ *     running timer and, for COOLDOWN vs HOLD_GRACE, a radar probe on a
+ *     copy)
+ *   - the timer deadline: restarted, kept or stopped
+ *   - the reported transitions and their timestamps
+ * Cells an input cannot reach through the API (a repeated radar level is
+ * filtered, TIMEOUT needs a running timer) are checked to change nothing.
+ * Further timelines: a timeout due before the next input, zero-length
+ * timers, energy thresholds, radar alone, and the millis() wrap.
+ *
+ * Build and run from the repository root (see tools/Makefile):
+ *   make -C tools && tools/build/presence_fusion_check
+ */
+
+#include <cstdio>
+#include <vector>
+#include "HostCheck.h"
+#include "sensors/PresenceFusion.h"
+
+namespace {
+
+constexpr uint32_t COOLDOWN_MS = 10000;
+constexpr uint32_t HOLD_MS = 3000;
+constexpr uint16_t ENERGY_MIN = 20;
+constexpr PresenceConfig CONFIG = { COOLDOWN_MS, HOLD_MS, ENERGY_MIN, ENERGY_MIN };
+
+enum State {
+    IDLE,
+    IDLE_RADAR,
+    TRIGGERED,
+    TRIGGERED_RADAR,
+    COOLDOWN,
+    COOLDOWN_RADAR,
+    HELD,
+    HOLD_GRACE,
+    STATE_COUNT,
+    UNKNOWN = STATE_COUNT
+};
+
+enum Input {
+    PIR_ON,
+    PIR_OFF,
+    RADAR_ON,
+    RADAR_OFF,
+    TIMEOUT,
+    INPUT_COUNT
+};
+
+const char* const STATE_NAMES[] = {
+    "IDLE", "IDLE_RADAR", "TRIGGERED", "TRIGGERED_RADAR", "COOLDOWN", "COOLDOWN_RADAR", "HELD", "HOLD_GRACE", "?"
+};
+const char* const INPUT_NAMES[] = { "PIR_ON", "PIR_OFF", "RADAR_ON", "RADAR_OFF", "TIMEOUT" };
+
+// The rule, written out per cell. `filtered` cells cannot be produced
+// through the API; the fusion must stay where it is.
+struct Expected {
+    State next;
+    bool filtered;
+};
+
+const Expected RULE[STATE_COUNT][INPUT_COUNT] = {
+    // PIR_ON                     PIR_OFF                    RADAR_ON                    RADAR_OFF                TIMEOUT
+    { { TRIGGERED, false },       { IDLE, false },           { IDLE_RADAR, false },      { IDLE, true },          { IDLE, true } },
+    { { TRIGGERED_RADAR, false }, { IDLE_RADAR, false },     { IDLE_RADAR, true },       { IDLE, false },         { IDLE_RADAR, true } },
+    { { TRIGGERED, false },       { COOLDOWN, false },       { TRIGGERED_RADAR, false }, { TRIGGERED, true },     { TRIGGERED, true } },
+    { { TRIGGERED_RADAR, false }, { COOLDOWN_RADAR, false }, { TRIGGERED_RADAR, true },  { TRIGGERED, false },    { TRIGGERED_RADAR, true } },
+    { { TRIGGERED, false },       { COOLDOWN, false },       { COOLDOWN_RADAR, false },  { COOLDOWN, true },      { IDLE, false } },
+    { { TRIGGERED_RADAR, false }, { COOLDOWN_RADAR, false }, { COOLDOWN_RADAR, true },   { COOLDOWN, false },     { HELD, false } },
+    { { TRIGGERED_RADAR, false }, { HELD, false },           { HELD, true },             { HOLD_GRACE, false },   { HELD, true } },
+    { { TRIGGERED, false },       { HOLD_GRACE, false },     { HELD, false },            { HOLD_GRACE, true },    { IDLE, false } },
+};
+
+bool isPresentState(State state) {
+    return state != IDLE && state != IDLE_RADAR;
+}
+
+bool hasTimer(State state) {
+    return state == COOLDOWN || state == COOLDOWN_RADAR || state == HOLD_GRACE;
+}
+
+struct Event {
+    bool present;
+    uint32_t timestamp;
+};
+
+void onTransition(void* context, bool present, uint32_t timestamp) {
+    static_cast<std::vector<Event>*>(context)->push_back({present, timestamp});
+}
+
+/**
+ * @brief A fusion instance plus the input levels the timeline has fed it
+ */
+struct Timeline {
+    PresenceFusion fusion{CONFIG};
+    std::vector<Event> events;
+    bool pir = false;
+    bool radar = false;
+    uint32_t now;
+
+    explicit Timeline(uint32_t start) : now(start) {
+        fusion.setTransitionListener(&onTransition, &events);
+    }
+
+    // The listener points at `events`
+    Timeline(const Timeline&) = delete;
+    Timeline& operator=(const Timeline&) = delete;
+
+    void setPir(bool motion, uint32_t step = 100) {
+        now += step;
+        pir = motion;
+        fusion.setPir(motion, now);
+    }
+
+    void setRadar(bool target, uint32_t step = 100, uint16_t energy = 80) {
+        now += step;
+        radar = target && energy >= ENERGY_MIN;
+        fusion.setRadar(target, energy, false, 0, now);
+    }
+
+    // Run the pending timer out, as SensorManager does at getDeadline()
+    void expire() {
+        uint32_t deadline;
+        if (fusion.getDeadline(deadline)) {
+            now = deadline;
+            fusion.advance(now);
+        } else {
+            now += 100000;
+            fusion.advance(now);
+        }
+    }
+
+    void apply(Input input) {
+        switch (input) {
+            case PIR_ON:    setPir(true); break;
+            case PIR_OFF:   setPir(false); break;
+            case RADAR_ON:  setRadar(true); break;
+            case RADAR_OFF: setRadar(false); break;
+            case TIMEOUT:   expire(); break;
+            default:        break;
+        }
+    }
+
+    /**
+     * @brief Tell the fusion state from what is observable
+     */
+    State identify() const {
+        uint32_t deadline;
+        const bool timer = fusion.getDeadline(deadline);
+        if (!fusion.isPresent()) {
+            return timer ? UNKNOWN : (radar ? IDLE_RADAR : IDLE);
+        }
+        if (pir) {
+            return timer ? UNKNOWN : (radar ? TRIGGERED_RADAR : TRIGGERED);
+        }
+        if (radar) {
+            return timer ? COOLDOWN_RADAR : HELD;
+        }
+        if (!timer) {
+            return UNKNOWN;
+        }
+
+        // COOLDOWN keeps its timer when the radar comes back, HOLD_GRACE stops it
+        PresenceFusion probe = fusion;
+        probe.setTransitionListener(nullptr, nullptr);
+        probe.setRadar(true, 100, false, 0, now);
+        uint32_t probeDeadline;
+        return probe.getDeadline(probeDeadline) ? COOLDOWN : HOLD_GRACE;
+    }
+};
+
+// Inputs that take a fresh fusion to `state`
+void reach(Timeline& timeline, State state) {
+    switch (state) {
+        case IDLE:
+            break;
+        case IDLE_RADAR:
+            timeline.setRadar(true);
+            break;
+        case TRIGGERED:
+            timeline.setPir(true);
+            break;
+        case TRIGGERED_RADAR:
+            timeline.setPir(true);
+            timeline.setRadar(true);
+            break;
+        case COOLDOWN:
+            timeline.setPir(true);
+            timeline.setPir(false);
+            break;
+        case COOLDOWN_RADAR:
+            timeline.setPir(true);
+            timeline.setRadar(true);
+            timeline.setPir(false);
+            break;
+        case HELD:
+            timeline.setPir(true);
+            timeline.setRadar(true);
+            timeline.setPir(false);
+            timeline.expire();
+            break;
+        case HOLD_GRACE:
+            timeline.setPir(true);
+            timeline.setRadar(true);
+            timeline.setPir(false);
+            timeline.expire();
+            timeline.setRadar(false);
+            break;
+        default:
+            break;
+    }
+}
+
+void runTable() {
+    printf("%-16s", "state \\ input");
+    for (int input = 0; input < INPUT_COUNT; input++) {
+        printf(" %-16s", INPUT_NAMES[input]);
+    }
+    printf("\n");
+
+    uint32_t cells = 0;
+    uint32_t failures = 0;
+    for (int s = 0; s < STATE_COUNT; s++) {
+        const State state = static_cast<State>(s);
+        printf("%-16s", STATE_NAMES[state]);
+
+        for (int i = 0; i < INPUT_COUNT; i++) {
+            const Input input = static_cast<Input>(i);
+            const Expected& expected = RULE[state][input];
+            Timeline timeline(1000);
+            reach(timeline, state);
+            bool good = timeline.identify() == state;
+
+            uint32_t before;
+            const bool timerBefore = timeline.fusion.getDeadline(before);
+            const size_t eventsBefore = timeline.events.size();
+
+            timeline.apply(input);
+            const uint32_t at = timeline.now;
+            const State reached = timeline.identify();
+            good = good && reached == expected.next;
+
+            // Timer: a running one keeps its deadline, a new one starts at the input
+            uint32_t after;
+            const bool timerAfter = timeline.fusion.getDeadline(after);
+            good = good && timerAfter == hasTimer(expected.next);
+            if (timerAfter && timerBefore && hasTimer(state)) {
+                good = good && after == before;
+            } else if (timerAfter) {
+                good = good && after == at + (expected.next == HOLD_GRACE ? HOLD_MS : COOLDOWN_MS);
+            }
+
+            // Exactly one report, at the input time, when presence flips
+            const size_t newEvents = timeline.events.size() - eventsBefore;
+            if (isPresentState(state) != isPresentState(expected.next)) {
+                good = good && newEvents == 1 && timeline.events.back().present == isPresentState(expected.next) &&
+                       timeline.events.back().timestamp == at;
+            } else {
+                good = good && newEvents == 0;
+            }
+
+            char cell[24];
+            snprintf(cell, sizeof(cell), "%s%s", good ? "" : "!", expected.filtered ? "(same)" : STATE_NAMES[reached]);
+            printf(" %-16s", cell);
+            cells++;
+            failures += good ? 0 : 1;
+        }
+        printf("\n");
+    }
+
+    check(failures == 0, "table", "cells marked ! differ from the rule");
+    printf("table      %u cells, %u bad\n", cells, failures);
+}
+
+// A timeout that fell due before the next input is applied at its deadline
+void runLateInput() {
+    Timeline timeline(5000);
+    timeline.setPir(true);
+    timeline.setPir(false);
+    const uint32_t deadline = timeline.now + COOLDOWN_MS;
+    timeline.setRadar(true, COOLDOWN_MS + 500);
+    const bool ordered = timeline.events.size() == 2 && !timeline.events[1].present &&
+                         timeline.events[1].timestamp == deadline;
+    check(ordered && timeline.identify() == IDLE_RADAR, "late",
+          "radar after the cooldown must not revive presence; off at the deadline");
+    printf("late       presence off at %u (deadline), radar alone then ignored\n",
+           timeline.events.empty() ? 0 : timeline.events.back().timestamp);
+}
+
+void runZeroTimers() {
+    Timeline timeline(1000);
+    timeline.fusion.setConfig({ 0, 0, ENERGY_MIN, ENERGY_MIN });
+    timeline.setPir(true);
+    timeline.setPir(false);
+    const bool cooldownImmediate = !timeline.fusion.isPresent() && timeline.events.size() == 2 &&
+                                   timeline.events[1].timestamp == timeline.now;
+
+    timeline.setRadar(true);
+    timeline.setPir(true);
+    timeline.setPir(false);        // Held by the radar at once
+    const bool held = timeline.fusion.isPresent() && timeline.identify() == HELD;
+    timeline.setRadar(false);      // Zero hold: gone at once
+    const bool holdImmediate = !timeline.fusion.isPresent();
+
+    check(cooldownImmediate && held && holdImmediate, "zero", "zero-length timers must expire on the spot");
+    printf("zero       cooldown 0 / hold 0 expire at the input\n");
+}
+
+void runThresholds() {
+    Timeline timeline(1000);
+    timeline.setPir(true);
+    timeline.setRadar(true, 100, ENERGY_MIN - 1);   // Below the minimum: no target
+    timeline.setPir(false);
+    const bool weakIgnored = timeline.identify() == COOLDOWN;
+
+    timeline.setRadar(true, 100, ENERGY_MIN);       // At the minimum: target
+    const bool strongCounts = timeline.identify() == COOLDOWN_RADAR;
+    timeline.expire();
+
+    // Stationary target alone also holds
+    Timeline stationary(1000);
+    stationary.setPir(true);
+    stationary.now += 100;
+    stationary.radar = true;
+    stationary.fusion.setRadar(false, 0, true, ENERGY_MIN, stationary.now);
+    stationary.setPir(false);
+    stationary.expire();
+
+    check(weakIgnored && strongCounts && timeline.identify() == HELD && stationary.identify() == HELD,
+          "threshold", "energy threshold or stationary target handled wrongly");
+    printf("threshold  energy %u ignored, %u counts, stationary target holds\n", ENERGY_MIN - 1, ENERGY_MIN);
+}
+
+void runRadarAlone() {
+    Timeline timeline(1000);
+    for (int i = 0; i < 20; i++) {
+        timeline.setRadar(i % 2 == 0, 700);
+        timeline.expire();
+    }
+    check(timeline.events.empty(), "radar", "radar alone triggered presence");
+    printf("radar      20 radar changes without PIR, %zu transition(s)\n", timeline.events.size());
+}
+
+void runWrap() {
+    // Cooldown deadline lands past the millis() wrap
+    Timeline timeline(0xFFFFFFFFu - 5000);
+    timeline.setPir(true);
+    timeline.setPir(false);
+    uint32_t deadline;
+    const bool running = timeline.fusion.getDeadline(deadline);
+    timeline.fusion.advance(0xFFFFFFFFu);           // Before the deadline: still present
+    const bool early = timeline.fusion.isPresent();
+    timeline.now = deadline;
+    timeline.fusion.advance(deadline);
+    check(running && deadline < 10000 && early && !timeline.fusion.isPresent() &&
+          timeline.events.back().timestamp == deadline, "wrap", "cooldown across the wrap");
+    printf("wrap       cooldown from %u ends at %u\n", 0xFFFFFFFFu - 4800, deadline);
+}
+
+}
+
+int main() {
+    runTable();
+    runLateInput();
+    runZeroTimers();
+    runThresholds();
+    runRadarAlone();
+    runWrap();
+    printf("\n%s\n", allPassed ? "PASS" : "FAIL");
+    return allPassed ? 0 : 1;
+}
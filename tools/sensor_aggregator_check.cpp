@@ -0,0 +1,339 @@
+/**
+ * @file sensor_aggregator_check.cpp
+ * @brief Host tool: rolling sensor aggregates against a brute-force recomputation
+ *
+ * Drives the firmware's SensorAggregator with a random but repeatable
+ * timeline of presence changes (some repeated), PIR motion, radar
+ * distances and battery readings, calling advance() at getDeadline() as
+ * the sensor task does. After every closed minute each window (1, 15,
+ * 60 min) is compared with a recomputation from the full event list:
+ * minutes covered, occupied seconds, motion and presence counts, the
+ * distance histogram and battery min/mean/max. The timeline starts 30
+ * minutes before the millis() wrap, and contains idle gaps of up to 5 h
+ * (light sleep) during which advance() is not called. Radar reports are
+ * sometimes offered again with the same frame number, as repeated polls
+ * do, and must only count once.
+ * Targeted scenarios follow:
+ *   - split:   one presence interval across three minutes
+ *   - warmup:  windows report fewer minutes until they have filled
+ *   - gap:     a gap longer than the ring, present throughout
+ *   - polls:   one radar report polled many times is one distance sample
+ *
+ * Build and run from the repository root (see tools/Makefile):
+ *   make -C tools && tools/build/sensor_aggregator_check [events]
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include "HostCheck.h"
+#include "sensors/SensorAggregator.h"
+
+namespace {
+
+constexpr uint64_t MINUTE = SensorAggregator::BUCKET_MS;
+
+enum class Kind { PRESENCE, MOTION, RADAR, BATTERY };
+
+struct Event {
+    uint64_t time;          // Absolute ms, never wraps
+    Kind kind;
+    uint16_t value;         // Presence 0/1, distance (cm) or millivolts
+};
+
+uint32_t rngState = 2463534242u;
+
+uint32_t nextRandom() {
+    rngState ^= rngState << 13;
+    rngState ^= rngState >> 17;
+    rngState ^= rngState << 5;
+    return rngState;
+}
+
+/**
+ * @brief Recompute one window from the event list
+ * @param start Absolute time the aggregator started
+ * @param bucketStart Absolute start of the open minute
+ * @param windowMinutes Nominal window length
+ */
+AggregateWindow reference(const std::vector<Event>& events, uint64_t start, uint64_t bucketStart,
+                          uint8_t windowMinutes) {
+    AggregateWindow out = {};
+    const uint64_t closed = (bucketStart - start) / MINUTE;
+    out.minutes = static_cast<uint16_t>(closed < windowMinutes ? closed : windowMinutes);
+    const uint64_t from = bucketStart - out.minutes * MINUTE;
+    const uint64_t to = bucketStart;
+
+    bool present = false;
+    uint64_t presentSince = 0;
+    uint64_t occupiedMs = 0;
+    uint32_t batterySum = 0;
+    uint32_t batteryCount = 0;
+    uint16_t batteryMin = UINT16_MAX;
+    uint16_t batteryMax = 0;
+
+    for (const Event& event : events) {
+        if (event.time >= to) {
+            break;
+        }
+        const bool inside = event.time >= from;
+        switch (event.kind) {
+            case Kind::PRESENCE:
+                if (event.value && !present) {
+                    present = true;
+                    presentSince = event.time;
+                    out.presenceCount += inside ? 1 : 0;
+                } else if (!event.value && present) {
+                    present = false;
+                    if (event.time > from) {
+                        occupiedMs += event.time - (presentSince > from ? presentSince : from);
+                    }
+                }
+                break;
+            case Kind::MOTION:
+                out.motionCount += inside ? 1 : 0;
+                break;
+            case Kind::RADAR:
+                if (inside) {
+                    const uint16_t bin = event.value / AggregateWindow::DISTANCE_BIN_CM;
+                    out.distanceHistogram[bin < AggregateWindow::DISTANCE_BINS ? bin
+                                                                               : AggregateWindow::DISTANCE_BINS - 1]++;
+                }
+                break;
+            case Kind::BATTERY:
+                if (inside) {
+                    batterySum += event.value;
+                    batteryCount++;
+                    batteryMin = event.value < batteryMin ? event.value : batteryMin;
+                    batteryMax = event.value > batteryMax ? event.value : batteryMax;
+                }
+                break;
+        }
+    }
+    if (present) {
+        occupiedMs += to - (presentSince > from ? presentSince : from);
+    }
+
+    out.occupiedSeconds = static_cast<uint32_t>(occupiedMs / 1000);
+    if (batteryCount > 0) {
+        out.batteryMinMv = batteryMin;
+        out.batteryMeanMv = static_cast<uint16_t>((batterySum + batteryCount / 2) / batteryCount);
+        out.batteryMaxMv = batteryMax;
+    }
+    return out;
+}
+
+bool sameWindow(const AggregateWindow& a, const AggregateWindow& b) {
+    bool same = a.minutes == b.minutes && a.occupiedSeconds == b.occupiedSeconds && a.motionCount == b.motionCount &&
+                a.presenceCount == b.presenceCount && a.batteryMinMv == b.batteryMinMv &&
+                a.batteryMeanMv == b.batteryMeanMv && a.batteryMaxMv == b.batteryMaxMv;
+    for (uint8_t bin = 0; bin < AggregateWindow::DISTANCE_BINS; bin++) {
+        same = same && a.distanceHistogram[bin] == b.distanceHistogram[bin];
+    }
+    return same;
+}
+
+void printWindow(const char* label, const AggregateWindow& window) {
+    printf("    %s: %u min, %u s, motion %u, presence %u, battery %u/%u/%u\n", label, window.minutes,
+           window.occupiedSeconds, window.motionCount, window.presenceCount, window.batteryMinMv,
+           window.batteryMeanMv, window.batteryMaxMv);
+}
+
+/**
+ * @brief Compare every window after a closed minute
+ * @return false on the first mismatch (printed)
+ */
+bool compare(const SensorAggregator& aggregator, const std::vector<Event>& events, uint64_t start,
+             uint64_t bucketStart) {
+    SensorAggregates aggregates{};
+    aggregator.getAggregates(aggregates);
+    if (aggregates.timestamp != static_cast<uint32_t>(bucketStart)) {
+        printf("  minute at %llu: timestamp %lu\n", static_cast<unsigned long long>(bucketStart),
+               static_cast<unsigned long>(aggregates.timestamp));
+        return false;
+    }
+    for (uint8_t w = 0; w < SensorAggregates::WINDOW_COUNT; w++) {
+        const AggregateWindow expected = reference(events, start, bucketStart, SensorAggregator::WINDOW_MINUTES[w]);
+        if (!sameWindow(aggregates.windows[w], expected)) {
+            printf("  minute at %llu, %u min window differs\n", static_cast<unsigned long long>(bucketStart),
+                   SensorAggregator::WINDOW_MINUTES[w]);
+            printWindow("got     ", aggregates.windows[w]);
+            printWindow("expected", expected);
+            return false;
+        }
+    }
+    return true;
+}
+
+void runRandom(uint32_t eventCount) {
+    const uint64_t start = 0x100000000ull - 30 * MINUTE;   // Wraps after 30 minutes
+    SensorAggregator aggregator;
+    aggregator.begin(static_cast<uint32_t>(start));
+
+    std::vector<Event> events;
+    events.reserve(eventCount);
+    uint64_t now = start;
+    uint64_t bucketStart = start;
+    uint32_t minutesChecked = 0;
+    uint32_t gaps = 0;
+    uint32_t radarFrame = 0;
+    bool good = true;
+
+    for (uint32_t i = 0; i < eventCount && good; i++) {
+        // Mostly seconds apart, sometimes a minute or more, rarely hours
+        const uint32_t roll = nextRandom() % 1000;
+        uint64_t step = 1 + nextRandom() % 8000;
+        bool sleeping = false;
+        if (roll < 5) {
+            step = MINUTE + nextRandom() % (5 * 60 * MINUTE);
+            sleeping = true;
+            gaps++;
+        } else if (roll < 50) {
+            step = nextRandom() % (3 * MINUTE);
+        }
+        const uint64_t next = now + step;
+
+        // The sensor task wakes at each deadline unless the SoC sleeps through
+        while (!sleeping && bucketStart + MINUTE <= next && good) {
+            bucketStart += MINUTE;
+            const bool closed = aggregator.advance(static_cast<uint32_t>(bucketStart));
+            good = closed && compare(aggregator, events, start, bucketStart);
+            minutesChecked++;
+        }
+        now = next;
+
+        Event event = {now, Kind::MOTION, 0};
+        switch (nextRandom() % 4) {
+            case 0:
+                event.kind = Kind::PRESENCE;
+                event.value = nextRandom() % 2;
+                aggregator.setPresence(event.value != 0, static_cast<uint32_t>(now));
+                break;
+            case 1:
+                aggregator.addMotion(static_cast<uint32_t>(now));
+                break;
+            case 2:
+                event.kind = Kind::RADAR;
+                event.value = nextRandom() % 1200;
+                radarFrame++;
+                aggregator.addRadarDistance(event.value, radarFrame, static_cast<uint32_t>(now));
+                if (nextRandom() % 3 == 0) {
+                    // The next poll sees the same report again
+                    aggregator.addRadarDistance(event.value, radarFrame, static_cast<uint32_t>(now + 250));
+                }
+                break;
+            default:
+                event.kind = Kind::BATTERY;
+                event.value = 3300 + nextRandom() % 900;
+                aggregator.addBatteryReading(event.value, static_cast<uint32_t>(now));
+                break;
+        }
+        events.push_back(event);
+
+        // After a gap the input itself closed the missed minutes; check on the next advance()
+        if (sleeping) {
+            while (bucketStart + MINUTE <= now) {
+                bucketStart += MINUTE;
+            }
+            good = aggregator.advance(static_cast<uint32_t>(now)) && compare(aggregator, events, start, bucketStart);
+            minutesChecked++;
+        }
+    }
+
+    check(good, "random", "a window differs from the recomputation");
+    printf("random     %zu events over %.1f h, %u gaps, %u minute closes compared, wrap at minute 30\n",
+           events.size(), (now - start) / 3600000.0, gaps, minutesChecked);
+}
+
+void runSplit() {
+    SensorAggregator aggregator;
+    aggregator.begin(0);
+    aggregator.setPresence(true, 40000);        // 20 s in minute 0
+    aggregator.setPresence(false, 150000);      // all of minute 1, 30 s of minute 2
+    aggregator.advance(180000);
+
+    SensorAggregates aggregates{};
+    aggregator.getAggregates(aggregates);
+    const AggregateWindow& last = aggregates.windows[0];
+    const AggregateWindow& quarter = aggregates.windows[1];
+    check(last.minutes == 1 && last.occupiedSeconds == 30 && last.presenceCount == 0, "split",
+          "last minute must hold the 30 s tail only");
+    check(quarter.minutes == 3 && quarter.occupiedSeconds == 110 && quarter.presenceCount == 1, "split",
+          "15 min window must hold 20 + 60 + 30 s and one presence start");
+    printf("split      20 s + 60 s + 30 s: 1 min window %u s, 15 min window %u s\n", last.occupiedSeconds,
+           quarter.occupiedSeconds);
+}
+
+void runWarmup() {
+    SensorAggregator aggregator;
+    aggregator.begin(1000);
+    bool good = true;
+    for (uint32_t minute = 1; minute <= 70 && good; minute++) {
+        aggregator.advance(1000 + minute * MINUTE);
+        SensorAggregates aggregates{};
+        aggregator.getAggregates(aggregates);
+        for (uint8_t w = 0; w < SensorAggregates::WINDOW_COUNT; w++) {
+            const uint8_t nominal = SensorAggregator::WINDOW_MINUTES[w];
+            good = good && aggregates.windows[w].minutes == (minute < nominal ? minute : nominal);
+        }
+    }
+    check(good, "warmup", "window minute counts while filling");
+    printf("warmup     1/15/60 min windows fill minute by minute over 70 minutes\n");
+}
+
+void runGap() {
+    SensorAggregator aggregator;
+    aggregator.begin(0);
+    aggregator.setPresence(true, 30000);
+    aggregator.addMotion(30000);
+    // Five hours asleep, present throughout; wake in the middle of a minute
+    const uint32_t wake = 5 * 60 * MINUTE + 15000;
+    const bool closed = aggregator.advance(wake);
+
+    SensorAggregates aggregates{};
+    aggregator.getAggregates(aggregates);
+    const AggregateWindow hour = aggregates.windows[2];
+    check(closed && hour.minutes == 60 && hour.occupiedSeconds == 3600, "gap", "hour window must be fully occupied");
+    check(hour.motionCount == 0 && hour.presenceCount == 0, "gap", "old events must have left the hour window");
+    check(aggregates.timestamp == 5 * 60 * MINUTE, "gap", "open minute must be the one containing the wake time");
+
+    aggregator.setPresence(false, wake + 5000);
+    aggregator.advance(5 * 60 * MINUTE + MINUTE);
+    aggregator.getAggregates(aggregates);
+    check(aggregates.windows[0].occupiedSeconds == 20, "gap", "occupancy in the wake minute");
+    printf("gap        5 h asleep while present: hour window %u min, %u s; wake minute %u s\n", hour.minutes,
+           hour.occupiedSeconds, aggregates.windows[0].occupiedSeconds);
+}
+
+void runPolls() {
+    SensorAggregator aggregator;
+    aggregator.begin(0);
+
+    // Report 7 seen by the 250 ms poll and two wake-interrupt polls, then report 8
+    aggregator.addRadarDistance(150, 7, 1000);
+    aggregator.addRadarDistance(150, 7, 1010);
+    aggregator.addRadarDistance(150, 7, 1250);
+    aggregator.addRadarDistance(150, 8, 1500);
+    aggregator.advance(MINUTE);
+
+    SensorAggregates aggregates{};
+    aggregator.getAggregates(aggregates);
+    uint32_t samples = 0;
+    for (uint8_t bin = 0; bin < AggregateWindow::DISTANCE_BINS; bin++) {
+        samples += aggregates.windows[0].distanceHistogram[bin];
+    }
+    check(samples == 2, "polls", "a repeated report was counted again");
+    printf("polls      4 polls of 2 reports: %u distance samples\n", samples);
+}
+
+}
+
+int main(int argc, char** argv) {
+    runRandom(argc > 1 ? static_cast<uint32_t>(atol(argv[1])) : 20000);
+    runSplit();
+    runWarmup();
+    runGap();
+    runPolls();
+    printf("\n%s\n", allPassed ? "PASS" : "FAIL");
+    return allPassed ? 0 : 1;
+}
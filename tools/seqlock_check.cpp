@@ -0,0 +1,194 @@
+/**
+ * @file seqlock_check.cpp
+ * @brief Host tool: Seqlock change detection and torn-read freedom
+ *
+ * Runs the firmware's Seqlock template on the host. Checks:
+ *   - generation: advances once per changed value, not on a republish of
+ *                 an equal one; changedSince() follows it
+ *   - padding:    a padded type without operator== built with {} does not
+ *                 advance on an equal republish, while the same value with
+ *                 garbage in its padding does (why Seqlock.h asks for {})
+ *   - operator==: PirData and SensorData compare field by field, so
+ *                 garbage padding or the constructor's unset padding does
+ *                 not count as a change
+ *   - torn:       one writer thread publishing as fast as it can against
+ *                 reader threads that check every snapshot is one write
+ *
+ * The threaded part relies on x86 ordering plus the fences in Seqlock; it
+ * is a smoke test, not a proof for the ESP32-S3.
+ *
+ * Build and run from the repository root (see tools/Makefile):
+ *   make -C tools && tools/build/seqlock_check [seconds]
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <thread>
+#include <vector>
+#include "HostCheck.h"
+#include "config/DataTypes.h"
+#include "utilities/Seqlock.h"
+
+unsigned long millis() {
+    return 1000;
+}
+
+namespace {
+
+void runGeneration() {
+    Seqlock<uint32_t> lock;
+    uint32_t value = 0;
+    const uint32_t start = lock.read(value);
+    const bool first = lock.publish(5);
+    const bool repeat = lock.publish(5);
+    const bool second = lock.publish(6);
+    const uint32_t generation = lock.read(value);
+    check(start == 0 && first && !repeat && second, "generation", "publish() return values");
+    check(generation == 2 && value == 6, "generation", "generation must count changes only");
+    check(lock.changedSince(1) && !lock.changedSince(2), "generation", "changedSince()");
+    printf("generation 5, 5, 6 -> generation %u, value %u\n", generation, value);
+}
+
+// uint8_t then uint32_t: three padding bytes, no operator==
+struct Padded {
+    uint8_t flag;
+    uint32_t count;
+};
+
+void runPadding() {
+    Seqlock<Padded> lock;
+
+    Padded clean{};
+    clean.flag = 1;
+    clean.count = 42;
+    lock.publish(clean);
+    Padded again{};
+    again.flag = 1;
+    again.count = 42;
+    const bool cleanRepublish = lock.publish(again);
+
+    Padded dirty;
+    memset(static_cast<void*>(&dirty), 0xA5, sizeof(dirty));
+    dirty.flag = 1;
+    dirty.count = 42;
+    const bool dirtyRepublish = lock.publish(dirty);
+
+    check(!cleanRepublish, "padding", "an equal value built with {} advanced the generation");
+    check(dirtyRepublish, "padding", "expected garbage padding to look like a change without operator==");
+    printf("padding    {} republish %s, garbage-padding republish %s (bytewise compare)\n",
+           cleanRepublish ? "advanced" : "ignored", dirtyRepublish ? "advanced" : "ignored");
+}
+
+void runOperatorEqual() {
+    Seqlock<PirData> pirLock;
+    PirData pir{};
+    pir.motionDetected = true;
+    pir.lastDetectionTime = 1234;
+    pir.detectionCount = 3;
+    pirLock.publish(pir);
+
+    PirData dirty;
+    memset(static_cast<void*>(&dirty), 0x5A, sizeof(dirty));
+    dirty.motionDetected = true;
+    dirty.lastDetectionTime = 1234;
+    dirty.detectionCount = 3;
+    const bool pirAdvanced = pirLock.publish(dirty);
+
+    // SensorData's constructor sets every field but not the padding
+    Seqlock<SensorData> sensorLock;
+    alignas(SensorData) unsigned char storage[2][sizeof(SensorData)];
+    memset(storage[0], 0x00, sizeof(storage[0]));
+    memset(storage[1], 0xFF, sizeof(storage[1]));
+    SensorData* first = new (storage[0]) SensorData();
+    SensorData* second = new (storage[1]) SensorData();
+    first->pirMotionDetected = second->pirMotionDetected = true;
+    first->batteryVoltage = second->batteryVoltage = 3.9f;
+    sensorLock.publish(*first);
+    const bool sensorAdvanced = sensorLock.publish(*second);
+    second->ld2410sDistance = 120;
+    const bool sensorChanged = sensorLock.publish(*second);
+
+    check(!pirAdvanced, "operator==", "PirData with garbage padding counted as a change");
+    check(!sensorAdvanced && sensorChanged, "operator==", "SensorData must compare its fields, not its bytes");
+    printf("operator== PirData garbage padding %s, SensorData unset padding %s, real change %s\n",
+           pirAdvanced ? "advanced" : "ignored", sensorAdvanced ? "advanced" : "ignored",
+           sensorChanged ? "advanced" : "ignored");
+}
+
+// Every field carries the same counter, so a torn copy has differing fields
+struct Wide {
+    uint32_t words[16];
+};
+
+void runTorn(double seconds) {
+    Seqlock<Wide> lock;
+    std::atomic<bool> stop{false};
+    std::atomic<uint64_t> reads{0};
+    std::atomic<uint64_t> torn{0};
+    std::atomic<uint64_t> backwards{0};
+
+    std::vector<std::thread> readers;
+    const unsigned readerCount = std::thread::hardware_concurrency() > 2 ? 2 : 1;
+    for (unsigned r = 0; r < readerCount; r++) {
+        readers.emplace_back([&]() {
+            uint64_t localReads = 0;
+            uint32_t lastGeneration = 0;
+            Wide value;
+            while (!stop.load(std::memory_order_relaxed)) {
+                const uint32_t generation = lock.read(value);
+                for (uint32_t word : value.words) {
+                    if (word != value.words[0]) {
+                        torn.fetch_add(1, std::memory_order_relaxed);
+                        break;
+                    }
+                }
+                if (generation < lastGeneration || value.words[0] != generation) {
+                    backwards.fetch_add(1, std::memory_order_relaxed);
+                }
+                lastGeneration = generation;
+                localReads++;
+            }
+            reads.fetch_add(localReads, std::memory_order_relaxed);
+        });
+    }
+
+    uint64_t writes = 0;
+    const auto end = std::chrono::steady_clock::now() + std::chrono::duration<double>(seconds);
+    Wide value{};
+    while (std::chrono::steady_clock::now() < end) {
+        for (int i = 0; i < 1000; i++) {
+            // Generation n holds counter n
+            const uint32_t next = value.words[0] + 1;
+            for (uint32_t& word : value.words) {
+                word = next;
+            }
+            lock.publish(value);
+            writes++;
+        }
+    }
+    stop.store(true);
+    for (std::thread& reader : readers) {
+        reader.join();
+    }
+
+    check(torn.load() == 0, "torn", "a reader saw a mix of two writes");
+    check(backwards.load() == 0, "torn", "generation and value disagree or went backwards");
+    printf("torn       %.1f s: %llu writes, %llu reads on %u reader(s), %llu torn, %llu inconsistent\n", seconds,
+           static_cast<unsigned long long>(writes), static_cast<unsigned long long>(reads.load()), readerCount,
+           static_cast<unsigned long long>(torn.load()), static_cast<unsigned long long>(backwards.load()));
+}
+
+}
+
+int main(int argc, char** argv) {
+    runGeneration();
+    runPadding();
+    runOperatorEqual();
+    runTorn(argc > 1 ? atof(argv[1]) : 2.0);
+    printf("\n%s\n", allPassed ? "PASS" : "FAIL");
+    return allPassed ? 0 : 1;
+}
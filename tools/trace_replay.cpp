@@ -0,0 +1,233 @@
+/**
+ * @file trace_replay.cpp
+ * @brief Host tool: replay recorded sensor traces through the presence fusion
+ *
+ * Feeds a trace recorded by TraceRecorder through the firmware's
+ * PresenceFusion engine as fast as it can be decoded, and counts the
+ * transitions and the MQTT publishes SensorManager would have made
+ * (one per PIR, radar presence, power source and fused presence change).
+ * Fusion parameters default to Settings.h and can be overridden to try
+ * other tunings on the same data.
+ *
+ * Build with `make -C tools` (see tools/Makefile).
+ *
+ * Get the segments with the 'd' console command and convert each hex
+ * block with `xxd -r -p block.txt segment.bin`, then:
+ *   tools/build/trace_replay [--cooldown ms] [--hold ms] [--moving-min n]
+ *                            [--stationary-min n] [--verbose] segment.bin...
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include "config/Settings.h"
+#include "sensors/PresenceFusion.h"
+#include "utilities/TraceCodec.h"
+
+namespace {
+
+struct Segment {
+    uint32_t sequence;
+    const char* path;
+    std::vector<uint8_t> data;
+};
+
+struct Counters {
+    uint32_t records = 0;
+    uint32_t dropped = 0;
+    uint32_t reboots = 0;
+    uint32_t pirEdges = 0;
+    uint32_t pirChanges = 0;
+    uint32_t radarChanges = 0;
+    uint32_t powerChanges = 0;
+    uint32_t presenceTransitions = 0;
+    uint64_t traceMs = 0;
+};
+
+bool verbose = false;
+
+void onTransition(void* context, bool present, uint32_t timestamp) {
+    static_cast<Counters*>(context)->presenceTransitions++;
+    if (verbose) {
+        printf("%10u ms  presence %s\n", timestamp, present ? "ON" : "off");
+    }
+}
+
+bool readSegment(const char* path, Segment& segment) {
+    FILE* file = fopen(path, "rb");
+    if (file == nullptr) {
+        fprintf(stderr, "%s: cannot open\n", path);
+        return false;
+    }
+
+    uint8_t chunk[4096];
+    size_t length;
+    while ((length = fread(chunk, 1, sizeof(chunk), file)) > 0) {
+        segment.data.insert(segment.data.end(), chunk, chunk + length);
+    }
+    fclose(file);
+
+    TraceCodec codec;
+    TraceRecord header;
+    if (codec.decode(segment.data.data(), segment.data.size(), header) == 0 ||
+        header.type != TraceRecordType::HEADER) {
+        fprintf(stderr, "%s: not a trace segment\n", path);
+        return false;
+    }
+
+    segment.sequence = header.value;
+    segment.path = path;
+    return true;
+}
+
+}
+
+int main(int argc, char** argv) {
+    PresenceConfig config = {
+        PRESENCE_COOLDOWN, PRESENCE_RADAR_HOLD, PRESENCE_MOVING_ENERGY_MIN, PRESENCE_STATIONARY_ENERGY_MIN
+    };
+    std::vector<Segment> segments;
+
+    for (int i = 1; i < argc; i++) {
+        const bool hasValue = i + 1 < argc;
+        if (strcmp(argv[i], "--cooldown") == 0 && hasValue) {
+            config.cooldownMs = strtoul(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "--hold") == 0 && hasValue) {
+            config.holdMs = strtoul(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "--moving-min") == 0 && hasValue) {
+            config.movingEnergyMin = static_cast<uint16_t>(strtoul(argv[++i], nullptr, 10));
+        } else if (strcmp(argv[i], "--stationary-min") == 0 && hasValue) {
+            config.stationaryEnergyMin = static_cast<uint16_t>(strtoul(argv[++i], nullptr, 10));
+        } else if (strcmp(argv[i], "--verbose") == 0) {
+            verbose = true;
+        } else if (argv[i][0] == '-') {
+            fprintf(stderr, "Unknown option %s\n", argv[i]);
+            return 2;
+        } else {
+            Segment segment;
+            if (readSegment(argv[i], segment)) {
+                segments.push_back(std::move(segment));
+            }
+        }
+    }
+
+    if (segments.empty()) {
+        fprintf(stderr, "Usage: %s [--cooldown ms] [--hold ms] [--moving-min n] "
+                        "[--stationary-min n] [--verbose] segment.bin...\n", argv[0]);
+        return 2;
+    }
+
+    // Oldest first, as recorded
+    std::sort(segments.begin(), segments.end(),
+              [](const Segment& a, const Segment& b) { return a.sequence < b.sequence; });
+
+    Counters counters;
+    PresenceFusion fusion(config);
+    fusion.setTransitionListener(&onTransition, &counters);
+
+    // SensorManager's publish-on-change state
+    bool pirMotion = false;
+    bool radarPresence = false;
+    bool usbPower = false;
+    bool havePower = false;
+    bool haveTime = false;
+    uint32_t firstMs = 0;
+    uint32_t lastMs = 0;
+
+    const auto started = std::chrono::steady_clock::now();
+
+    for (const Segment& segment : segments) {
+        TraceCodec codec;
+        size_t offset = 0;
+
+        while (offset < segment.data.size()) {
+            TraceRecord record;
+            const size_t used = codec.decode(segment.data.data() + offset, segment.data.size() - offset, record);
+            if (used == 0) {
+                fprintf(stderr, "%s: stopped at corrupt record, offset %zu\n", segment.path, offset);
+                break;
+            }
+            offset += used;
+            counters.records++;
+
+            switch (record.type) {
+                case TraceRecordType::HEADER:
+                    continue;
+
+                case TraceRecordType::SYNC:
+                    counters.dropped += record.value;
+                    // millis() went backwards: the device restarted
+                    if (haveTime && static_cast<int32_t>(record.timestamp - lastMs) < 0) {
+                        counters.reboots++;
+                        counters.traceMs += lastMs - firstMs;
+                        firstMs = record.timestamp;
+                        fusion = PresenceFusion(config);
+                        fusion.setTransitionListener(&onTransition, &counters);
+                        pirMotion = false;
+                        radarPresence = false;
+                        havePower = false;
+                    }
+                    break;
+
+                case TraceRecordType::PIR_EDGE:
+                    counters.pirEdges++;
+                    break;
+
+                case TraceRecordType::PIR_STATE:
+                    if (record.level != pirMotion) {
+                        pirMotion = record.level;
+                        counters.pirChanges++;
+                    }
+                    fusion.setPir(record.level, record.timestamp);
+                    break;
+
+                case TraceRecordType::RADAR: {
+                    const bool presence = record.moving || record.stationary;
+                    if (presence != radarPresence) {
+                        radarPresence = presence;
+                        counters.radarChanges++;
+                    }
+                    fusion.setRadar(record.moving, record.movingEnergy,
+                                    record.stationary, record.stationaryEnergy, record.timestamp);
+                    break;
+                }
+
+                case TraceRecordType::POWER:
+                    if (havePower && record.usbPower != usbPower) {
+                        counters.powerChanges++;
+                    }
+                    usbPower = record.usbPower;
+                    havePower = true;
+                    break;
+            }
+
+            if (!haveTime) {
+                firstMs = record.timestamp;
+                haveTime = true;
+            }
+            lastMs = record.timestamp;
+        }
+    }
+
+    // Timers that expired before the last record
+    fusion.advance(lastMs);
+    counters.traceMs += lastMs - firstMs;
+
+    const double wallMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started).count();
+    const uint32_t publishes = counters.pirChanges + counters.radarChanges + counters.powerChanges +
+                               counters.presenceTransitions;
+
+    printf("Fusion: cooldown %u ms, hold %u ms, energy >= %u moving / %u stationary\n",
+           config.cooldownMs, config.holdMs, config.movingEnergyMin, config.stationaryEnergyMin);
+    printf("Trace: %zu segments, %u records, %.1f s recorded, %u restarts, %u records dropped\n",
+           segments.size(), counters.records, counters.traceMs / 1000.0, counters.reboots, counters.dropped);
+    printf("Inputs: %u raw PIR edges, %u PIR changes, %u radar presence changes, %u power source changes\n",
+           counters.pirEdges, counters.pirChanges, counters.radarChanges, counters.powerChanges);
+    printf("Presence transitions: %u\n", counters.presenceTransitions);
+    printf("Publishes: %u\n", publishes);
+    printf("Replayed in %.2f ms (%.0fx real time)\n", wallMs, wallMs > 0 ? counters.traceMs / wallMs : 0.0);
+    return 0;
+}